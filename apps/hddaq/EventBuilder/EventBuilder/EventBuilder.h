@@ -57,4 +57,13 @@ const int g_EVENT_TYPE_NULL    = 1;
 #define ET_NOMAL g_EVENT_TYPE_NORMAL;
 #define ET_NULL g_EVENT_TYPE_NULL;
 
+// Batch framing between a front-end and the event builder: a super-frame
+// header {g_BATCH_MAGIC, total size in words including these two words}
+// followed by consecutive event_header-prefixed fragments. A reader with
+// the "batch" flag in the node map sends g_BATCH_REQUEST after connecting
+// and accepts both super-frames and plain events from then on.
+const int  g_BATCH_MAGIC    = 0x42415443;
+const char g_BATCH_REQUEST  = 'B';
+const int  g_BATCH_MAX_BYTE = 64 * 1024 * 1024;
+
 #endif
@@ -58,13 +58,25 @@
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
 #include "kol/kolthread.h"
 #include "RingBuffer/RingBuffer.h"
 #include "EventData/EventBuffer.h"
 #include "EventData/EventParam.h"
 #include "EventBuilder/readerThread.h"
+#include "EventBuilder/builderWorker.h"
 #include "ControlThread/statableThread.h"
 
+// In zero-copy mode a send buffer slot holds the event header followed
+// by one fragment_ref per node instead of the merged data. Fragments that
+// cannot stay in their node ring (null events, slow readers) are copied
+// behind the references.
+struct fragment_ref {
+  const char*  data;
+  unsigned int nbyte;
+  int          node;   // node ring to be freed after sending, -1 if inline
+};
+
 class BuilderThread : public StatableThread
 {
   //static const int SEND_RB_BUFLEN   = 20;
@@ -84,6 +96,15 @@ public:
   int getRingBufferDepth();
   void setSemPost();
 
+  void setZeroCopy(bool zero_copy);
+  bool isZeroCopy() const { return m_zero_copy; }
+  int  freeSentFragments(EventBuffer* event);
+
+  // parallel mode: nworker > 1 assembly workers copy the fragments
+  void setWorkers(int nworker);
+  int  getWorkers() const { return m_nworker; }
+  int  commitMergData(const build_job& job);
+
   void setDebugPrint(int d_print);
   void setParaFd(int fd_para);
   void getOneShot();
@@ -94,15 +115,24 @@ protected:
   double checkTrigRate(int ntimes);
   int    checkEventNumber();
   int    waitReaders();
+  int    mergeFragments(char* ptr);
+  int    referFragments(char* ptr, char* end);
+  int    dispatchFragments(EventBuffer* event, char* ptr);
+  void   startWorkers();
+  void   stopWorkers();
 
 private:
   int m_node_num;
   int m_fd_para;
   int m_debug_print;
+  bool m_zero_copy;
+  int  m_nworker;
 
   ReaderThread** m_readers;
   EventBuffer*   m_event_f[max_node_num];
+  bool           m_acquired[max_node_num];
   RingBuffer*    m_send_rb;
+  std::vector<BuilderWorker*> m_workers;
 };
 
 #endif
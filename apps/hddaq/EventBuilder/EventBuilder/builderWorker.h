@@ -0,0 +1,77 @@
+// -*- C++ -*-
+/**
+ *  @file   builderWorker.h
+ *  @brief  assembly workers of the parallel builder mode
+ *
+ *  In the parallel mode the BuilderThread is only a dispatcher: it
+ *  collects the fragment pointers of an event, checks them, reserves the
+ *  next send buffer slot and writes the event header. The copy of the
+ *  fragments into the slot is left to one of K BuilderWorkers, event n
+ *  going to worker n % K. A worker commits its slot and frees the node
+ *  ring fragments only when it holds the turn token, which is passed
+ *  round-robin from worker to worker, so the SenderThread still receives
+ *  the events in event-number order.
+ */
+
+#ifndef BUILDER_WORKER_H
+#define BUILDER_WORKER_H
+
+#include <vector>
+
+#include "kol/kolthread.h"
+#include "EventData/EventBuffer.h"
+#include "EventData/EventParam.h"
+
+class BuilderThread;
+
+struct build_job {
+  // send buffer slot to be committed, 0 asks the worker to exit
+  EventBuffer* event;
+  int          nfrag;
+  struct {
+    const char*  src;
+    char*        dst;
+    unsigned int nbyte;
+    int          node;
+  } frag[max_node_num];
+};
+
+class BuilderWorker : public kol::Thread
+{
+public:
+  static const int JOB_DEPTH = 8;
+
+  BuilderWorker(BuilderThread& builder, int id);
+  virtual ~BuilderWorker();
+
+  int  getId() const { return m_id; }
+  void setNext(BuilderWorker* next) { m_next = next; }
+  void giveTurn() { m_turn.post(); }
+
+  // called by the dispatcher
+  build_job& peekJob();
+  void       postJob();
+  void       postExit();
+
+  unsigned long getEventCount() const { return m_nevent; }
+
+protected:
+  int run();
+
+private:
+  BuilderWorker(const BuilderWorker&);
+  BuilderWorker& operator=(const BuilderWorker&);
+
+  BuilderThread&         m_builder;
+  int                    m_id;
+  BuilderWorker*         m_next;
+  std::vector<build_job> m_job;
+  int                    m_job_wr;
+  int                    m_job_rd;
+  kol::Semaphore         m_nfree;
+  kol::Semaphore         m_nfull;
+  kol::Semaphore         m_turn;
+  unsigned long          m_nevent;
+};
+
+#endif
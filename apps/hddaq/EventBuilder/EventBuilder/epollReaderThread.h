@@ -0,0 +1,107 @@
+// -*- C++ -*-
+/**
+ *  @file   epollReaderThread.h
+ *  @brief  event readers served by a small pool of epoll threads
+ *
+ *  An EpollReaderThread is a ReaderThread without a thread of its own:
+ *  it keeps the node ring buffer and the run state seen by the builder
+ *  and the controller, while the socket is read without blocking by one
+ *  of the workers of an EpollReaderEngine. A node whose ring buffer is
+ *  full is taken out of the epoll set until the builder has freed a slot
+ *  (backpressure), so a slow consumer never blocks the other nodes of
+ *  the same worker.
+ */
+
+#ifndef EPOLL_READER_THREAD_H
+#define EPOLL_READER_THREAD_H
+
+#include <vector>
+#include <sys/time.h>
+
+#include "kol/kolthread.h"
+#include "kol/koltcp.h"
+#include "EventBuilder/readerThread.h"
+
+class EpollReaderThread : public ReaderThread
+{
+public:
+  enum Status { READ_AGAIN, READ_BLOCKED, READ_CLOSED };
+
+public:
+  EpollReaderThread(int buflen, int quelen);
+  EpollReaderThread(int buflen, int quelen, bool lockfree);
+  virtual ~EpollReaderThread();
+
+  // called by the owning EpollReaderWorker
+  int    open();
+  void   close();
+  int    fd() const { return m_fd; }
+  int    node() const { return m_node; }
+  Status onReadable();
+  bool   isBlocked() const { return m_blocked; }
+  bool   hasRoom();
+  void   unblock();
+  int    pollCommand() { return checkCommand(); }
+
+  unsigned long getStallCount() const { return m_nstall; }
+  double        getStallTime() const { return m_stall_time; }
+
+private:
+  enum Phase { HEADER, BODY, DISCARD };
+
+  Status fail(const char* what);
+  void   block();
+
+  kol::TcpClient*   m_client;
+  int               m_fd;
+  Phase             m_phase;
+  size_t            m_done;
+  unsigned int      m_header[2];
+  EventBuffer*      m_slot;
+  size_t            m_trans_byte;
+  size_t            m_rest_byte;
+  std::vector<char> m_discard;
+  std::string       m_label;
+
+  bool              m_blocked;
+  struct timeval    m_blocked_since;
+  unsigned long     m_nstall;
+  double            m_stall_time;
+};
+
+class EpollReaderWorker : public kol::Thread
+{
+public:
+  EpollReaderWorker();
+  virtual ~EpollReaderWorker();
+  void add(EpollReaderThread* reader) { m_readers.push_back(reader); }
+  bool empty() const { return m_readers.empty(); }
+
+protected:
+  int run();
+
+private:
+  std::vector<EpollReaderThread*> m_readers;
+};
+
+class EpollReaderEngine : public kol::Thread
+{
+public:
+  EpollReaderEngine(int nthread);
+  virtual ~EpollReaderEngine();
+  void add(EpollReaderThread* reader);
+  int  size() const { return m_readers.size(); }
+
+protected:
+  int run();
+
+private:
+  bool allCommand(Command command);
+  void runOnce();
+  void report();
+
+  std::vector<EpollReaderThread*> m_readers;
+  std::vector<EpollReaderWorker*> m_workers;
+};
+
+#endif
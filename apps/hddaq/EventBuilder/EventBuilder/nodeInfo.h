@@ -59,6 +59,19 @@ public:
   int         getRingbufSize(){ return m_ringbuf_size;}
   int         getRingbufLen(){ return m_ringbuf_len;}
   std::string getSyncFlag() { return m_sync;}
+
+  // the flag column is a comma separated list, e.g. "slow" or "spsc"
+  bool hasFlag(const std::string& key)
+  {
+    std::string::size_type pos = 0;
+    while (pos <= m_sync.size()) {
+      std::string::size_type end = m_sync.find(',', pos);
+      if (end == std::string::npos) end = m_sync.size();
+      if (m_sync.compare(pos, end-pos, key) == 0) return true;
+      pos = end + 1;
+    }
+    return false;
+  }
   
 private:
   std::string m_hostname;
@@ -63,14 +63,21 @@ public:
   
 public:
   ReaderThread(int buflen, int quelen);
+  ReaderThread(int buflen, int quelen, bool lockfree);
   virtual ~ReaderThread();
   void setHost(const char * host, int port, int node);
+  // accept super-frames of several events (g_BATCH_MAGIC)
+  void setBatch(bool batch) { m_batch = batch; }
   virtual void initBuffer();
   RingBuffer * getNodeRB();
   virtual EventBuffer * peekReadFragData();
   virtual int releaseReadFragData();
   virtual EventBuffer * peekWriteFragData();
   virtual int releaseWriteFragData();
+  // zero-copy building: fragments stay in the node ring until sent
+  virtual bool supportsAcquire() { return true; }
+  virtual EventBuffer * acquireReadFragData();
+  virtual int freeReadFragData();
   virtual int leftEventData();
   virtual int getRingBufferDepth();
 
@@ -87,6 +94,13 @@ protected:
 			      unsigned int* header,
 			      int trans_byte,
 			      int rest_byte);
+  virtual int requestBatch(kol::TcpClient& client);
+  // reads (buf) or skips (buf = 0) nbyte of a super-frame
+  virtual int readBatchBytes(kol::TcpClient& client,
+			     char* buf,
+			     size_t nbyte);
+  virtual int updateBatchData(kol::TcpClient& client,
+			      unsigned int* header);
 
 // private:
   std::string m_host;
@@ -94,6 +108,7 @@ protected:
   int    m_node;
   int    m_ringbuf_len;
   RingBuffer * m_node_rb;
+  bool   m_batch;
 
 };
 #endif
@@ -51,6 +51,8 @@
 #define SENDER_THREAD_H
 
 #include <iostream>
+#include <vector>
+#include <sys/uio.h>
 #include "kol/kolthread.h"
 #include "kol/koltcp.h"
 #include "ControlThread/statableThread.h"
@@ -71,9 +73,11 @@ protected:
   int active_loop();
   int run();
   int waitBuilder();
+  void setIov(EventBuffer* event);
 
 private:
   BuilderThread * m_builder;
+  std::vector<struct iovec> m_iov;
 };
 
 #endif
@@ -20,6 +20,8 @@ public:
   virtual int  releaseWriteFragData();
   virtual EventBuffer* peekReadFragData();
   virtual EventBuffer* peekWriteFragData();
+  // the single buffer is guarded by a mutex owned by the builder thread
+  virtual bool supportsAcquire() { return false; }
 
 protected:
   virtual int updateEventData(kol::TcpClient& client,
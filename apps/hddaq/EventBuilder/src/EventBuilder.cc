@@ -72,6 +72,7 @@
 #include "EventBuilder/readerThread.h"
 #include "EventBuilder/syncReaderThread.h"
 #include "EventBuilder/slowReaderThread.h"
+#include "EventBuilder/epollReaderThread.h"
 #include "EventBuilder/builderThread.h"
 #include "EventBuilder/senderThread.h"
 #include "EventBuilder/nodeInfo.h"
@@ -97,6 +98,7 @@ typedef std::vector<NodeInfo> Node_info;
 Node_info node_info;
 
 const int k_quelen = 200;
+const int k_epoll_threads = 4;
 
 int get_node_inf(const char* filename, Node_map* node_map)
 {
@@ -196,6 +198,9 @@ int main(int argc, char* argv[])
   std::string nickname = NodeId::getNodeId(NODETYPE_EB, &nodeid);
 
   std::string nodemapname = "nodemap.txt";
+  bool zero_copy = false;
+  int  epoll_threads = k_epoll_threads;
+  int  builder_threads = 1;
   for(int i=1 ; i<argc ; i++){
     std::string arg = argv[i];
     if( arg.size() > 0 && arg[0] != '-' ){
@@ -222,6 +227,23 @@ int main(int argc, char* argv[])
 	is_match = true;
       }
 #endif //2014.11.26 K.Hosomi
+      if (arg.substr(0, 16) == "--epoll-threads=") {
+	std::istringstream ssval(arg.substr(16));
+	ssval >> epoll_threads;
+	std::cout << "EPOLL THREADS : " << epoll_threads << std::endl;
+	is_match = true;
+      }
+      if (arg.substr(0, 18) == "--builder-threads=") {
+	std::istringstream ssval(arg.substr(18));
+	ssval >> builder_threads;
+	std::cout << "BUILDER THREADS : " << builder_threads << std::endl;
+	is_match = true;
+      }
+      if (arg == "--zero-copy") {
+	zero_copy = true;
+	std::cout << "ZERO COPY : on" << std::endl;
+	is_match = true;
+      }
       if (arg.substr(0, 11) == "--nickname=") {
 	nickname = arg.substr(11);
 	std::cout << "NICKNAME : " << nickname << std::endl;
@@ -268,15 +290,31 @@ int main(int argc, char* argv[])
 
       //     readers = new ReaderThread * [node_number];
       readers.resize(node_number);
+      EpollReaderEngine epoll_engine(epoll_threads);
 
       for(int node=0; node<node_number; node++) {
 	int node_buflen = node_info[node].getRingbufSize();
 	int quelen = node_info[node].getRingbufLen();
 	const std::string& flag = node_info[node].getSyncFlag();
-	if (flag.empty())
-	  readers[node] = new ReaderThread(node_buflen, quelen);
-	else if (flag=="slow")
+	if (node_info[node].hasFlag("slow"))
 	  readers[node] = new SlowReaderThread(node_buflen, quelen);
+	else if (node_info[node].hasFlag("epoll")) {
+	  EpollReaderThread* reader;
+	  if (node_info[node].hasFlag("spsc"))
+	    reader = new EpollReaderThread(node_buflen, quelen, true);
+	  else if (node_info[node].hasFlag("sem"))
+	    reader = new EpollReaderThread(node_buflen, quelen, false);
+	  else
+	    reader = new EpollReaderThread(node_buflen, quelen);
+	  epoll_engine.add(reader);
+	  readers[node] = reader;
+	}
+	else if (node_info[node].hasFlag("spsc"))
+	  readers[node] = new ReaderThread(node_buflen, quelen, true);
+	else if (node_info[node].hasFlag("sem"))
+	  readers[node] = new ReaderThread(node_buflen, quelen, false);
+	else
+	  readers[node] = new ReaderThread(node_buflen, quelen);
 
 	const char *hostname = node_info[node].getHostName().c_str();
 	int port       = node_info[node].getPortNo();
@@ -284,6 +322,16 @@ int main(int argc, char* argv[])
 	name << "** ReaderThread" << std::setw(3) << node;
 	readers[node]->setName(name.str());
 	readers[node]->setHost(hostname, port, node);
+	if (node_info[node].hasFlag("batch")) {
+	  // the epoll and slow readers keep the per event framing
+	  if (node_info[node].hasFlag("epoll")
+	      || node_info[node].hasFlag("slow"))
+	    std::cerr << "EB: node " << node
+		      << " batch flag ignored for epoll/slow reader"
+		      << std::endl;
+	  else
+	    readers[node]->setBatch(true);
+	}
 
 	// std::cerr << "  hostname:" << node_info[node].getHostName();
 	// std::cerr << "  RingBuf Size:" << node_buflen
@@ -293,7 +341,8 @@ int main(int argc, char* argv[])
 	msg << "EB: node =" << std::setw(15) << hostname
 	    << "  port =" << std::setw(5) << port
 	    << "  Bsize =" << std::setw(6) << node_buflen
-	    << "  Nque =" << std::setw(6) << quelen;
+	    << "  Nque =" << std::setw(6) << quelen
+	    << (flag.empty() ? "" : "  +"+flag);
 	std::cout << msg.str() << std::endl;
 	msock.sendString(msg.str());
       }
@@ -301,11 +350,21 @@ int main(int argc, char* argv[])
       BuilderThread builder(event_buflen, k_quelen);
       builder.setName("## BuilderThread");
       builder.setDebugPrint(0);
+      builder.setZeroCopy(zero_copy);
+      if (zero_copy && builder_threads > 1) {
+	std::cout << "#W --builder-threads is ignored with --zero-copy"
+		  << std::endl;
+      } else {
+	builder.setWorkers(builder_threads);
+      }
       builder.setAllReaders(&readers[0], node_number);
       {
 	std::stringstream msg;
 	msg << "## bulderThread: Bsize = " << event_buflen
-	    << " Nque = " << k_quelen;
+	    << " Nque = " << k_quelen
+	    << (zero_copy ? " zero-copy" : "");
+	if (builder.getWorkers() > 1)
+	  msg << " workers = " << builder.getWorkers();
 	std::cout << msg.str() << std::endl;
 	msock.sendString(msg.str());
       }
@@ -336,7 +395,10 @@ int main(int argc, char* argv[])
 
       sender.start();
       for(int node=0; node < node_number; node++)
-	readers[node]->start();
+	if (!node_info[node].hasFlag("epoll"))
+	  readers[node]->start();
+      if (epoll_engine.size() > 0)
+	epoll_engine.start();
       std::cerr << "readers start" << std::endl;
 
       builder.start();
@@ -348,6 +410,7 @@ int main(int argc, char* argv[])
       sender.join();
       for(int node=0; node < node_number; node++)
 	readers[node]->join();
+      epoll_engine.join();
       controller.join();
     }
   catch(...)
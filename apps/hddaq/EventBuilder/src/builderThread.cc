@@ -101,9 +101,9 @@
 #endif
 
 BuilderThread::BuilderThread(int buflen, int quelen)
- :m_node_num(0), m_debug_print(1000)
+ :m_node_num(0), m_debug_print(1000), m_zero_copy(false), m_nworker(1)
 {
-  m_send_rb = new RingBuffer(buflen, quelen);
+  m_send_rb = newRingBuffer(buflen, quelen);
   m_command = STOP;
   m_event_number = 0;
 }
@@ -170,6 +170,66 @@ void BuilderThread::setSemPost()
   releaseWriteMergData();
 }
 
+void BuilderThread::setZeroCopy(bool zero_copy)
+{
+  m_zero_copy = zero_copy;
+}
+
+int BuilderThread::freeSentFragments(EventBuffer* event)
+{
+  event_header* header = reinterpret_cast<event_header*>(event->getBuf());
+  fragment_ref* ref
+    = reinterpret_cast<fragment_ref*>(event->getBuf() + sizeof(event_header));
+  for(unsigned int i=0; i<header->nblock; i++) {
+    if (ref[i].node >= 0)
+      m_readers[ref[i].node]->freeReadFragData();
+  }
+  return 0;
+}
+
+void BuilderThread::setWorkers(int nworker)
+{
+  m_nworker = (nworker > 1) ? nworker : 1;
+}
+
+int BuilderThread::commitMergData(const build_job& job)
+{
+  for(int i=0; i<job.nfrag; i++) {
+    m_readers[job.frag[i].node]->freeReadFragData();
+  }
+  return m_send_rb->writeBufCommit();
+}
+
+void BuilderThread::startWorkers()
+{
+  for(int i=0; i<m_nworker; i++) {
+    m_workers.push_back(new BuilderWorker(*this, i));
+  }
+  for(int i=0; i<m_nworker; i++) {
+    m_workers[i]->setNext(m_workers[(i + 1) % m_nworker]);
+  }
+  m_workers[0]->giveTurn();
+  for(int i=0; i<m_nworker; i++) {
+    m_workers[i]->start();
+  }
+}
+
+void BuilderThread::stopWorkers()
+{
+  /* the queued events are still committed before the workers exit */
+  for(size_t i=0; i<m_workers.size(); i++) {
+    m_workers[i]->postExit();
+  }
+  for(size_t i=0; i<m_workers.size(); i++) {
+    m_workers[i]->join();
+    std::cerr << "## BT worker " << m_workers[i]->getId()
+	      << " built " << m_workers[i]->getEventCount()
+	      << " events" << std::endl;
+    delete m_workers[i];
+  }
+  m_workers.clear();
+}
+
 void BuilderThread::setDebugPrint(int d_print)
 {
   m_debug_print = d_print;
@@ -338,6 +398,8 @@ int BuilderThread::active_loop()
   waitReaders();
   m_state = RUNNING;
   m_event_number = 0;
+  bool parallel = (m_nworker > 1 && !m_zero_copy);
+  if (parallel) startWorkers();
   while( true ){
     if(checkCommand() != 0)
       break;
@@ -400,8 +462,15 @@ int BuilderThread::active_loop()
     total_len = 0;
 
     for(int node=0; node<m_node_num; node++) {
+      m_acquired[node] = false;
       if (m_readers[node]->is_active) {
-	m_event_f[node] = m_readers[node]->peekReadFragData();
+	if ((m_zero_copy || parallel)
+	    && m_readers[node]->supportsAcquire()) {
+	  m_event_f[node] = m_readers[node]->acquireReadFragData();
+	  m_acquired[node] = true;
+	} else {
+	  m_event_f[node] = m_readers[node]->peekReadFragData();
+	}
 	if (m_event_f[node]->getHeader() != (int)EV_MAGIC) {
 	  if( m_event_number > 0 ){
 	    std::stringstream msg;
@@ -438,7 +507,9 @@ int BuilderThread::active_loop()
     total_len = total_len
       + sizeof(struct event_header) / sizeof(unsigned int);
 
-    EventBuffer *event_merg = m_send_rb->writeBufPeek();
+    EventBuffer *event_merg = parallel
+      ? m_send_rb->writeBufAcquire()
+      : m_send_rb->writeBufPeek();
     char *event_buf = event_merg->getBuf();
     eheader = reinterpret_cast<struct event_header*>(event_buf);
     eheader->magic        = EV_MAGIC;
@@ -450,18 +521,21 @@ int BuilderThread::active_loop()
     eheader->nblock       = m_node_num;
     eheader->reserve      = (unsigned int)std::time(0);
 
-    int total_frag_len = 0;
     char *ptr = event_buf + sizeof(struct event_header);
-    for(int node=0; node<m_node_num; node++) {
-      int frag_len = m_event_f[node]->getLength();
-      std::memcpy(ptr, reinterpret_cast<char*>
-		  (m_event_f[node]->getBuf()),
-		  frag_len * 4);
-      ptr += frag_len * sizeof(int);
-      total_frag_len += frag_len;
-      if (m_readers[node]->is_active) {
-	m_readers[node]->releaseReadFragData(); //rotate the node_rb
-      }
+    int total_frag_len;
+    if (m_zero_copy)
+      total_frag_len = referFragments(ptr, event_buf + event_merg->getLen());
+    else if (parallel)
+      total_frag_len = dispatchFragments(event_merg, ptr);
+    else
+      total_frag_len = mergeFragments(ptr);
+    if (total_frag_len < 0) {
+      std::stringstream msg;
+      msg << "#ERR. EB: Inline fragments exceed the send buffer "
+	  << event_merg->getLen() << " B";
+      std::cout << msg.str() << std::endl;
+      msock.sendString(MT_ERROR, msg.str());
+      break;
     }
 
     if( (unsigned int)total_len !=
@@ -475,7 +549,8 @@ int BuilderThread::active_loop()
       break;
     }
 
-    m_send_rb->writeBufRelease();
+    /* in parallel mode the worker commits the slot */
+    if (!parallel) m_send_rb->writeBufRelease();
     m_event_number++;
 
 #ifdef USE_PARAPORT
@@ -483,6 +558,7 @@ int BuilderThread::active_loop()
 #endif
 
   }//while()
+  if (parallel) stopWorkers();
   std::cerr << "builder exited active_loop" << std::endl;
 
   msock.sendString("EB: stop");
@@ -490,6 +566,84 @@ int BuilderThread::active_loop()
   return 0;
 }
 
+int BuilderThread::mergeFragments(char* ptr)
+{
+  int total_frag_len = 0;
+  for(int node=0; node<m_node_num; node++) {
+    int frag_len = m_event_f[node]->getLength();
+    std::memcpy(ptr, reinterpret_cast<char*>
+		(m_event_f[node]->getBuf()),
+		frag_len * 4);
+    ptr += frag_len * sizeof(int);
+    total_frag_len += frag_len;
+    if (m_readers[node]->is_active) {
+      m_readers[node]->releaseReadFragData(); //rotate the node_rb
+    }
+  }
+  return total_frag_len;
+}
+
+int BuilderThread::referFragments(char* ptr, char* end)
+{
+  int  total_frag_len = 0;
+  bool overflow = false;
+  fragment_ref* ref = reinterpret_cast<fragment_ref*>(ptr);
+  char* inl = reinterpret_cast<char*>(ref + m_node_num);
+  for(int node=0; node<m_node_num; node++) {
+    int frag_len = m_event_f[node]->getLength();
+    ref[node].nbyte = frag_len * sizeof(int);
+    if (m_acquired[node]) {
+      /* freed by SenderThread when the event is on the wire */
+      ref[node].data = m_event_f[node]->getBuf();
+      ref[node].node = node;
+    } else {
+      if (inl + ref[node].nbyte <= end) {
+	std::memcpy(inl, m_event_f[node]->getBuf(), ref[node].nbyte);
+	ref[node].data = inl;
+	inl += ref[node].nbyte;
+      } else {
+	overflow = true;
+      }
+      ref[node].node = -1;
+      if (m_readers[node]->is_active) {
+	m_readers[node]->releaseReadFragData();
+      }
+    }
+    total_frag_len += frag_len;
+  }
+  return overflow ? -1 : total_frag_len;
+}
+
+int BuilderThread::dispatchFragments(EventBuffer* event, char* ptr)
+{
+  int total_frag_len = 0;
+  BuilderWorker* worker = m_workers[m_event_number % m_nworker];
+  build_job& job = worker->peekJob();
+  job.event = event;
+  job.nfrag = 0;
+  for(int node=0; node<m_node_num; node++) {
+    int frag_len = m_event_f[node]->getLength();
+    unsigned int nbyte = frag_len * sizeof(int);
+    if (m_acquired[node]) {
+      /* copied by the worker, freed when the event is committed */
+      job.frag[job.nfrag].src   = m_event_f[node]->getBuf();
+      job.frag[job.nfrag].dst   = ptr;
+      job.frag[job.nfrag].nbyte = nbyte;
+      job.frag[job.nfrag].node  = node;
+      job.nfrag++;
+    } else {
+      std::memcpy(ptr, m_event_f[node]->getBuf(), nbyte);
+      if (m_readers[node]->is_active) {
+	m_readers[node]->releaseReadFragData();
+      }
+    }
+    ptr += nbyte;
+    total_frag_len += frag_len;
+  }
+  worker->postJob();
+  return total_frag_len;
+}
+
 double BuilderThread::checkTrigRate(int ntimes)
 {
   static struct timeval now, last;
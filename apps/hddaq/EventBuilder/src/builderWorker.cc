@@ -0,0 +1,81 @@
+// -*- C++ -*-
+/**
+ *  @file   builderWorker.cc
+ *  @brief  assembly workers of the parallel builder mode
+ */
+
+#include <cstring>
+
+#include "EventBuilder/builderWorker.h"
+#include "EventBuilder/builderThread.h"
+
+//______________________________________________________________________________
+BuilderWorker::BuilderWorker(BuilderThread& builder, int id)
+  : m_builder(builder),
+    m_id(id),
+    m_next(this),
+    m_job(JOB_DEPTH),
+    m_job_wr(0),
+    m_job_rd(0),
+    m_nfree(JOB_DEPTH),
+    m_nfull(0),
+    m_turn(0),
+    m_nevent(0)
+{
+}
+
+//______________________________________________________________________________
+BuilderWorker::~BuilderWorker()
+{
+}
+
+//______________________________________________________________________________
+build_job& BuilderWorker::peekJob()
+{
+  m_nfree.wait();
+  return m_job[m_job_wr];
+}
+
+//______________________________________________________________________________
+void BuilderWorker::postJob()
+{
+  m_job_wr = (m_job_wr + 1) % JOB_DEPTH;
+  m_nfull.post();
+}
+
+//______________________________________________________________________________
+void BuilderWorker::postExit()
+{
+  build_job& job = peekJob();
+  job.event = 0;
+  job.nfrag = 0;
+  postJob();
+}
+
+//______________________________________________________________________________
+int BuilderWorker::run()
+{
+  while (true) {
+    m_nfull.wait();
+    build_job& job = m_job[m_job_rd];
+    if (!job.event) {
+      m_job_rd = (m_job_rd + 1) % JOB_DEPTH;
+      m_nfree.post();
+      break;
+    }
+
+    for (int i=0; i<job.nfrag; i++)
+      std::memcpy(job.frag[i].dst, job.frag[i].src, job.frag[i].nbyte);
+
+    /* the events of all workers are committed in dispatch order */
+    m_turn.wait();
+    m_builder.commitMergData(job);
+    m_next->giveTurn();
+
+    m_job_rd = (m_job_rd + 1) % JOB_DEPTH;
+    m_nfree.post();
+    m_nevent++;
+  }
+
+  return 0;
+}
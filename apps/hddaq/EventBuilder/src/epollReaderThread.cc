@@ -0,0 +1,456 @@
+// -*- C++ -*-
+/**
+ *  @file   epollReaderThread.cc
+ *  @brief  event readers served by a small pool of epoll threads
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <iomanip>
+#include <sstream>
+
+#include "EventBuilder/epollReaderThread.h"
+#include "Message/GlobalMessageClient.h"
+#include "ControlThread/GlobalInfo.h"
+
+namespace
+{
+  const int    MAX_EVENTS_PER_WAKEUP = 64;
+  const int    IDLE_TIMEOUT_MS       = 100;
+  const int    BLOCKED_TIMEOUT_MS    = 1;
+  const size_t DISCARD_BYTE          = 64 * 1024;
+
+  double elapsed(const struct timeval& since)
+  {
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return (now.tv_sec - since.tv_sec)
+      + (now.tv_usec - since.tv_usec) * 1e-6;
+  }
+}
+
+//______________________________________________________________________________
+EpollReaderThread::EpollReaderThread(int buflen, int quelen)
+  : ReaderThread(buflen, quelen),
+    m_client(0),
+    m_fd(-1),
+    m_phase(HEADER),
+    m_done(0),
+    m_slot(0),
+    m_trans_byte(0),
+    m_rest_byte(0),
+    m_discard(DISCARD_BYTE),
+    m_blocked(false),
+    m_nstall(0),
+    m_stall_time(0.)
+{
+}
+
+//______________________________________________________________________________
+EpollReaderThread::EpollReaderThread(int buflen, int quelen, bool lockfree)
+  : ReaderThread(buflen, quelen, lockfree),
+    m_client(0),
+    m_fd(-1),
+    m_phase(HEADER),
+    m_done(0),
+    m_slot(0),
+    m_trans_byte(0),
+    m_rest_byte(0),
+    m_discard(DISCARD_BYTE),
+    m_blocked(false),
+    m_nstall(0),
+    m_stall_time(0.)
+{
+}
+
+//______________________________________________________________________________
+EpollReaderThread::~EpollReaderThread()
+{
+  delete m_client;
+}
+
+//______________________________________________________________________________
+int
+EpollReaderThread::open()
+{
+  is_active = 1;
+  m_event_number = 0;
+  m_phase   = HEADER;
+  m_done    = 0;
+  m_slot    = 0;
+  m_blocked = false;
+  m_nstall  = 0;
+  m_stall_time = 0.;
+
+  std::stringstream name;
+  name << m_name << " " << m_host << " " << m_port;
+  m_label = name.str();
+
+  initBuffer();
+
+  delete m_client;
+  m_client = new kol::TcpClient;
+  try {
+    m_client->Start(m_host.c_str(), m_port);
+  } catch (kol::SocketException &e) {
+    std::cerr << "Reader cnnection open error: " << e.what()
+	      << " host: " << m_host << std::endl;
+    delete m_client;
+    m_client = 0;
+    is_active = 0;
+    writeNullEvent();
+    return -1;
+  }
+
+  m_fd = m_client->getDescriptor();
+  ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+  m_state = RUNNING;
+  return m_fd;
+}
+
+//______________________________________________________________________________
+void
+EpollReaderThread::close()
+{
+  if (m_blocked) unblock();
+  if (m_client) {
+    m_client->close();
+    delete m_client;
+    m_client = 0;
+  }
+  m_fd = -1;
+  m_state = IDLE;
+  is_active = 0;
+  std::cerr << "** reader exited active_loop() " << m_host << std::endl;
+}
+
+//______________________________________________________________________________
+bool
+EpollReaderThread::hasRoom()
+{
+  return m_node_rb->left() < m_node_rb->depth();
+}
+
+//______________________________________________________________________________
+void
+EpollReaderThread::block()
+{
+  /* a parked socket still reports EPOLLHUP/EPOLLERR */
+  if (m_blocked) return;
+  m_blocked = true;
+  ++m_nstall;
+  gettimeofday(&m_blocked_since, 0);
+}
+
+//______________________________________________________________________________
+void
+EpollReaderThread::unblock()
+{
+  m_blocked = false;
+  m_stall_time += elapsed(m_blocked_since);
+}
+
+//______________________________________________________________________________
+EpollReaderThread::Status
+EpollReaderThread::fail(const char* what)
+{
+  GlobalMessageClient & msock = GlobalMessageClient::getInstance();
+  std::cerr << "#E Reader Socket error: " << what
+	    << " host: " << m_host << std::endl;
+  std::stringstream msg;
+  msg << "EB Reader exception : " << m_host << ": " << m_port
+      << " : " << what;
+  msock.sendString(MT_ERROR, msg.str());
+  is_active = 0;
+  writeNullEvent();
+  return READ_CLOSED;
+}
+
+//______________________________________________________________________________
+EpollReaderThread::Status
+EpollReaderThread::onReadable()
+{
+  for (int nev=0; nev<MAX_EVENTS_PER_WAKEUP; ) {
+    char*  dst = 0;
+    size_t len = 0;
+    switch (m_phase) {
+    case HEADER:
+      dst = reinterpret_cast<char*>(m_header) + m_done;
+      len = HEADER_BYTE_SIZE - m_done;
+      break;
+    case BODY:
+      if (!m_slot) {
+	if (!hasRoom()) {
+	  block();
+	  return READ_BLOCKED;
+	}
+	m_slot = m_node_rb->writeBufPeek();
+	std::memcpy(m_slot->getBuf(), m_header, HEADER_BYTE_SIZE);
+      }
+      dst = m_slot->getBuf() + HEADER_BYTE_SIZE + m_done;
+      len = m_trans_byte - m_done;
+      break;
+    case DISCARD:
+      dst = &m_discard[0];
+      len = m_rest_byte - m_done;
+      if (len > m_discard.size()) len = m_discard.size();
+      break;
+    }
+
+    /* a header-only fragment has no body to read */
+    if (len > 0) {
+      ssize_t n = ::recv(m_fd, dst, len, 0);
+      if (n < 0) {
+	if (errno == EAGAIN || errno == EWOULDBLOCK)
+	  return READ_AGAIN;
+	if (errno == EINTR)
+	  continue;
+	return fail(std::strerror(errno));
+      }
+      if (n == 0) {
+	// peer closed the connection
+	return READ_CLOSED;
+      }
+      m_done += n;
+    }
+
+    switch (m_phase) {
+    case HEADER:
+      if (m_done < (size_t)HEADER_BYTE_SIZE) break;
+      checkHeader(m_header[0], m_label);
+      m_trans_byte = (m_header[1] - 2) * sizeof(unsigned int);
+      m_rest_byte  = 0;
+      if (m_trans_byte > 0)
+	m_rest_byte
+	  = checkDataSize(m_ringbuf_len*sizeof(unsigned int),
+			  m_trans_byte, m_label);
+      m_done = 0;
+      if (m_rest_byte == (size_t)-1) {
+	/* invalid length, wait for the next header */
+	m_rest_byte = 0;
+	break;
+      }
+      m_phase = BODY;
+      break;
+    case BODY:
+      if (m_done < m_trans_byte) break;
+      m_done = 0;
+      if (m_rest_byte > 0) {
+	m_phase = DISCARD;
+	break;
+      }
+      /* fall through */
+    case DISCARD:
+      if (m_done < m_rest_byte) break;
+      if (m_node_rb->writeBufRelease() != 0) {
+	std::cerr << "ERROR: m_node_rb.writeBufRelease()"
+		  << std::endl;
+      }
+      m_slot  = 0;
+      m_done  = 0;
+      m_phase = HEADER;
+      ++m_event_number;
+      ++nev;
+      break;
+    }
+  }
+  return READ_AGAIN;
+}
+
+//______________________________________________________________________________
+EpollReaderWorker::EpollReaderWorker()
+{
+}
+
+//______________________________________________________________________________
+EpollReaderWorker::~EpollReaderWorker()
+{
+}
+
+//______________________________________________________________________________
+int
+EpollReaderWorker::run()
+{
+  int ep = ::epoll_create1(0);
+  if (ep < 0) {
+    GlobalMessageClient & msock = GlobalMessageClient::getInstance();
+    msock.sendString(MT_ERROR, "EB: epoll_create failed");
+    for (size_t i=0; i<m_readers.size(); ++i)
+      m_readers[i]->close();
+    return -1;
+  }
+
+  int nlive = 0;
+  for (size_t i=0; i<m_readers.size(); ++i) {
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.ptr = m_readers[i];
+    ::epoll_ctl(ep, EPOLL_CTL_ADD, m_readers[i]->fd(), &ev);
+    ++nlive;
+  }
+
+  std::vector<struct epoll_event> events(m_readers.size());
+  while (nlive > 0) {
+    bool blocked = false;
+    for (size_t i=0; i<m_readers.size(); ++i) {
+      EpollReaderThread* reader = m_readers[i];
+      if (reader->fd() < 0) continue;
+      if (reader->pollCommand() != 0) {
+	::epoll_ctl(ep, EPOLL_CTL_DEL, reader->fd(), 0);
+	reader->close();
+	--nlive;
+	continue;
+      }
+      if (reader->isBlocked()) {
+	if (reader->hasRoom()) {
+	  reader->unblock();
+	  struct epoll_event ev;
+	  ev.events   = EPOLLIN;
+	  ev.data.ptr = reader;
+	  ::epoll_ctl(ep, EPOLL_CTL_MOD, reader->fd(), &ev);
+	} else {
+	  blocked = true;
+	}
+      }
+    }
+    if (nlive == 0) break;
+
+    int n = ::epoll_wait(ep, &events[0], events.size(),
+			 blocked ? BLOCKED_TIMEOUT_MS : IDLE_TIMEOUT_MS);
+    for (int i=0; i<n; ++i) {
+      EpollReaderThread* reader
+	= static_cast<EpollReaderThread*>(events[i].data.ptr);
+      if (reader->fd() < 0) continue;
+      if (reader->isBlocked()) {
+	/* parked (events=0): only a hang-up or an error gets here */
+	if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+	  ::epoll_ctl(ep, EPOLL_CTL_DEL, reader->fd(), 0);
+	  reader->close();
+	  --nlive;
+	}
+	continue;
+      }
+      switch (reader->onReadable()) {
+      case EpollReaderThread::READ_AGAIN:
+	break;
+      case EpollReaderThread::READ_BLOCKED: {
+	/* keep the socket, stop polling it until the ring drains */
+	struct epoll_event ev;
+	ev.events   = 0;
+	ev.data.ptr = reader;
+	::epoll_ctl(ep, EPOLL_CTL_MOD, reader->fd(), &ev);
+	break;
+      }
+      case EpollReaderThread::READ_CLOSED:
+	::epoll_ctl(ep, EPOLL_CTL_DEL, reader->fd(), 0);
+	reader->close();
+	--nlive;
+	break;
+      }
+    }
+  }
+
+  ::close(ep);
+  return 0;
+}
+
+//______________________________________________________________________________
+EpollReaderEngine::EpollReaderEngine(int nthread)
+  : m_workers(nthread > 0 ? nthread : 1)
+{
+}
+
+//______________________________________________________________________________
+EpollReaderEngine::~EpollReaderEngine()
+{
+}
+
+//______________________________________________________________________________
+void
+EpollReaderEngine::add(EpollReaderThread* reader)
+{
+  m_readers.push_back(reader);
+}
+
+//______________________________________________________________________________
+bool
+EpollReaderEngine::allCommand(Command command)
+{
+  for (size_t i=0; i<m_readers.size(); ++i) {
+    if (m_readers[i]->getCommand() != command)
+      return false;
+  }
+  return true;
+}
+
+//______________________________________________________________________________
+int
+EpollReaderEngine::run()
+{
+  if (m_readers.empty())
+    return 0;
+
+  /* the StatableThread state machine of the passive readers */
+  while (!allCommand(EXIT)) {
+    if (allCommand(START))
+      runOnce();
+    ::usleep(100000);
+  }
+  return 0;
+}
+
+//______________________________________________________________________________
+void
+EpollReaderEngine::runOnce()
+{
+  for (size_t i=0; i<m_readers.size(); ++i) {
+    m_readers[i]->reset_command();
+    m_readers[i]->is_active = 1;
+  }
+  while (GlobalInfo::getInstance().state!=IDLE)
+    ::usleep(1);
+
+  std::cerr << "** epoll readers entered active_loop() "
+	    << m_readers.size() << " nodes / "
+	    << m_workers.size() << " threads" << std::endl;
+
+  for (size_t i=0; i<m_workers.size(); ++i)
+    m_workers[i] = new EpollReaderWorker;
+  for (size_t i=0; i<m_readers.size(); ++i) {
+    if (m_readers[i]->open() >= 0)
+      m_workers[i % m_workers.size()]->add(m_readers[i]);
+  }
+
+  for (size_t i=0; i<m_workers.size(); ++i)
+    if (!m_workers[i]->empty()) m_workers[i]->start();
+  for (size_t i=0; i<m_workers.size(); ++i) {
+    if (!m_workers[i]->empty()) m_workers[i]->join();
+    delete m_workers[i];
+    m_workers[i] = 0;
+  }
+
+  report();
+}
+
+//______________________________________________________________________________
+void
+EpollReaderEngine::report()
+{
+  GlobalMessageClient & msock = GlobalMessageClient::getInstance();
+  for (size_t i=0; i<m_readers.size(); ++i) {
+    EpollReaderThread* reader = m_readers[i];
+    if (reader->getStallCount() == 0) continue;
+    std::stringstream msg;
+    msg << "EB Reader: node " << reader->node() << " backpressure "
+	<< reader->getStallCount() << " times, "
+	<< std::fixed << std::setprecision(3)
+	<< reader->getStallTime() << " s";
+    std::cerr << msg.str() << std::endl;
+    msock.sendString(msg.str());
+  }
+}
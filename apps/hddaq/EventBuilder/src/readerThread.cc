@@ -85,9 +85,19 @@
 
 
 ReaderThread::ReaderThread(int buflen, int quelen)
-  : m_ringbuf_len(buflen)
+  : m_ringbuf_len(buflen),
+    m_batch(false)
 {
-  m_node_rb = new RingBuffer(buflen, quelen);
+  m_node_rb = newRingBuffer(buflen, quelen);
+  m_command = STOP;
+  m_event_number = 0;
+}
+
+ReaderThread::ReaderThread(int buflen, int quelen, bool lockfree)
+  : m_ringbuf_len(buflen),
+    m_batch(false)
+{
+  m_node_rb = newRingBuffer(buflen, quelen, lockfree);
   m_command = STOP;
   m_event_number = 0;
 }
@@ -134,6 +144,16 @@ int ReaderThread::releaseWriteFragData()
   return m_node_rb->writeBufRelease();
 }
 
+EventBuffer *ReaderThread::acquireReadFragData()
+{
+  return m_node_rb->readBufAcquire();
+}
+
+int ReaderThread::freeReadFragData()
+{
+  return m_node_rb->readBufFree();
+}
+
 int ReaderThread::leftEventData()
 {
   return m_node_rb->left();
@@ -263,6 +283,131 @@ int ReaderThread::updateEventData(kol::TcpClient& client,
   return status;
 }
 
+int ReaderThread::requestBatch(kol::TcpClient& client)
+{
+  try {
+    client.write(&g_BATCH_REQUEST, 1);
+    client.flush();
+  } catch (kol::SocketException& e) {
+    GlobalMessageClient & msock = GlobalMessageClient::getInstance();
+    std::ostringstream msg;
+    msg << "EB: Reader batch request failed: " << e.what()
+	<< " host: " << m_host;
+    msock.sendString(MT_WARNING, msg);
+    std::cerr << msg.str() << std::endl;
+    return -1;
+  }
+  return 0;
+}
+
+int ReaderThread::readBatchBytes(kol::TcpClient& client,
+				 char* buf,
+				 size_t nbyte)
+{
+  GlobalMessageClient & msock = GlobalMessageClient::getInstance();
+  while (true) {
+    if (checkCommand()) break;
+    try {
+      if (buf) {
+	if (!client.read(buf, nbyte)) break;
+      } else if (!client.ignore(nbyte)) break;
+      return 0;
+    } catch (kol::SocketException& e) {
+      if (e.reason() == EWOULDBLOCK) {
+	client.iostate_good();
+	continue;
+      }
+      std::ostringstream msg;
+      msg << "EB: Reader data reading error: "
+	  << e.what()
+	  << " host: " << m_host;
+      msock.sendString(MT_ERROR, msg);
+      std::cerr << msg.str() << std::endl;
+      break;
+    }
+  }
+  return -1;
+}
+
+int ReaderThread::updateBatchData(kol::TcpClient& client,
+				  unsigned int* header)
+{
+  GlobalMessageClient & msock = GlobalMessageClient::getInstance();
+
+  size_t batch_byte = (header[1] - 2) * sizeof(unsigned int);
+  if (header[1] < 2 || batch_byte > (size_t)g_BATCH_MAX_BYTE) {
+    std::ostringstream msg;
+    msg << "EB: Reader invalid batch size: " << header[1]
+	<< " host: " << m_host;
+    msock.sendString(MT_ERROR, msg);
+    std::cerr << msg.str() << std::endl;
+    return -1;
+  }
+
+  std::stringstream name;
+  name << m_name  << " " << m_host << " " << m_port;
+
+  // Each fragment is read straight into its own ring buffer slot. The
+  // header of the next fragment is read together with the body, when
+  // the slot has room for it, so that a fragment costs one read().
+  unsigned int frag[2];
+  std::memset(frag, 0, HEADER_BYTE_SIZE);
+  if (batch_byte >= (size_t)HEADER_BYTE_SIZE
+      && readBatchBytes(client, reinterpret_cast<char*>(frag),
+			HEADER_BYTE_SIZE) != 0)
+    return -1;
+
+  while (batch_byte > 0) {
+    // the rest of the stream cannot be trusted: stop rather than lose
+    // the events of this node only
+    size_t frag_byte = frag[1] * sizeof(unsigned int);
+    if (batch_byte < (size_t)HEADER_BYTE_SIZE
+	|| frag_byte < (size_t)HEADER_BYTE_SIZE || frag_byte > batch_byte
+	|| checkHeader(frag[0], name.str()) != 0) {
+      std::ostringstream msg;
+      msg << "EB: Reader broken batch fragment, "
+	  << batch_byte << " bytes left, host: " << m_host;
+      msock.sendString(MT_ERROR, msg);
+      std::cerr << msg.str() << std::endl;
+      return -1;
+    }
+    batch_byte -= frag_byte;
+
+    size_t trans_byte = frag_byte - HEADER_BYTE_SIZE;
+    size_t rest_byte  = 0;
+    if (trans_byte > 0)
+      rest_byte = checkDataSize(m_ringbuf_len*sizeof(unsigned int),
+				trans_byte, name.str());
+    const bool has_next = batch_byte >= (size_t)HEADER_BYTE_SIZE;
+
+    EventBuffer* event_f = m_node_rb->writeBufPeek();
+    char* event_buf      = event_f->getBuf();
+    char* body           = event_buf + HEADER_BYTE_SIZE;
+    std::memcpy(event_buf, frag, HEADER_BYTE_SIZE);
+    if (has_next && rest_byte == 0
+	&& frag_byte + HEADER_BYTE_SIZE <= (size_t)event_f->getLen()) {
+      if (readBatchBytes(client, body, trans_byte + HEADER_BYTE_SIZE) != 0)
+	return -1;
+      std::memcpy(frag, body + trans_byte, HEADER_BYTE_SIZE);
+    } else {
+      if (readBatchBytes(client, body, trans_byte) != 0
+	  || (rest_byte > 0 && readBatchBytes(client, 0, rest_byte) != 0)
+	  || (has_next
+	      && readBatchBytes(client, reinterpret_cast<char*>(frag),
+				HEADER_BYTE_SIZE) != 0))
+	return -1;
+    }
+
+    if (m_node_rb->writeBufRelease() != 0) {
+      std::cerr
+	<< "ERROR: m_node_rb.writeBufRelease()"
+	<< std::endl;
+    }
+    m_event_number++;
+  }
+  return 0;
+}
+
 int ReaderThread::active_loop()
 {
   is_active = 1;
@@ -297,6 +442,7 @@ int ReaderThread::active_loop()
   timeoutv.tv_usec = 0;
   client.setsockopt(SOL_SOCKET, SO_RCVTIMEO,
 		    &timeoutv, sizeof(timeoutv));
+  bool batch = m_batch && (requestBatch(client) == 0);
 
   m_state = RUNNING;
   while (true) {
@@ -307,6 +453,12 @@ int ReaderThread::active_loop()
     if (status>0) break;
     else if (status<0) return status;
 
+    if (batch && header[0] == (unsigned int)g_BATCH_MAGIC) {
+      if (updateBatchData(client, header)!=0)
+	break;
+      continue;
+    }
+
     checkHeader(header[0], name.str());
 
     size_t trans_byte = (header[1] - 2) * sizeof(unsigned int);
@@ -75,6 +75,20 @@ void SenderThread::setSemPost()
   m_builder->releaseReadMergData();
 }
 
+void SenderThread::setIov(EventBuffer* event)
+{
+  event_header* header = reinterpret_cast<event_header*>(event->getBuf());
+  fragment_ref* ref
+    = reinterpret_cast<fragment_ref*>(event->getBuf() + sizeof(event_header));
+  m_iov.resize(header->nblock + 1);
+  m_iov[0].iov_base = header;
+  m_iov[0].iov_len  = sizeof(event_header);
+  for (unsigned int i=0; i<header->nblock; ++i) {
+    m_iov[i+1].iov_base = const_cast<char*>(ref[i].data);
+    m_iov[i+1].iov_len  = ref[i].nbyte;
+  }
+}
+
 int SenderThread::waitBuilder()
 {
   while(m_builder->getState() != RUNNING) {
@@ -144,6 +158,9 @@ int SenderThread::active_loop()
 	size_t trans_byte = (event->getLength()) * sizeof(unsigned int);
 	if (checkDataSize(max_event_len, trans_byte, m_name)!=0) break;
 
+	bool zero_copy = m_builder->isZeroCopy();
+	if (zero_copy) setIov(event);
+
 	bool writeerr;
 	bool retry;
 	do {
@@ -151,7 +168,9 @@ int SenderThread::active_loop()
 	  retry    = false;
 	  if (checkCommand()) break;
 	  try {
-	    if (sock.write(event->getBuf(), trans_byte) == 0) {
+	    if ((zero_copy
+		 ? sock.writev(&m_iov[0], m_iov.size())
+		 : sock.write(event->getBuf(), trans_byte)) == 0) {
 	      std::stringstream msg;
 	      msg << "== SenderThread Error: write error occurred"
 		  << std::endl;
@@ -182,6 +201,7 @@ int SenderThread::active_loop()
 	if (writeerr)
 	  break;
 
+	if (zero_copy) m_builder->freeSentFragments(event);
 	m_builder->releaseReadMergData();
 	m_event_number++;
       }
@@ -51,6 +51,7 @@
 #include "kol/kolthread.h"
 #include "ControlThread/statableThread.h"
 #include "EventDistributor/distReader.h"
+#include "EventDistributor/eventBlock.h"
 
 struct timeval;
 class SenderThread;
@@ -87,7 +88,8 @@ protected:
   DistReader&              m_dist_reader;
   std::list<SenderThread*> m_sender_list;
   kol::Mutex               m_list_mutex;
-  std::vector<char>        m_common_data;
+  EventBlockPool           m_block_pool;
+  EventBlock*              m_common_data;
 
 private:
   kol::ThreadController  m_controller;
@@ -95,45 +97,6 @@ private:
 
 };
 
-//______________________________________________________________________________
-template <typename T>
-class Locker
-{
-
-public:
-  Locker() : m_busy(), m_data() { m_data.lock(); };
-  ~Locker(){};
-
-  void clearBusy()  { m_busy.unlock(); };
-  bool isBusy()     { return (m_busy.trylock()!=0);  };
-  void lockData()   { m_data.lock(); };
-  void unlockData() { m_data.unlock(); };
-
-private:
-  T m_busy;
-  T m_data;
-
-};
-
-//______________________________________________________________________________
-template <>
-class Locker<kol::Semaphore>
-{
-public:
-  Locker() : m_empty(1), m_filled(0) {};
-  ~Locker() {};
-
-  void clearBusy()  { while (m_empty.trywait()==0); m_empty.post(); };
-  bool isBusy()     { return (m_empty.trywait()!=0); };
-  void lockData()   { m_filled.wait(); };
-  void unlockData() { while (m_filled.trywait()==0); m_filled.post(); };
-
-private:
-  kol::Semaphore m_empty;
-  kol::Semaphore m_filled;
-
-};
-
 //______________________________________________________________________________
 class SenderThread : public kol::Thread
 {
@@ -146,7 +109,10 @@ public:
   void clearBusy();
   bool good() const;
   bool isBusy();
-  void update(const std::vector<char>& common_buffer);
+  // Hands over a shared event. The previous one is dropped if this
+  // client has not started to send it yet (skip to the latest event).
+  void update(EventBlock* block);
+  unsigned long getSkipCount() const { return m_nskip; }
 
 protected:
   virtual int run();
@@ -155,15 +121,17 @@ private:
   SenderThread(const SenderThread&);
   SenderThread& operator=(const SenderThread&);
 
-  bool send();
+  bool        send(const EventBlock* block);
+  EventBlock* take();
 
 private:
   kol::TcpSocket    m_socket;
   DataSender&       m_data_sender;
   const timeval*    m_timeoutv;
-  std::vector<char> m_buffer;
-  Locker<kol::Mutex>       m_locker;
-  // 	Locker<kol::Semaphore>   m_locker;
+  kol::Mutex        m_pending_mutex;
+  kol::Semaphore    m_filled;
+  EventBlock*       m_pending;
+  unsigned long     m_nskip;
 
 };
 
@@ -0,0 +1,70 @@
+// -*- C++ -*-
+/**
+ *  @file   eventBlock.h
+ *  @brief  reference-counted event shared by all clients of a DataSender
+ *
+ *  The DataSender copies an event out of the DistReader once into an
+ *  EventBlock and hands the same block to every SenderThread. The block
+ *  is not modified while it is shared; the last client releasing it
+ *  gives it back to the pool, where its storage is kept for reuse.
+ */
+#ifndef EVENT_BLOCK_H
+#define EVENT_BLOCK_H
+
+#include <vector>
+
+#include "kol/kolthread.h"
+
+class EventBlockPool;
+
+//______________________________________________________________________________
+class EventBlock
+{
+  friend class EventBlockPool;
+
+public:
+  const char* data() const { return m_data.empty() ? 0 : &m_data[0]; }
+  size_t      size() const { return m_data.size(); }
+
+  // only by the owner, before the block is shared
+  void assign(const char* begin, const char* end);
+
+  void addRef();
+  void release();
+
+private:
+  EventBlock(EventBlockPool& pool);
+  ~EventBlock();
+  EventBlock(const EventBlock&);
+  EventBlock& operator=(const EventBlock&);
+
+  EventBlockPool&   m_pool;
+  int               m_ref;
+  std::vector<char> m_data;
+};
+
+//______________________________________________________________________________
+class EventBlockPool
+{
+  friend class EventBlock;
+
+public:
+  EventBlockPool();
+  ~EventBlockPool();
+
+  // a block with one reference held by the caller
+  EventBlock* get();
+  int         getAllocated() const { return m_nalloc; }
+
+private:
+  EventBlockPool(const EventBlockPool&);
+  EventBlockPool& operator=(const EventBlockPool&);
+
+  void put(EventBlock* block);
+
+  kol::Mutex               m_mutex;
+  std::vector<EventBlock*> m_free;
+  int                      m_nalloc;
+};
+
+#endif
@@ -85,7 +85,8 @@ DataSender::DataSender(DistReader& reader)
     m_dist_reader(reader),
     m_sender_list(),
     m_list_mutex(),
-    m_common_data(),
+    m_block_pool(),
+    m_common_data(0),
     m_controller(),
     m_timeoutv(0)
 {
@@ -124,12 +125,19 @@ int DataSender::active_loop()
     char* srcEnd
       = srcBegin + srcBuf->getLength() * sizeof(unsigned int);
 
-    m_common_data.clear();
-    m_common_data.assign(srcBegin, srcEnd);
+    // the only copy of the event, shared by all the clients
+    EventBlock* block = m_block_pool.get();
+    block->assign(srcBegin, srcEnd);
     releaseReader();
 
-    if (checkCommand()!=0) break;
-    notify();
+    bool stop = (checkCommand()!=0);
+    if (!stop) {
+      m_common_data = block;
+      notify();
+      m_common_data = 0;
+    }
+    block->release();
+    if (stop) break;
     ++m_event_number;
   }
   releaseReader();
@@ -171,7 +179,7 @@ void DataSender::init()
 {
   while (waitReader()!=0);
   m_event_number = 0;
-  m_common_data.clear();
+  m_common_data = 0;
 
   m_list_mutex.lock();
 
@@ -289,8 +297,10 @@ SenderThread::SenderThread(const kol::TcpSocket& socket,
     m_socket(socket),
     m_data_sender(dataSender),
     m_timeoutv(0),
-    m_buffer(),
-    m_locker()
+    m_pending_mutex(),
+    m_filled(0),
+    m_pending(0),
+    m_nskip(0)
 {
   m_data_sender.add(this);
   m_timeoutv = m_data_sender.getTimeout();
@@ -302,12 +312,19 @@ SenderThread::~SenderThread()
   //std::cerr << "#d SenderThread destruct 1" << std::endl;
   m_data_sender.remove(this);
   //std::cerr << "#d SenderThread destruct 2" << std::endl;
+  if (m_pending)
+    m_pending->release();
 }
 
 //______________________________________________________________________________
 void SenderThread::clearBusy()
 {
-  m_locker.clearBusy();
+  m_pending_mutex.lock();
+  EventBlock* block = m_pending;
+  m_pending = 0;
+  m_pending_mutex.unlock();
+  if (block)
+    block->release();
   return;
 }
 
@@ -320,7 +337,8 @@ bool SenderThread::good() const
 //______________________________________________________________________________
 bool SenderThread::isBusy()
 {
-  return m_locker.isBusy();
+  // an event is waiting, the next update() would replace it
+  return (__atomic_load_n(&m_pending, __ATOMIC_ACQUIRE)!=0);
 }
 
 //______________________________________________________________________________
@@ -331,27 +349,27 @@ int SenderThread::run()
 			m_timeoutv, sizeof(struct timeval));
 
   while (true) {
-    m_locker.lockData();
-    if (!send())
-      //	break;
-      {
-	m_locker.clearBusy();
-	break;
-      }
-
-    m_locker.clearBusy();
+    m_filled.wait();
+    EventBlock* block = take();
+    if (!block)
+      continue;
+    bool status = send(block);
+    block->release();
+    if (!status)
+      break;
   }
 
-  std::cout << " @@@ #D sender client exit run() " << std::endl;
+  std::cout << " @@@ #D sender client exit run() "
+	    << m_nskip << " events skipped" << std::endl;
   return 0;
 }
 
 //______________________________________________________________________________
-bool SenderThread::send()
+bool SenderThread::send(const EventBlock* block)
 {
   const std::string& name = m_data_sender.getName();
   try {
-    m_socket.write(&m_buffer[0], m_buffer.size());
+    m_socket.write(block->data(), block->size());
     m_socket.flush();
   } catch(const kol::SocketException & e) {
     if (e.reason()==EWOULDBLOCK) {
@@ -365,11 +383,30 @@ bool SenderThread::send()
 }
 
 //______________________________________________________________________________
-void SenderThread::update(const std::vector<char>& common_data)
+EventBlock* SenderThread::take()
 {
-  m_buffer.clear();
-  m_buffer.assign(common_data.begin(), common_data.end());
-  m_locker.unlockData();
+  m_pending_mutex.lock();
+  EventBlock* block = m_pending;
+  m_pending = 0;
+  m_pending_mutex.unlock();
+  return block;
+}
+
+//______________________________________________________________________________
+void SenderThread::update(EventBlock* block)
+{
+  block->addRef();
+  m_pending_mutex.lock();
+  EventBlock* old = m_pending;
+  __atomic_store_n(&m_pending, block, __ATOMIC_RELEASE);
+  m_pending_mutex.unlock();
+
+  if (old) {
+    ++m_nskip;
+    old->release();
+  } else {
+    m_filled.post();
+  }
   return;
 }
 
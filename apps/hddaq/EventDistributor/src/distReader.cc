@@ -95,7 +95,7 @@ DistReader::DistReader(int buflen, int quelen)
    //   m_mondata_modified(),
    m_mondata_locker()
 {
-  m_dist_rb = new RingBuffer(buflen, quelen);
+  m_dist_rb = newRingBuffer(buflen, quelen);
   m_monData = new EventBuffer(max_event_len);
   m_command = STOP;
   m_event_number = 0;
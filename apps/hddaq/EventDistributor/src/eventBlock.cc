@@ -0,0 +1,85 @@
+// -*- C++ -*-
+/**
+ *  @file   eventBlock.cc
+ *  @brief  reference-counted event shared by all clients of a DataSender
+ */
+
+#include "EventDistributor/eventBlock.h"
+
+//______________________________________________________________________________
+EventBlock::EventBlock(EventBlockPool& pool)
+  : m_pool(pool),
+    m_ref(0),
+    m_data()
+{
+}
+
+//______________________________________________________________________________
+EventBlock::~EventBlock()
+{
+}
+
+//______________________________________________________________________________
+void EventBlock::assign(const char* begin, const char* end)
+{
+  // assign() keeps the capacity of the previous event
+  m_data.assign(begin, end);
+}
+
+//______________________________________________________________________________
+void EventBlock::addRef()
+{
+  __atomic_add_fetch(&m_ref, 1, __ATOMIC_RELAXED);
+}
+
+//______________________________________________________________________________
+void EventBlock::release()
+{
+  if (__atomic_sub_fetch(&m_ref, 1, __ATOMIC_ACQ_REL) == 0)
+    m_pool.put(this);
+}
+
+//______________________________________________________________________________
+// class EventBlockPool
+//______________________________________________________________________________
+EventBlockPool::EventBlockPool()
+  : m_mutex(),
+    m_free(),
+    m_nalloc(0)
+{
+}
+
+//______________________________________________________________________________
+EventBlockPool::~EventBlockPool()
+{
+  for (std::vector<EventBlock*>::iterator i=m_free.begin();
+       i!=m_free.end(); ++i)
+    delete *i;
+}
+
+//______________________________________________________________________________
+EventBlock* EventBlockPool::get()
+{
+  EventBlock* block = 0;
+  m_mutex.lock();
+  if (!m_free.empty()) {
+    block = m_free.back();
+    m_free.pop_back();
+  }
+  m_mutex.unlock();
+
+  if (!block) {
+    block = new EventBlock(*this);
+    __atomic_add_fetch(&m_nalloc, 1, __ATOMIC_RELAXED);
+  }
+  block->m_ref = 1;
+  return block;
+}
+
+//______________________________________________________________________________
+void EventBlockPool::put(EventBlock* block)
+{
+  m_mutex.lock();
+  m_free.push_back(block);
+  m_mutex.unlock();
+}
@@ -77,13 +77,10 @@ void MonDataSender::notify()
 	 i = m_sender_list.begin(), iEnd = m_sender_list.end();
        i!=iEnd; ++i) {
     SenderThread* t  = *i;
-    if (!t)
+    if (!t || !t->good())
       continue;
-    if (t->isBusy()) {
-      //if (checkCommand()!=0) return;
-      if (checkCommand()!=0) break;
-      else continue;
-    }
+    // a monitor still sending gets the newest event next, the one it
+    // has not picked up yet is dropped
     t->update(m_common_data);
   }
   m_list_mutex.unlock();
@@ -9,6 +9,7 @@
 #include "MessageHelper.h"
 #include "daqthread.h"
 #include "pollthread.h"
+#include "sendthread.h"
 #include "userdevice.h"
 
 static const int EV_MAGIC = 0x45564e54;
@@ -47,7 +48,6 @@ int DaqThread::run()
 
   unsigned int *buf           = new unsigned int[max_buf_len];
   struct event_header *header = reinterpret_cast<struct event_header *>(buf);
-  unsigned int *data          = buf + event_header_len;
 
   memset(header, 0, event_header_size);
   header->magic = EV_MAGIC;
@@ -88,9 +88,21 @@ int DaqThread::run()
       continue;
     }
 
+    m_nodeprop.setBatch(false);
     PollThread poller( m_nodeprop, dsock );
     poller.start();
 
+    // pipelined readout: events are read into buffers of the sender's
+    // pool and sent by the SendThread while the next ones are read
+    const int pipeline = m_nodeprop.getPipelineDepth();
+    SendThread* sender = 0;
+    unsigned int* ev = buf;
+    if (pipeline > 0) {
+      sender = new SendThread( m_nodeprop, dsock, pipeline, max_buf_len );
+      sender->start();
+      ev = sender->acquire();
+    }
+
     header->type       = m_nodeprop.getDaqMode();
     header->run_number = m_nodeprop.getRunNumber();
     m_nodeprop.setEventNumber( 0 );
@@ -112,7 +124,7 @@ int DaqThread::run()
       //User read_device
       int len;
       std::cout << "(before read_device) len " << "\t" << " = " << len << std::endl; // add for debugging
-      status = read_device(m_nodeprop, data, len);
+      status = read_device(m_nodeprop, ev + event_header_len, len);
       if(status==-1) continue;
 
       len += event_header_len;
@@ -122,6 +134,14 @@ int DaqThread::run()
 
       header->event_number = m_nodeprop.getEventNumber();
 
+      if (sender) {
+	std::memcpy(ev, header, event_header_size);
+	sender->submit(ev);
+	m_nodeprop.setEventNumber( header->event_number+1 );
+	ev = sender->acquire();
+	continue;
+      }
+
       int clen = len * sizeof(unsigned int);
 
       try{
@@ -139,6 +159,14 @@ int DaqThread::run()
 
     } //while( getState() == RUNNING )
 
+    if (sender) {
+      // the events already read are sent before finalize_device
+      sender->stop();
+      sender->join();
+      delete sender;
+      m_nodeprop.setQueueDepth(0);
+    }
+
     //User finalize_device
     finalize_device(m_nodeprop);
 
@@ -14,6 +14,7 @@ int main(int argc, char* argv[])
   int dataport = 9000;
   std::string nickname = "nickname";
   bool noupdate_flag = false;
+  int pipeline = 0;
 
   std::istringstream iss;
 
@@ -32,6 +33,10 @@ int main(int argc, char* argv[])
       iss.str(arg.substr(12));
       iss >> dataport;
     }
+    if (arg.substr(0, 11) == "--pipeline=") {
+      iss.str(arg.substr(11));
+      iss >> pipeline;
+    }
     if (arg.substr(0, 24) == "--ignore-nodeprop-update") {
       noupdate_flag = true;
     }
@@ -63,6 +68,7 @@ int main(int argc, char* argv[])
   NodeProp       nodeprop(nodeid, nickname, dataport, noupdate_flag);
   nodeprop.setArgc(argc);
   nodeprop.setArgv(argv);
+  nodeprop.setPipelineDepth(pipeline);
   DaqThread      daqthread(nodeprop);
   ControlThread  controller(nodeprop);
   WatchdogThread watchdog(nodeprop);
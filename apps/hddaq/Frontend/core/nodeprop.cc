@@ -12,6 +12,9 @@ NodeProp::NodeProp(int nodeid, std::string nickname, int data_port, bool noupdat
     m_node_id(nodeid),
     m_event_number(0),
     m_event_size(0),
+    m_pipeline_depth(0),
+    m_queue_depth(0),
+    m_batch(false),
     m_data_port(data_port),
     m_nickname(nickname),
     m_update_flag(false),
@@ -119,6 +122,51 @@ int NodeProp::getEventSize()
   return ret;
 }
 
+void NodeProp::setPipelineDepth(int new_value)
+{
+  access_mutex->lock();
+  m_pipeline_depth = new_value;
+  access_mutex->unlock();
+  return;
+}
+int NodeProp::getPipelineDepth()
+{
+  access_mutex->lock();
+  int ret = m_pipeline_depth;
+  access_mutex->unlock();
+  return ret;
+}
+
+void NodeProp::setQueueDepth(int new_value)
+{
+  access_mutex->lock();
+  m_queue_depth = new_value;
+  access_mutex->unlock();
+  return;
+}
+int NodeProp::getQueueDepth()
+{
+  access_mutex->lock();
+  int ret = m_queue_depth;
+  access_mutex->unlock();
+  return ret;
+}
+
+void NodeProp::setBatch(bool new_value)
+{
+  access_mutex->lock();
+  m_batch = new_value;
+  access_mutex->unlock();
+  return;
+}
+bool NodeProp::getBatch()
+{
+  access_mutex->lock();
+  bool ret = m_batch;
+  access_mutex->unlock();
+  return ret;
+}
+
 void NodeProp::ackStatus()
 {
   std::ostringstream oss;
@@ -144,6 +192,8 @@ void NodeProp::ackStatus()
   oss << " run:" << m_run_number;
   oss << " event:" << m_event_number;
   oss << " size:" << m_event_size;
+  if (m_pipeline_depth > 0)
+    oss << " queue:" << m_queue_depth << "/" << m_pipeline_depth;
 
   access_mutex->unlock();
 
@@ -36,6 +36,9 @@ private:
   int                      m_node_id;
   int                      m_event_number;
   int                      m_event_size;
+  int                      m_pipeline_depth;
+  int                      m_queue_depth;
+  bool                     m_batch;
   int                      m_data_port;
   std::string              m_nickname;
   bool                     m_update_flag;
@@ -61,6 +64,18 @@ public:
   void setEventSize(int new_value);
   int getEventSize();
 
+  // pipelined readout: number of event buffers (0: sequential readout)
+  // and events read but not sent yet
+  void setPipelineDepth(int new_value);
+  int getPipelineDepth();
+
+  void setQueueDepth(int new_value);
+  int getQueueDepth();
+
+  // the event builder accepts super-frames of several events
+  void setBatch(bool new_value);
+  bool getBatch();
+
   int getDataPort() const { return m_data_port; }
   int getNodeId() const { return m_node_id; }
 
@@ -9,6 +9,10 @@
 #include "MessageHelper.h"
 #include "pollthread.h"
 
+// sent by an event builder reader which accepts super-frames
+// (g_BATCH_REQUEST in EventBuilder.h)
+static const char BATCH_REQUEST = 'B';
+
 PollThread::PollThread(NodeProp& nodeprop, kol::TcpSocket& sock)
   : m_nodeprop(nodeprop),
     m_sock(sock)
@@ -36,6 +40,11 @@ int PollThread::run()
 	  m_nodeprop.setStateAck(END);
 	  break;
 	}
+
+	if (buf[0] == BATCH_REQUEST){
+	  std::cout << "#D event builder requests batch transfer" << std::endl;
+	  m_nodeprop.setBatch(true);
+	}
       }
     catch(...)
       {
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <cstdlib>
+#include <sys/uio.h>
+
+#include "kol/koltcp.h"
+
+#include "nodeprop.h"
+#include "MessageHelper.h"
+#include "sendthread.h"
+
+// position of the event size (in words) in struct event_header
+static const int EVENT_SIZE_WORD = 1;
+
+SendThread::SendThread(NodeProp& nodeprop, kol::TcpSocket& sock,
+		       int nbuffer, int buf_len)
+  : m_nodeprop(nodeprop),
+    m_sock(sock),
+    m_pool(nbuffer),
+    m_free(),
+    m_full(),
+    m_mutex(),
+    m_nfull(0),
+    m_nfree(nbuffer)
+{
+  for (int i=0; i<nbuffer; ++i) {
+    m_pool[i] = new unsigned int[buf_len];
+    m_free.push_back(m_pool[i]);
+  }
+  m_nodeprop.setQueueDepth(0);
+}
+
+SendThread::~SendThread()
+{
+  for (size_t i=0; i<m_pool.size(); ++i)
+    delete [] m_pool[i];
+  std::cout << "SendThread destructed" << std::endl;
+}
+
+unsigned int* SendThread::acquire()
+{
+  m_nfree.wait();
+  m_mutex.lock();
+  unsigned int* buf = m_free.back();
+  m_free.pop_back();
+  m_mutex.unlock();
+  return buf;
+}
+
+void SendThread::submit(unsigned int* buf)
+{
+  m_mutex.lock();
+  m_full.push_back(buf);
+  int depth = m_full.size();
+  m_mutex.unlock();
+  m_nodeprop.setQueueDepth(depth);
+  m_nfull.post();
+}
+
+void SendThread::stop()
+{
+  // a null buffer marks the end of the run
+  m_mutex.lock();
+  m_full.push_back(0);
+  m_mutex.unlock();
+  m_nfull.post();
+}
+
+int SendThread::run()
+{
+  unsigned int* batch[MAX_BATCH];
+  struct iovec  iov[MAX_BATCH+1];
+  bool done = false;
+
+  while (!done) {
+    // wait for one event, then take every event already queued
+    m_nfull.wait();
+    int n = 0;
+    size_t clen = 0;
+    m_mutex.lock();
+    do {
+      unsigned int* buf = m_full.front();
+      m_full.pop_front();
+      if (!buf) {
+	done = true;
+	break;
+      }
+      batch[n] = buf;
+      iov[n+1].iov_base = buf;
+      iov[n+1].iov_len  = buf[EVENT_SIZE_WORD] * sizeof(unsigned int);
+      clen += iov[n+1].iov_len;
+      ++n;
+    } while (n < MAX_BATCH && clen < MAX_BATCH_BYTE
+	     && m_nfull.trywait() == 0);
+    int depth = m_full.size();
+    m_mutex.unlock();
+    m_nodeprop.setQueueDepth(depth);
+
+    if (n == 0) continue;
+
+    // iov[0] is the super-frame header, used for more than one event
+    int first = 1;
+    if (n > 1 && m_nodeprop.getBatch()) {
+      m_batch_header[0] = BATCH_MAGIC;
+      m_batch_header[1] = 2 + clen / sizeof(unsigned int);
+      iov[0].iov_base = m_batch_header;
+      iov[0].iov_len  = sizeof(m_batch_header);
+      clen += sizeof(m_batch_header);
+      first = 0;
+    }
+
+    try{
+      m_sock.writev(&iov[first], n+1-first);
+    }catch(...){
+      send_fatal_message(m_nodeprop.getNickName()+" data send failure");
+      std::cout << m_nodeprop.getNickName() << " #E data send failed -> exit "
+		<< "event=" << m_nodeprop.getEventNumber()
+		<< ",nevent=" << n
+		<< ",clen=" << clen << std::endl;
+      std::exit(-1);
+    }
+
+    m_mutex.lock();
+    for (int i=0; i<n; ++i)
+      m_free.push_back(batch[i]);
+    m_mutex.unlock();
+    for (int i=0; i<n; ++i)
+      m_nfree.post();
+  }
+
+  return 0;
+}
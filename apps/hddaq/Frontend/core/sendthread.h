@@ -0,0 +1,55 @@
+#ifndef SENDTHREAD_H
+#define SENDTHREAD_H
+
+#include <deque>
+#include <vector>
+
+#include "kol/kolthread.h"
+
+namespace kol { class TcpSocket;}
+class NodeProp;
+
+// Pipelined readout: the DaqThread fills event buffers taken from a pool
+// and queues them, this thread sends the queued events to the event
+// builder, several of them per writev(), while the next events are read.
+// When the event builder asked for batch transfer, the events sent
+// together are wrapped in one super-frame {BATCH_MAGIC, size}.
+class SendThread : public kol::Thread
+{
+public:
+  static const int MAX_BATCH = 64;
+  // A batch is closed once it holds MAX_BATCH_BYTE, so it may pass this
+  // by one event. 4 MB keeps that well below the 64 MB the event builder
+  // accepts (g_BATCH_MAX_BYTE). Events of a few MB fill a writev() on
+  // their own and gain nothing from being batched.
+  static const size_t MAX_BATCH_BYTE = 4*1024*1024;
+  static const unsigned int BATCH_MAGIC = 0x42415443;
+
+  SendThread(NodeProp& nodeprop, kol::TcpSocket& sock,
+	     int nbuffer, int buf_len);
+  ~SendThread();
+
+  // free buffer for the next event, waits while every buffer is queued
+  unsigned int* acquire();
+  // queues a filled event, the event header gives its size
+  void submit(unsigned int* buf);
+  // the thread ends after sending the events queued before stop()
+  void stop();
+  int run();
+
+private:
+  SendThread(const SendThread&);
+  SendThread& operator=(const SendThread&);
+
+  NodeProp&                  m_nodeprop;
+  kol::TcpSocket&            m_sock;
+  std::vector<unsigned int*> m_pool;
+  std::vector<unsigned int*> m_free;
+  std::deque<unsigned int*>  m_full;
+  kol::Mutex                 m_mutex;
+  kol::Semaphore             m_nfull;
+  kol::Semaphore             m_nfree;
+  unsigned int               m_batch_header[2];
+};
+
+#endif
@@ -11,6 +11,8 @@
 
 #include <iostream>
 
+#include "GZRestartListener.hh"
+
 namespace hddaq
 {
   namespace unpacker
@@ -50,6 +52,10 @@ namespace hddaq
       char_type*              m_pback_cur_save;
       char_type*              m_pback_end_save;
       bool		    m_pback_init;
+      GZRestartListener*      m_listener;
+      uint64_t                m_restart_interval;
+      uint64_t                m_raw_offset;
+      uint64_t                m_next_restart;
       //     char_type*           m_ext_buf;
       //     std::streamsize      m_ext_buf_size;
       //     const char*	    m_ext_next;
@@ -65,6 +71,10 @@ namespace hddaq
 			 std::ios_base::openmode mode);
       void          set_compression(int level,
 				    int strategy = Z_DEFAULT_STRATEGY);
+      // ends the gzip member every interval bytes of input, see
+      // GZRestartListener
+      void          set_restart(GZRestartListener* listener,
+				uint64_t interval);
 
     protected:
       void                    allocate_internal_buffer();
@@ -113,7 +123,11 @@ namespace hddaq
 	m_pback(),
 	m_pback_cur_save(0),
 	m_pback_end_save(0),
-	m_pback_init(false)
+	m_pback_init(false),
+	m_listener(0),
+	m_restart_interval(0),
+	m_raw_offset(0),
+	m_next_restart(0)
 	//     m_ext_buf(0),
 	//     m_ext_buf_size(0),
 	//     m_ext_next(0),
@@ -165,13 +179,38 @@ namespace hddaq
     basic_gz_filebuf<CharT, Traits>::convert_to_external(char_type* s,
 							 std::streamsize n)
     {
-      std::streamsize elen;
-      std::streamsize plen;
-      elen = ::gzwrite(m_file,
-		       reinterpret_cast<char*>(s),
-		       n);
-      plen = n;
-      return (elen == plen);
+      if (!m_listener || m_restart_interval == 0)
+	{
+	  std::streamsize elen;
+	  std::streamsize plen;
+	  elen = ::gzwrite(m_file,
+			   reinterpret_cast<char*>(s),
+			   n);
+	  plen = n;
+	  return (elen == plen);
+	}
+
+      while (n > 0)
+	{
+	  std::streamsize len = n;
+	  if (m_raw_offset + len > m_next_restart)
+	    len = m_next_restart - m_raw_offset;
+	  if (::gzwrite(m_file, reinterpret_cast<char*>(s), len) != len)
+	    return false;
+	  m_raw_offset += len;
+	  s += len;
+	  n -= len;
+	  if (m_raw_offset == m_next_restart)
+	    {
+	      // Z_FINISH completes the member, the next gzwrite() starts a
+	      // new one; everything is written, gzoffset() is the file size
+	      if (::gzflush(m_file, Z_FINISH) != Z_OK)
+		return false;
+	      m_listener->restart(m_raw_offset, ::gzoffset(m_file));
+	      m_next_restart += m_restart_interval;
+	    }
+	}
+      return true;
     }
 
     //______________________________________________________________________________
@@ -261,6 +300,8 @@ namespace hddaq
       if (this->is_open())
 	{
 	  allocate_internal_buffer();
+	  m_raw_offset   = 0;
+	  m_next_restart = m_restart_interval;
 	  m_mode    = mode;
 	  m_reading = false;
 	  m_writing = false;
@@ -482,6 +523,18 @@ namespace hddaq
       return;
     }
 
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    void
+    basic_gz_filebuf<CharT, Traits>::set_restart(GZRestartListener* listener,
+						 uint64_t interval)
+    {
+      m_listener         = listener;
+      m_restart_interval = interval;
+      m_next_restart     = m_raw_offset + interval;
+      return;
+    }
+
     //______________________________________________________________________________
     template <typename CharT, typename Traits>
     std::streamsize
@@ -0,0 +1,33 @@
+// -*- C++ -*-
+/**
+ *  @file   GZRestartListener.hh
+ *  @brief  notification of gzip member boundaries in compressed output
+ *
+ *  A reader can start decompressing at the beginning of any gzip member.
+ *  The gzip output buffers report where each new member starts, both in
+ *  the uncompressed data and in the file, so that an event index can jump
+ *  into a compressed run without inflating it from the beginning.
+ */
+
+#ifndef HDDAQ__GZ_RESTART_LISTENER_H
+#define HDDAQ__GZ_RESTART_LISTENER_H
+
+#include <stdint.h>
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+    class GZRestartListener
+    {
+    public:
+      virtual ~GZRestartListener() {}
+      // Called by the thread which writes the file, once per member after
+      // the first one (which always starts at 0, 0).
+      virtual void restart(uint64_t raw_offset, uint64_t file_offset) = 0;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,17 @@
+// -*- C++ -*-
+
+#ifndef HDDAQ__O_PGZ_FILE_STREAM_H
+#define HDDAQ__O_PGZ_FILE_STREAM_H
+
+#include "PGZFileBuf.hh"
+#include "output_stream.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+    // gzip output compressed by several threads, see ParallelGZip
+    typedef basic_output_stream<basic_pgz_filebuf, char> OPGZFileStream;
+  }
+}
+#endif
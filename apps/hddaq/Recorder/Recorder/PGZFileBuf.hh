@@ -0,0 +1,230 @@
+// -*- C++ -*-
+
+#ifndef HDDAQ__PGZ_FILE_BUF_H
+#define HDDAQ__PGZ_FILE_BUF_H
+
+#include <streambuf>
+#include <bits/char_traits.h>
+#include <vector>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "ParallelGZip.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+    // Output-only counterpart of basic_gz_filebuf. Every block_size bytes
+    // become one gzip member compressed by ParallelGZip; the file reads
+    // back through basic_gz_filebuf (gzread handles concatenated members).
+    template<typename CharT, typename Traits = std::char_traits<CharT> >
+    class basic_pgz_filebuf
+      : public std::basic_streambuf<CharT, Traits>
+    {
+
+      static const unsigned int k_Block_Size = 1024*1024;
+
+    public:
+      typedef CharT                     	        char_type;
+      typedef Traits                    	        traits_type;
+      typedef typename traits_type::int_type      int_type;
+
+      typedef std::basic_streambuf<char_type, traits_type>  streambuf_type;
+      typedef basic_pgz_filebuf<char_type, traits_type>     filebuf_type;
+
+    protected:
+      ParallelGZip*           m_engine;
+      std::ios_base::openmode m_mode;
+      int                     m_level;
+      int                     m_strategy;
+      int                     m_nthread;
+      std::size_t             m_block_size;
+      std::vector<char>       m_block;
+      GZRestartListener*      m_listener;
+
+    public:
+      basic_pgz_filebuf();
+      virtual ~basic_pgz_filebuf();
+
+      filebuf_type* close() throw();
+      bool          is_open() const throw();
+      filebuf_type* open(const char* s,
+			 std::ios_base::openmode mode);
+      void          set_compression(int level,
+				    int strategy = Z_DEFAULT_STRATEGY);
+      // before open(); nthread = 0 uses one thread per online CPU
+      void          set_parallel(int nthread,
+				 std::size_t block_size = k_Block_Size);
+      // before open(); every block starts a new gzip member
+      void          set_restart(GZRestartListener* listener);
+
+    protected:
+      bool                    submit_block();
+      virtual int_type        overflow(int_type c = Traits::eof());
+      virtual int             sync();
+
+    };
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    basic_pgz_filebuf<CharT, Traits>::basic_pgz_filebuf()
+      : streambuf_type(),
+	m_engine(0),
+	m_mode(std::ios_base::openmode(0)),
+	m_level(Z_BEST_SPEED),
+	m_strategy(Z_DEFAULT_STRATEGY),
+	m_nthread(0),
+	m_block_size(k_Block_Size),
+	m_block(),
+	m_listener(0)
+    {
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    basic_pgz_filebuf<CharT, Traits>::~basic_pgz_filebuf()
+    {
+      this->close();
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    typename basic_pgz_filebuf<CharT, Traits>::filebuf_type*
+    basic_pgz_filebuf<CharT, Traits>::close() throw()
+    {
+      filebuf_type* ret=0;
+      if (this->is_open())
+	{
+	  bool flushed = submit_block();
+	  if (m_engine->close() && flushed)
+	    ret = this;
+	  delete m_engine;
+	  m_engine = 0;
+	  this->setp(0, 0);
+	}
+      return ret;
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    bool
+    basic_pgz_filebuf<CharT, Traits>::is_open() const throw()
+    {
+      return (0 != m_engine);
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    typename basic_pgz_filebuf<CharT, Traits>::filebuf_type*
+    basic_pgz_filebuf<CharT, Traits>::open(const char* s,
+					   std::ios_base::openmode mode)
+    {
+      filebuf_type* ret = 0;
+      if (this->is_open() || (std::ios_base::in & mode))
+	return ret;
+
+      int nthread = m_nthread;
+      if (nthread <= 0)
+	nthread = ::sysconf(_SC_NPROCESSORS_ONLN);
+      m_engine = new ParallelGZip(nthread, m_level, m_strategy);
+      m_engine->set_listener(m_listener);
+      if (!m_engine->open(s))
+	{
+	  delete m_engine;
+	  m_engine = 0;
+	  return ret;
+	}
+
+      m_mode = mode;
+      m_block.resize(m_block_size);
+      this->setp(&m_block[0], &m_block[0] + m_block.size());
+      ret = this;
+      return ret;
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    typename basic_pgz_filebuf<CharT, Traits>::int_type
+    basic_pgz_filebuf<CharT, Traits>::overflow(int_type c)
+    {
+      int_type ret = traits_type::eof();
+      if (!this->is_open() || !submit_block())
+	return ret;
+
+      if (!traits_type::eq_int_type(c, ret))
+	{
+	  *this->pptr() = traits_type::to_char_type(c);
+	  this->pbump(1);
+	}
+      return traits_type::not_eof(c);
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    void
+    basic_pgz_filebuf<CharT, Traits>::set_compression(int level, int strategy)
+    {
+      m_level    = level;
+      m_strategy = strategy;
+      return;
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    void
+    basic_pgz_filebuf<CharT, Traits>::set_parallel(int nthread,
+						   std::size_t block_size)
+    {
+      if (!this->is_open())
+	{
+	  m_nthread    = nthread;
+	  m_block_size = (block_size > 0) ? block_size : k_Block_Size;
+	}
+      return;
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    void
+    basic_pgz_filebuf<CharT, Traits>::set_restart(GZRestartListener* listener)
+    {
+      if (!this->is_open())
+	m_listener = listener;
+      return;
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    bool
+    basic_pgz_filebuf<CharT, Traits>::submit_block()
+    {
+      std::size_t n = this->pptr() - this->pbase();
+      if (n > 0)
+	{
+	  // the block is swapped, not copied, into the compressor queue
+	  m_block.resize(n);
+	  m_engine->submit(m_block);
+	  m_block.resize(m_block_size);
+	  this->setp(&m_block[0], &m_block[0] + m_block.size());
+	}
+      return m_engine->good();
+    }
+
+    //______________________________________________________________________________
+    template <typename CharT, typename Traits>
+    int
+    basic_pgz_filebuf<CharT, Traits>::sync()
+    {
+      if (!this->is_open())
+	return 0;
+      return submit_block() ? 0 : -1;
+    }
+
+    //______________________________________________________________________________
+    typedef basic_pgz_filebuf<char> PGZFileBuf;
+
+  }
+}
+#endif
@@ -0,0 +1,105 @@
+// -*- C++ -*-
+/**
+ *  @file   ParallelGZip.hh
+ *  @brief  block-parallel gzip compression to a file
+ *
+ *  The input is cut into blocks which are compressed by a pool of worker
+ *  threads, each one into a complete gzip member, and written in their
+ *  original order by a writer thread. A gzip file may consist of several
+ *  members, so the result is read back by gzread() (IGZFileStream) or
+ *  gunzip as a single stream, like files written by pigz.
+ */
+
+#ifndef HDDAQ__PARALLEL_GZIP_H
+#define HDDAQ__PARALLEL_GZIP_H
+
+#include <deque>
+#include <vector>
+
+#include "kol/kolthread.h"
+#include "GZRestartListener.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+    class ParallelGZip
+    {
+    public:
+      ParallelGZip(int nthread, int level, int strategy);
+      ~ParallelGZip();
+
+      bool open(const char* path);
+      // false once a write to the file failed
+      bool close();
+      bool good() const { return m_good; }
+      bool is_open() const { return (m_fd >= 0); }
+      // Hands the data in block over to the compressors. The vector is
+      // swapped with recycled storage, so the caller does not copy.
+      void submit(std::vector<char>& block);
+      // every block is a member, each one after the first is reported
+      void set_listener(GZRestartListener* listener) { m_listener = listener; }
+
+    private:
+      struct Job
+      {
+	Job();
+	std::vector<char> in;
+	std::vector<char> out;
+	kol::Semaphore    done;
+      };
+
+      class Worker : public kol::Thread
+      {
+      public:
+	Worker(ParallelGZip& owner) : m_owner(owner) {}
+      protected:
+	int run() { return m_owner.work(); }
+      private:
+	ParallelGZip& m_owner;
+      };
+
+      class Writer : public kol::Thread
+      {
+      public:
+	Writer(ParallelGZip& owner) : m_owner(owner) {}
+      protected:
+	int run() { return m_owner.write(); }
+      private:
+	ParallelGZip& m_owner;
+      };
+
+      ParallelGZip(const ParallelGZip&);
+      ParallelGZip& operator=(const ParallelGZip&);
+
+      int  work();
+      int  write();
+      bool compress(Job* job);
+      bool writeAll(const char* buf, size_t len);
+
+      int                  m_level;
+      int                  m_strategy;
+      int                  m_fd;
+      bool                 m_good;
+      unsigned long        m_nblock;
+      GZRestartListener*   m_listener;
+      uint64_t             m_raw_offset;  // written by the writer thread
+      uint64_t             m_file_offset;
+
+      std::vector<Job*>    m_jobs;
+      std::vector<Worker*> m_workers;
+      Writer               m_writer;
+
+      kol::Mutex           m_mutex;
+      std::vector<Job*>    m_free;      // recycled jobs
+      std::deque<Job*>     m_work;      // waiting for a worker
+      std::deque<Job*>     m_order;     // submission order, for the writer
+      kol::Semaphore       m_nfree;
+      kol::Semaphore       m_nwork;
+      kol::Semaphore       m_norder;
+    };
+
+  }
+}
+#endif
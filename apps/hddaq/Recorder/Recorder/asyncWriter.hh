@@ -0,0 +1,95 @@
+// -*- C++ -*-
+/**
+ *  @file   asyncWriter.hh
+ *  @brief  double-buffered output file written by a separate thread
+ *
+ *  The RecorderThread copies events into large page-aligned buffers and
+ *  hands every full buffer to a writer thread, so reading the socket and
+ *  writing the disk overlap. A plain data file is written with O_DIRECT
+ *  (falling back to buffered I/O where the file system refuses it); a
+ *  compressed one goes through the given gzip stream in the writer
+ *  thread. The
+ *  RecorderThread waits for a free buffer only when the disk stays slower
+ *  than the input for longer than the whole pool can absorb.
+ */
+
+#ifndef RECORDER_ASYNC_WRITER_H
+#define RECORDER_ASYNC_WRITER_H
+
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+#include "kol/kolthread.h"
+
+class AsyncWriter : public kol::Thread
+{
+public:
+  static const size_t ALIGNMENT = 4096;
+
+public:
+  // ofs: already opened compressed stream, owned by the writer, or 0
+  AsyncWriter(const std::string& filename, std::ostream* ofs,
+	      size_t buffer_byte, int nbuffer);
+  virtual ~AsyncWriter();
+
+  bool good() const { return m_good; }
+  bool isDirect() const { return m_direct; }
+  // called by the recorder thread only
+  void write(const void* buf, size_t len);
+  void close();
+  // one line of ingest/disk throughput since the last call
+  std::string statistics();
+
+protected:
+  int run();
+
+private:
+  struct Buffer
+  {
+    char*  data;
+    size_t len;
+  };
+
+  AsyncWriter(const AsyncWriter&);
+  AsyncWriter& operator=(const AsyncWriter&);
+
+  bool    open(const std::string& filename);
+  void    submit(Buffer* buffer);
+  Buffer* acquire();
+  bool    flush(Buffer* buffer);
+
+  std::string          m_filename;
+  size_t               m_buffer_byte;
+  bool                 m_good;
+  bool                 m_direct;
+  int                  m_fd;
+  std::ostream*        m_ofs;
+
+  std::vector<Buffer>  m_pool;
+  Buffer*              m_current;
+  std::deque<Buffer*>  m_full;
+  std::vector<Buffer*> m_free;
+  kol::Mutex           m_mutex;
+  kol::Semaphore       m_nfull;
+  kol::Semaphore       m_nfree;
+  bool                 m_closing;
+
+  // statistics, ingest side is owned by the recorder thread
+  struct timeval       m_start;
+  struct timeval       m_last_report;
+  unsigned long long   m_ingest_byte;
+  unsigned long long   m_ingest_byte_reported;
+  double               m_stall_time;
+  unsigned long        m_nstall;
+  // disk side, written by the writer thread
+  unsigned long long   m_file_byte;
+  unsigned long long   m_disk_byte;
+  unsigned long long   m_disk_byte_reported;
+  unsigned long long   m_disk_usec;
+  unsigned long long   m_disk_usec_reported;
+};
+
+#endif
@@ -0,0 +1,56 @@
+// -*- C++ -*-
+
+#ifndef RECORD_EVENT_INDEX_H
+#define RECORD_EVENT_INDEX_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Recorder/GZRestartListener.hh"
+
+// Writes bookmark/runNNNNN_index.dat next to the Bookmarker file:
+//
+//   uint64_t event_offset[n_event];   start of event i in the raw data
+//   uint64_t restart[n_restart][2];   {raw offset, file offset} at which
+//                                     a gzip member starts (.gz runs only)
+//   Trailer                           see below, at the end of the file
+//
+// The restart points are collected from the compressed stream and written
+// by close(), which must be called after the stream has been closed.
+class EventIndexer : public hddaq::unpacker::GZRestartListener
+{
+
+public:
+  static const uint32_t k_magic   = 0x58494448; // "HDIX"
+  static const uint32_t k_version = 1;
+
+  struct Trailer
+  {
+    uint32_t m_magic;
+    uint32_t m_version;
+    uint64_t m_n_event;
+    uint64_t m_n_restart;
+    uint64_t m_data_size;
+  };
+
+  EventIndexer(int run_number,
+	       std::string dir_name);
+  ~EventIndexer();
+
+public:
+  void close();
+  void operator +=(unsigned long long size);
+  void restart(uint64_t raw_offset, uint64_t file_offset);
+
+private:
+  std::string           m_filename;
+  std::ofstream         m_index;
+  uint64_t              m_offset;
+  uint64_t              m_n_event;
+  // filled by the thread which writes the data file
+  std::vector<uint64_t> m_restart;
+};
+
+#endif
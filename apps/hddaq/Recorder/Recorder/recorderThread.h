@@ -46,6 +46,8 @@
 
 enum {REC_NORMAL, REC_COMPRESS};
 
+namespace hddaq { namespace unpacker { class GZRestartListener; } }
+
 class RecorderThread : public StatableThread
 {
 public:
@@ -57,10 +59,16 @@ public:
   void setPortNo(int port);
   void setRecordMode(int);
   int getRecordMode();
+  // write the file from a separate thread through nbuffer buffers
+  void setAsyncWriter(size_t buffer_byte, int nbuffer);
+  // 1: zlib in the recorder thread, 0: one per CPU, n: n threads
+  void setCompressThreads(int nthread);
 
 protected:
   int active_loop();
   std::string makeFileName(int run_no);
+  std::ostream* openCompressed(const std::string& fname,
+			       hddaq::unpacker::GZRestartListener* listener);
   int checkCopperData(unsigned int*, int);
   int dump_data(unsigned int *, unsigned int *, int);
 
@@ -70,6 +78,10 @@ private:
   std::string m_dir_name;
   std::string m_hostname;
   int m_rec_mode;
+  bool m_async;
+  size_t m_async_buffer_byte;
+  int m_async_nbuffer;
+  int m_compress_threads;
 };
 
 #endif
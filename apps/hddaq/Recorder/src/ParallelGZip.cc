@@ -0,0 +1,260 @@
+// -*- C++ -*-
+/**
+ *  @file   ParallelGZip.cc
+ *  @brief  block-parallel gzip compression to a file
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <iostream>
+
+#include "Recorder/ParallelGZip.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+    namespace
+    {
+      // windowBits for deflateInit2: 32 kB window with a gzip wrapper
+      const int k_gzip_window_bits = 15 + 16;
+      const int k_mem_level        = 8;
+    }
+
+    //__________________________________________________________________________
+    ParallelGZip::Job::Job()
+      : in(),
+	out(),
+	done(0)
+    {
+    }
+
+    //__________________________________________________________________________
+    ParallelGZip::ParallelGZip(int nthread, int level, int strategy)
+      : m_level(level),
+	m_strategy(strategy),
+	m_fd(-1),
+	m_good(true),
+	m_nblock(0),
+	m_listener(0),
+	m_raw_offset(0),
+	m_file_offset(0),
+	m_jobs(),
+	m_workers(nthread > 0 ? nthread : 1),
+	m_writer(*this),
+	m_mutex(),
+	m_free(),
+	m_work(),
+	m_order(),
+	m_nfree(0),
+	m_nwork(0),
+	m_norder(0)
+    {
+      // two blocks per worker keep the workers busy while one is written
+      m_jobs.resize(2 * m_workers.size() + 1);
+      for (std::size_t i=0; i<m_jobs.size(); ++i) {
+	m_jobs[i] = new Job;
+	m_free.push_back(m_jobs[i]);
+	m_nfree.post();
+      }
+      for (std::size_t i=0; i<m_workers.size(); ++i)
+	m_workers[i] = 0;
+    }
+
+    //__________________________________________________________________________
+    ParallelGZip::~ParallelGZip()
+    {
+      close();
+      for (std::size_t i=0; i<m_jobs.size(); ++i)
+	delete m_jobs[i];
+    }
+
+    //__________________________________________________________________________
+    bool
+    ParallelGZip::open(const char* path)
+    {
+      if (is_open())
+	return false;
+      m_fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (m_fd < 0)
+	return false;
+      m_good        = true;
+      m_nblock      = 0;
+      m_raw_offset  = 0;
+      m_file_offset = 0;
+
+      for (std::size_t i=0; i<m_workers.size(); ++i) {
+	m_workers[i] = new Worker(*this);
+	m_workers[i]->start();
+      }
+      m_writer.start();
+      return true;
+    }
+
+    //__________________________________________________________________________
+    bool
+    ParallelGZip::close()
+    {
+      if (!is_open())
+	return m_good;
+
+      // a file without any member is not a valid gzip file
+      if (m_nblock == 0) {
+	std::vector<char> empty;
+	submit(empty);
+      }
+
+      m_mutex.lock();
+      for (std::size_t i=0; i<m_workers.size(); ++i)
+	m_work.push_back(0);
+      m_mutex.unlock();
+      for (std::size_t i=0; i<m_workers.size(); ++i)
+	m_nwork.post();
+      for (std::size_t i=0; i<m_workers.size(); ++i) {
+	m_workers[i]->join();
+	delete m_workers[i];
+	m_workers[i] = 0;
+      }
+
+      m_mutex.lock();
+      m_order.push_back(0);
+      m_mutex.unlock();
+      m_norder.post();
+      m_writer.join();
+
+      if (::close(m_fd) != 0)
+	m_good = false;
+      m_fd = -1;
+      return m_good;
+    }
+
+    //__________________________________________________________________________
+    void
+    ParallelGZip::submit(std::vector<char>& block)
+    {
+      m_nfree.wait();
+      m_mutex.lock();
+      Job* job = m_free.back();
+      m_free.pop_back();
+      m_mutex.unlock();
+
+      job->in.swap(block);
+      block.clear();
+
+      m_mutex.lock();
+      m_work.push_back(job);
+      m_order.push_back(job);
+      m_mutex.unlock();
+      m_nwork.post();
+      m_norder.post();
+      ++m_nblock;
+    }
+
+    //__________________________________________________________________________
+    int
+    ParallelGZip::work()
+    {
+      while (true) {
+	m_nwork.wait();
+	m_mutex.lock();
+	Job* job = m_work.front();
+	m_work.pop_front();
+	m_mutex.unlock();
+	if (!job)
+	  break;
+	if (!compress(job))
+	  m_good = false;
+	job->done.post();
+      }
+      return 0;
+    }
+
+    //__________________________________________________________________________
+    int
+    ParallelGZip::write()
+    {
+      while (true) {
+	m_norder.wait();
+	m_mutex.lock();
+	Job* job = m_order.front();
+	m_order.pop_front();
+	m_mutex.unlock();
+	if (!job)
+	  break;
+
+	job->done.wait();
+	if (m_listener && m_file_offset > 0)
+	  m_listener->restart(m_raw_offset, m_file_offset);
+	if (m_good && !job->out.empty()
+	    && !writeAll(&job->out[0], job->out.size()))
+	  m_good = false;
+	m_raw_offset  += job->in.size();
+	m_file_offset += job->out.size();
+
+	m_mutex.lock();
+	m_free.push_back(job);
+	m_mutex.unlock();
+	m_nfree.post();
+      }
+      return 0;
+    }
+
+    //__________________________________________________________________________
+    bool
+    ParallelGZip::compress(Job* job)
+    {
+      z_stream zs;
+      std::memset(&zs, 0, sizeof(zs));
+      if (::deflateInit2(&zs, m_level, Z_DEFLATED, k_gzip_window_bits,
+			 k_mem_level, m_strategy) != Z_OK) {
+	job->out.clear();
+	return false;
+      }
+
+      job->out.resize(::deflateBound(&zs, job->in.size()));
+      zs.next_in   = reinterpret_cast<Bytef*>(job->in.empty() ? 0
+						  : &job->in[0]);
+      zs.avail_in  = job->in.size();
+      zs.next_out  = reinterpret_cast<Bytef*>(&job->out[0]);
+      zs.avail_out = job->out.size();
+
+      int status = ::deflate(&zs, Z_FINISH);
+      while (status == Z_OK) {
+	// deflateBound() is an upper limit, this is not expected
+	std::size_t used = zs.total_out;
+	job->out.resize(job->out.size() * 2);
+	zs.next_out  = reinterpret_cast<Bytef*>(&job->out[used]);
+	zs.avail_out = job->out.size() - used;
+	status = ::deflate(&zs, Z_FINISH);
+      }
+      job->out.resize(zs.total_out);
+      ::deflateEnd(&zs);
+      return (status == Z_STREAM_END);
+    }
+
+    //__________________________________________________________________________
+    bool
+    ParallelGZip::writeAll(const char* buf, size_t len)
+    {
+      while (len > 0) {
+	ssize_t n = ::write(m_fd, buf, len);
+	if (n < 0) {
+	  if (errno == EINTR)
+	    continue;
+	  std::cerr << "#E ParallelGZip: write error : "
+		    << std::strerror(errno) << std::endl;
+	  return false;
+	}
+	buf += n;
+	len -= n;
+      }
+      return true;
+    }
+
+  }
+}
@@ -0,0 +1,331 @@
+// -*- C++ -*-
+/**
+ *  @file   asyncWriter.cc
+ *  @brief  double-buffered output file written by a separate thread
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Recorder/asyncWriter.hh"
+
+namespace
+{
+  double elapsed(const struct timeval& since, const struct timeval& now)
+  {
+    return (now.tv_sec - since.tv_sec)
+      + (now.tv_usec - since.tv_usec) * 1e-6;
+  }
+
+  double now_elapsed(const struct timeval& since)
+  {
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return elapsed(since, now);
+  }
+}
+
+//______________________________________________________________________________
+AsyncWriter::AsyncWriter(const std::string& filename, std::ostream* ofs,
+			 size_t buffer_byte, int nbuffer)
+  : kol::Thread(),
+    m_filename(filename),
+    m_buffer_byte(0),
+    m_good(false),
+    m_direct(false),
+    m_fd(-1),
+    m_ofs(ofs),
+    m_pool(nbuffer > 2 ? nbuffer : 2),
+    m_current(0),
+    m_full(),
+    m_free(),
+    m_mutex(),
+    m_nfull(0),
+    m_nfree(m_pool.size()),
+    m_closing(false),
+    m_ingest_byte(0),
+    m_ingest_byte_reported(0),
+    m_stall_time(0.),
+    m_nstall(0),
+    m_file_byte(0),
+    m_disk_byte(0),
+    m_disk_byte_reported(0),
+    m_disk_usec(0),
+    m_disk_usec_reported(0)
+{
+  // O_DIRECT needs whole, aligned blocks
+  m_buffer_byte = (buffer_byte + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  if (m_buffer_byte == 0)
+    m_buffer_byte = ALIGNMENT;
+
+  m_good = true;
+  for (size_t i=0; i<m_pool.size(); ++i) {
+    void* p = 0;
+    if (::posix_memalign(&p, ALIGNMENT, m_buffer_byte) != 0) {
+      std::cerr << "#E AsyncWriter: unable to allocate "
+		<< m_buffer_byte << " bytes" << std::endl;
+      m_good = false;
+      p = 0;
+    }
+    m_pool[i].data = static_cast<char*>(p);
+    m_pool[i].len  = 0;
+    m_free.push_back(&m_pool[i]);
+  }
+
+  if (m_good)
+    m_good = open(filename);
+
+  gettimeofday(&m_start, 0);
+  m_last_report = m_start;
+}
+
+//______________________________________________________________________________
+AsyncWriter::~AsyncWriter()
+{
+  close();
+  for (size_t i=0; i<m_pool.size(); ++i)
+    std::free(m_pool[i].data);
+}
+
+//______________________________________________________________________________
+bool
+AsyncWriter::open(const std::string& filename)
+{
+  if (m_ofs)
+    return !m_ofs->fail();
+
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+  m_fd = ::open(filename.c_str(), flags | O_DIRECT, 0666);
+  if (m_fd >= 0) {
+    m_direct = true;
+    return true;
+  }
+  // e.g. tmpfs does not support direct I/O
+  std::cerr << "#W AsyncWriter: O_DIRECT not available for "
+	    << filename << " : " << std::strerror(errno) << std::endl;
+#endif
+  m_fd = ::open(filename.c_str(), flags, 0666);
+  return (m_fd >= 0);
+}
+
+//______________________________________________________________________________
+AsyncWriter::Buffer*
+AsyncWriter::acquire()
+{
+  if (m_nfree.trywait() != 0) {
+    // every buffer is queued or being written: the disk is behind
+    struct timeval t0;
+    gettimeofday(&t0, 0);
+    ++m_nstall;
+    m_nfree.wait();
+    m_stall_time += now_elapsed(t0);
+  }
+  m_mutex.lock();
+  Buffer* buffer = m_free.back();
+  m_free.pop_back();
+  m_mutex.unlock();
+  buffer->len = 0;
+  return buffer;
+}
+
+//______________________________________________________________________________
+void
+AsyncWriter::submit(Buffer* buffer)
+{
+  m_mutex.lock();
+  m_full.push_back(buffer);
+  m_mutex.unlock();
+  m_nfull.post();
+}
+
+//______________________________________________________________________________
+void
+AsyncWriter::write(const void* buf, size_t len)
+{
+  const char* p = static_cast<const char*>(buf);
+  while (len > 0) {
+    if (!m_current)
+      m_current = acquire();
+    size_t n = m_buffer_byte - m_current->len;
+    if (n > len)
+      n = len;
+    std::memcpy(m_current->data + m_current->len, p, n);
+    m_current->len += n;
+    m_ingest_byte  += n;
+    p   += n;
+    len -= n;
+    if (m_current->len == m_buffer_byte) {
+      submit(m_current);
+      m_current = 0;
+    }
+  }
+}
+
+//______________________________________________________________________________
+void
+AsyncWriter::close()
+{
+  if (m_closing)
+    return;
+
+  if (m_current && m_current->len > 0)
+    submit(m_current);
+  m_current = 0;
+
+  m_mutex.lock();
+  m_closing = true;
+  m_mutex.unlock();
+  m_nfull.post();
+  join();
+
+  if (m_ofs) {
+    delete m_ofs;
+    m_ofs = 0;
+  }
+  if (m_fd >= 0) {
+    // drop the padding of the last direct write
+    if (m_direct && ::ftruncate(m_fd, m_file_byte) != 0) {
+      std::cerr << "#E AsyncWriter: ftruncate " << m_filename
+		<< " : " << std::strerror(errno) << std::endl;
+      m_good = false;
+    }
+    if (::close(m_fd) != 0)
+      m_good = false;
+    m_fd = -1;
+  }
+}
+
+//______________________________________________________________________________
+int
+AsyncWriter::run()
+{
+  while (true) {
+    m_nfull.wait();
+    m_mutex.lock();
+    if (m_full.empty()) {
+      bool closing = m_closing;
+      m_mutex.unlock();
+      if (closing)
+	break;
+      continue;
+    }
+    Buffer* buffer = m_full.front();
+    m_full.pop_front();
+    m_mutex.unlock();
+
+    if (m_good && !flush(buffer))
+      m_good = false;
+
+    m_mutex.lock();
+    m_free.push_back(buffer);
+    m_mutex.unlock();
+    m_nfree.post();
+  }
+  return 0;
+}
+
+//______________________________________________________________________________
+bool
+AsyncWriter::flush(Buffer* buffer)
+{
+  struct timeval t0;
+  gettimeofday(&t0, 0);
+
+  bool status = true;
+  if (m_ofs) {
+    m_ofs->write(buffer->data, buffer->len);
+    status = !m_ofs->fail();
+  } else {
+    size_t nbyte = buffer->len;
+    if (m_direct && nbyte % ALIGNMENT) {
+      // only the last buffer of a run is partial
+      size_t padded = (nbyte + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+      std::memset(buffer->data + nbyte, 0, padded - nbyte);
+      nbyte = padded;
+    }
+    const char* p = buffer->data;
+    while (nbyte > 0) {
+      ssize_t n = ::write(m_fd, p, nbyte);
+      if (n < 0) {
+	if (errno == EINTR)
+	  continue;
+#ifdef O_DIRECT
+	if (errno == EINVAL && m_direct) {
+	  std::cerr << "#W AsyncWriter: direct write refused,"
+		    << " falling back to buffered I/O" << std::endl;
+	  ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) & ~O_DIRECT);
+	  m_direct = false;
+	  size_t done = p - buffer->data;
+	  nbyte = (done < buffer->len) ? (buffer->len - done) : 0;
+	  continue;
+	}
+#endif
+	std::cerr << "#E AsyncWriter: write " << m_filename
+		  << " : " << std::strerror(errno) << std::endl;
+	status = false;
+	break;
+      }
+      p     += n;
+      nbyte -= n;
+    }
+  }
+  m_file_byte += buffer->len;
+
+  struct timeval t1;
+  gettimeofday(&t1, 0);
+  unsigned long long usec
+    = static_cast<unsigned long long>(elapsed(t0, t1) * 1e6);
+  __atomic_add_fetch(&m_disk_usec, usec, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&m_disk_byte, buffer->len, __ATOMIC_RELEASE);
+  return status;
+}
+
+//______________________________________________________________________________
+std::string
+AsyncWriter::statistics()
+{
+  struct timeval now;
+  gettimeofday(&now, 0);
+  double dt = elapsed(m_last_report, now);
+  if (dt <= 0.)
+    dt = 1e-6;
+
+  unsigned long long disk_byte
+    = __atomic_load_n(&m_disk_byte, __ATOMIC_ACQUIRE);
+  unsigned long long disk_usec
+    = __atomic_load_n(&m_disk_usec, __ATOMIC_RELAXED);
+  double ingest = (m_ingest_byte - m_ingest_byte_reported) / dt;
+  double disk   = (disk_byte - m_disk_byte_reported) / dt;
+  double busy   = (disk_usec - m_disk_usec_reported) * 1e-6;
+  double speed  = busy > 0. ? (disk_byte - m_disk_byte_reported) / busy : 0.;
+
+  m_mutex.lock();
+  int nqueued = m_full.size();
+  m_mutex.unlock();
+
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(1)
+     << "Rec: ingest " << ingest / 1e6 << " MB/s"
+     << ", disk " << disk / 1e6 << " MB/s"
+     << " (busy " << std::setprecision(0) << busy / dt * 100. << "%"
+     << std::setprecision(1)
+     << ", " << speed / 1e6 << " MB/s while writing"
+     << (m_direct ? ", O_DIRECT" : "") << ")"
+     << ", " << nqueued << "/" << m_pool.size() << " buffers queued"
+     << ", " << m_nstall << " stalls "
+     << std::setprecision(2) << m_stall_time << " s";
+
+  m_last_report          = now;
+  m_ingest_byte_reported = m_ingest_byte;
+  m_disk_byte_reported   = disk_byte;
+  m_disk_usec_reported   = disk_usec;
+  return ss.str();
+}
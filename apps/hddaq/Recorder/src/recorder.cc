@@ -91,6 +91,10 @@ int main(int argc, char* argv[])
   std::string nickname = NodeId::getNodeId(NODETYPE_REC, &nodeid);
 
   int rmode = REC_NORMAL;
+  bool async = false;
+  int async_buffer_mb = 64;
+  int async_nbuffer = 4;
+  int compress_threads = 1;
 
   for (int i = 1 ; i < argc ; i++) {
     if (strcmp(argv[i], "--ebport") == 0) {
@@ -129,9 +133,24 @@ int main(int argc, char* argv[])
 		  if (strcmp(argv[i], "--compress") == 0) {
 		    rmode = REC_COMPRESS;
 		    std::cout << "Data compress mode" << std::endl;
-		  } else {
-		    std::cout << "unknown option : " << argv[i] << std::endl;
-		  }
+		  } else
+		    if (strcmp(argv[i], "--async") == 0) {
+		      async = true;
+		    } else
+		      if (sscanf(argv[i], "--async-buffer-mb=%d", &val) == 1) {
+			async_buffer_mb = val;
+		      } else
+			if (sscanf(argv[i], "--async-buffers=%d", &val) == 1) {
+			  async_nbuffer = val;
+			} else
+			  if (sscanf(argv[i], "--compress-threads=%d", &val) == 1) {
+			    rmode = REC_COMPRESS;
+			    compress_threads = val;
+			    std::cout << "Data compress mode, "
+				      << val << " threads" << std::endl;
+			  } else {
+			    std::cout << "unknown option : " << argv[i] << std::endl;
+			  }
   }
 
   std::cout << "NODE ID : " << nodeid << std::endl;
@@ -155,6 +174,13 @@ int main(int argc, char* argv[])
     recorder.setName("$$ recorder");
     recorder.setDirectoryName(dir_name);
     recorder.setRecordMode(rmode);
+    recorder.setCompressThreads(compress_threads);
+    if (async) {
+      std::cout << "Async writer : " << async_nbuffer << " x "
+		<< async_buffer_mb << " MB buffers" << std::endl;
+      recorder.setAsyncWriter(static_cast<size_t>(async_buffer_mb) << 20,
+			      async_nbuffer);
+    }
     ControlThread controller;
     controller.setSlave(&recorder);
 
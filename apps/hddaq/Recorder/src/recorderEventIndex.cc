@@ -0,0 +1,92 @@
+// -*- C++ -*-
+
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "Recorder/recorderEventIndex.hh"
+
+//______________________________________________________________________________
+EventIndexer::EventIndexer(int run_number,
+			   std::string dir_name)
+  : m_filename(),
+    m_index(),
+    m_offset(0),
+    m_n_event(0),
+    m_restart()
+{
+  if(dir_name.empty()){
+    std::cerr << "#E dir name is empty" << std::endl;
+    return;
+  }
+  if (dir_name[dir_name.size()-1]!='/')
+    dir_name += "/";
+  dir_name += "bookmark/";
+  mkdir(dir_name.c_str(), 0755);
+  std::stringstream ss;
+  ss << "run" << std::setw(5) << std::setfill('0') << run_number
+     << "_index.dat";
+  m_filename = dir_name + ss.str();
+
+  std::ifstream index_exists(m_filename.c_str());
+  if (index_exists.good())
+    {
+      index_exists.close();
+      throw std::runtime_error("Index file already exists : "+m_filename);
+    }
+  m_index.open(m_filename.c_str(), std::ios::out | std::ios::binary);
+  if (m_index.fail())
+    std::cerr << "#E failed to open file: " << m_filename << std::endl;
+}
+
+//______________________________________________________________________________
+EventIndexer::~EventIndexer()
+{
+  if (m_index.is_open())
+    {
+      close();
+    }
+}
+
+//______________________________________________________________________________
+void
+EventIndexer::operator+=(unsigned long long size)
+{
+  m_index.write(reinterpret_cast<char*>(&m_offset), sizeof(uint64_t));
+  m_offset += size;
+  ++m_n_event;
+  return;
+}
+
+//______________________________________________________________________________
+void
+EventIndexer::restart(uint64_t raw_offset, uint64_t file_offset)
+{
+  m_restart.push_back(raw_offset);
+  m_restart.push_back(file_offset);
+  return;
+}
+
+//______________________________________________________________________________
+void
+EventIndexer::close()
+{
+  if (!m_restart.empty())
+    m_index.write(reinterpret_cast<char*>(&m_restart[0]),
+		  m_restart.size() * sizeof(uint64_t));
+
+  Trailer trailer;
+  trailer.m_magic     = k_magic;
+  trailer.m_version   = k_version;
+  trailer.m_n_event   = m_n_event;
+  trailer.m_n_restart = m_restart.size() / 2;
+  trailer.m_data_size = m_offset;
+  m_index.write(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+
+  m_index.flush();
+  m_index.close();
+  ::chmod(m_filename.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  return;
+}
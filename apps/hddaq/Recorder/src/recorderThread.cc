@@ -66,22 +66,37 @@
 
 #include "Recorder/recorderThread.h"
 #include "Recorder/OGZFileStream.hh"
+#include "Recorder/OPGZFileStream.hh"
 #include "EventBuilder/EventBuilder.h"
 #include "Message/Message.h"
 #include "Message/GlobalMessageClient.h"
 #include "Recorder/recorderBookmarker.hh"
+#include "Recorder/recorderEventIndex.hh"
 #include "Recorder/recorderLogger.hh"
+#include "Recorder/asyncWriter.hh"
 
 using namespace  hddaq::unpacker;
 
+namespace
+{
+  // seconds between two throughput reports of the async writer
+  const std::time_t k_report_interval = 10;
+  // raw bytes between two restart points of a single-threaded .gz file;
+  // a seek decompresses at most this much before reaching the event
+  const uint64_t k_restart_interval = 4*1024*1024;
+}
 
 RecorderThread::RecorderThread()
+  : m_async(false), m_async_buffer_byte(0), m_async_nbuffer(0),
+    m_compress_threads(1)
 {
   std::cerr << "Recorder Created" << std::endl;
 }
 
 RecorderThread::RecorderThread(std::string hostname, int port)
-  : m_port(port), m_hostname(hostname)
+  : m_port(port), m_hostname(hostname),
+    m_async(false), m_async_buffer_byte(0), m_async_nbuffer(0),
+    m_compress_threads(1)
 {
   std::cerr << "Recorder Created" << std::endl;
 }
@@ -119,6 +134,35 @@ int RecorderThread::getRecordMode()
   return m_rec_mode;
 }
 
+void RecorderThread::setAsyncWriter(size_t buffer_byte, int nbuffer)
+{
+  m_async = true;
+  m_async_buffer_byte = buffer_byte;
+  m_async_nbuffer = nbuffer;
+}
+
+void RecorderThread::setCompressThreads(int nthread)
+{
+  m_compress_threads = nthread;
+}
+
+std::ostream* RecorderThread::openCompressed(const std::string& fname,
+					     GZRestartListener* listener)
+{
+  if (m_compress_threads == 1) {
+    OGZFileStream *ofs = new OGZFileStream;
+    ofs->rdbuf()->set_restart(listener, k_restart_interval);
+    ofs->open(fname.c_str(), std::ios::out | std::ios::binary);
+    return ofs;
+  }
+
+  OPGZFileStream *ofs = new OPGZFileStream;
+  ofs->rdbuf()->set_parallel(m_compress_threads);
+  ofs->rdbuf()->set_restart(listener);
+  ofs->open(fname.c_str(), std::ios::out | std::ios::binary);
+  return ofs;
+}
+
 int RecorderThread::active_loop()
 {
 
@@ -130,6 +174,8 @@ int RecorderThread::active_loop()
 	    << m_port << std::endl;
   int run_number = getRunNumber();
   std::vector<unsigned int> data;
+  AsyncWriter *writer = 0;
+  EventIndexer *indexer = 0;
   try {
 
     std::cerr << "RUN NO: " << run_number << " ";
@@ -164,19 +210,31 @@ int RecorderThread::active_loop()
     m_state = RUNNING;
     m_event_number = 0;
 
+    // the compressed stream reports its restart points to the index
+    indexer = new EventIndexer(run_number, m_dir_name);
     std::ostream *ofsp = 0;
-    if (m_rec_mode == REC_COMPRESS) {
-      ofsp = new OGZFileStream(fname.c_str(), std::ios::out | std::ios::binary);
+    if (m_async) {
+      writer = new AsyncWriter(fname, (m_rec_mode == REC_COMPRESS
+				       ? openCompressed(fname, indexer) : 0),
+			       m_async_buffer_byte, m_async_nbuffer);
+      if (writer->good())
+	writer->start();
+    } else if (m_rec_mode == REC_COMPRESS) {
+      ofsp = openCompressed(fname, indexer);
     } else {
       ofsp = new std::ofstream(fname.c_str(), std::ios::out | std::ios::binary);
     }
-    if( !ofsp || !(*ofsp) || ofsp->fail() ){
+    if (writer ? !writer->good()
+	: ( !ofsp || !(*ofsp) || ofsp->fail() )) {
       std::ostringstream msgss;
       msgss << "Rec: unable to create or write file";
       std::cerr << msgss.str() << std::endl;
       msock.sendString(MT_ERROR, msgss.str());
+      delete writer;
+      delete indexer;
       return -1;
     }
+    std::time_t report_time = std::time(0);
     Logger logger(m_event_number,
 		  run_number, m_dir_name+"recorder.log");
     Bookmarker bookmarker(run_number, m_dir_name);
@@ -242,15 +300,45 @@ int RecorderThread::active_loop()
 	break;
 	}
       */
-      ofsp->write(reinterpret_cast<char *>(header), sizeof(header));
-      ofsp->write(reinterpret_cast<char *>(&data[0]), recv_byte);
+      if (writer) {
+	writer->write(header, sizeof(header));
+	writer->write(&data[0], recv_byte);
+      } else {
+	ofsp->write(reinterpret_cast<char *>(header), sizeof(header));
+	ofsp->write(reinterpret_cast<char *>(&data[0]), recv_byte);
+      }
       logger += (sizeof(header) + recv_byte);
       bookmarker += (sizeof(header) + recv_byte);
+      *indexer += (sizeof(header) + recv_byte);
       //std::cerr << '.';
       m_event_number++;
+
+      if (writer) {
+	if (!writer->good()) {
+	  std::string msg = "#E Rec: write error on " + fname;
+	  msock.sendString(MT_ERROR, msg);
+	  std::cerr << msg << std::endl;
+	  break;
+	}
+	if (std::time(0) - report_time >= k_report_interval) {
+	  msock.sendString(writer->statistics());
+	  report_time = std::time(0);
+	}
+      }
+    }
+    if (writer) {
+      writer->close();
+      msock.sendString(writer->statistics());
+      if (!writer->good())
+	msock.sendString(MT_ERROR, "#E Rec: write error on " + fname);
+      delete writer;
+      writer = 0;
     }
     delete ofsp;
     ofsp = 0;
+    indexer->close();
+    delete indexer;
+    indexer = 0;
     ::chmod(fname.c_str(), S_IRUSR | S_IRGRP | S_IROTH);
     std::cerr << "file   closed" << std::endl;
     client.close();
@@ -264,6 +352,9 @@ int RecorderThread::active_loop()
     std::cerr << e.what() << std::endl;
     std::string messageStr = "#ERR. Rec: " + std::string(e.what());
     msock.sendString(MT_ERROR, messageStr);
+    // let the writer thread flush what it already has
+    delete writer;
+    delete indexer;
   }
 
   std::cerr << "recorderThread: exited active_loop" << std::endl;
@@ -0,0 +1,197 @@
+/*
+ *  pgzbench: OGZFileStream vs OPGZFileStream write throughput
+ *
+ *  usage: pgzbench [total_MB] [nthread ...] [dir]
+ *         nthread 0 uses one thread per online CPU
+ *
+ *  Writes the same synthetic event stream (event headers followed by
+ *  TDC-like words with a few random low bits, compressible like detector
+ *  data) through the single-threaded OGZFileStream and through
+ *  OPGZFileStream with each given number of threads, then reads every
+ *  file back with gzread(), as IGZFileStream does, and compares it with
+ *  the original.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <zlib.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Recorder/OGZFileStream.hh"
+#include "Recorder/OPGZFileStream.hh"
+
+using namespace hddaq::unpacker;
+
+namespace
+{
+  const unsigned int MAGIC = 0x45564e54;
+
+  double now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+  }
+
+  // one event of nword words, reproducible from the event number
+  void makeEvent(unsigned int n, std::vector<unsigned int>& ev)
+  {
+    unsigned int nword = 64 + (n * 2654435761u >> 24);
+    ev.resize(nword);
+    ev[0] = MAGIC;
+    ev[1] = nword;
+    ev[2] = n;
+    unsigned int seed = n;
+    for (unsigned int i=3; i<nword; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      ev[i] = (i << 20) | (0x400 + ((seed >> 16) & 0x3f));
+    }
+  }
+
+  struct Result
+  {
+    double      elapse;
+    double      nbyte;
+    off_t       file_byte;
+    bool        good;
+  };
+
+  Result writeFile(std::ostream& ofs, double total_byte)
+  {
+    Result r;
+    std::vector<unsigned int> ev;
+    r.nbyte = 0;
+    double t0 = now();
+    for (unsigned int n=0; r.nbyte<total_byte; ++n) {
+      makeEvent(n, ev);
+      ofs.write(reinterpret_cast<char*>(&ev[0]),
+		ev.size() * sizeof(unsigned int));
+      r.nbyte += ev.size() * sizeof(unsigned int);
+    }
+    r.elapse = now() - t0;
+    return r;
+  }
+
+  bool verify(const std::string& fname, double nbyte)
+  {
+    gzFile gz = ::gzopen(fname.c_str(), "rb");
+    if (!gz)
+      return false;
+    std::vector<unsigned int> ev;
+    std::vector<unsigned int> buf;
+    double nread = 0;
+    bool good = true;
+    for (unsigned int n=0; nread<nbyte; ++n) {
+      makeEvent(n, ev);
+      buf.resize(ev.size());
+      int len = ev.size() * sizeof(unsigned int);
+      if (::gzread(gz, &buf[0], len) != len
+	  || std::memcmp(&buf[0], &ev[0], len) != 0) {
+	good = false;
+	break;
+      }
+      nread += len;
+    }
+    char extra;
+    if (good && ::gzread(gz, &extra, 1) != 0)
+      good = false;
+    ::gzclose(gz);
+    return good;
+  }
+
+  void print(const std::string& name, const Result& r)
+  {
+    std::cout << std::setw(16) << name
+	      << std::fixed << std::setprecision(2)
+	      << "  " << std::setw(7) << r.elapse << " s"
+	      << "  " << std::setw(8) << std::setprecision(1)
+	      << r.nbyte / r.elapse / 1e6 << " MB/s"
+	      << "  ratio " << std::setprecision(2)
+	      << r.nbyte / r.file_byte
+	      << "  read back " << (r.good ? "OK" : "ERROR")
+	      << std::endl;
+  }
+
+  off_t fileSize(const std::string& fname)
+  {
+    struct stat st;
+    if (::stat(fname.c_str(), &st) != 0)
+      return 0;
+    return st.st_size;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  double total_byte = (argc > 1 ? std::atof(argv[1]) : 256.) * 1e6;
+  std::vector<int> nthreads;
+  std::string dir = "/tmp";
+  for (int i=2; i<argc; ++i) {
+    if (argv[i][0] >= '0' && argv[i][0] <= '9')
+      nthreads.push_back(std::atoi(argv[i]));
+    else
+      dir = argv[i];
+  }
+  if (nthreads.empty()) {
+    nthreads.push_back(0);
+  }
+
+  std::cout << "total " << total_byte / 1e6 << " MB"
+	    << "  online CPUs " << ::sysconf(_SC_NPROCESSORS_ONLN)
+	    << std::endl;
+
+  int nerr = 0;
+  {
+    std::string fname = dir + "/pgzbench_ogz.dat.gz";
+    Result r;
+    {
+      OGZFileStream ofs(fname.c_str(), std::ios::out | std::ios::binary);
+      r = writeFile(ofs, total_byte);
+      double t0 = now();
+      ofs.close();
+      r.elapse += now() - t0;
+    }
+    r.file_byte = fileSize(fname);
+    r.good = verify(fname, r.nbyte);
+    print("OGZFileStream", r);
+    nerr += !r.good;
+    ::unlink(fname.c_str());
+  }
+
+  // gzopen("wb") behind OGZFileStream uses the zlib default level, the
+  // parallel stream is compared both at that level and at its default
+  for (std::size_t i=0; i<2*nthreads.size(); ++i) {
+    int  nthread = nthreads[i/2];
+    bool level6  = (i % 2 == 0);
+    std::ostringstream name;
+    name << "OPGZ " << nthread << (nthread ? " thr" : " auto")
+	 << (level6 ? " -6" : " -1");
+    std::string fname = dir + "/pgzbench_opgz.dat.gz";
+    Result r;
+    {
+      OPGZFileStream ofs;
+      ofs.rdbuf()->set_parallel(nthread);
+      if (level6)
+	ofs.rdbuf()->set_compression(Z_DEFAULT_COMPRESSION);
+      ofs.open(fname.c_str(), std::ios::out | std::ios::binary);
+      r = writeFile(ofs, total_byte);
+      double t0 = now();
+      ofs.close();
+      r.elapse += now() - t0;
+    }
+    r.file_byte = fileSize(fname);
+    r.good = verify(fname, r.nbyte);
+    print(name.str(), r);
+    nerr += !r.good;
+    ::unlink(fname.c_str());
+  }
+
+  return nerr ? 1 : 0;
+}
@@ -50,27 +50,41 @@ class RingBuffer {
 public:
   // constructor/destructor
   RingBuffer(int buflen, int quelen=20);
-  ~RingBuffer();
+  virtual ~RingBuffer();
 
   // extructor
-  EventBuffer* readBufPeek();
-  EventBuffer* writeBufPeek();
+  virtual EventBuffer* readBufPeek();
+  virtual EventBuffer* writeBufPeek();
+  // Two-stage read for consumers which keep several slots at once:
+  // readBufAcquire() hands out the filled slots in order and
+  // readBufFree() gives back the oldest acquired one, possibly from
+  // another thread. Do not mix with readBufPeek/readBufRelease.
+  virtual EventBuffer* readBufAcquire();
+  virtual int          readBufFree();
+  // Two-stage write for producers which fill several slots at once:
+  // writeBufAcquire() hands out the empty slots in order and
+  // writeBufCommit() publishes the oldest acquired one, possibly from
+  // another thread. Do not mix with writeBufPeek/writeBufRelease.
+  virtual EventBuffer* writeBufAcquire();
+  virtual int          writeBufCommit();
 
   // method
-  void initBuffer();
-  int  readBufRelease();
-  int  writeBufRelease();
-  int  left();
+  virtual void initBuffer();
+  virtual int  readBufRelease();
+  virtual int  writeBufRelease();
+  virtual int  left();
   int  depth();
   int  BufSize();
-  int  trywaitFill();
-  int  trywaitEmpty();
+  virtual int  trywaitFill();
+  virtual int  trywaitEmpty();
 
 protected:
   int m_quelen;
   int m_buflen;
   int m_write_ptr;
   int m_read_ptr;
+  int m_acq_ptr;
+  int m_wacq_ptr;
   int m_len;
   kol::Semaphore m_empty;
   kol::Semaphore m_filled;
@@ -81,4 +95,9 @@ protected:
   
 };
 
+// Returns a SpscRingBuffer when lockfree is true, a RingBuffer otherwise.
+// The default follows the USE_SPSC_RINGBUFFER compile flag.
+RingBuffer* newRingBuffer(int buflen, int quelen, bool lockfree);
+RingBuffer* newRingBuffer(int buflen, int quelen);
+
 #endif
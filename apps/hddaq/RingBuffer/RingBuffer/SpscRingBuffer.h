@@ -0,0 +1,83 @@
+// -*- C++ -*-
+/**
+ *  @file   SpscRingBuffer.h
+ *  @brief  lock-free single-producer/single-consumer RingBuffer
+ *
+ *  Same peek/release interface as RingBuffer, but the hand-over between
+ *  the producer and the consumer is done with two atomic indices instead
+ *  of a pair of semaphores and the read/write mutex. A waiting side spins
+ *  for a while, then yields, and finally parks on a futex. The other side
+ *  issues the wake-up system call only when somebody is actually parked,
+ *  so in the steady state no system call is made per event.
+ *
+ *  The indices run over [0, 2*quelen) so that all quelen slots can be
+ *  used: the ring is empty when both are equal and full when they differ
+ *  by quelen.
+ */
+#ifndef SPSC_RINGBUFFER_H
+#define SPSC_RINGBUFFER_H
+
+#include "RingBuffer/RingBuffer.h"
+
+////
+class SpscRingBuffer : public RingBuffer {
+public:
+  static const int CACHE_LINE  = 64;
+  // spinning is skipped on a single CPU, where it only delays the peer
+  static const int SPIN_COUNT  = 2000;
+  static const int YIELD_COUNT = 100;
+  static const long PARK_TIMEOUT_NS = 100000000;
+
+public:
+  // constructor/destructor
+  SpscRingBuffer(int buflen, int quelen=20);
+  virtual ~SpscRingBuffer();
+
+  // extructor
+  virtual EventBuffer* readBufPeek();
+  virtual EventBuffer* writeBufPeek();
+  virtual EventBuffer* readBufAcquire();
+  virtual int          readBufFree();
+  // the committing thread must be ordered after the acquiring one
+  virtual EventBuffer* writeBufAcquire();
+  virtual int          writeBufCommit();
+
+  // method
+  virtual void initBuffer();
+  virtual int  readBufRelease();
+  virtual int  writeBufRelease();
+  virtual int  left();
+  // 0 when a slot is ready; unlike the semaphore version nothing is taken
+  virtual int  trywaitFill();
+  virtual int  trywaitEmpty();
+
+  // number of times a side gave up spinning and slept in the kernel
+  unsigned long parkCount() const;
+
+private:
+  int  index(int ptr) const { return ptr<m_quelen ? ptr : ptr-m_quelen; }
+  int  advance(int ptr) const { return ptr+1==2*m_quelen ? 0 : ptr+1; }
+  int  count(int wr, int rd) const;
+  void backoff(int round, int* word, int seen, int* waiting,
+	       unsigned long* nparks);
+  void wake(int* word, int* waiting);
+
+  int  m_spin;
+
+  // producer owned
+  char m_pad0[CACHE_LINE];
+  int  m_wacq;
+  int  m_wr;
+  int  m_wr_waiting; // consumer is parked on m_wr
+  unsigned long m_wr_parks;
+
+  // consumer owned
+  char m_pad1[CACHE_LINE];
+  int  m_acq;
+  int  m_rd;
+  int  m_rd_waiting; // producer is parked on m_rd
+  unsigned long m_rd_parks;
+  char m_pad2[CACHE_LINE];
+};
+
+#endif
@@ -42,6 +42,7 @@
 
 #include <iostream>
 #include "RingBuffer/RingBuffer.h"
+#include "RingBuffer/SpscRingBuffer.h"
 
 #define GLOBAL_LOCK
 
@@ -51,6 +52,8 @@ RingBuffer::RingBuffer(int buflen, int quelen)
     m_buflen(buflen),
     m_write_ptr(0),
     m_read_ptr(0),
+    m_acq_ptr(0),
+    m_wacq_ptr(0),
     m_len(0),
     m_empty(quelen),
     m_filled(0)
@@ -86,6 +89,8 @@ RingBuffer::initBuffer()
   m_rwlock.lock();
   m_write_ptr = 0;
   m_read_ptr  = 0;
+  m_acq_ptr   = 0;
+  m_wacq_ptr  = 0;
   m_len       = 0;
   m_empty     = m_quelen;
   m_filled    = 0;
@@ -115,6 +120,25 @@ RingBuffer::readBufRelease() {
   return 0;
 }
 
+////
+EventBuffer*
+RingBuffer::readBufAcquire()
+{
+  m_filled.wait();
+  m_rwlock.lock();
+  EventBuffer* buf = m_buf[m_acq_ptr];
+  m_acq_ptr = (m_acq_ptr + 1)%m_quelen;
+  m_rwlock.unlock();
+  return buf;
+}
+
+////
+int
+RingBuffer::readBufFree()
+{
+  return readBufRelease();
+}
+
 ////
 EventBuffer*
 RingBuffer::writeBufPeek() {
@@ -135,6 +159,25 @@ RingBuffer::writeBufRelease() {
   return 0;
 }
 
+////
+EventBuffer*
+RingBuffer::writeBufAcquire()
+{
+  m_empty.wait();
+  m_rwlock.lock();
+  EventBuffer* buf = m_buf[m_wacq_ptr];
+  m_wacq_ptr = (m_wacq_ptr + 1)%m_quelen;
+  m_rwlock.unlock();
+  return buf;
+}
+
+////
+int
+RingBuffer::writeBufCommit()
+{
+  return writeBufRelease();
+}
+
 int RingBuffer::left()
 {
   return m_len;
@@ -159,3 +202,21 @@ int RingBuffer::trywaitEmpty()
 {
   return m_empty.trywait();
 }
+
+////
+RingBuffer* newRingBuffer(int buflen, int quelen, bool lockfree)
+{
+  if (lockfree)
+    return new SpscRingBuffer(buflen, quelen);
+  return new RingBuffer(buflen, quelen);
+}
+
+////
+RingBuffer* newRingBuffer(int buflen, int quelen)
+{
+#ifdef USE_SPSC_RINGBUFFER
+  return newRingBuffer(buflen, quelen, true);
+#else
+  return newRingBuffer(buflen, quelen, false);
+#endif
+}
@@ -0,0 +1,237 @@
+// -*- C++ -*-
+/**
+ *  @file   SpscRingBuffer.cc
+ *  @brief  lock-free single-producer/single-consumer RingBuffer
+ */
+
+#include <climits>
+#include <ctime>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "RingBuffer/SpscRingBuffer.h"
+
+namespace
+{
+  inline void cpu_relax()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+  }
+
+  inline void futex_wait(int* addr, int val, long timeout_ns)
+  {
+    struct timespec ts;
+    ts.tv_sec  = timeout_ns / 1000000000L;
+    ts.tv_nsec = timeout_ns % 1000000000L;
+    ::syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, &ts, 0, 0);
+  }
+
+  inline void futex_wake(int* addr)
+  {
+    ::syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, 0, 0, 0);
+  }
+}
+
+////
+SpscRingBuffer::SpscRingBuffer(int buflen, int quelen)
+  : RingBuffer(buflen, quelen),
+    m_spin(::sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPIN_COUNT : 0),
+    m_wacq(0),
+    m_wr(0),
+    m_wr_waiting(0),
+    m_wr_parks(0),
+    m_acq(0),
+    m_rd(0),
+    m_rd_waiting(0),
+    m_rd_parks(0)
+{
+}
+
+////
+SpscRingBuffer::~SpscRingBuffer()
+{
+}
+
+////
+int
+SpscRingBuffer::count(int wr, int rd) const
+{
+  int n = wr - rd;
+  return n<0 ? n + 2*m_quelen : n;
+}
+
+////
+void
+SpscRingBuffer::backoff(int round, int* word, int seen, int* waiting,
+			unsigned long* nparks)
+{
+  if (round < m_spin) {
+    cpu_relax();
+    return;
+  }
+  if (round < m_spin + YIELD_COUNT) {
+    ::sched_yield();
+    return;
+  }
+
+  // Announce ourselves before the last check. Together with the
+  // seq_cst store/load pair in wake() this guarantees that either we
+  // see the new index or the other side sees the flag.
+  __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(word, __ATOMIC_SEQ_CST) == seen) {
+    ++(*nparks);
+    futex_wait(word, seen, PARK_TIMEOUT_NS);
+  }
+  __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+}
+
+////
+void
+SpscRingBuffer::wake(int* word, int* waiting)
+{
+  if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST))
+    futex_wake(word);
+}
+
+////
+void
+SpscRingBuffer::initBuffer()
+{
+  __atomic_store_n(&m_wr, 0, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&m_rd, 0, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&m_acq, 0, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&m_wacq, 0, __ATOMIC_SEQ_CST);
+  for(int i=0; i<m_quelen; i++)
+    m_buf[i]->clear();
+  futex_wake(&m_wr);
+  futex_wake(&m_rd);
+}
+
+////
+EventBuffer*
+SpscRingBuffer::readBufPeek()
+{
+  int rd = __atomic_load_n(&m_rd, __ATOMIC_RELAXED);
+  for (int round=0;; ++round) {
+    int wr = __atomic_load_n(&m_wr, __ATOMIC_ACQUIRE);
+    if (wr != rd)
+      break;
+    backoff(round, &m_wr, wr, &m_wr_waiting, &m_rd_parks);
+    rd = __atomic_load_n(&m_rd, __ATOMIC_RELAXED);
+  }
+  return m_buf[index(rd)];
+}
+
+////
+int
+SpscRingBuffer::readBufRelease()
+{
+  int rd = __atomic_load_n(&m_rd, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_rd, advance(rd), __ATOMIC_SEQ_CST);
+  wake(&m_rd, &m_rd_waiting);
+  return 0;
+}
+
+////
+EventBuffer*
+SpscRingBuffer::readBufAcquire()
+{
+  int acq = __atomic_load_n(&m_acq, __ATOMIC_RELAXED);
+  for (int round=0;; ++round) {
+    int wr = __atomic_load_n(&m_wr, __ATOMIC_ACQUIRE);
+    if (wr != acq)
+      break;
+    backoff(round, &m_wr, wr, &m_wr_waiting, &m_rd_parks);
+  }
+  __atomic_store_n(&m_acq, advance(acq), __ATOMIC_RELAXED);
+  return m_buf[index(acq)];
+}
+
+////
+int
+SpscRingBuffer::readBufFree()
+{
+  return readBufRelease();
+}
+
+////
+EventBuffer*
+SpscRingBuffer::writeBufPeek()
+{
+  int wr = __atomic_load_n(&m_wr, __ATOMIC_RELAXED);
+  for (int round=0;; ++round) {
+    int rd = __atomic_load_n(&m_rd, __ATOMIC_ACQUIRE);
+    if (count(wr, rd) < m_quelen)
+      break;
+    backoff(round, &m_rd, rd, &m_rd_waiting, &m_wr_parks);
+    wr = __atomic_load_n(&m_wr, __ATOMIC_RELAXED);
+  }
+  return m_buf[index(wr)];
+}
+
+////
+int
+SpscRingBuffer::writeBufRelease()
+{
+  int wr = __atomic_load_n(&m_wr, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_wr, advance(wr), __ATOMIC_SEQ_CST);
+  wake(&m_wr, &m_wr_waiting);
+  return 0;
+}
+
+////
+EventBuffer*
+SpscRingBuffer::writeBufAcquire()
+{
+  int wacq = __atomic_load_n(&m_wacq, __ATOMIC_RELAXED);
+  for (int round=0;; ++round) {
+    int rd = __atomic_load_n(&m_rd, __ATOMIC_ACQUIRE);
+    if (count(wacq, rd) < m_quelen)
+      break;
+    backoff(round, &m_rd, rd, &m_rd_waiting, &m_wr_parks);
+  }
+  __atomic_store_n(&m_wacq, advance(wacq), __ATOMIC_RELAXED);
+  return m_buf[index(wacq)];
+}
+
+////
+int
+SpscRingBuffer::writeBufCommit()
+{
+  return writeBufRelease();
+}
+
+////
+int
+SpscRingBuffer::left()
+{
+  return count(__atomic_load_n(&m_wr, __ATOMIC_ACQUIRE),
+	       __atomic_load_n(&m_rd, __ATOMIC_ACQUIRE));
+}
+
+////
+int
+SpscRingBuffer::trywaitFill()
+{
+  return left() > 0 ? 0 : -1;
+}
+
+////
+int
+SpscRingBuffer::trywaitEmpty()
+{
+  return left() < m_quelen ? 0 : -1;
+}
+
+////
+unsigned long
+SpscRingBuffer::parkCount() const
+{
+  return m_wr_parks + m_rd_parks;
+}
@@ -0,0 +1,110 @@
+/*
+ *  rbbench: producer -> consumer throughput of RingBuffer vs SpscRingBuffer
+ *
+ *  usage: rbbench [nevent] [event_byte] [quelen]
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <iostream>
+#include <iomanip>
+
+#include "kol/kolthread.h"
+#include "RingBuffer/RingBuffer.h"
+#include "RingBuffer/SpscRingBuffer.h"
+
+class Producer : public kol::Thread
+{
+public:
+  Producer(RingBuffer* rb, int nevent, int len)
+    : m_rb(rb), m_nevent(nevent), m_len(len) {}
+protected:
+  int run()
+  {
+    for (int i=0; i<m_nevent; ++i) {
+      EventBuffer* ev = m_rb->writeBufPeek();
+      unsigned int* p = reinterpret_cast<unsigned int*>(ev->getBuf());
+      p[0] = i;
+      p[m_len/sizeof(unsigned int) - 1] = i;
+      m_rb->writeBufRelease();
+    }
+    return 0;
+  }
+private:
+  RingBuffer* m_rb;
+  int m_nevent;
+  int m_len;
+};
+
+static double now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static long nctxsw()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_nvcsw + ru.ru_nivcsw;
+}
+
+static int bench(const char* name, RingBuffer* rb, int nevent, int len)
+{
+  rb->initBuffer();
+  Producer producer(rb, nevent, len);
+
+  long   csw0 = nctxsw();
+  double t0   = now();
+  producer.start();
+
+  int nerr = 0;
+  for (int i=0; i<nevent; ++i) {
+    EventBuffer* ev = rb->readBufPeek();
+    unsigned int* p = reinterpret_cast<unsigned int*>(ev->getBuf());
+    if (p[0] != (unsigned int)i || p[len/sizeof(unsigned int) - 1] != (unsigned int)i)
+      ++nerr;
+    rb->readBufRelease();
+  }
+  producer.join();
+  double elapse = now() - t0;
+  long   csw    = nctxsw() - csw0;
+
+  std::cout << std::setw(12) << name
+	    << std::fixed << std::setprecision(3)
+	    << "  " << std::setw(8) << elapse << " s"
+	    << "  " << std::setw(10) << std::setprecision(1)
+	    << nevent / elapse / 1000. << " kHz"
+	    << "  ctx-switch " << std::setw(8) << csw;
+  SpscRingBuffer* spsc = dynamic_cast<SpscRingBuffer*>(rb);
+  if (spsc)
+    std::cout << "  park " << spsc->parkCount();
+  if (nerr)
+    std::cout << "  ERROR " << nerr << " events corrupted";
+  std::cout << std::endl;
+  return nerr;
+}
+
+int main(int argc, char* argv[])
+{
+  int nevent = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  int len    = argc > 2 ? std::atoi(argv[2]) : 64;
+  int quelen = argc > 3 ? std::atoi(argv[3]) : 20;
+  if (len < (int)sizeof(unsigned int)) len = sizeof(unsigned int);
+
+  std::cout << "nevent " << nevent << "  event " << len << " B"
+	    << "  quelen " << quelen << std::endl;
+
+  RingBuffer     sem(len, quelen);
+  SpscRingBuffer spsc(len, quelen);
+
+  int nerr = 0;
+  nerr += bench("semaphore", &sem, nevent, len);
+  nerr += bench("spsc", &spsc, nevent, len);
+
+  return nerr ? 1 : 0;
+}
@@ -6,3 +6,5 @@ CXXFLAGS	:= -O2 -Wall
 
 INCLUDES 	:= -I.
 LIBS		:= -lpthread -lrt
+# lock-free ring buffers between reader/builder/sender by default
+# CXXFLAGS	+= -DUSE_SPSC_RINGBUFFER
@@ -14,6 +14,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #endif /* WIN32 */
 
 #ifndef SHUT_RD
@@ -115,6 +116,9 @@ namespace kol
     Socket accept(struct sockaddr* addr=0, socklen_t* addrlen=0);
     int send(const void* buf, size_t len, int flags=0);
     int recv(void* buf, size_t len, int flags=0);
+#ifndef WIN32
+    int sendmsg(const struct msghdr* msg, int flags=0);
+#endif /* WIN32 */
     int sendto(const void* buf, size_t len, int flags, const struct sockaddr* to, socklen_t tolen);
     int recvfrom(void* buf, size_t len, int flags, struct sockaddr* from, socklen_t* fromlen);
     int shutdown(int how=SHUT_RDWR);
@@ -1,8 +1,18 @@
 #ifndef MYTCP_H_INCLUDED
 #define MYTCP_H_INCLUDED
 
+#include <vector>
 #include "kolsocket.h"
 
+// 17-Oct-2026
+//  - read() copies the buffered bytes with memcpy and receives the rest
+//    directly into the user buffer, also when get() or getline() left
+//    data in the read buffer. ignore() discards in bulk (MSG_TRUNC on
+//    Linux) instead of byte by byte.
+//  - The size of the read buffer can be changed with setrbufsize().
+//  - writev() was added for gather writes. The iovec array is consumed
+//    as data is sent so that a call interrupted by a time-out can be
+//    resumed without sending anything twice.
 // 08-Jun-2007
 //  - getsockname() and getpeername() functions were added in TcpBuffer.
 // 16-Nov-2006
@@ -36,6 +46,9 @@ namespace kol
     TcpBuffer& put(int c);
     TcpBuffer& write(const void* buf, std::streamsize len);
     TcpBuffer& send(const void* buf, std::streamsize len, int flags);
+#ifndef WIN32
+    TcpBuffer& writev(struct iovec* iov, int iovcnt);
+#endif /* WIN32 */
     TcpBuffer& flush();
     virtual int shutdown(int how=SHUT_RDWR);
     int getsockname(struct sockaddr* name, socklen_t* namelen) const;
@@ -43,6 +56,8 @@ namespace kol
     int getsockopt(int level, int optname, void* optval, socklen_t* optlen) const;
     int setsockopt(int level, int optname, const void* optval, socklen_t optlen);
     std::streamsize gcount() const { return m_gcount; }
+    size_t rbufsize() const { return m_rbufmax; }
+    void setrbufsize(size_t size);
     bool good() const { return (m_iostate == goodbit); }
     bool eof() const { return ((m_iostate & eofbit) != 0); }
     bool fail() const { return ((m_iostate & (failbit | badbit)) != 0); }
@@ -58,6 +73,7 @@ namespace kol
     int sync();
     void initparams();
     int recv_all(unsigned char* buf, int nbytes);
+    std::streamsize discard_all(std::streamsize nbytes);
     int send_all(const unsigned char* buf, int nbytes);
     int send_all(const unsigned char* buf, int nbytes, int flag);
   private:
@@ -71,7 +87,7 @@ namespace kol
     size_t m_rbufmax;
     size_t m_rbuflen;
     size_t m_rbufnxt;
-    unsigned char m_rbuf[bufsize];
+    std::vector<unsigned char> m_rbuf;
     size_t m_sbufmax;
     size_t m_sbuflen;
     size_t m_sbufnxt;
@@ -291,6 +291,17 @@ Socket::recv(void* buf, size_t len, int flags)
   return n;
 }
 
+#ifndef WIN32
+int
+Socket::sendmsg(const struct msghdr* msg, int flags)
+{
+  int n;
+  if((n = ::sendmsg(m_sd, msg, flags)) == sockerr)
+    throw SocketException("Socket::sendmsg error");
+  return n;
+}
+#endif /* WIN32 */
+
 int
 Socket::recvfrom(void* buf, size_t len, int flags, struct sockaddr* from, socklen_t* fromlen)
 {
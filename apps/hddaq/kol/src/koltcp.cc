@@ -10,6 +10,7 @@
 #include <ws2tcpip.h>
 #else
 #include <string.h>
+#include <limits.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #endif /* !WIN32 */
@@ -43,6 +44,7 @@ TcpBuffer::initparams()
   m_gcount = 0;
   m_iostate = goodbit;
   m_rbufmax = bufsize;
+  m_rbuf.resize(m_rbufmax);
   m_rbuflen = 0;
   m_rbufnxt = 0;
   m_sbufmax = bufsize;
@@ -64,6 +66,23 @@ TcpBuffer::shutdown(int how)
   return m_socket.shutdown(how);
 }
 
+void
+TcpBuffer::setrbufsize(size_t size)
+{
+  // keep the bytes not yet consumed at the head of the new buffer
+  size_t nleft = (m_rbufnxt < m_rbuflen) ? (m_rbuflen - m_rbufnxt) : 0;
+  if((nleft > 0) && (m_rbufnxt > 0))
+    memmove(&m_rbuf[0], &m_rbuf[m_rbufnxt], nleft);
+  m_rbuflen = nleft;
+  m_rbufnxt = 0;
+  if(size < nleft)
+    size = nleft;
+  if(size == 0)
+    size = 1;
+  m_rbuf.resize(size);
+  m_rbufmax = size;
+}
+
 int
 TcpBuffer::getsockname(struct sockaddr* name, socklen_t* namelen) const
 {
@@ -125,6 +144,45 @@ TcpBuffer::recv_all(unsigned char* buf, int nbytes)
   return (nbytes - nleft);
 }
 
+std::streamsize
+TcpBuffer::discard_all(std::streamsize nbytes)
+{
+  std::streamsize nleft = nbytes;
+
+  try
+  {
+    while( nleft > 0 )
+    {
+      size_t len = (nleft < INT_MAX) ? (size_t)nleft : (size_t)INT_MAX;
+#ifdef __linux__
+      // TCP drops the data in the kernel without copying it
+      int nrecv = m_socket.recv( 0, len, MSG_TRUNC );
+#else
+      if( len > m_rbufmax )
+        len = m_rbufmax;
+      int nrecv = m_socket.recv( &m_rbuf[0], len );
+#endif
+      if( nrecv < 0 )
+      {
+        m_iostate |= badbit;
+        break;
+      }
+      else if( nrecv == 0 )
+      {
+        m_iostate |= (eofbit | failbit);
+        break;
+      }
+      nleft -= nrecv;
+    }
+  }
+  catch(...)
+  {
+    m_iostate |= badbit;
+    throw;
+  }
+  return (nbytes - nleft);
+}
+
 int
 TcpBuffer::send_all(const unsigned char* buf, int nbytes)
 {
@@ -191,20 +249,23 @@ TcpBuffer::read(char* buf, std::streamsize len)
     return *this;
   std::streamsize n = 0;
 
-  if(m_rbuflen == 0)
+  // bytes left by get() or getline() first, then straight from the socket
+  if(m_rbufnxt < m_rbuflen)
   {
-    int nr = recv_all((unsigned char*)buf, (int)len);
-    m_gcount = nr;
-    return *this;
+    std::streamsize nbuf = m_rbuflen - m_rbufnxt;
+    n = (len < nbuf) ? len : nbuf;
+    memcpy(buf, &m_rbuf[m_rbufnxt], n);
+    m_rbufnxt += n;
+    m_gcount = n;
+    if(n == len)
+      return *this;
   }
+  m_rbuflen = 0;
+  m_rbufnxt = 0;
 
-  for(n = 0; n < len; n++)
-  {
-    int c;
-    if((c = get()) == std::char_traits<char>::eof())
-      break;
-    *buf++ = (c & 255);
-  }
+  int nr = recv_all((unsigned char*)buf + n, (int)(len - n));
+  if(nr > 0)
+    n += nr;
   m_gcount = n;
   return *this;
 }
@@ -215,14 +276,21 @@ TcpBuffer::ignore(std::streamsize len)
   m_gcount = 0;
   if(len == 0)
     return *this;
-
   std::streamsize n = 0;
-  for(n = 0; n < len; n++)
+
+  if(m_rbufnxt < m_rbuflen)
   {
-    int c;
-    if((c = get()) == std::char_traits<char>::eof())
-      break;
+    std::streamsize nbuf = m_rbuflen - m_rbufnxt;
+    n = (len < nbuf) ? len : nbuf;
+    m_rbufnxt += n;
+    m_gcount = n;
+    if(n == len)
+      return *this;
   }
+  m_rbuflen = 0;
+  m_rbufnxt = 0;
+
+  n += discard_all(len - n);
   m_gcount = n;
   return *this;
 }
@@ -257,6 +325,55 @@ TcpBuffer::send(const void* buf, std::streamsize len, int flag)
   return *this;
 }
 
+#ifndef WIN32
+TcpBuffer&
+TcpBuffer::writev(struct iovec* iov, int iovcnt)
+{
+  flush();
+  while(iovcnt > 0)
+  {
+    if(iov->iov_len == 0)
+    {
+      ++iov;
+      --iovcnt;
+      continue;
+    }
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (iovcnt < IOV_MAX) ? iovcnt : IOV_MAX;
+    try
+    {
+      int nsend = m_socket.sendmsg(&msg, MSG_NOSIGNAL);
+      if(nsend <= 0)
+      {
+        m_iostate |= badbit;
+        break;
+      }
+      size_t n = nsend;
+      while((iovcnt > 0) && (n >= iov->iov_len))
+      {
+        n -= iov->iov_len;
+        iov->iov_len = 0;
+        ++iov;
+        --iovcnt;
+      }
+      if(n > 0)
+      {
+        iov->iov_base = (char*)iov->iov_base + n;
+        iov->iov_len -= n;
+      }
+    }
+    catch(...)
+    {
+      m_iostate |= badbit;
+      throw;
+    }
+  }
+  return *this;
+}
+#endif /* WIN32 */
+
 int
 TcpBuffer::get()
 {
@@ -268,7 +385,7 @@ TcpBuffer::get()
     {
       m_rbuflen = 0;
       m_rbufnxt = 0;
-      int n = m_socket.recv(m_rbuf, m_rbufmax);
+      int n = m_socket.recv(&m_rbuf[0], m_rbufmax);
       if(n <= 0)
       {
         m_gcount = 0;
@@ -0,0 +1,181 @@
+/*
+ *  tcpbench: TcpBuffer read()/ignore() throughput over a loopback socket
+ *
+ *  usage: tcpbench [nevent] [body_byte] [oversize_every] [rbufsize] [port]
+ *
+ *  A server thread sends a short text line followed by nevent frames of
+ *  an 8 byte header and a body. Every oversize_every-th frame is twice
+ *  as long as the receive buffer and its tail has to be skipped, as the
+ *  EventBuilder readers do for oversized fragments. The line is read with
+ *  getline(), which leaves the first frames in the TcpBuffer read buffer.
+ *
+ *  "bulk" uses read()/ignore(); "per-byte" does the same through get(),
+ *  which is what read() and ignore() used to fall back to as soon as the
+ *  read buffer was not empty.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "kol/koltcp.h"
+#include "kol/kolthread.h"
+
+namespace
+{
+  const unsigned int MAGIC = 0x45564e54;
+
+  struct Param
+  {
+    int nevent;
+    int body;
+    int oversize;
+    int rbufsize;
+    int port;
+  };
+
+  double now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+  }
+
+  int frameWords(const Param& p, int i)
+  {
+    int nword = p.body / sizeof(unsigned int);
+    if (p.oversize > 0 && i % p.oversize == p.oversize - 1)
+      nword *= 2;
+    return nword;
+  }
+}
+
+class Sender : public kol::Thread
+{
+public:
+  Sender(kol::TcpServer& server, const Param& p)
+    : m_server(server), m_p(p) {}
+protected:
+  int run()
+  {
+    kol::TcpSocket sock = m_server.accept();
+    std::vector<unsigned int> frame(2 + 2 * m_p.body / sizeof(unsigned int));
+    sock.write("tcpbench\n", 9);
+    for (int i=0; i<m_p.nevent; ++i) {
+      int nword = frameWords(m_p, i);
+      frame[0] = MAGIC;
+      frame[1] = nword;
+      frame[2] = i;
+      frame[1 + nword] = i;
+      sock.write(&frame[0], (2 + nword) * sizeof(unsigned int));
+    }
+    sock.close();
+    return 0;
+  }
+private:
+  kol::TcpServer& m_server;
+  Param m_p;
+};
+
+static void perByteRead(kol::TcpBuffer& sock, char* buf, std::streamsize len)
+{
+  for (std::streamsize n=0; n<len; ++n) {
+    int c = sock.get();
+    if (c == std::char_traits<char>::eof())
+      break;
+    buf[n] = c & 255;
+  }
+}
+
+static void perByteIgnore(kol::TcpBuffer& sock, std::streamsize len)
+{
+  for (std::streamsize n=0; n<len; ++n)
+    if (sock.get() == std::char_traits<char>::eof())
+      break;
+}
+
+static int bench(const char* name, const Param& p, bool bulk)
+{
+  kol::TcpServer server(p.port);
+  Sender sender(server, p);
+  sender.start();
+
+  kol::TcpClient client("127.0.0.1", p.port);
+  if (p.rbufsize > 0)
+    client.setrbufsize(p.rbufsize);
+
+  double t0 = now();
+  char line[64];
+  client.getline(line, sizeof(line));
+
+  std::vector<unsigned int> body(p.body / sizeof(unsigned int));
+  std::streamsize capacity = body.size() * sizeof(unsigned int);
+  double nbyte = 0;
+  int nerr = 0;
+  for (int i=0; i<p.nevent; ++i) {
+    unsigned int header[2];
+    if (bulk)
+      client.read(reinterpret_cast<char*>(header), sizeof(header));
+    else
+      perByteRead(client, reinterpret_cast<char*>(header), sizeof(header));
+    if (header[0] != MAGIC) {
+      std::cerr << "#E bad magic at event " << i << std::endl;
+      ++nerr;
+      break;
+    }
+    std::streamsize len  = header[1] * sizeof(unsigned int);
+    std::streamsize rest = len > capacity ? len - capacity : 0;
+    if (rest)
+      len = capacity;
+    char* p_body = reinterpret_cast<char*>(&body[0]);
+    if (bulk) {
+      client.read(p_body, len);
+      if (rest) client.ignore(rest);
+    } else {
+      perByteRead(client, p_body, len);
+      if (rest) perByteIgnore(client, rest);
+    }
+    if (body[0] != (unsigned int)i
+	|| (!rest && body[header[1] - 1] != (unsigned int)i))
+      ++nerr;
+    nbyte += sizeof(header) + len + rest;
+  }
+  double elapse = now() - t0;
+  sender.join();
+
+  std::cout << std::setw(10) << name
+	    << std::fixed << std::setprecision(3)
+	    << "  " << std::setw(8) << elapse << " s"
+	    << "  " << std::setw(10) << std::setprecision(1)
+	    << nbyte / elapse / 1e6 << " MB/s";
+  if (nerr)
+    std::cout << "  ERROR " << nerr << " frames corrupted";
+  std::cout << std::endl;
+  return nerr;
+}
+
+int main(int argc, char* argv[])
+{
+  Param p;
+  p.nevent   = argc > 1 ? std::atoi(argv[1]) : 20000;
+  p.body     = argc > 2 ? std::atoi(argv[2]) : 64 * 1024;
+  p.oversize = argc > 3 ? std::atoi(argv[3]) : 10;
+  p.rbufsize = argc > 4 ? std::atoi(argv[4]) : 0;
+  p.port     = argc > 5 ? std::atoi(argv[5]) : 19800;
+  if (p.body < (int)sizeof(unsigned int)) p.body = sizeof(unsigned int);
+
+  std::cout << "nevent " << p.nevent << "  body " << p.body << " B"
+	    << "  oversize every " << p.oversize
+	    << "  rbuf " << (p.rbufsize > 0 ? p.rbufsize : 1024) << " B"
+	    << std::endl;
+
+  int nerr = 0;
+  nerr += bench("per-byte", p, false);
+  nerr += bench("bulk", p, true);
+
+  return nerr ? 1 : 0;
+}
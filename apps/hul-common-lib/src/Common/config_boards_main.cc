@@ -0,0 +1,76 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <string>
+
+#include "UDPRBCP.hh"
+#include "BoardConfigurator.hh"
+
+enum argIndex{kBin, kBoardList};
+using namespace HUL;
+
+int main(int argc, char* argv[])
+{
+  if(argc < 2){
+    std::cout << "Usage\n";
+    std::cout << "config_boards [Board list] (--parallel=N) (--window=N) (--cache=dir) (--force) (--quiet)" << std::endl;
+    std::cout << " Configures the boards concurrently and reads the registers back." << std::endl;
+    std::cout << " Board list: one board per line, [name] [IP address] [config file] (UDP port)" << std::endl;
+    std::cout << " Config file: reg/pulse [address] [data] (n_cycle), block/fifo [address] [byte]..." << std::endl;
+    std::cout << " --cache skips the boards still holding an unchanged configuration." << std::endl;
+    return 0;
+  }// usage
+
+  // body ------------------------------------------------------
+  std::string cache_dir;
+  int32_t     max_parallel = 0;
+  int32_t     window       = 16;
+  bool        force        = false;
+  bool        verbose      = true;
+  for(int32_t i = kBoardList+1; i<argc; ++i){
+    std::string arg = argv[i];
+    if(arg.find("--parallel=") == 0)   max_parallel = atoi(arg.substr(11).c_str());
+    else if(arg.find("--window=") == 0) window      = atoi(arg.substr(9).c_str());
+    else if(arg.find("--cache=") == 0)  cache_dir   = arg.substr(8);
+    else if(arg == "--force")           force       = true;
+    else if(arg == "--quiet")           verbose     = false;
+    else{
+      std::cerr << "#E: Unknown option " << arg << std::endl;
+      return -1;
+    }
+  }
+
+  BoardConfigurator configurator(cache_dir);
+  configurator.SetMaxParallel(max_parallel);
+  configurator.SetWindow(window);
+  configurator.SetForce(force);
+  configurator.SetVerbose(verbose);
+
+  std::ifstream ifs(argv[kBoardList]);
+  if(!ifs.is_open()){
+    std::cerr << "#E: Cannot open " << argv[kBoardList] << std::endl;
+    return -1;
+  }
+
+  std::string line;
+  while(std::getline(ifs, line)){
+    std::string::size_type comment = line.find('#');
+    if(comment != std::string::npos) line.erase(comment);
+
+    std::istringstream iss(line);
+    BoardConfig board;
+    std::string config_file;
+    if(!(iss >> board.name >> board.ip_addr >> config_file)) continue;
+    if(!(iss >> board.port)) board.port = RBCP::gUdpPort;
+
+    if(!BoardConfigurator::LoadConfigFile(config_file, board)) return -1;
+    configurator.AddBoard(board);
+  }
+
+  int32_t n_failed = configurator.Run();
+  configurator.PrintSummary();
+
+  return n_failed == 0 ? 0 : 1;
+
+}// main
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <sstream>
+#include <vector>
+
+#include "UDPRBCP.hh"
+#include "FPGAModule.hh"
+#include "SiTCPSimulator.hh"
+
+enum argIndex{kBin, kIp, kAddr, kNRegister, kWindow, kDropRate};
+using namespace HUL;
+
+namespace{
+  double
+  Elapsed(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc < 4){
+    std::cout << "Usage\n";
+    std::cout << "rbcp_bench [IP address] [Base address (hex)] [Num registers] (window) (drop rate)" << std::endl;
+    std::cout << " Writes and reads back 1-byte registers at consecutive addresses," << std::endl;
+    std::cout << " one access at a time and through the pipelined batch API." << std::endl;
+    std::cout << " IP address \"sim\" starts a local SiTCP simulator (drop rate applies)." << std::endl;
+    std::cout << " Do not run it on a board unless the address range is a scratch area." << std::endl;
+    return 0;
+  }// usage
+
+  // body ------------------------------------------------------
+  std::string board_ip = argv[kIp];
+  uint32_t base_address;
+  std::istringstream iss_addr(argv[kAddr]);
+  iss_addr >> std::hex >> base_address;
+  int32_t n_register = atoi(argv[kNRegister]);
+  int32_t window     = argc > kWindow   ? atoi(argv[kWindow])   : 16;
+  double  drop_rate  = argc > kDropRate ? atof(argv[kDropRate]) : 0.;
+
+  RBCP::SiTCPSimulator* simulator = nullptr;
+  std::thread           simulator_thread;
+  if(board_ip == "sim"){
+    board_ip  = "127.0.0.1";
+    simulator = new RBCP::SiTCPSimulator(RBCP::gUdpPort, drop_rate);
+    if(!simulator->Open()) return -1;
+    simulator_thread = std::thread(&RBCP::SiTCPSimulator::Run, simulator);
+  }
+
+  RBCP::UDPRBCP udp_rbcp(board_ip, RBCP::gUdpPort, RBCP::DebugMode::kNoDisp);
+  HUL::FPGAModule fpga_module(udp_rbcp);
+  fpga_module.SetBatchWindow(window);
+
+  std::vector<FPGAModule::RegisterAccess> list;
+  for(int32_t i = 0; i<n_register; ++i){
+    list.push_back({base_address + i, static_cast<uint32_t>((i*7 + 1) & 0xff), 1});
+  }
+
+  // one by one (clears the registers) ------------------------
+  auto start = std::chrono::steady_clock::now();
+  for(const auto& access : list){
+    fpga_module.WriteModule(access.local_address, 0, access.n_cycle);
+  }
+  double t_single = Elapsed(start);
+
+  // pipelined -------------------------------------------------
+  start = std::chrono::steady_clock::now();
+  int32_t n_fail = fpga_module.WriteModuleBatch(list);
+  double t_batch = Elapsed(start);
+
+  std::vector<FPGAModule::RegisterAccess> read_list(list);
+  for(auto& access : read_list) access.data = 0;
+  start = std::chrono::steady_clock::now();
+  n_fail += fpga_module.ReadModuleBatch(read_list);
+  double t_read = Elapsed(start);
+
+  int32_t n_mismatch = 0;
+  for(std::size_t i = 0; i<list.size(); ++i){
+    if(read_list[i].data != list[i].data) ++n_mismatch;
+  }
+
+  printf("#D: %d registers, window %d\n", n_register, window);
+  printf("    WriteModule       : %8.3f s (%8.0f access/s)\n", t_single, n_register/t_single);
+  printf("    WriteModuleBatch  : %8.3f s (%8.0f access/s)\n", t_batch,  n_register/t_batch);
+  printf("    ReadModuleBatch   : %8.3f s (%8.0f access/s)\n", t_read,   n_register/t_read);
+  printf("    failed accesses %d, read back mismatch %d\n", n_fail, n_mismatch);
+
+  if(simulator){
+    simulator->Stop();
+    simulator_thread.join();
+    printf("    simulator: %lu requests, %lu dropped\n",
+	   (unsigned long)simulator->GetNumRequest(), (unsigned long)simulator->GetNumDrop());
+    delete simulator;
+  }
+
+  return n_mismatch == 0 && n_fail == 0 ? 0 : 1;
+
+}// main
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+
+#include "UDPRBCP.hh"
+#include "SiTCPSimulator.hh"
+
+enum argIndex{kBin, kPort, kDropRate, kDelayUs};
+
+namespace{
+  RBCP::SiTCPSimulator* g_simulator = nullptr;
+
+  void
+  StopFromCtrlC(int signal)
+  {
+    if(g_simulator) g_simulator->Stop();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc > 1 && std::string(argv[1]) == "-h"){
+    std::cout << "Usage\n";
+    std::cout << "sitcp_simulator (UDP port) (drop rate) (delay [us])" << std::endl;
+    std::cout << " Answers RBCP requests like a SiTCP board (default port " << RBCP::gUdpPort << ")" << std::endl;
+    return 0;
+  }// usage
+
+  // body ------------------------------------------------------
+  uint32_t port      = argc > kPort     ? atoi(argv[kPort])     : RBCP::gUdpPort;
+  double   drop_rate = argc > kDropRate ? atof(argv[kDropRate]) : 0.;
+  int32_t  delay_us  = argc > kDelayUs  ? atoi(argv[kDelayUs])  : 0;
+
+  RBCP::SiTCPSimulator simulator(port, drop_rate, delay_us);
+  if(!simulator.Open()) return -1;
+
+  g_simulator = &simulator;
+  (void) signal(SIGINT, StopFromCtrlC);
+
+  std::cout << "#D: SiTCP simulator on UDP port " << port
+	    << ", drop rate " << drop_rate
+	    << ", delay " << delay_us << " us" << std::endl;
+  simulator.Run();
+
+  std::cout << "#D: " << simulator.GetNumRequest() << " requests, "
+	    << simulator.GetNumDrop() << " dropped" << std::endl;
+
+  return 0;
+
+}// main
@@ -1,28 +1,31 @@
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
 
 #include "UDPRBCP.hh"
 #include "FPGAModule.hh"
 #include "DaqFuncs.hh"
 
-enum argIndex{kBin, kIp, kRunNo};
+enum argIndex{kBin, kIp, kRunNo, kSegmentMB};
 using namespace HUL;
 
 int main(int argc, char* argv[])
 {
   if(1 == argc){
     std::cout << "Usage\n";
-    std::cout << "daq [IP address] [RunNo.]" << std::endl;
+    std::cout << "daq [IP address] [RunNo.] (segment size [MB])" << std::endl;
+    std::cout << " segment size: start a new data file every N MB (0: one file)" << std::endl;
     return 0;
   }// usage
   
   // body ------------------------------------------------------
   std::string board_ip = argv[kIp];
   int32_t runno        = atoi(argv[kRunNo]);
+  uint64_t segment_mb  = argc > kSegmentMB ? strtoull(argv[kSegmentMB], nullptr, 0) : 0;
 
   RBCP::UDPRBCP udp_rbcp(board_ip, RBCP::gUdpPort, RBCP::DebugMode::kNoDisp);
   HUL::FPGAModule fpga_module(udp_rbcp);
-  HUL::DAQ::DoStrDaq(board_ip, runno);
+  HUL::DAQ::DoStrDaq(board_ip, runno, segment_mb*1024*1024);
 
   return 0;
   
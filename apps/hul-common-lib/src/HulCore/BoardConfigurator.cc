@@ -0,0 +1,428 @@
+#include<iostream>
+#include<iomanip>
+#include<fstream>
+#include<sstream>
+#include<cstdio>
+#include<chrono>
+#include<thread>
+#include<atomic>
+#include<algorithm>
+
+#include"BoardConfigurator.hh"
+#include"RBCPEngine.hh"
+#include"Utility.hh"
+
+namespace HUL{
+
+  namespace{
+    static const std::string class_name("BoardConfigurator");
+
+    // same layout as FPGAModule: byte i of a register is at laddr + (i << 16)
+    static constexpr  int32_t kShiftMultiByteOffset {16};
+    static constexpr  int32_t kMaxCycle             {4};
+    static constexpr  int32_t kDataSize             {8};
+    static constexpr uint32_t kDataMask             {0xFF};
+
+    const char* const kKindName[] = {"reg", "pulse", "block", "fifo"};
+    const char* const kStateName[] = {"waiting", "running", "skipped", "done", "FAILED"};
+
+    double
+    Elapsed(std::chrono::steady_clock::time_point start)
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool
+    IsReadable(const ConfigPhase& phase)
+    {
+      return phase.kind == ConfigPhase::Kind::kRegister
+	|| phase.kind == ConfigPhase::Kind::kBlock;
+    }
+
+    // Expands a step into RBCP writes, or reads with the expected bytes.
+    void
+    MakeTransactions(const ConfigPhase& phase, const bool read,
+		     std::vector<RBCP::Transaction>& list,
+		     std::vector<uint8_t>& expected)
+    {
+      using RBCP::RBCPEngine;
+
+      if(phase.kind == ConfigPhase::Kind::kRegister
+	 || phase.kind == ConfigPhase::Kind::kPulse){
+	for(const auto& access : phase.registers){
+	  for(int32_t i = 0; i<access.n_cycle; ++i){
+	    uint8_t  wd = static_cast<uint8_t>((access.data >> kDataSize*i) & kDataMask);
+	    uint32_t address = access.local_address + (i << kShiftMultiByteOffset);
+	    if(read){
+	      list.push_back(RBCPEngine::MakeRead(address, 1));
+	      expected.push_back(wd);
+	    }else{
+	      list.push_back(RBCPEngine::MakeWrite(address, &wd, 1));
+	    }
+	  }
+	}
+      }else if(phase.kind == ConfigPhase::Kind::kBlock){
+	const uint32_t n_byte = phase.bytes.size();
+	for(uint32_t offset = 0; offset<n_byte; offset += RBCPEngine::kMaxLength_){
+	  uint32_t length = std::min(RBCPEngine::kMaxLength_, n_byte - offset);
+	  if(read){
+	    list.push_back(RBCPEngine::MakeRead(phase.address + offset, length));
+	    expected.insert(expected.end(), phase.bytes.begin() + offset,
+			    phase.bytes.begin() + offset + length);
+	  }else{
+	    list.push_back(RBCPEngine::MakeWrite(phase.address + offset,
+						 &phase.bytes[offset], length));
+	  }
+	}
+      }else if(phase.kind == ConfigPhase::Kind::kFifo && !read){
+	for(uint8_t wd : phase.bytes){
+	  list.push_back(RBCPEngine::MakeWrite(phase.address, &wd, 1));
+	}
+      }
+    }
+  }
+
+  // Constructor -------------------------------------------------------------
+  BoardConfigurator::BoardConfigurator(const std::string cache_dir)
+    :
+    cache_dir_(cache_dir),
+    elapsed_(0.),
+    max_parallel_(0),
+    window_(16),
+    force_(false),
+    verbose_(true)
+  {
+  }
+
+  // AddBoard ----------------------------------------------------------------
+  void
+  BoardConfigurator::AddBoard(const BoardConfig& board)
+  {
+    boards_.push_back(board);
+  }
+
+  // LoadConfigFile ----------------------------------------------------------
+  bool
+  BoardConfigurator::LoadConfigFile(const std::string& path, BoardConfig& board)
+  {
+    static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+    std::ifstream ifs(path);
+    if(!ifs.is_open()){
+      Utility::PrintError(func_name, "Cannot open " + path);
+      return false;
+    }
+
+    std::string line;
+    int32_t     line_number = 0;
+    while(std::getline(ifs, line)){
+      ++line_number;
+      std::string::size_type comment = line.find('#');
+      if(comment != std::string::npos) line.erase(comment);
+
+      std::istringstream iss(line);
+      std::string keyword;
+      if(!(iss >> keyword)) continue;
+
+      std::ostringstream where;
+      where << path << ":" << line_number;
+
+      uint32_t address;
+      if(!(iss >> std::hex >> address)){
+	Utility::PrintError(func_name, "No address at " + where.str());
+	return false;
+      }
+
+      if(keyword == "reg" || keyword == "pulse"){
+	ConfigPhase::Kind kind = keyword == "reg" ?
+	  ConfigPhase::Kind::kRegister : ConfigPhase::Kind::kPulse;
+
+	FPGAModule::RegisterAccess access {address, 0, 1};
+	if(!(iss >> access.data)){
+	  Utility::PrintError(func_name, "No data at " + where.str());
+	  return false;
+	}
+	int32_t n_cycle;
+	if(iss >> std::dec >> n_cycle) access.n_cycle = n_cycle;
+	if(access.n_cycle < 1 || access.n_cycle > kMaxCycle){
+	  Utility::PrintError(func_name, "Invalid n_cycle at " + where.str());
+	  return false;
+	}
+
+	// consecutive lines of the same kind are pipelined together
+	if(board.phases.empty() || board.phases.back().kind != kind){
+	  board.phases.emplace_back();
+	  board.phases.back().kind = kind;
+	}
+	board.phases.back().registers.push_back(access);
+      }else if(keyword == "block" || keyword == "fifo"){
+	ConfigPhase phase;
+	phase.kind    = keyword == "block" ?
+	  ConfigPhase::Kind::kBlock : ConfigPhase::Kind::kFifo;
+	phase.address = address;
+
+	uint32_t byte;
+	while(iss >> byte){
+	  if(byte > kDataMask){
+	    Utility::PrintError(func_name, "Not a byte at " + where.str());
+	    return false;
+	  }
+	  phase.bytes.push_back(static_cast<uint8_t>(byte));
+	}
+	if(phase.bytes.empty()){
+	  Utility::PrintError(func_name, "No data at " + where.str());
+	  return false;
+	}
+	board.phases.push_back(phase);
+      }else{
+	Utility::PrintError(func_name, "Unknown keyword " + keyword + " at " + where.str());
+	return false;
+      }
+    }
+
+    return true;
+  }
+
+  // CalcDigest --------------------------------------------------------------
+  // 64-bit FNV-1a over the contents of the steps
+  uint64_t
+  BoardConfigurator::CalcDigest(const BoardConfig& board)
+  {
+    uint64_t digest = 0xcbf29ce484222325ULL;
+    auto add = [&digest](uint32_t value){
+      for(int32_t i = 0; i<4; ++i){
+	digest ^= (value >> 8*i) & 0xff;
+	digest *= 0x100000001b3ULL;
+      }
+    };
+
+    for(const auto& phase : board.phases){
+      add(static_cast<uint32_t>(phase.kind));
+      add(phase.address);
+      add(phase.registers.size());
+      for(const auto& access : phase.registers){
+	add(access.local_address);
+	add(access.data);
+	add(access.n_cycle);
+      }
+      add(phase.bytes.size());
+      for(uint8_t byte : phase.bytes) add(byte);
+    }
+
+    return digest;
+  }
+
+  // Cache -------------------------------------------------------------------
+  std::string
+  BoardConfigurator::GetCachePath(const BoardConfig& board) const
+  {
+    return cache_dir_ + "/" + board.ip_addr + "_" + std::to_string(board.port) + ".digest";
+  }
+
+  bool
+  BoardConfigurator::ReadCache(const BoardConfig& board, uint64_t& digest) const
+  {
+    if(cache_dir_.empty()) return false;
+
+    std::ifstream ifs(GetCachePath(board));
+    return static_cast<bool>(ifs >> std::hex >> digest);
+  }
+
+  void
+  BoardConfigurator::WriteCache(const BoardConfig& board, const uint64_t digest) const
+  {
+    static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+    if(cache_dir_.empty()) return;
+
+    std::ofstream ofs(GetCachePath(board));
+    if(!ofs.is_open()){
+      Utility::PrintError(func_name, "Cannot write " + GetCachePath(board));
+      return;
+    }
+    ofs << std::hex << digest << " " << board.name << std::endl;
+  }
+
+  // Print -------------------------------------------------------------------
+  void
+  BoardConfigurator::Print(const int32_t index, const std::string& message)
+  {
+    std::lock_guard<std::mutex> lock(print_mutex_);
+    std::cout << "#D: [" << boards_[index].name << " " << boards_[index].ip_addr
+	      << "] " << message << std::endl;
+  }
+
+  // ReadBack ----------------------------------------------------------------
+  int32_t
+  BoardConfigurator::ReadBack(RBCP::RBCPEngine& engine, const ConfigPhase& phase,
+			      BoardStatus& status)
+  {
+    std::vector<RBCP::Transaction> list;
+    std::vector<uint8_t>           expected;
+    MakeTransactions(phase, true, list, expected);
+
+    engine.SetWindow(window_);
+    status.n_fail   += engine.Execute(list);
+    status.n_access += list.size();
+
+    int32_t n_mismatch = 0;
+    auto    itr        = expected.cbegin();
+    for(const auto& trans : list){
+      for(int32_t i = 0; i<trans.length; ++i, ++itr){
+	if(trans.status < 0 || i >= (int32_t)trans.data.size() || trans.data[i] != *itr){
+	  ++n_mismatch;
+	}
+      }
+    }
+
+    return n_mismatch;
+  }
+
+  // ConfigureBoard ----------------------------------------------------------
+  void
+  BoardConfigurator::ConfigureBoard(const int32_t index)
+  {
+    const BoardConfig& board  = boards_[index];
+    BoardStatus&       status = status_[index];
+
+    auto start     = std::chrono::steady_clock::now();
+    status.state   = BoardStatus::State::kRunning;
+    status.n_phase = board.phases.size();
+
+    RBCP::RBCPEngine engine(board.ip_addr, board.port, window_);
+    if(!engine.IsOpen()){
+      status.state   = BoardStatus::State::kFailed;
+      status.elapsed = Elapsed(start);
+      return;
+    }
+
+    // unchanged configuration, check that the board still holds it.
+    // FIFO and pulse steps (SPI and ASIC loads) cannot be read back, a
+    // board with any of them is configured again: an ASIC reset on its own
+    // would not show in the registers.
+    const uint64_t digest = CalcDigest(board);
+    uint64_t       cached_digest;
+    const bool     checkable = std::all_of(board.phases.begin(), board.phases.end(),
+					   IsReadable);
+    if(!force_ && checkable
+       && ReadCache(board, cached_digest) && cached_digest == digest){
+      int32_t n_mismatch = 0;
+      for(const auto& phase : board.phases){
+	n_mismatch += ReadBack(engine, phase, status);
+      }
+
+      if(status.n_fail == 0 && n_mismatch == 0){
+	status.state     = BoardStatus::State::kSkipped;
+	status.n_done    = status.n_phase;
+	status.n_retrans = engine.GetNumRetrans();
+	status.elapsed   = Elapsed(start);
+	if(verbose_) Print(index, "Register image unchanged, skipped");
+	return;
+      }
+
+      if(verbose_) Print(index, "Register image differs from the cache, configuring");
+      status.n_fail = 0;
+    }
+
+    // a board left half-configured must not be skipped next time
+    if(!cache_dir_.empty()) std::remove(GetCachePath(board).c_str());
+
+    for(const auto& phase : board.phases){
+      std::vector<RBCP::Transaction> list;
+      std::vector<uint8_t>           expected;
+      MakeTransactions(phase, false, list, expected);
+
+      // a lost packet is resent behind the following ones
+      bool ordered = phase.kind == ConfigPhase::Kind::kFifo
+	|| phase.kind == ConfigPhase::Kind::kPulse;
+      engine.SetWindow(ordered ? 1 : window_);
+      status.n_fail   += engine.Execute(list);
+      status.n_access += list.size();
+      if(status.n_fail != 0) break;
+
+      if(IsReadable(phase)) status.n_mismatch += ReadBack(engine, phase, status);
+      if(status.n_fail != 0) break;
+
+      ++status.n_done;
+      if(verbose_){
+	std::ostringstream message;
+	message << "Step " << status.n_done << "/" << status.n_phase
+		<< " (" << kKindName[static_cast<int32_t>(phase.kind)] << ", "
+		<< list.size() << " accesses) done";
+	Print(index, message.str());
+      }
+    }
+
+    status.n_retrans = engine.GetNumRetrans();
+    status.elapsed   = Elapsed(start);
+    if(status.n_fail == 0 && status.n_mismatch == 0){
+      status.state = BoardStatus::State::kDone;
+      WriteCache(board, digest);
+    }else{
+      status.state = BoardStatus::State::kFailed;
+      std::ostringstream message;
+      message << "Failed, " << status.n_fail << " RBCP errors, "
+	      << status.n_mismatch << " read back mismatches";
+      Print(index, message.str());
+    }
+  }
+
+  // Run ---------------------------------------------------------------------
+  int32_t
+  BoardConfigurator::Run()
+  {
+    status_.assign(boards_.size(), BoardStatus());
+
+    int32_t n_thread = boards_.size();
+    if(max_parallel_ > 0 && max_parallel_ < n_thread) n_thread = max_parallel_;
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int32_t> next(0);
+    std::vector<std::thread> threads;
+    for(int32_t i = 0; i<n_thread; ++i){
+      threads.emplace_back([this, &next](){
+	for(int32_t index = next++; index < (int32_t)boards_.size(); index = next++){
+	  ConfigureBoard(index);
+	}
+      });
+    }
+    for(auto& thread : threads) thread.join();
+    elapsed_ = Elapsed(start);
+
+    int32_t n_failed = 0;
+    for(const auto& status : status_){
+      if(status.state == BoardStatus::State::kFailed) ++n_failed;
+    }
+
+    return n_failed;
+  }
+
+  // PrintSummary ------------------------------------------------------------
+  void
+  BoardConfigurator::PrintSummary() const
+  {
+    double sum_elapsed = 0.;
+    double max_elapsed = 0.;
+
+    std::cout << "#D: Configuration summary" << std::endl;
+    for(std::size_t i = 0; i<boards_.size(); ++i){
+      const BoardStatus& status = status_[i];
+      std::cout << "  " << std::left << std::setw(16) << boards_[i].name
+		<< " " << std::setw(16) << boards_[i].ip_addr
+		<< " " << std::setw(8) << kStateName[static_cast<int32_t>(status.state)]
+		<< std::right
+		<< " steps " << status.n_done << "/" << status.n_phase
+		<< ", accesses " << status.n_access
+		<< ", retrans " << status.n_retrans
+		<< ", " << std::fixed << std::setprecision(3) << status.elapsed << " s"
+		<< std::defaultfloat << std::endl;
+      sum_elapsed += status.elapsed;
+      max_elapsed  = std::max(max_elapsed, status.elapsed);
+    }
+
+    std::cout << "#D: " << boards_.size() << " boards in " << elapsed_ << " s"
+	      << " (slowest board " << max_elapsed << " s, serial sum "
+	      << sum_elapsed << " s)" << std::endl;
+  }
+
+};
@@ -0,0 +1,133 @@
+#ifndef BOARDCONFIGURATOR_HH
+#define BOARDCONFIGURATOR_HH
+
+#include<vector>
+#include<string>
+#include<mutex>
+#include<stdint.h>
+
+#include"FPGAModule.hh"
+
+namespace RBCP{
+  class  RBCPEngine;
+};
+
+namespace HUL{
+
+  // One step of a board configuration. The steps of a board are executed
+  // in order, the accesses inside a step are pipelined when allowed.
+  //  kRegister : FPGAModule registers (n_cycle bytes, local address), read back
+  //  kPulse    : register writes without read back (reset, start of SPI, ...)
+  //  kBlock    : bytes written to consecutive addresses, read back
+  //  kFifo     : bytes written one by one to the same address, in order
+  struct ConfigPhase
+  {
+    enum class Kind : int32_t
+      {
+	kRegister, kPulse, kBlock, kFifo,
+	kSizeKind
+      };
+
+    Kind kind {Kind::kRegister};
+    std::vector<FPGAModule::RegisterAccess> registers; // kRegister, kPulse
+    uint32_t             address {0};                  // kBlock, kFifo
+    std::vector<uint8_t> bytes;                        // kBlock, kFifo
+  };
+
+  struct BoardConfig
+  {
+    std::string              name;
+    std::string              ip_addr;
+    uint32_t                 port {4660};
+    std::vector<ConfigPhase> phases;
+  };
+
+  struct BoardStatus
+  {
+    enum class State : int32_t
+      {
+	kWaiting, kRunning, kSkipped, kDone, kFailed,
+	kSizeState
+      };
+
+    State       state       {State::kWaiting};
+    int32_t     n_phase     {0};
+    int32_t     n_done      {0}; // finished phases
+    uint64_t    n_access    {0};
+    uint64_t    n_retrans   {0};
+    int32_t     n_fail      {0}; // RBCP errors
+    int32_t     n_mismatch  {0}; // read back differences
+    double      elapsed     {0.}; // sec
+  };
+
+  // __________________________________________________________________
+  // Configures a list of boards concurrently.
+  //
+  // Each board is handled by its own RBCP::RBCPEngine, up to max_parallel
+  // boards at a time, so the total time is set by the slowest board.
+  // Register and block steps are pipelined and read back after writing;
+  // FIFO and pulse steps use a window of 1 to keep their order.
+  //
+  // With a cache directory, the digest of the configuration of every
+  // successfully configured board is stored there. A board whose digest
+  // is unchanged is read back only, and skipped if its registers and
+  // blocks still hold the image (a power-cycled board is configured again).
+  // Only boards made of register and block steps can be checked: a board
+  // with any FIFO or pulse step is always configured.
+  class BoardConfigurator
+  {
+  private:
+    std::vector<BoardConfig> boards_;
+    std::vector<BoardStatus> status_;
+    std::string              cache_dir_;
+    double                   elapsed_;
+    int32_t                  max_parallel_;
+    int32_t                  window_;
+    bool                     force_;
+    bool                     verbose_;
+    std::mutex               print_mutex_;
+
+    // __________________________________________________________________
+  public:
+    BoardConfigurator(const BoardConfigurator&) = delete;
+    BoardConfigurator(const std::string cache_dir = "");
+    virtual ~BoardConfigurator() = default;
+    BoardConfigurator& operator=(const BoardConfigurator&) = delete;
+
+    // Member methods ___________________________________________________
+    void    AddBoard(const BoardConfig& board);
+
+    // Text configuration, one access per line, '#' starts a comment.
+    //  reg   [address] [data] (n_cycle)
+    //  pulse [address] [data] (n_cycle)
+    //  block [address] [byte] [byte] ...
+    //  fifo  [address] [byte] [byte] ...
+    // Numbers are hex. Consecutive reg/pulse lines form one step.
+    static bool LoadConfigFile(const std::string& path, BoardConfig& board);
+
+    // Returns the number of boards which failed.
+    int32_t Run();
+    void    PrintSummary() const;
+
+    const std::vector<BoardStatus>& GetStatus() const { return status_; }
+    void    SetMaxParallel(const int32_t n) { max_parallel_ = n; }
+    void    SetWindow(const int32_t window) { window_ = window; }
+    void    SetForce(const bool force) { force_ = force; }
+    void    SetVerbose(const bool verbose) { verbose_ = verbose; }
+
+    static uint64_t CalcDigest(const BoardConfig& board);
+
+  private:
+    void    ConfigureBoard(const int32_t index);
+    // returns the number of bytes differing from the configuration
+    int32_t ReadBack(RBCP::RBCPEngine& engine, const ConfigPhase& phase,
+		     BoardStatus& status);
+    std::string GetCachePath(const BoardConfig& board) const;
+    bool    ReadCache(const BoardConfig& board, uint64_t& digest) const;
+    void    WriteCache(const BoardConfig& board, const uint64_t digest) const;
+    void    Print(const int32_t index, const std::string& message);
+  }; // End of Class definition
+
+};// End of namespace HUL
+
+#endif
@@ -3,7 +3,13 @@
 #include<iostream>
 #include<cstdio>
 #include<csignal>
-#include<list>
+#include<deque>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<atomic>
+#include<chrono>
 #include<unistd.h>
 
 #include"UDPRBCP.hh"
@@ -125,17 +131,177 @@ namespace HUL::DAQ{
     static const int32_t kNumData   {10000};
     //static const int32_t kNumData   {20000};
     static const int32_t kNumByte   {8};
-  };
-  
-  void
-  DoStrDaq(std::string ip, int32_t runno)
-  {
+    static const int32_t kNumBuffer {256}; // 256 x 80 kB receive buffers
+    static const int32_t kReportInterval {5}; // sec
 
     struct DataCont{
-      uint8_t data[STR::kNumData*STR::kNumByte];
+      uint8_t  data[kNumData*kNumByte];
       uint32_t recv_bytes;
     };
-    
+
+    // Receive buffers circulate between the socket reader and the file
+    // writer. When every buffer is waiting to be written the reader stops
+    // reading the socket, and the TCP window throttles the FPGA.
+    class BufferPool{
+    public:
+      BufferPool(int32_t n_buffer)
+	: pool_(n_buffer)
+      {
+	for(auto& cont : pool_) free_.push_back(&cont);
+      }
+
+      DataCont*
+      GetFree()
+      {
+	std::unique_lock<std::mutex> lock(mutex_);
+	if(free_.empty()){
+	  ++n_stall_;
+	  auto start = std::chrono::steady_clock::now();
+	  cond_free_.wait(lock, [this]{ return !free_.empty(); });
+	  stall_time_ += std::chrono::steady_clock::now() - start;
+	}
+	DataCont* cont = free_.front();
+	free_.pop_front();
+	return cont;
+      }
+
+      void
+      PutFree(DataCont* cont)
+      {
+	{
+	  std::lock_guard<std::mutex> lock(mutex_);
+	  free_.push_back(cont);
+	}
+	cond_free_.notify_one();
+      }
+
+      // nullptr tells the writer that the run is over
+      void
+      PutFull(DataCont* cont)
+      {
+	{
+	  std::lock_guard<std::mutex> lock(mutex_);
+	  full_.push_back(cont);
+	}
+	cond_full_.notify_one();
+      }
+
+      DataCont*
+      GetFull()
+      {
+	std::unique_lock<std::mutex> lock(mutex_);
+	cond_full_.wait(lock, [this]{ return !full_.empty(); });
+	DataCont* cont = full_.front();
+	full_.pop_front();
+	return cont;
+      }
+
+      int32_t
+      GetNumFull()
+      {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return full_.size();
+      }
+
+      int32_t  GetNumBuffer() const { return pool_.size(); }
+      uint64_t GetNumStall() const  { return n_stall_; }
+      double   GetStallTime() const { return stall_time_.count(); }
+
+    private:
+      std::vector<DataCont>   pool_;
+      std::deque<DataCont*>   free_;
+      std::deque<DataCont*>   full_;
+      std::mutex              mutex_;
+      std::condition_variable cond_free_;
+      std::condition_variable cond_full_;
+      // updated by the reader only
+      uint64_t                      n_stall_ {0};
+      std::chrono::duration<double> stall_time_ {0};
+    };
+
+    // Writes the received buffers to data/run<runno>.dat, or to
+    // data/run<runno>_<segment>.dat files of segment_bytes each when
+    // segment_bytes is not 0.
+    class FileWriter{
+    public:
+      FileWriter(BufferPool& pool, int32_t runno, uint64_t segment_bytes)
+	: pool_(pool), runno_(runno), segment_bytes_(segment_bytes)
+      {
+      }
+
+      bool
+      Open()
+      {
+	std::string filename = "data/run" + std::to_string(runno_);
+	if(segment_bytes_ != 0){
+	  char suffix[16];
+	  snprintf(suffix, sizeof(suffix), "_%04d", segment_);
+	  filename += suffix;
+	}
+	filename += ".dat";
+
+	ofs_.open(filename.c_str(), std::ios::binary);
+	if(!ofs_.is_open()){
+	  std::cerr << "#E: Data file cannot be created.\n"
+		    << "    Does a 'data' directory exist in the current directory?"
+		    << std::endl;
+	  return false;
+	}
+
+	segment_written_ = 0;
+	return true;
+      }
+
+      void
+      Run()
+      {
+	while(DataCont* cont = pool_.GetFull()){
+	  if(!failed_){
+	    if(segment_bytes_ != 0 && segment_written_ != 0
+	       && segment_written_ + cont->recv_bytes > segment_bytes_){
+	      ofs_.close();
+	      ++segment_;
+	      if(!Open()) failed_ = true;
+	    }
+	  }
+
+	  if(!failed_){
+	    ofs_.write((char*)cont->data, cont->recv_bytes);
+	    if(!ofs_.good()){
+	      std::cerr << "#E: Data file write error" << std::endl;
+	      failed_ = true;
+	    }
+	  }
+
+	  segment_written_ += cont->recv_bytes;
+	  written_bytes_.fetch_add(cont->recv_bytes, std::memory_order_relaxed);
+	  pool_.PutFree(cont);
+	}
+
+	ofs_.close();
+      }
+
+      uint64_t GetWrittenBytes() const { return written_bytes_.load(std::memory_order_relaxed); }
+      int32_t  GetSegment() const      { return segment_; }
+      bool     IsFailed() const        { return failed_; }
+
+    private:
+      BufferPool&           pool_;
+      int32_t               runno_;
+      uint64_t              segment_bytes_;
+      int32_t               segment_ {0};
+      uint64_t              segment_written_ {0};
+      std::atomic<uint64_t> written_bytes_ {0};
+      std::atomic<bool>     failed_ {false};
+      std::ofstream         ofs_;
+    };
+  };
+
+  void
+  DoStrDaq(std::string ip, int32_t runno, uint64_t segment_bytes)
+  {
+    using Clock = std::chrono::steady_clock;
+
     (void) signal(SIGINT, UserStop_FromCtrlC);
 
     // TCP socket
@@ -144,75 +310,83 @@ namespace HUL::DAQ{
     std::cout << "#D: Socket connected" << std::endl;
 
     // Start DAQ
-    std::string filename = "data/run" + std::to_string(runno) + ".dat";
-    std::ofstream ofs(filename.c_str(), std::ios::binary);
-    if(!ofs.is_open()){
-      std::cerr << "#E: Data file cannot be created.\n"
-		<< "    Does a 'data' directory exist in the current directory?"
-		<< std::endl;
+    STR::BufferPool pool(STR::kNumBuffer);
+    STR::FileWriter writer(pool, runno, segment_bytes);
+    if(!writer.Open()){
       close(sock);
       return;
     }
 
+    std::thread writer_thread(&STR::FileWriter::Run, &writer);
+
     std::cout << "#D: Start DAQ" << std::endl;
     // DAQ Cycle
-    std::list<DataCont> data_list;
     static const uint32_t kReadSize = sizeof(uint8_t)*STR::kNumByte*STR::kNumData;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point last_report = start;
+    uint64_t recv_bytes      = 0;
+    uint64_t last_recv_bytes = 0;
+    uint64_t last_written    = 0;
     for(;;){
-      DataCont dcont = {{0},0};
+      STR::DataCont* dcont = pool.GetFree();
       int32_t recv_status = 0;
 
-      while( kRecvTimeOut == ( recv_status = Receive(sock, dcont.data, kReadSize, dcont.recv_bytes)) && !user_stop) continue;
+      while( kRecvTimeOut == ( recv_status = Receive(sock, dcont->data, kReadSize, dcont->recv_bytes)) && !user_stop){
+	// keep what arrived before the time out
+	if(dcont->recv_bytes != 0) break;
+      }
 
       if(recv_status == kRecvZero){
 	std::cout << "#E: Recv() returns 0" << std::endl;
+	// the peer may close in the middle of a buffer
+	recv_bytes += dcont->recv_bytes;
+	if(dcont->recv_bytes != 0) pool.PutFull(dcont);
+	else                       pool.PutFree(dcont);
 	break;
       }
 
       if(recv_status == kRecvError){
 	std::cout << "#E: Recv() returns -1" << std::endl;
+	pool.PutFree(dcont);
 	break;
       }
 
-      printf("Recording...");
-      data_list.push_back(dcont);
-    
+      recv_bytes += dcont->recv_bytes;
+      if(dcont->recv_bytes != 0) pool.PutFull(dcont);
+      else                       pool.PutFree(dcont);
+
+      const Clock::time_point now = Clock::now();
+      const double interval = std::chrono::duration<double>(now - last_report).count();
+      if(interval >= STR::kReportInterval){
+	const uint64_t written = writer.GetWrittenBytes();
+	printf("#D: %.0f s, recv %.1f MB/s, write %.1f MB/s, queued %d/%d, stall %lu (%.1f s), segment %d\n",
+	       std::chrono::duration<double>(now - start).count(),
+	       (recv_bytes - last_recv_bytes)/interval/1e6,
+	       (written - last_written)/interval/1e6,
+	       pool.GetNumFull(), pool.GetNumBuffer(),
+	       (unsigned long)pool.GetNumStall(), pool.GetStallTime(),
+	       writer.GetSegment());
+	fflush(stdout);
+	last_report     = now;
+	last_recv_bytes = recv_bytes;
+	last_written    = written;
+      }
+
       if(user_stop == 1) break;
+      if(writer.IsFailed()) break;
     }// For()
 
-    close(sock);    
-    
-    std::list<DataCont>::iterator itr     = data_list.begin();
-    std::list<DataCont>::iterator itr_end = data_list.end();
-    for(; itr != itr_end; ++itr){
-      //    std::cout << "N:" << (*itr).n_word << std::endl;
-      ofs.write((char*)(*itr).data, (*itr).recv_bytes);
-    }
+    close(sock);
 
-    ofs.close();
+    pool.PutFull(nullptr);
+    writer_thread.join();
 
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "#D: " << recv_bytes << " bytes were recorded in "
+	      << writer.GetSegment() + 1 << " file(s), "
+	      << recv_bytes/elapsed/1e6 << " MB/s on average." << std::endl;
     std::cout << "#D: End of DAQ." << std::endl;
-    
-#if 0
-    std::list<DataCont>::iterator itr     = data_list.begin();
-    std::list<DataCont>::iterator itr_end = data_list.end();
-    for(; itr != itr_end; ++itr){
-      //    std::cout << "N:" << (*itr).n_word << std::endl;
-      ofs.write((char*)(*itr).data, (*itr).recv_bytes);
-    }
-
-    std::cout << "#D: Read remaining data in FPGA. Wait time out." << std::endl;
-  
-    sleep(1);
-    DataCont dcont = {{0},0};
-    while(kRecvTimeOut != Receive(sock, dcont.data, kReadSize,dcont.recv_bytes));
-  
-    std::cout << "#D: Time out is detected. End of DAQ." << std::endl;
 
-    close(sock);
-    ofs.close();
-#endif
-  
     return;
   }
 
@@ -279,7 +453,7 @@ namespace HUL::DAQ{
       tmp_ret = recv(sock, (char*)data_buf + revd_size, length -revd_size, 0);
 
       if(tmp_ret == 0){
-	num_received_bytes = 0;
+	num_received_bytes = static_cast<uint32_t>(revd_size);
 	ret_val            = HUL::DAQ::kRecvZero;
 	return ret_val;
       }
@@ -14,7 +14,8 @@ namespace HUL::DAQ{
   void    UserStop_FromCtrlC(int signal);
   
   void    DoTrgDaq(std::string ip, int32_t runno, int32_t event_num, uint32_t daq_gate_address);
-  void    DoStrDaq(std::string ip, int32_t runno);
+  // segment_bytes != 0 rotates the data file every segment_bytes
+  void    DoStrDaq(std::string ip, int32_t runno, uint64_t segment_bytes = 0);
 
   int32_t ConnectSocket(std::string ip);
   int32_t DoEventCycle(int sock, uint32_t* buffer);
@@ -4,6 +4,7 @@
 
 #include"FPGAModule.hh"
 #include"UDPRBCP.hh"
+#include"RBCPEngine.hh"
 #include"Utility.hh"
 
 namespace HUL{
@@ -12,6 +13,16 @@ namespace HUL{
     static const std::string class_name("FPGAModule");
   }
 
+  // Constructor -------------------------------------------------------------
+  FPGAModule::FPGAModule(RBCP::UDPRBCP& udp_rbcp)
+    :
+    udp_rbcp_(udp_rbcp),
+    batch_window_(kBatchWindow)
+  {
+  }
+
+  FPGAModule::~FPGAModule() = default;
+
   // 32-bit length register --------------------------------------------------  
   // WriteModule -------------------------------------------------------------
   int32_t
@@ -166,4 +177,106 @@ namespace HUL{
 
     return ret;
   }
+
+  // Batched access ----------------------------------------------------------
+  RBCP::RBCPEngine&
+  FPGAModule::GetEngine()
+  {
+    if(!engine_){
+      engine_.reset(new RBCP::RBCPEngine(udp_rbcp_.GetIpAddr(), udp_rbcp_.GetPort(),
+					 batch_window_));
+      engine_->SetRbcpVer(udp_rbcp_.GetRbcpVer());
+    }
+
+    return *engine_;
+  }
+
+  void
+  FPGAModule::SetBatchWindow(const int32_t window)
+  {
+    batch_window_ = window;
+    if(engine_) engine_->SetWindow(window);
+  }
+
+  // WriteModuleBatch --------------------------------------------------------
+  int32_t
+  FPGAModule::WriteModuleBatch(const std::vector<RegisterAccess>& list)
+  {
+    static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+    std::vector<RBCP::Transaction> trans_list;
+    trans_list.reserve(list.size());
+    for(const auto& access : list){
+      if(access.n_cycle > kMaxCycle){
+	std::ostringstream message;
+	message << "Too many cycle " << access.n_cycle;
+	Utility::PrintError(func_name, message.str());
+	return -1;
+      }
+
+      for(int32_t i = 0; i<access.n_cycle; ++i){
+	uint8_t udp_wd = static_cast<uint8_t>((access.data >> kDataSize*i) & kDataMask);
+	int32_t multi_byte_offset = i << kShiftMultiByteOffset;
+	trans_list.push_back(RBCP::RBCPEngine::MakeWrite(access.local_address+multi_byte_offset,
+							 &udp_wd, 1));
+      }
+    }
+
+    int32_t n_fail = GetEngine().Execute(trans_list);
+    if(n_fail != 0){
+      std::ostringstream message;
+      message << "Write error in " << n_fail << " of " << trans_list.size() << " accesses";
+      Utility::PrintError(func_name, message.str());
+    }
+
+    return n_fail;
+  }
+
+  // ReadModuleBatch ---------------------------------------------------------
+  int32_t
+  FPGAModule::ReadModuleBatch(std::vector<RegisterAccess>& list)
+  {
+    static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+    std::vector<RBCP::Transaction> trans_list;
+    trans_list.reserve(list.size());
+    for(const auto& access : list){
+      if(access.n_cycle > kMaxCycle){
+	std::ostringstream message;
+	message << "Too many cycle " << access.n_cycle;
+	Utility::PrintError(func_name, message.str());
+	return -1;
+      }
+
+      for(int32_t i = 0; i<access.n_cycle; ++i){
+	int32_t multi_byte_offset = i << kShiftMultiByteOffset;
+	trans_list.push_back(RBCP::RBCPEngine::MakeRead(access.local_address+multi_byte_offset, 1));
+      }
+    }
+
+    int32_t n_fail = GetEngine().Execute(trans_list);
+
+    auto itr = trans_list.cbegin();
+    for(auto& access : list){
+      uint32_t data = 0;
+      bool     good = true;
+      for(int32_t i = 0; i<access.n_cycle; ++i, ++itr){
+	if(itr->status < 0 || itr->data.empty()){
+	  good = false;
+	  continue;
+	}
+	uint32_t tmp = static_cast<uint32_t>(itr->data[0]);
+	data += (tmp & 0xff) << kDataSize*i;
+      }
+      access.data = good ? data : 0xeeeeeeee;
+    }
+
+    if(n_fail != 0){
+      std::ostringstream message;
+      message << "Read error in " << n_fail << " of " << trans_list.size() << " accesses";
+      Utility::PrintError(func_name, message.str());
+    }
+
+    return n_fail;
+  }
 };// End of namespace HUL
@@ -3,11 +3,13 @@
 
 #include<vector>
 #include<string>
+#include<memory>
 #include<stdint.h>
 
 namespace RBCP{
   struct RbcpHeader;
   class  UDPRBCP;
+  class  RBCPEngine;
 };
 
 namespace HUL{
@@ -21,10 +23,8 @@ namespace HUL{
 
     FPGAModule() = delete;
     FPGAModule(const FPGAModule&) = delete;
-    FPGAModule(RBCP::UDPRBCP& udp_rbcp)
-      :
-      udp_rbcp_(udp_rbcp){ };
-    virtual ~FPGAModule() = default;
+    FPGAModule(RBCP::UDPRBCP& udp_rbcp);
+    virtual ~FPGAModule();
     FPGAModule& operator=(const FPGAModule&) = delete;
 
     // 32-bit length regiser ----------------------------------
@@ -66,6 +66,24 @@ namespace HUL{
 			     const uint32_t n_byte
 			     );
 
+    // Batched access ------------------------------------------
+    // The accesses of a list are sent through a persistent pipelined
+    // RBCPEngine with up to batch_window requests in flight. Each entry
+    // is n_cycle 1-byte accesses as in WriteModule/ReadModule.
+    // A window of 1 keeps the order of the accesses even on packet loss.
+    struct RegisterAccess
+    {
+      uint32_t local_address;
+      uint32_t data;
+      int32_t  n_cycle;
+    };
+
+    // Return value is the number of failed RBCP accesses.
+    int32_t WriteModuleBatch(const std::vector<RegisterAccess>& list);
+    // data of each entry is filled with the read register
+    int32_t ReadModuleBatch(std::vector<RegisterAccess>& list);
+    void    SetBatchWindow(const int32_t window);
+
     uint32_t GetReadWord(){return rd_word_;};
 
     DataTypeItr GetDataIteratorBegin(){ return rd_data_.begin(); };
@@ -85,8 +103,13 @@ namespace HUL{
     static constexpr  int32_t    kMaxCycle64     {8};
     static constexpr  int32_t    kDataSize       {8};
     static constexpr  int32_t    kShiftMultiByteOffset {16};
+    static constexpr  int32_t    kBatchWindow    {16};
+
+    RBCP::RBCPEngine& GetEngine();
   
     RBCP::UDPRBCP&    udp_rbcp_;
+    std::unique_ptr<RBCP::RBCPEngine> engine_;
+    int32_t           batch_window_;
 
     DataType          rd_data_;
     uint32_t          rd_word_;
@@ -0,0 +1,270 @@
+#include"RBCPEngine.hh"
+#include"Utility.hh"
+
+#include<cstring>
+#include<chrono>
+#include<sstream>
+#include<arpa/inet.h>
+#include<unistd.h>
+#include<poll.h>
+#include<sys/types.h>
+#include<sys/socket.h>
+#include<netinet/in.h>
+
+namespace RBCP
+{
+
+namespace{
+  static const std::string class_name("RBCPEngine");
+
+  static constexpr int32_t kSizeUdpBuf     {4096};
+  static constexpr int32_t kTimeOutDefault {200000}; // usec
+  static constexpr int32_t kMaxRetransDef  {3};
+
+  int64_t
+  NowUs()
+  {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+// Constructor -------------------------------------------------------------
+RBCPEngine::RBCPEngine(const std::string ip_addr, const uint32_t port,
+		       const int32_t window)
+  :
+  ip_addr_(ip_addr),
+  port_(port),
+  sock_(-1),
+  rbcp_ver_(0xFF),
+  next_id_(0),
+  window_(1),
+  timeout_us_(kTimeOutDefault),
+  max_retrans_(kMaxRetransDef),
+  n_sent_(0),
+  n_retrans_(0)
+{
+  static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+  SetWindow(window);
+
+  sock_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if(sock_ < 0){
+    Utility::PrintError(func_name, "Cannot create a UDP socket");
+    return;
+  }
+
+  // the socket only receives packets from the board
+  struct sockaddr_in sitcp_addr;
+  memset(&sitcp_addr, 0, sizeof(sitcp_addr));
+  sitcp_addr.sin_family      = AF_INET;
+  sitcp_addr.sin_port        = htons(port_);
+  sitcp_addr.sin_addr.s_addr = inet_addr(ip_addr_.c_str());
+  if(0 > connect(sock_, (struct sockaddr*)&sitcp_addr, sizeof(sitcp_addr))){
+    Utility::PrintError(func_name, "Cannot connect the UDP socket to " + ip_addr_);
+    close(sock_);
+    sock_ = -1;
+  }
+}
+
+// Destructor --------------------------------------------------------------
+RBCPEngine::~RBCPEngine()
+{
+  if(sock_ >= 0) close(sock_);
+}
+
+// SetWindow ---------------------------------------------------------------
+void
+RBCPEngine::SetWindow(const int32_t window)
+{
+  // ids of the in-flight requests must stay far from each other
+  window_ = window < 1 ? 1 : (window > kMaxWindow_ ? kMaxWindow_ : window);
+}
+
+// MakeWrite ---------------------------------------------------------------
+Transaction
+RBCPEngine::MakeWrite(const uint32_t address, const uint8_t* data,
+		      const uint32_t length)
+{
+  Transaction trans;
+  trans.command = kRbcpCmdWr_;
+  trans.address = address;
+  trans.length  = static_cast<uint8_t>(length);
+  trans.data.assign(data, data + length);
+  if(length > kMaxLength_) trans.data.clear();
+  return trans;
+}
+
+// MakeRead ----------------------------------------------------------------
+Transaction
+RBCPEngine::MakeRead(const uint32_t address, const uint32_t length)
+{
+  Transaction trans;
+  trans.command = kRbcpCmdRd_;
+  trans.address = address;
+  trans.length  = static_cast<uint8_t>(length);
+  if(length > kMaxLength_) trans.length = 0;
+  return trans;
+}
+
+// Send --------------------------------------------------------------------
+bool
+RBCPEngine::Send(const uint8_t id)
+{
+  const Transaction& trans = *slot_[id].trans;
+
+  uint8_t    snd_buf[kSizeUdpBuf];
+  RbcpHeader header;
+  header.type    = rbcp_ver_;
+  header.command = trans.command;
+  header.id      = id;
+  header.length  = trans.length;
+  header.address = htonl(trans.address);
+  memcpy(snd_buf, &header, sizeof(RbcpHeader));
+
+  int32_t pck_len = sizeof(RbcpHeader);
+  if(trans.command == kRbcpCmdWr_){
+    memcpy(snd_buf + pck_len, trans.data.data(), trans.length);
+    pck_len += trans.length;
+  }
+
+  ++n_sent_;
+  return send(sock_, snd_buf, pck_len, 0) == pck_len;
+}
+
+// ReceiveAck --------------------------------------------------------------
+// Completes the request matching the reply, packets matching no request
+// in flight are dropped.
+void
+RBCPEngine::ReceiveAck(int32_t& n_fail)
+{
+  uint8_t rcvd_buf[kSizeUdpBuf];
+  int32_t rcvd_bytes = recv(sock_, rcvd_buf, kSizeUdpBuf, 0);
+  if(rcvd_bytes < (int32_t)sizeof(RbcpHeader)) return;
+
+  RbcpHeader header;
+  memcpy(&header, rcvd_buf, sizeof(RbcpHeader));
+  Slot& slot = slot_[header.id];
+  if(!slot.trans) return; // late reply of a retransmitted request
+
+  Transaction& trans = *slot.trans;
+  if(ntohl(header.address) != trans.address
+     || (header.command & 0xf0) != trans.command){
+    return;
+  }
+
+  if((0x0f & header.command) != 0x8){
+    trans.status = kStatusBusError_;
+    ++n_fail;
+  }else{
+    trans.status = rcvd_bytes;
+    if(trans.command == kRbcpCmdRd_){
+      trans.data.assign(rcvd_buf + sizeof(RbcpHeader), rcvd_buf + rcvd_bytes);
+    }
+  }
+
+  slot.trans = nullptr;
+}
+
+// Execute -----------------------------------------------------------------
+int32_t
+RBCPEngine::Execute(Transaction& trans)
+{
+  std::vector<Transaction> list(1, trans);
+  int32_t n_fail = Execute(list);
+  trans = list[0];
+  return n_fail;
+}
+
+int32_t
+RBCPEngine::Execute(std::vector<Transaction>& list)
+{
+  static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+  int32_t n_fail = 0;
+  if(sock_ < 0){
+    for(auto& trans : list) trans.status = kStatusSocket_;
+    return list.size();
+  }
+
+  std::vector<uint8_t> in_flight;
+  in_flight.reserve(window_);
+
+  std::size_t next = 0;
+  while(next < list.size() || !in_flight.empty()){
+    // fill the window
+    while((int32_t)in_flight.size() < window_ && next < list.size()){
+      Transaction& trans = list[next++];
+      if(trans.length == 0
+	 || (trans.command == kRbcpCmdWr_ && trans.data.size() < trans.length)){
+	std::ostringstream message;
+	message << "Invalid request, address 0x" << std::hex << trans.address;
+	Utility::PrintError(func_name, message.str());
+	trans.status = kStatusSocket_;
+	++n_fail;
+	continue;
+      }
+
+      // a request waiting for retransmission keeps its id
+      while(slot_[next_id_].trans) ++next_id_;
+      const uint8_t id = next_id_++;
+      slot_[id].trans     = &trans;
+      slot_[id].n_retrans = 0;
+      slot_[id].deadline  = NowUs() + timeout_us_;
+      Send(id);
+      in_flight.push_back(id);
+    }
+
+    if(in_flight.empty()) continue;
+
+    // wait for a reply until the oldest deadline
+    int64_t deadline = slot_[in_flight.front()].deadline;
+    for(uint8_t id : in_flight){
+      if(slot_[id].deadline < deadline) deadline = slot_[id].deadline;
+    }
+
+    int64_t wait_us = deadline - NowUs();
+    struct pollfd pfd;
+    pfd.fd     = sock_;
+    pfd.events = POLLIN;
+    if(wait_us > 0 && 0 < poll(&pfd, 1, (wait_us + 999)/1000)){
+      // take every reply already queued
+      do{
+	ReceiveAck(n_fail);
+	pfd.revents = 0;
+      }while(0 < poll(&pfd, 1, 0));
+    }
+
+    // drop the completed requests, retransmit the expired ones
+    const int64_t now = NowUs();
+    std::size_t n_keep = 0;
+    for(uint8_t id : in_flight){
+      Slot& slot = slot_[id];
+      if(!slot.trans) continue;
+
+      if(slot.deadline <= now){
+	if(slot.n_retrans < max_retrans_){
+	  ++slot.n_retrans;
+	  ++n_retrans_;
+	  slot.deadline = now + timeout_us_;
+	  Send(id);
+	}else{
+	  std::ostringstream message;
+	  message << "Time out, address 0x" << std::hex << slot.trans->address;
+	  Utility::PrintError(func_name, message.str());
+	  slot.trans->status = kStatusTimeOut_;
+	  slot.trans = nullptr;
+	  ++n_fail;
+	  continue;
+	}
+      }
+
+      in_flight[n_keep++] = id;
+    }
+    in_flight.resize(n_keep);
+  }
+
+  return n_fail;
+}
+
+};
@@ -0,0 +1,104 @@
+#ifndef RBCPENGINE_HH
+#define RBCPENGINE_HH
+
+#include<vector>
+#include<string>
+#include<stdint.h>
+
+#include"rbcp.hh"
+
+namespace RBCP{
+
+  // One RBCP access handled by the RBCPEngine.
+  // status: number of bytes of the ACK packet, or kStatus* on failure.
+  struct Transaction
+  {
+    uint8_t              command {0};
+    uint32_t             address {0};
+    uint8_t              length  {0};
+    std::vector<uint8_t> data;     // write data, read data after Execute()
+    int32_t              status  {0};
+  };
+
+  // __________________________________________________________________
+  // Pipelined RBCP client.
+  //
+  // A single UDP socket is kept open for the lifetime of the engine, and
+  // up to "window" requests are in flight at once. Replies are matched to
+  // requests by the RBCP id field, and a request without reply is resent
+  // with the same id after the time out.
+  //
+  // SiTCP executes the packets in arrival order, but a retransmitted
+  // request lands after the ones sent behind it. A window larger than 1
+  // is therefore only for accesses which do not depend on each other
+  // (register images, read back). Sequences writing to a FIFO or
+  // starting an operation must use a window of 1.
+  class RBCPEngine
+  {
+  public:
+    static constexpr int32_t  kStatusTimeOut_  {-3};
+    static constexpr int32_t  kStatusBusError_ {-1};
+    static constexpr int32_t  kStatusSocket_   {-2};
+    static constexpr int32_t  kMaxWindow_      {128};
+    static constexpr uint32_t kMaxLength_      {255};
+    static constexpr uint8_t  kRbcpCmdWr_      {0x80};
+    static constexpr uint8_t  kRbcpCmdRd_      {0xC0};
+
+  private:
+    struct Slot
+    {
+      Transaction* trans     {nullptr};
+      int32_t      n_retrans {0};
+      int64_t      deadline  {0}; // usec, steady clock
+    };
+
+    const std::string  ip_addr_;
+    const uint32_t     port_;
+    int                sock_;
+    uint8_t            rbcp_ver_;
+    uint8_t            next_id_;
+    int32_t            window_;
+    int32_t            timeout_us_;
+    int32_t            max_retrans_;
+    Slot               slot_[256];
+
+    // statistics
+    uint64_t           n_sent_;
+    uint64_t           n_retrans_;
+
+    // __________________________________________________________________
+  public:
+    RBCPEngine() = delete;
+    RBCPEngine(const RBCPEngine&) = delete;
+    RBCPEngine(const std::string ip_addr, const uint32_t port,
+	       const int32_t window = 16);
+    virtual ~RBCPEngine();
+    RBCPEngine& operator=(const RBCPEngine&) = delete;
+
+    // Member methods ___________________________________________________
+    bool     IsOpen() const { return sock_ >= 0; }
+
+    // Runs every transaction, returns the number of failed ones.
+    int32_t  Execute(std::vector<Transaction>& list);
+    int32_t  Execute(Transaction& trans);
+
+    static Transaction MakeWrite(const uint32_t address, const uint8_t* data,
+				 const uint32_t length);
+    static Transaction MakeRead(const uint32_t address, const uint32_t length);
+
+    void     SetRbcpVer(const uint8_t version) { rbcp_ver_ = version; }
+    void     SetWindow(const int32_t window);
+    void     SetTimeOut(const int32_t timeout_us) { timeout_us_ = timeout_us; }
+    void     SetMaxRetrans(const int32_t n) { max_retrans_ = n; }
+    int32_t  GetWindow() const { return window_; }
+    uint64_t GetNumSent() const { return n_sent_; }
+    uint64_t GetNumRetrans() const { return n_retrans_; }
+
+  private:
+    bool     Send(const uint8_t id);
+    void     ReceiveAck(int32_t& n_fail);
+  }; // End of Class definition
+
+}; // End of namespace RBCP
+
+#endif
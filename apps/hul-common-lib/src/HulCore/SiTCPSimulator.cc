@@ -0,0 +1,138 @@
+#include"SiTCPSimulator.hh"
+#include"rbcp.hh"
+#include"Utility.hh"
+
+#include<cstring>
+#include<arpa/inet.h>
+#include<unistd.h>
+#include<sys/types.h>
+#include<sys/socket.h>
+#include<sys/time.h>
+#include<netinet/in.h>
+
+namespace RBCP
+{
+
+namespace{
+  static const std::string class_name("SiTCPSimulator");
+
+  static constexpr int32_t kSizeUdpBuf  {4096};
+  static constexpr uint8_t kRbcpCmdWr   {0x80};
+  static constexpr uint8_t kRbcpCmdRd   {0xC0};
+  static constexpr uint8_t kRbcpAck     {0x08};
+  static constexpr uint8_t kRbcpBusErr  {0x01};
+}
+
+// Constructor -------------------------------------------------------------
+SiTCPSimulator::SiTCPSimulator(const uint32_t port, const double drop_rate,
+			       const int32_t delay_us)
+  :
+  port_(port),
+  sock_(-1),
+  drop_rate_(drop_rate),
+  delay_us_(delay_us),
+  stop_(false),
+  rng_(port),
+  n_request_(0),
+  n_drop_(0)
+{
+}
+
+// Destructor --------------------------------------------------------------
+SiTCPSimulator::~SiTCPSimulator()
+{
+  if(sock_ >= 0) close(sock_);
+}
+
+// Open --------------------------------------------------------------------
+bool
+SiTCPSimulator::Open()
+{
+  static const std::string func_name {"[" + class_name + "::" + __func__ + "()"};
+
+  sock_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if(sock_ < 0){
+    Utility::PrintError(func_name, "Cannot create a UDP socket");
+    return false;
+  }
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(port_);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if(0 > bind(sock_, (struct sockaddr*)&addr, sizeof(addr))){
+    Utility::PrintError(func_name, "Cannot bind the UDP port " + std::to_string(port_));
+    close(sock_);
+    sock_ = -1;
+    return false;
+  }
+
+  // wake up regularly to see Stop()
+  struct timeval tv;
+  tv.tv_sec  = 0;
+  tv.tv_usec = 100000;
+  setsockopt(sock_, SOL_SOCKET, SO_RCVTIMEO, (char*)&tv, sizeof(tv));
+
+  return true;
+}
+
+// Peek --------------------------------------------------------------------
+uint8_t
+SiTCPSimulator::Peek(const uint32_t address) const
+{
+  auto itr = memory_.find(address);
+  return itr == memory_.end() ? 0 : itr->second;
+}
+
+// Run ---------------------------------------------------------------------
+void
+SiTCPSimulator::Run()
+{
+  std::uniform_real_distribution<double> uniform(0., 1.);
+
+  uint8_t buf[kSizeUdpBuf];
+  while(!stop_ && sock_ >= 0){
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+    int32_t n = recvfrom(sock_, buf, sizeof(buf), 0,
+			 (struct sockaddr*)&from, &from_len);
+    if(n < (int32_t)sizeof(RbcpHeader)) continue;
+
+    ++n_request_;
+    if(drop_rate_ > 0. && uniform(rng_) < drop_rate_){
+      ++n_drop_;
+      continue;
+    }
+
+    if(delay_us_ > 0) usleep(delay_us_);
+
+    RbcpHeader header;
+    memcpy(&header, buf, sizeof(RbcpHeader));
+    const uint32_t address = ntohl(header.address);
+    const uint32_t length  = header.length;
+
+    int32_t reply_len = sizeof(RbcpHeader) + length;
+    if(header.command == kRbcpCmdWr
+       && n == (int32_t)(sizeof(RbcpHeader) + length)){
+      // the ACK of a write echoes the written data
+      for(uint32_t i = 0; i<length; ++i){
+	memory_[address + i] = buf[sizeof(RbcpHeader) + i];
+      }
+      header.command |= kRbcpAck;
+    }else if(header.command == kRbcpCmdRd){
+      for(uint32_t i = 0; i<length; ++i){
+	buf[sizeof(RbcpHeader) + i] = Peek(address + i);
+      }
+      header.command |= kRbcpAck;
+    }else{
+      header.command |= kRbcpAck | kRbcpBusErr;
+      reply_len = sizeof(RbcpHeader);
+    }
+
+    memcpy(buf, &header, sizeof(RbcpHeader));
+    sendto(sock_, buf, reply_len, 0, (struct sockaddr*)&from, from_len);
+  }
+}
+
+};
@@ -0,0 +1,57 @@
+#ifndef SITCPSIMULATOR_HH
+#define SITCPSIMULATOR_HH
+
+#include<atomic>
+#include<random>
+#include<string>
+#include<unordered_map>
+#include<stdint.h>
+
+namespace RBCP{
+
+  // __________________________________________________________________
+  // UDP responder answering RBCP requests like a SiTCP board, for
+  // testing and benchmarking the slow-control software without hardware.
+  // The register space is a sparse byte memory initialized to 0. A
+  // fraction of the requests can be dropped to exercise retransmission,
+  // and each request can be given a processing delay.
+  class SiTCPSimulator
+  {
+  private:
+    const uint32_t  port_;
+    int             sock_;
+    double          drop_rate_;
+    int32_t         delay_us_;
+    std::atomic<bool> stop_;
+    std::mt19937    rng_;
+    std::unordered_map<uint32_t, uint8_t> memory_;
+
+    // statistics
+    uint64_t        n_request_;
+    uint64_t        n_drop_;
+
+    // __________________________________________________________________
+  public:
+    SiTCPSimulator() = delete;
+    SiTCPSimulator(const SiTCPSimulator&) = delete;
+    SiTCPSimulator(const uint32_t port, const double drop_rate = 0.,
+		   const int32_t delay_us = 0);
+    virtual ~SiTCPSimulator();
+    SiTCPSimulator& operator=(const SiTCPSimulator&) = delete;
+
+    // Member methods ___________________________________________________
+    bool     Open();
+    // serves requests until Stop() is called
+    void     Run();
+    void     Stop() { stop_ = true; }
+
+    // not thread safe, to be used once Run() has returned
+    uint8_t  Peek(const uint32_t address) const;
+    uint64_t GetNumRequest() const { return n_request_; }
+    uint64_t GetNumDrop() const { return n_drop_; }
+
+  }; // End of Class definition
+
+}; // End of namespace RBCP
+
+#endif
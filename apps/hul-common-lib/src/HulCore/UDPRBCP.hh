@@ -68,6 +68,10 @@ namespace RBCP{
     }
     
     int  DoRBCP();
+    const std::string& GetIpAddr() const { return ip_addr_; }
+    uint32_t           GetPort() const   { return port_; }
+    uint8_t            GetRbcpVer() const { return send_header_.type; }
+
     void SetDispMode(const DebugMode mode)
     {
       mode_ = mode;
@@ -0,0 +1,95 @@
+// -*- C++ -*-
+
+#ifndef DC_COMBINATION_SEARCH_HH
+#define DC_COMBINATION_SEARCH_HH
+
+#include <vector>
+
+#include <TString.h>
+
+class DCPairHitCluster;
+
+//_____________________________________________________________________________
+// Depth-first generator of the cluster combinations of a local track
+// search, the lazy counterpart of track::MakeIndex().
+//
+// The combinations come in the order of MakeIndex() (plane 0 fastest,
+// "no cluster" = -1 first), so the track containers and their sorting
+// are unchanged. A branch is cut as soon as
+//  - the planes left cannot give min_n_hit hits any more, or
+//  - the least squares fit of the non-honeycomb hits chosen so far gives
+//    a chisqr/NDF above max_chisqr already with the largest possible NDF.
+// Both are lower bounds of what DCLocalTrack::DoFit() gives for every
+// combination of the branch, so no accepted track is lost. The honeycomb
+// hits move with the iterations of DoFit() and stay out of the bound;
+// max_chisqr=0 disables the chisqr cut (e.g. for DoFitBcSdc()).
+//
+// Only the combinations that pass the cuts count against max_combi. Once
+// there are more, Next() returns false and GetStatus() is false; the
+// caller then drops the tracks found so far, so an event gives either
+// all of its tracks or none.
+class DCCombinationSearch
+{
+public:
+  static const TString& ClassName();
+  using ClusterList = std::vector<DCPairHitCluster*>;
+  using IndexList   = std::vector<Int_t>;
+  DCCombinationSearch(const std::vector<ClusterList>& cand_cont,
+                      const IndexList& n_combi,
+                      Int_t min_n_hit,
+                      Double_t max_chisqr=0.,
+                      Double_t max_combi=1.0e6);
+  ~DCCombinationSearch();
+
+private:
+  DCCombinationSearch(const DCCombinationSearch&);
+  DCCombinationSearch& operator =(const DCCombinationSearch&);
+
+private:
+  // normal equations of (x0, u0, y0, v0) of the non-honeycomb hits
+  struct Sum
+  {
+    Int_t    n_hit; // all hits
+    Int_t    n_fit; // non-honeycomb hits
+    Double_t a[10]; // symmetric 4x4, packed
+    Double_t b[4];
+    Double_t c;
+  };
+
+  const std::vector<ClusterList>& m_cand_cont;
+  Int_t                           m_n_plane;
+  IndexList                       m_n_cand;         // [plane]
+  Int_t                           m_min_n_hit;
+  Double_t                        m_max_chisqr;
+  Double_t                        m_max_combi;
+  std::vector<std::vector<Sum>>   m_cluster_sum;    // [plane][cluster]
+  std::vector<Int_t>              m_max_hit_below;  // [plane]
+  IndexList                       m_index;          // [plane]
+  std::vector<Sum>                m_sum;            // [plane], planes >= plane
+  Int_t                           m_depth;
+  Double_t                        m_n_combi;
+  Double_t                        m_n_pruned;
+  Bool_t                          m_status;
+
+public:
+  // false at the end, or after max_combi combinations
+  Bool_t   Next(IndexList& combination);
+  Bool_t   GetStatus() const { return m_status; }
+  Double_t GetNCombi() const { return m_n_combi; }
+  Double_t GetNPruned() const { return m_n_pruned; }
+
+private:
+  Bool_t   IsPruned(Int_t plane) const;
+  static void     Add(Sum& sum, const Sum& right);
+  static Double_t MinChisqr(const Sum& sum);
+};
+
+//_____________________________________________________________________________
+inline const TString&
+DCCombinationSearch::ClassName()
+{
+  static TString s_name("DCCombinationSearch");
+  return s_name;
+}
+
+#endif
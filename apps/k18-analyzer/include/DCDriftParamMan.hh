@@ -7,6 +7,8 @@
 #include <vector>
 #include <TString.h>
 
+#include "DenseParamTable.hh"
+
 struct DCDriftParamRecord;
 
 //_____________________________________________________________________________
@@ -35,9 +37,13 @@ private:
 private:
   typedef std::map<Int_t, DCDriftParamRecord*> DCDriftContainer;
   typedef DCDriftContainer::const_iterator DCDriftIterator;
+  // [plane][wire] of the keys, built by Freeze()
+  typedef DenseParamTable<DCDriftParamRecord, 1> DCDriftTable;
   Bool_t           m_is_ready;
+  Bool_t           m_is_frozen;
   TString          m_file_name;
   DCDriftContainer m_container;
+  DCDriftTable     m_table;
 
 public:
   Bool_t CalcDrift(Int_t PlaneId, Double_t WireId, Double_t ctime,
@@ -45,6 +51,10 @@ public:
   Bool_t Initialize();
   Bool_t Initialize(const TString& file_name);
   Bool_t IsReady() const { return m_is_ready; }
+  // the lookups use the table once frozen (end of Initialize()),
+  // Freeze(false) puts them back on the map
+  void   Freeze(Bool_t flag=true);
+  Bool_t IsFrozen() const { return m_is_frozen; }
   void   SetFileName(const TString& file_name) { m_file_name = file_name; }
 
 private:
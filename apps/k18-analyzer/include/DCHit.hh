@@ -13,6 +13,8 @@
 
 #include <std_ostream.hh>
 
+#include "ObjectPool.hh"
+
 class DCRawHit;
 class DCLTrackHit;
 
@@ -21,6 +23,8 @@ class DCHit
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   DCHit(const DCRawHit* rhit);
   DCHit(Int_t layer);
   DCHit(Int_t layer, Double_t wire);
@@ -237,4 +241,18 @@ DCHit::Compare(const DCHit* left, const DCHit* right)
     return left->LayerId() < right->LayerId();
 }
 
+//_____________________________________________________________________________
+inline void*
+DCHit::operator new(std::size_t size)
+{
+  return mem::ObjectPool<DCHit>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+DCHit::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<DCHit>::Deallocate(p, size);
+}
+
 #endif
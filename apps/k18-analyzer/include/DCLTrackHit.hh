@@ -4,6 +4,7 @@
 #define DC_LTRACK_HIT_HH
 
 #include "DCHit.hh"
+#include "ObjectPool.hh"
 
 #include <TString.h>
 
@@ -14,6 +15,8 @@ class DCLTrackHit
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   DCLTrackHit(DCHit* hit, Double_t pos, Int_t nh);
   DCLTrackHit(const DCLTrackHit& right);
   ~DCLTrackHit();
@@ -118,4 +121,18 @@ DCLTrackHit::ClassName()
   return s_name;
 }
 
+//_____________________________________________________________________________
+inline void*
+DCLTrackHit::operator new(std::size_t size)
+{
+  return mem::ObjectPool<DCLTrackHit>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+DCLTrackHit::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<DCLTrackHit>::Deallocate(p, size);
+}
+
 #endif
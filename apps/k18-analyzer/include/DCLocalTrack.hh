@@ -8,26 +8,38 @@
 
 #include <std_ostream.hh>
 
+#include "ObjectPool.hh"
 #include "ThreeVector.hh"
 #include "DCLTrackHit.hh"
 #include "DetectorID.hh"
 
 class DCLTrackHit;
 class DCAnalyzer;
+class DCLocalTrackFitter;
 
 //_____________________________________________________________________________
 class DCLocalTrack
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   explicit DCLocalTrack();
   ~DCLocalTrack();
 
 private:
   DCLocalTrack(const DCLocalTrack &);
   DCLocalTrack & operator =(const DCLocalTrack &);
+  friend class DCLocalTrackFitter;
 
 private:
+  // inputs of one iteration of DoFit() [hit], the residual of a hit
+  // is (r-s)*c with s of the track at z0
+  struct FitInput
+  {
+    std::vector<Double_t> z0, z, w, s, ct, st, r, c;
+  };
+
   Bool_t  m_is_fitted;     // flag of DoFit()
   Bool_t  m_is_calculated; // flag of Calculate()
   Bool_t  m_is_bcsdc;
@@ -125,6 +137,13 @@ public:
   Double_t GetDe() const { return m_de; }
   void   Print(const TString& arg="", std::ostream& ost=hddaq::cout) const;
   void   PrintVXU(const TString& arg="") const;
+
+private:
+  Int_t  BeginFit(const TString& func);
+  void   SetFitInput(Int_t iItr, FitInput& in) const;
+  Bool_t EndIteration(Int_t iItr, Double_t x0, Double_t u0,
+                      Double_t y0, Double_t v0, Double_t chisqr,
+                      Double_t& prev_chisqr);
 };
 
 //_____________________________________________________________________________
@@ -323,4 +342,18 @@ struct DCLTrackCompSdcOut
     }
 };
 
+//_____________________________________________________________________________
+inline void*
+DCLocalTrack::operator new(std::size_t size)
+{
+  return mem::ObjectPool<DCLocalTrack>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+DCLocalTrack::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<DCLocalTrack>::Deallocate(p, size);
+}
+
 #endif
@@ -0,0 +1,71 @@
+// -*- C++ -*-
+
+#ifndef DC_LOCAL_TRACK_FITTER_HH
+#define DC_LOCAL_TRACK_FITTER_HH
+
+#include <vector>
+
+#include <TString.h>
+
+#include "DCLocalTrack.hh"
+
+//_____________________________________________________________________________
+// Batched DCLocalTrack::DoFit() of the track candidates of a search.
+//
+// The candidates are fitted NLane at a time: the hits of each lane are
+// laid out as [hit][lane] (padded with zero weight), the normal equations
+// are summed in the same order as MathTools::SolveGaussJordan() and the
+// 4x4 systems are solved by LDL^T in parallel lanes (AVX2 when the CPU
+// has it). The honeycomb iterations go on for the candidates which have
+// not converged. The results agree with DoFit() within rounding.
+class DCLocalTrackFitter
+{
+public:
+  static const TString& ClassName();
+  static constexpr Int_t NLane = 4;
+  explicit DCLocalTrackFitter(Int_t block_size=64);
+  ~DCLocalTrackFitter();
+
+private:
+  DCLocalTrackFitter(const DCLocalTrackFitter&);
+  DCLocalTrackFitter& operator =(const DCLocalTrackFitter&);
+
+private:
+  Int_t                                m_block_size;
+  std::vector<DCLocalTrack*>           m_track;
+  std::vector<Bool_t>                  m_status;
+  std::vector<DCLocalTrack::FitInput>  m_input;
+  std::vector<Int_t>                   m_n_itr;
+  std::vector<Double_t>                m_prev_chisqr;
+  std::vector<Int_t>                   m_active;
+  std::vector<Int_t>                   m_next;
+  std::vector<Double_t>                m_lane;  // [hit][input][lane]
+
+public:
+  void          Add(DCLocalTrack* track) { m_track.push_back(track); }
+  void          Clear();
+  // fits all the candidates, returns the number of successful fits
+  Int_t         Fit();
+  Int_t         GetNTrack() const { return m_track.size(); }
+  DCLocalTrack* GetTrack(Int_t i) const { return m_track.at(i); }
+  // result of DoFit() of the i-th candidate
+  Bool_t        GetStatus(Int_t i) const { return m_status.at(i); }
+  Bool_t        IsFull() const { return GetNTrack() >= m_block_size; }
+  // AVX2 kernel on/off for all the fitters (test/fittest), false when
+  // the AVX2 kernel is asked for and the CPU does not have it
+  static Bool_t SetUseAvx2(Bool_t flag);
+  static Bool_t UseAvx2();
+
+private:
+  Int_t         FillLane(const Int_t* index, Int_t n);
+};
+
+//_____________________________________________________________________________
+inline const TString&
+DCLocalTrackFitter::ClassName()
+{
+  static TString s_name("DCLocalTrackFitter");
+  return s_name;
+}
+
+#endif
@@ -5,11 +5,15 @@
 
 #include <TString.h>
 
+#include "ObjectPool.hh"
+
 //_____________________________________________________________________________
 class DCRawHit
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   DCRawHit(const TString& detector_name, Int_t plane_id, Int_t wire_id);
   ~DCRawHit();
 
@@ -56,4 +60,18 @@ DCRawHit::ClassName()
   return s_name;
 }
 
+//_____________________________________________________________________________
+inline void*
+DCRawHit::operator new(std::size_t size)
+{
+  return mem::ObjectPool<DCRawHit>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+DCRawHit::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<DCRawHit>::Deallocate(p, size);
+}
+
 #endif
@@ -7,6 +7,8 @@
 #include <vector>
 #include <TString.h>
 
+#include "DenseParamTable.hh"
+
 struct DCTdcCalMap;
 
 //_____________________________________________________________________________
@@ -25,9 +27,13 @@ private:
 private:
   typedef std::map<Int_t, DCTdcCalMap*> DCTdcContainer;
   typedef DCTdcContainer::const_iterator DCTdcIterator;
+  // [plane][wire] of the keys, built by Freeze()
+  typedef DenseParamTable<DCTdcCalMap, 1> DCTdcTable;
   Bool_t         m_is_ready;
+  Bool_t         m_is_frozen;
   TString        m_file_name;
   DCTdcContainer m_container;
+  DCTdcTable     m_table;
 
 public:
   Bool_t GetParameter(Int_t plane_id, Double_t wire_id,
@@ -39,6 +45,10 @@ public:
   Bool_t Initialize();
   Bool_t Initialize(const TString& file_name);
   Bool_t IsReady() const { return m_is_ready; }
+  // the lookups use the table once frozen (end of Initialize()),
+  // Freeze(false) puts them back on the map
+  void   Freeze(Bool_t flag=true);
+  Bool_t IsFrozen() const { return m_is_frozen; }
   void   SetFileName(const TString& file_name) { m_file_name = file_name; }
 
 private:
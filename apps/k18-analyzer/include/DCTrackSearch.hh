@@ -32,6 +32,10 @@ std::vector<IndexList> MakeIndex_VXU(Int_t ndim, Int_t maximumHit, const Int_t *
 std::vector<IndexList> MakeIndex_VXU(Int_t ndim, Int_t maximumHit, const IndexList& index1);
 DCLocalTrack*          MakeTrack(const std::vector<ClusterList>& CandCont,
                                  const IndexList& combination);
+void                   MakeCandidates(const std::vector<DCHC>& HC,
+                                      const DCPairPlaneInfo *PpInfo,
+                                      Int_t npp,
+                                      std::vector<ClusterList>& CandCont);
 
 Int_t LocalTrackSearch(const std::vector<DCHC>& HC,
                        const DCPairPlaneInfo *PpInfo,
@@ -0,0 +1,127 @@
+// -*- C++ -*-
+
+#ifndef DENSE_PARAM_TABLE_HH
+#define DENSE_PARAM_TABLE_HH
+
+#include <algorithm>
+#include <vector>
+
+#include <TString.h>
+
+//_____________________________________________________________________________
+// Flat lookup table of the parameter records of a manager, built from its
+// std::map once the parameter file is loaded (Freeze() of the managers).
+//
+// A record is addressed by a detector (or plane) id and N indices inside
+// it, e.g. (plane, segment, up/down). Each id has its own extent of the
+// indices and an offset in a single array of record pointers, nullptr is
+// a missing entry. A lookup is a few bounds checks and two indexed loads.
+// The records stay owned by the map.
+template <typename T, Int_t N>
+class DenseParamTable
+{
+public:
+  DenseParamTable();
+  ~DenseParamTable();
+
+private:
+  struct Detector
+  {
+    Int_t offset;
+    Int_t size[N]; // 0 when the id has no record
+  };
+  std::vector<Detector> m_detector; // [id]
+  std::vector<T*>       m_record;
+
+public:
+  void Clear();
+  // decode(key, id, index) gives the address of a key of the map,
+  // false if the key cannot be put in the table
+  template <typename Map, typename Decode>
+  void Build(const Map& cont, Decode decode);
+  T*   Get(Int_t id, const Int_t (&index)[N]) const;
+};
+
+//_____________________________________________________________________________
+template <typename T, Int_t N>
+inline
+DenseParamTable<T, N>::DenseParamTable()
+  : m_detector(),
+    m_record()
+{
+}
+
+//_____________________________________________________________________________
+template <typename T, Int_t N>
+inline
+DenseParamTable<T, N>::~DenseParamTable()
+{
+}
+
+//_____________________________________________________________________________
+template <typename T, Int_t N>
+inline void
+DenseParamTable<T, N>::Clear()
+{
+  m_detector.clear();
+  m_record.clear();
+}
+
+//_____________________________________________________________________________
+template <typename T, Int_t N>
+template <typename Map, typename Decode>
+inline void
+DenseParamTable<T, N>::Build(const Map& cont, Decode decode)
+{
+  Clear();
+  Int_t id;
+  Int_t index[N];
+  for(const auto& p: cont){
+    if(!p.second || !decode(p.first, id, index))
+      continue;
+    if(id >= (Int_t)m_detector.size())
+      m_detector.resize(id+1, Detector());
+    Detector& d = m_detector[id];
+    for(Int_t k=0; k<N; ++k)
+      d.size[k] = std::max(d.size[k], index[k]+1);
+  }
+
+  Int_t n_record = 0;
+  for(auto& d: m_detector){
+    d.offset = n_record;
+    Int_t size = 1;
+    for(Int_t k=0; k<N; ++k)
+      size *= d.size[k];
+    n_record += size;
+  }
+
+  m_record.assign(n_record, nullptr);
+  for(const auto& p: cont){
+    if(!p.second || !decode(p.first, id, index))
+      continue;
+    const Detector& d = m_detector[id];
+    Int_t i = 0;
+    for(Int_t k=0; k<N; ++k)
+      i = i*d.size[k] + index[k];
+    m_record[d.offset+i] = p.second;
+  }
+}
+
+//_____________________________________________________________________________
+template <typename T, Int_t N>
+inline T*
+DenseParamTable<T, N>::Get(Int_t id, const Int_t (&index)[N]) const
+{
+  if(id < 0 || id >= (Int_t)m_detector.size())
+    return nullptr;
+  const Detector& d = m_detector[id];
+  Int_t i = 0;
+  for(Int_t k=0; k<N; ++k){
+    if(index[k] < 0 || index[k] >= d.size[k])
+      return nullptr;
+    i = i*d.size[k] + index[k];
+  }
+  return m_record[d.offset+i];
+}
+
+#endif
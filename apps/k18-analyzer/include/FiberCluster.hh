@@ -9,12 +9,15 @@
 
 #include "FiberHit.hh"
 #include "HodoCluster.hh"
+#include "ObjectPool.hh"
 
 //_____________________________________________________________________________
 class FiberCluster : public HodoCluster
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   FiberCluster(const HodoHC& cont,
                const index_t& index);
   virtual ~FiberCluster();
@@ -35,4 +38,18 @@ FiberCluster::ClassName()
   return s_name;
 }
 
+//_____________________________________________________________________________
+inline void*
+FiberCluster::operator new(std::size_t size)
+{
+  return mem::ObjectPool<FiberCluster>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+FiberCluster::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<FiberCluster>::Deallocate(p, size);
+}
+
 #endif
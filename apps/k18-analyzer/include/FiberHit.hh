@@ -9,12 +9,15 @@
 
 // #include "DCHit.hh"
 #include "HodoHit.hh"
+#include "ObjectPool.hh"
 
 //_____________________________________________________________________________
 class FiberHit : public HodoHit
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   explicit FiberHit(HodoRawHit* hit);
   virtual  ~FiberHit();
 
@@ -79,4 +82,18 @@ FiberHit::Compare(const FiberHit* left, const FiberHit* right)
   return left->Position() < right->Position();
 }
 
+//_____________________________________________________________________________
+inline void*
+FiberHit::operator new(std::size_t size)
+{
+  return mem::ObjectPool<FiberHit>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+FiberHit::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<FiberHit>::Deallocate(p, size);
+}
+
 #endif
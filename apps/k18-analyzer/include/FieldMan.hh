@@ -34,6 +34,7 @@ private:
   S2sFieldMap* m_s2s_map;
   S2sFieldMap* m_shs_map;
   FEContainer     m_element_list;
+  Bool_t          m_central_difference;
 
 public:
   Bool_t   Initialize();
@@ -42,16 +43,26 @@ public:
                       const TString& file_name_shs);
   Bool_t   IsReady() const { return m_is_ready; }
   TVector3 GetField(const TVector3& position) const;
+  // field and its derivatives (per mm) from one lookup of the map, or
+  // from the +-0.1 mm differences of GetdBdX()/GetdBdY() as before with
+  // SetCentralDifference(true) (FLDCDIFF 1 in the conf file)
+  TVector3 GetField(const TVector3& position,
+                    TVector3& dBdX, TVector3& dBdY,
+                    TVector3* dBdZ=nullptr) const;
   TVector3 GetdBdX(const TVector3& position) const;
   TVector3 GetdBdY(const TVector3& position) const;
   TVector3 GetdBdZ(const TVector3& position) const;
   void     ClearElementsList();
   void     AddElement(FieldElements* element);
+  void     SetCentralDifference(Bool_t flag) { m_central_difference = flag; }
   void     SetS2sFileName(const TString& file_name) { m_file_name_s2s = file_name; }
   void     SetShsFileName(const TString& file_name) { m_file_name_shs = file_name; }
   Double_t StepSize(const TVector3& position,
                     Double_t default_step_size,
                     Double_t min_step_size) const;
+
+private:
+  TVector3 GetElementField(const TVector3& position) const;
 };
 
 //_____________________________________________________________________________
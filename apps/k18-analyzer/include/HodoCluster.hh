@@ -6,6 +6,7 @@
 #include <TString.h>
 
 #include "HodoHit.hh"
+#include "ObjectPool.hh"
 
 using index_t = std::vector<Int_t>;
 
@@ -14,6 +15,8 @@ class HodoCluster
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   HodoCluster(const HodoHC& cont,
               const index_t& index);
   virtual ~HodoCluster();
@@ -76,4 +79,18 @@ HodoCluster::ClassName()
   return s_name;
 }
 
+//_____________________________________________________________________________
+inline void*
+HodoCluster::operator new(std::size_t size)
+{
+  return mem::ObjectPool<HodoCluster>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+HodoCluster::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<HodoCluster>::Deallocate(p, size);
+}
+
 #endif
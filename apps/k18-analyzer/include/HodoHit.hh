@@ -9,6 +9,7 @@
 #include <TString.h>
 
 #include "HodoRawHit.hh"
+#include "ObjectPool.hh"
 #include "ThreeVector.hh"
 
 class HodoHit;
@@ -24,6 +25,8 @@ public:
                    Double_t max_time_diff=10.);
   virtual ~HodoHit();
   static TString ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
 
 private:
   HodoHit(const HodoHit&);
@@ -137,4 +140,18 @@ HodoHit::Compare(const HodoHit* left, const HodoHit* right)
   return left->SegmentId() < right->SegmentId();
 }
 
+//_____________________________________________________________________________
+inline void*
+HodoHit::operator new(std::size_t size)
+{
+  return mem::ObjectPool<HodoHit>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+HodoHit::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<HodoHit>::Deallocate(p, size);
+}
+
 #endif
@@ -6,6 +6,8 @@
 #include <map>
 #include <TString.h>
 
+#include "DenseParamTable.hh"
+
 //_____________________________________________________________________________
 //Hodo TDC to Time
 class HodoTParam
@@ -122,17 +124,28 @@ private:
   typedef TContainer::const_iterator TIterator;
   typedef AContainer::const_iterator AIterator;
   typedef FContainer::const_iterator FIterator;
+  // [cid][plid][seg][ud], built by Freeze()
+  typedef DenseParamTable<HodoTParam, 3> TTable;
+  typedef DenseParamTable<HodoAParam, 3> ATable;
   Bool_t     m_is_ready;
+  Bool_t     m_is_frozen;
   TString    m_file_name;
   TContainer m_TPContainer;
   AContainer m_AHPContainer;
   AContainer m_ALPContainer;
   FContainer m_FPContainer;
+  TTable     m_TPTable;
+  ATable     m_AHPTable;
+  ATable     m_ALPTable;
 
 public:
   Bool_t   Initialize();
   Bool_t   Initialize(const TString& file_name);
   Bool_t   IsReady() const { return m_is_ready; }
+  // the lookups use the tables once frozen (end of Initialize()),
+  // Freeze(false) puts them back on the maps
+  void     Freeze(Bool_t flag=true);
+  Bool_t   IsFrozen() const { return m_is_frozen; }
   Bool_t   GetTime(Int_t cid, Int_t plid, Int_t seg,
                    Int_t ud, Int_t tdc, Double_t &time) const;
   Bool_t   GetDeHighGain(Int_t cid, Int_t plid, Int_t seg,
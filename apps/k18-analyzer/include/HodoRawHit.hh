@@ -7,11 +7,15 @@
 
 #include <TString.h>
 
+#include "ObjectPool.hh"
+
 //_____________________________________________________________________________
 class HodoRawHit
 {
 public:
   static const TString& ClassName();
+  static void* operator new(std::size_t size);
+  static void  operator delete(void* p, std::size_t size);
   HodoRawHit(const TString& detector_name, Int_t plane_id, Int_t segment_id);
   ~HodoRawHit();
   enum EChannel { kUp, kDown, kExtra, kNChannel };
@@ -138,4 +142,18 @@ HodoRawHit::ClassName()
   return s_name;
 }
 
+//_____________________________________________________________________________
+inline void*
+HodoRawHit::operator new(std::size_t size)
+{
+  return mem::ObjectPool<HodoRawHit>::Allocate(size);
+}
+
+//_____________________________________________________________________________
+inline void
+HodoRawHit::operator delete(void* p, std::size_t size)
+{
+  mem::ObjectPool<HodoRawHit>::Deallocate(p, size);
+}
+
 #endif
@@ -0,0 +1,140 @@
+// -*- C++ -*-
+
+#ifndef OBJECT_POOL_HH
+#define OBJECT_POOL_HH
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+//_____________________________________________________________________________
+// Storage of the objects created and deleted in every event (raw hits,
+// hits, clusters, tracks), used by their class operator new/delete.
+//
+// Deleted objects go to a free list and are reused by the next event, the
+// chunks are never given back, so after the first events no allocation
+// reaches malloc. The analysis is single threaded (ParallelDriver forks
+// processes), the pool is not locked. Derived classes of a different size
+// which do not have their own pool use the global operator new.
+namespace mem
+{
+//_____________________________________________________________________________
+// false: Allocate()/Deallocate() go to the global operator new/delete, to
+// compare the two (test/poolbench). Switch only between events, when no
+// object of a pooled class is alive.
+inline bool&
+UsePool()
+{
+  static bool s_use_pool = true;
+  return s_use_pool;
+}
+
+//_____________________________________________________________________________
+template <typename T>
+class ObjectPool
+{
+public:
+  static ObjectPool& GetInstance();
+  ~ObjectPool();
+
+private:
+  ObjectPool();
+  ObjectPool(const ObjectPool&);
+  ObjectPool& operator =(const ObjectPool&);
+
+private:
+  union Node
+  {
+    Node* m_next;
+    alignas(T) char m_storage[sizeof(T)];
+  };
+  static const std::size_t kChunkSize = 256; // objects
+
+  Node*              m_free;
+  std::vector<Node*> m_chunk;
+
+public:
+  static void* Allocate(std::size_t size);
+  static void  Deallocate(void* p, std::size_t size);
+  std::size_t  GetNChunk() const { return m_chunk.size(); }
+
+private:
+  void  Grow();
+};
+
+//_____________________________________________________________________________
+template <typename T>
+inline ObjectPool<T>&
+ObjectPool<T>::GetInstance()
+{
+  // never destroyed, objects may be deleted by other static destructors
+  static ObjectPool* s_instance = new ObjectPool;
+  return *s_instance;
+}
+
+//_____________________________________________________________________________
+template <typename T>
+inline
+ObjectPool<T>::ObjectPool()
+  : m_free(nullptr),
+    m_chunk()
+{
+}
+
+//_____________________________________________________________________________
+template <typename T>
+inline
+ObjectPool<T>::~ObjectPool()
+{
+  for(auto& chunk: m_chunk)
+    ::operator delete(chunk);
+}
+
+//_____________________________________________________________________________
+template <typename T>
+inline void
+ObjectPool<T>::Grow()
+{
+  Node* chunk = static_cast<Node*>(::operator new(kChunkSize*sizeof(Node)));
+  m_chunk.push_back(chunk);
+  for(std::size_t i=0; i<kChunkSize; ++i){
+    chunk[i].m_next = m_free;
+    m_free = &chunk[i];
+  }
+}
+
+//_____________________________________________________________________________
+template <typename T>
+inline void*
+ObjectPool<T>::Allocate(std::size_t size)
+{
+  if(size != sizeof(T) || !UsePool())
+    return ::operator new(size);
+  ObjectPool& pool = GetInstance();
+  if(!pool.m_free)
+    pool.Grow();
+  Node* node = pool.m_free;
+  pool.m_free = node->m_next;
+  return node;
+}
+
+//_____________________________________________________________________________
+template <typename T>
+inline void
+ObjectPool<T>::Deallocate(void* p, std::size_t size)
+{
+  if(!p)
+    return;
+  if(size != sizeof(T) || !UsePool()){
+    ::operator delete(p);
+    return;
+  }
+  ObjectPool& pool = GetInstance();
+  Node* node = static_cast<Node*>(p);
+  node->m_next = pool.m_free;
+  pool.m_free = node;
+}
+
+}
+
+#endif
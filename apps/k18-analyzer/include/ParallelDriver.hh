@@ -0,0 +1,85 @@
+// -*- C++ -*-
+
+#ifndef PARALLEL_DRIVER_HH
+#define PARALLEL_DRIVER_HH
+
+#include <functional>
+#include <vector>
+
+#include <sys/types.h>
+
+#include <TString.h>
+
+//_____________________________________________________________________________
+// Event-parallel driver of the analyzer.
+//
+// The unpacker, the parameter managers and the user code (root::event,
+// root::tree, histograms) are process-wide singletons, so each worker is
+// a forked process running the ordinary sequential analysis on its own
+// output file. The parent is the I/O process: it reads the raw events
+// from the input stream and writes each of them to the stdin pipe of a
+// worker, whose unpacker reads "std::cin". At the end the worker files
+// are merged (TTree/TH1) into the output file.
+//
+// In the ordered mode the events are dealt round-robin and the trees of
+// the output are rebuilt in the input order, assuming that ProcessingEnd
+// fills each tree once per event. Otherwise an event goes to the first
+// worker able to take it and the trees are concatenated.
+class ParallelDriver
+{
+public:
+  static const TString& ClassName();
+  // runs the sequential analysis of a worker, returns the exit status
+  using Analysis = std::function<Int_t(const TString& in_file,
+                                       const TString& out_file)>;
+
+  ParallelDriver(const TString& in_file, const TString& out_file,
+                 Int_t n_worker, Bool_t ordered=false);
+  ~ParallelDriver();
+
+private:
+  ParallelDriver(const ParallelDriver&);
+  ParallelDriver& operator=(const ParallelDriver&);
+
+private:
+  TString                m_in_file;
+  TString                m_out_file;
+  Int_t                  m_n_worker;
+  Bool_t                 m_ordered;
+  Long64_t               m_skip;
+  Long64_t               m_max_loop;
+  std::vector<pid_t>     m_pid;
+  std::vector<Int_t>     m_fd;      // write end of the worker pipes
+  std::vector<Long64_t>  m_n_event; // events sent to each worker
+  Bool_t                 m_keep_worker_file;
+
+public:
+  // skip and max_loop of the unpacker configuration apply to the stream
+  // of each worker and are reset there, the dispatcher applies these
+  void    SetSkip(Long64_t n) { m_skip = n; }
+  void    SetMaxLoop(Long64_t n) { m_max_loop = n; }
+  void    KeepWorkerFile(Bool_t flag=true) { m_keep_worker_file = flag; }
+  Int_t   Run(const Analysis& analysis);
+  TString WorkerFileName(Int_t i) const;
+  TString WorkerLogName(Int_t i) const;
+
+private:
+  Bool_t  Fork(const Analysis& analysis);
+  Bool_t  Dispatch();
+  Bool_t  Wait();
+  Bool_t  Merge();
+  Bool_t  MergeOrdered(const TString& tree_name);
+  Int_t   SelectWorker(Long64_t event);
+  Bool_t  WriteEvent(Int_t i, const char* buf, size_t n);
+  void    CloseWorker(Int_t i);
+};
+
+//_____________________________________________________________________________
+inline const TString&
+ParallelDriver::ClassName()
+{
+  static TString s_name("ParallelDriver");
+  return s_name;
+}
+
+#endif
@@ -35,6 +35,7 @@ private:
 
 public:
   void           Clear(const TString& name="");
+  // loops over the fired channels of the device only (see DigitIndex)
   Bool_t         DecodeHits(const TString& name="");
   Bool_t         DecodeCalibHits();
   const HodoRHC& GetHodoRawHitContainer(const TString& name) const;
@@ -59,12 +60,6 @@ public:
   template <typename T> const T* Get(const TString& name, Int_t i) const;
 
 private:
-  Bool_t AddHodoRawHit(const TString& name, Int_t plane, Int_t seg,
-                       Int_t UorD, Int_t data, Double_t val);
-  Bool_t AddFiberRawHit(const TString& name, Int_t plane, Int_t seg,
-                        Int_t UorD, Int_t data, Double_t val);
-  Bool_t AddDCRawHit(const TString& name, Int_t plane, Int_t seg,
-                     Int_t UorD, Int_t data, Double_t val);
   void TdcCut(const TString& name, Double_t min_tdc, Double_t max_tdc);
   void EraseEmptyHits(DCRHC& HitCont);
 };
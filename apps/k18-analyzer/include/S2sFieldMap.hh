@@ -3,7 +3,9 @@
 #ifndef S2S_FIELD_MAP_HH
 #define S2S_FIELD_MAP_HH
 
+#include <cstddef>
 #include <vector>
+
 #include <TString.h>
 
 //_____________________________________________________________________________
@@ -20,11 +22,14 @@ private:
   S2sFieldMap& operator =(const S2sFieldMap&);
 
 private:
-  struct XYZ { Double_t x, y, z; };
-  typedef std::vector<std::vector<std::vector<XYZ>>> Field;
-  Bool_t   m_is_ready;
-  TString  m_file_name;
-  Field    B;
+  // the components are stored separately (SoA) on one flat grid, the
+  // 8 corners of a cell are at index(ix, iy, iz) + {0, 1, Nz, Nz+1, ...}
+  Bool_t                m_is_ready;
+  TString               m_file_name;
+  std::vector<Double_t> m_field;   // [3][Nx][Ny][Nz] parsed from the text
+  const Double_t*       B[3];      // into m_field or the mapped cache
+  void*                 m_map_addr;
+  size_t                m_map_size;
   Int_t    Nx;
   Int_t    Ny;
   Int_t    Nz;
@@ -43,10 +48,17 @@ private:
 public:
   Bool_t Initialize();
   Bool_t IsReady() const { return m_is_ready; }
-  Bool_t GetFieldValue(const Double_t pointCM[3], Double_t* BfieldTesla) const;
+  // dBdxTeslaPerCM[3*j+i] = dB_i/dx_j, from the same trilinear weights
+  Bool_t GetFieldValue(const Double_t pointCM[3], Double_t* BfieldTesla,
+                       Double_t* dBdxTeslaPerCM=nullptr) const;
 
 private:
-  void ClearField();
+  void    ClearField();
+  // binary copy of the scaled field next to the text map, mapped at
+  // the next start instead of parsing the text
+  TString CacheFileName() const;
+  Bool_t  ReadCache(Double_t factor);
+  void    WriteCache(Double_t factor) const;
 };
 
 //_____________________________________________________________________________
@@ -31,7 +31,9 @@ Catch(Int_t sig)
 {
   std::signal(SIGINT, SIG_IGN);
   user_stop = true;
-  if(gUnpacker.get_root()->is_esc_on()){
+  // no unpacker in the dispatcher of the parallel mode
+  const Unpacker* root = gUnpacker.get_root();
+  if(root && root->is_esc_on()){
     hddaq::cout << esc::k_yellow
                 << FUNC_NAME << " exit process by signal " << sig
                 << esc::k_default_color << std::endl;
@@ -0,0 +1,212 @@
+// -*- C++ -*-
+
+#include "DCCombinationSearch.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <TMath.h>
+
+#include <std_ostream.hh>
+
+#include "DCGeomMan.hh"
+#include "DCLTrackHit.hh"
+#include "DCPairHitCluster.hh"
+#include "FuncName.hh"
+
+namespace
+{
+const auto& gGeom = DCGeomMan::GetInstance();
+// relative size of a pivot below which the fit is taken as undetermined
+const Double_t MinPivot = 1.0e-10;
+// margin against rounding, a branch is cut only clearly above max_chisqr
+const Double_t ChisqrMargin = 1.0e-6;
+}
+
+//_____________________________________________________________________________
+DCCombinationSearch::DCCombinationSearch(const std::vector<ClusterList>& cand_cont,
+                                         const IndexList& n_combi,
+                                         Int_t min_n_hit,
+                                         Double_t max_chisqr,
+                                         Double_t max_combi)
+  : m_cand_cont(cand_cont),
+    m_n_plane(n_combi.size()),
+    m_n_cand(n_combi),
+    m_min_n_hit(min_n_hit),
+    m_max_chisqr(max_chisqr),
+    m_max_combi(max_combi),
+    m_cluster_sum(m_n_plane),
+    m_max_hit_below(m_n_plane, 0),
+    m_index(m_n_plane, -2),
+    m_sum(m_n_plane+1),
+    m_depth(m_n_plane-1),
+    m_n_combi(0.),
+    m_n_pruned(0.),
+    m_status(true)
+{
+  // z is taken from the mean of the hits for the conditioning of the sums
+  Double_t z_ref = 0.;
+  Int_t    n_ref = 0;
+  for(Int_t i=0; i<m_n_plane; ++i){
+    for(Int_t j=0; j<m_n_cand[i]; ++j){
+      const DCPairHitCluster* cluster = m_cand_cont[i][j];
+      for(Int_t k=0, n=cluster ? cluster->NumberOfHits() : 0; k<n; ++k){
+        const DCLTrackHit* hit = cluster->GetHit(k);
+        if(!hit) continue;
+        z_ref += hit->GetZ();
+        ++n_ref;
+      }
+    }
+  }
+  if(n_ref > 0)
+    z_ref /= n_ref;
+
+  Int_t max_hit = 0;
+  for(Int_t i=0; i<m_n_plane; ++i){
+    m_max_hit_below[i] = max_hit;
+    Int_t max_hit_plane = 0;
+    m_cluster_sum[i].resize(m_n_cand[i]);
+    for(Int_t j=0; j<m_n_cand[i]; ++j){
+      Sum& sum = m_cluster_sum[i][j];
+      sum = Sum();
+      const DCPairHitCluster* cluster = m_cand_cont[i][j];
+      for(Int_t k=0, n=cluster ? cluster->NumberOfHits() : 0; k<n; ++k){
+        const DCLTrackHit* hit = cluster->GetHit(k);
+        if(!hit) continue;
+        ++sum.n_hit;
+        if(hit->IsHoneycomb()) continue;
+        ++sum.n_fit;
+        // the same weight and residual as DCLocalTrack::DoFit()
+        const Double_t res = gGeom.GetResolution(hit->GetLayer());
+        const Double_t w   = 1./(res*res);
+        const Double_t aa  = hit->GetTiltAngle()*TMath::DegToRad();
+        const Double_t z   = hit->GetZ() - z_ref;
+        const Double_t s   = hit->GetLocalHitPos();
+        const Double_t ct  = std::cos(aa);
+        const Double_t st  = std::sin(aa);
+        const Double_t a[4] = { ct, z*ct, st, z*st };
+        for(Int_t p=0, l=0; p<4; ++p){
+          for(Int_t q=0; q<=p; ++q, ++l)
+            sum.a[l] += w*a[p]*a[q];
+          sum.b[p] += w*s*a[p];
+        }
+        sum.c += w*s*s;
+      }
+      max_hit_plane = std::max(max_hit_plane, sum.n_hit);
+    }
+    max_hit += max_hit_plane;
+  }
+  m_sum[m_n_plane] = Sum();
+}
+
+//_____________________________________________________________________________
+DCCombinationSearch::~DCCombinationSearch()
+{
+}
+
+//_____________________________________________________________________________
+Bool_t
+DCCombinationSearch::Next(IndexList& combination)
+{
+  if(m_n_plane <= 0)
+    return false;
+
+  // planes above m_depth are fixed, plane m_depth takes its next cluster
+  while(m_depth < m_n_plane){
+    const Int_t d = m_depth;
+    if(++m_index[d] >= m_n_cand[d]){
+      m_index[d] = -2;
+      ++m_depth;
+      continue;
+    }
+
+    m_sum[d] = m_sum[d+1];
+    if(m_index[d] >= 0)
+      Add(m_sum[d], m_cluster_sum[d][m_index[d]]);
+    if(IsPruned(d)){
+      ++m_n_pruned;
+      continue;
+    }
+
+    if(d > 0){
+      --m_depth;
+      continue;
+    }
+
+    if(++m_n_combi > m_max_combi){
+      hddaq::cout << FUNC_NAME << " too much combinations... "
+                  << m_n_combi << std::endl;
+      m_status = false;
+      m_depth = m_n_plane;
+      return false;
+    }
+    combination = m_index;
+    return true;
+  }
+
+  return false;
+}
+
+//_____________________________________________________________________________
+Bool_t
+DCCombinationSearch::IsPruned(Int_t plane) const
+{
+  const Sum&  sum   = m_sum[plane];
+  const Int_t n_max = sum.n_hit + m_max_hit_below[plane];
+  if(n_max < m_min_n_hit)
+    return true;
+
+  if(m_max_chisqr <= 0. || sum.n_fit <= 4 || n_max <= 4)
+    return false;
+
+  return MinChisqr(sum)/(n_max-4) > m_max_chisqr*(1.+ChisqrMargin);
+}
+
+//_____________________________________________________________________________
+void
+DCCombinationSearch::Add(Sum& sum, const Sum& right)
+{
+  sum.n_hit += right.n_hit;
+  sum.n_fit += right.n_fit;
+  for(Int_t l=0; l<10; ++l)
+    sum.a[l] += right.a[l];
+  for(Int_t p=0; p<4; ++p)
+    sum.b[p] += right.b[p];
+  sum.c += right.c;
+}
+
+//_____________________________________________________________________________
+// minimum of the weighted sum of squared residuals, c - b^T A^-1 b by the
+// LDL^T decomposition of A; 0 when A does not fix the 4 parameters
+Double_t
+DCCombinationSearch::MinChisqr(const Sum& sum)
+{
+  Double_t l[4][4] = {};
+  Double_t d[4];
+  for(Int_t p=0; p<4; ++p){
+    for(Int_t q=0; q<=p; ++q){
+      Double_t v = sum.a[p*(p+1)/2+q];
+      for(Int_t k=0; k<q; ++k)
+        v -= l[p][k]*l[q][k]*d[k];
+      if(q < p){
+        l[p][q] = v/d[q];
+      }else{
+        if(v <= MinPivot*sum.a[p*(p+1)/2+p])
+          return 0.;
+        d[p] = v;
+        l[p][p] = 1.;
+      }
+    }
+  }
+
+  Double_t chisqr = sum.c;
+  Double_t y[4];
+  for(Int_t p=0; p<4; ++p){
+    y[p] = sum.b[p];
+    for(Int_t k=0; k<p; ++k)
+      y[p] -= l[p][k]*y[k];
+    chisqr -= y[p]*y[p]/d[p];
+  }
+  return std::max(chisqr, 0.);
+}
@@ -26,11 +26,15 @@ namespace
 {
 const auto qnan = TMath::QuietNaN();
 
-inline void
-DecodeKey(Int_t key, Int_t& plane, Int_t& wire)
+inline Bool_t
+DecodeKey(Int_t key, Int_t& plane, Int_t (&wire)[1])
 {
-  wire  = key & 0x3ff;
-  plane = key >> 10;
+  // keys out of the table (negative or plane > 1023) stay in the map
+  if(key < 0 || key >= (1 << 20))
+    return false;
+  wire[0] = key & 0x3ff;
+  plane   = key >> 10;
+  return true;
 }
 
 inline Int_t
@@ -43,8 +47,10 @@ MakeKey(Int_t plane, Double_t wire)
 //_____________________________________________________________________________
 DCDriftParamMan::DCDriftParamMan()
   : m_is_ready(false),
+    m_is_frozen(false),
     m_file_name(),
-    m_container()
+    m_container(),
+    m_table()
 {
 }
 
@@ -58,6 +64,7 @@ DCDriftParamMan::~DCDriftParamMan()
 void
 DCDriftParamMan::ClearElements()
 {
+  m_table.Clear();
   del::ClearMap(m_container);
 }
 
@@ -106,6 +113,7 @@ DCDriftParamMan::Initialize()
     m_container[key] = record;
   }
 
+  Freeze();
   m_is_ready = true;
   return m_is_ready;
 }
@@ -118,12 +126,26 @@ DCDriftParamMan::Initialize(const TString& file_name)
   return Initialize();
 }
 
+//_____________________________________________________________________________
+void
+DCDriftParamMan::Freeze(Bool_t flag)
+{
+  if(flag)
+    m_table.Build(m_container, DecodeKey);
+  else
+    m_table.Clear();
+  m_is_frozen = flag;
+}
+
 //_____________________________________________________________________________
 DCDriftParamRecord*
 DCDriftParamMan::GetParameter(Int_t PlaneId, Double_t WireId) const
 {
   WireId = 0;
   Int_t key = MakeKey(PlaneId, WireId);
+  Int_t id, index[1];
+  if(m_is_frozen && DecodeKey(key, id, index))
+    return m_table.Get(id, index);
   DCDriftIterator itr = m_container.find(key);
   if(itr != m_container.end())
     return itr->second;
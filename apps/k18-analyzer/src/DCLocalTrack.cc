@@ -205,108 +205,142 @@ DCLocalTrack::DeleteNullHit()
 Bool_t
 DCLocalTrack::DoFit()
 {
-  if(m_is_fitted){
-    hddaq::cerr << FUNC_NAME << " "
-		<< "already called" << std::endl;
+  const Int_t nItr = BeginFit(FUNC_NAME);
+  if(nItr <= 0)
     return false;
-  }
-
-  DeleteNullHit();
 
   const Int_t n = m_hit_array.size();
-  if(n < DCLocalMinNHits){
-    hddaq::cout << FUNC_NAME << " "
-		<< "the number of layers is too small : " << n << std::endl;
-    return false;
-  }
-
-  const Int_t nItr = HasHoneycomb() ? MaxIteration : 1;
-
   Double_t prev_chisqr = m_chisqr;
-  std::vector <Double_t> z0(n), z(n), wp(n),
-    w(n), s(n), ct(n), st(n), coss(n);
-  std::vector<Bool_t> honeycomb(n);
+  FitInput in;
   for(Int_t iItr=0; iItr<nItr; ++iItr){
-    for(Int_t i=0; i<n; ++i){
-      DCLTrackHit *hitp = m_hit_array[i];
-      Int_t    lnum = hitp->GetLayer();
-      honeycomb[i] = hitp->IsHoneycomb();
-      wp[i] = hitp->GetWirePosition();
-      z0[i] = hitp->GetZ();
-      Double_t ww = gGeom.GetResolution(lnum);
-      w[i] = 1./(ww*ww);
-      Double_t aa = hitp->GetTiltAngle()*TMath::DegToRad();
-      ct[i] = TMath::Cos(aa); st[i] = TMath::Sin(aa);
-      Double_t ss = hitp->GetLocalHitPos();
-      Double_t dl = hitp->DriftLength();
-      Double_t dsdz = m_u0*TMath::Cos(aa)+m_v0*TMath::Sin(aa);
-      Double_t dcos = TMath::Cos(TMath::ATan(dsdz));
-      coss[i] = dcos;
-      Double_t dsin = TMath::Sin(TMath::ATan(dsdz));
-      Double_t ds = dl * dcos;
-      Double_t dz = dl * dsin;
-      Double_t scal = iItr==0 ? ss : GetS(z[i],aa);
-      if(honeycomb[i]){
-	s[i] = scal-wp[i]>0 ? wp[i]+ds : wp[i]-ds;
-	z[i] = scal-wp[i]>0 ? z0[i]-dz : z0[i]+dz;
-      }else{
-	s[i] = ss;
-	z[i] = z0[i];
-      }
-    }
+    SetFitInput(iItr, in);
 
     Double_t x0, u0, y0, v0;
-    if(!MathTools::SolveGaussJordan(z, w, s, ct, st,
+    if(!MathTools::SolveGaussJordan(in.z, in.w, in.s, in.ct, in.st,
                                     x0, u0, y0, v0)){
       hddaq::cerr << FUNC_NAME << " Fitting failed" << std::endl;
       return false;
     }
 
     Double_t chisqr = 0.;
-    Double_t de     = 0.;
     for(Int_t i=0; i<n; ++i){
-      Double_t scal = (x0+u0*z0[i])*ct[i]+(y0+v0*z0[i])*st[i];
-      Double_t ss   = wp[i]+(s[i]-wp[i])/coss[i];
-      Double_t res  = honeycomb[i] ? (ss-scal)*coss[i] : s[i]-scal;
-      chisqr += w[i]*res*res;
+      Double_t scal = (x0+u0*in.z0[i])*in.ct[i]+(y0+v0*in.z0[i])*in.st[i];
+      Double_t res  = (in.r[i]-scal)*in.c[i];
+      chisqr += in.w[i]*res*res;
     }
     chisqr /= GetNDF();
 
-    if(iItr==0) m_chisqr1st = chisqr;
+    if(EndIteration(iItr, x0, u0, y0, v0, chisqr, prev_chisqr))
+      break;
+  }
 
-    // if worse, not update
-    if(prev_chisqr-chisqr>0.){
-      m_x0 = x0;
-      m_y0 = y0;
-      m_u0 = u0;
-      m_v0 = v0;
-      m_chisqr = chisqr;
-      m_de     = de;
+  m_is_fitted = true;
+  return true;
+}
+
+//_____________________________________________________________________________
+// checks before DoFit(), returns the number of iterations or 0
+Int_t
+DCLocalTrack::BeginFit(const TString& func)
+{
+  if(m_is_fitted){
+    hddaq::cerr << func << " "
+		<< "already called" << std::endl;
+    return 0;
+  }
+
+  DeleteNullHit();
+
+  const Int_t n = m_hit_array.size();
+  if(n < DCLocalMinNHits){
+    hddaq::cout << func << " "
+		<< "the number of layers is too small : " << n << std::endl;
+    return 0;
+  }
+
+  return HasHoneycomb() ? MaxIteration : 1;
+}
+
+//_____________________________________________________________________________
+// the honeycomb hits are put on the side of the wire given by the current
+// parameters, in.z keeps the hit positions of the previous iteration
+void
+DCLocalTrack::SetFitInput(Int_t iItr, FitInput& in) const
+{
+  const Int_t n = m_hit_array.size();
+  in.z0.resize(n); in.z.resize(n); in.w.resize(n); in.s.resize(n);
+  in.ct.resize(n); in.st.resize(n); in.r.resize(n); in.c.resize(n);
+  for(Int_t i=0; i<n; ++i){
+    const DCLTrackHit *hitp = m_hit_array[i];
+    Int_t    lnum = hitp->GetLayer();
+    Double_t wp = hitp->GetWirePosition();
+    in.z0[i] = hitp->GetZ();
+    Double_t ww = gGeom.GetResolution(lnum);
+    in.w[i] = 1./(ww*ww);
+    Double_t aa = hitp->GetTiltAngle()*TMath::DegToRad();
+    in.ct[i] = TMath::Cos(aa); in.st[i] = TMath::Sin(aa);
+    Double_t ss = hitp->GetLocalHitPos();
+    Double_t dl = hitp->DriftLength();
+    Double_t dsdz = m_u0*TMath::Cos(aa)+m_v0*TMath::Sin(aa);
+    Double_t dcos = TMath::Cos(TMath::ATan(dsdz));
+    Double_t dsin = TMath::Sin(TMath::ATan(dsdz));
+    Double_t ds = dl * dcos;
+    Double_t dz = dl * dsin;
+    Double_t scal = iItr==0 ? ss : GetS(in.z[i],aa);
+    if(hitp->IsHoneycomb()){
+      in.s[i] = scal-wp>0 ? wp+ds : wp-ds;
+      in.z[i] = scal-wp>0 ? in.z0[i]-dz : in.z0[i]+dz;
+      // residual along the drift direction
+      in.r[i] = wp+(in.s[i]-wp)/dcos;
+      in.c[i] = dcos;
+    }else{
+      in.s[i] = ss;
+      in.z[i] = in.z0[i];
+      in.r[i] = ss;
+      in.c[i] = 1.;
     }
+  }
+}
 
-    // judge convergence
-    if(prev_chisqr-chisqr<MaxChisqrDiff){
+//_____________________________________________________________________________
+// keeps the result of an iteration if better, true at the convergence
+Bool_t
+DCLocalTrack::EndIteration(Int_t iItr, Double_t x0, Double_t u0,
+                           Double_t y0, Double_t v0, Double_t chisqr,
+                           Double_t& prev_chisqr)
+{
+  if(iItr==0) m_chisqr1st = chisqr;
+
+  // if worse, not update
+  if(prev_chisqr-chisqr>0.){
+    m_x0 = x0;
+    m_y0 = y0;
+    m_u0 = u0;
+    m_v0 = v0;
+    m_chisqr = chisqr;
+    m_de     = 0.;
+  }
+
+  // judge convergence
+  if(prev_chisqr-chisqr<MaxChisqrDiff){
 #if 0
-      // if(chisqr<200. && GetTheta()>4.)
-      if(chisqr<20.)
-      {
-	if(iItr==0) hddaq::cout << "=============" << std::endl;
-	hddaq::cout << FUNC_NAME << " NIteration : " << iItr << " "
-		    << "chisqr = " << std::setw(10) << std::setprecision(4)
-		    << m_chisqr << " "
-		    << "diff = " << std::setw(20) << std::left
-		    << m_chisqr-m_chisqr1st << " ndf = " << GetNDF() << std::endl;
-      }
-#endif
-      m_n_iteration = iItr;
-      break;
+    // if(chisqr<200. && GetTheta()>4.)
+    if(chisqr<20.)
+    {
+      if(iItr==0) hddaq::cout << "=============" << std::endl;
+      hddaq::cout << FUNC_NAME << " NIteration : " << iItr << " "
+		  << "chisqr = " << std::setw(10) << std::setprecision(4)
+		  << m_chisqr << " "
+		  << "diff = " << std::setw(20) << std::left
+		  << m_chisqr-m_chisqr1st << " ndf = " << GetNDF() << std::endl;
     }
-
-    prev_chisqr = chisqr;
+#endif
+    m_n_iteration = iItr;
+    return true;
   }
 
-  m_is_fitted = true;
-  return true;
+  prev_chisqr = chisqr;
+  return false;
 }
 
 //_____________________________________________________________________________
@@ -0,0 +1,295 @@
+// -*- C++ -*-
+
+#include "DCLocalTrackFitter.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <std_ostream.hh>
+
+#include "FuncName.hh"
+
+namespace
+{
+const Int_t NLane = DCLocalTrackFitter::NLane;
+// inputs of a hit in the lanes
+enum EInput { kZ0, kZ, kW, kS, kCt, kSt, kR, kC, kNInput };
+
+// one value of every lane, the operators work on all the lanes at once
+typedef Double_t Lane __attribute__((vector_size(NLane*sizeof(Double_t))));
+
+//_____________________________________________________________________________
+inline void
+Load(Lane& v, const Double_t* p)
+{
+  std::memcpy(&v, p, sizeof(v));
+}
+
+//_____________________________________________________________________________
+// normal equations and LDL^T solution of the lanes, then the chisqr sum.
+// The sums follow MathTools::SolveGaussJordan() and DoFit() term by term
+// and no FMA is used, so that all the targets give the same bits.
+inline __attribute__((always_inline)) void
+FitLaneImpl(const Double_t* lane, Int_t n_hit,
+            Double_t* param, Double_t* chisqr, Long64_t* ok)
+{
+  Lane a00 = {}, a01 = {}, a02 = {}, a03 = {}, a11 = {};
+  Lane a13 = {}, a22 = {}, a23 = {}, a33 = {};
+  Lane b0 = {}, b1 = {}, b2 = {}, b3 = {};
+  for(Int_t i=0; i<n_hit; ++i){
+    const Double_t* h = lane + i*kNInput*NLane;
+    Lane z, w, s, ct, st;
+    Load(z,  h + kZ*NLane);
+    Load(w,  h + kW*NLane);
+    Load(s,  h + kS*NLane);
+    Load(ct, h + kCt*NLane);
+    Load(st, h + kSt*NLane);
+    const Lane wz    = w*z;
+    const Lane wzz   = wz*z;
+    const Lane wct   = w*ct;
+    const Lane wst   = w*st;
+    const Lane wzct  = wz*ct;
+    const Lane wzst  = wz*st;
+    const Lane wzzct = wzz*ct;
+    const Lane wzzst = wzz*st;
+    a00 += wct*ct;
+    a01 += wzct*ct;
+    a02 += wct*st;
+    a03 += wzct*st; // = a12
+    a11 += wzzct*ct;
+    a13 += wzzct*st;
+    a22 += wst*st;
+    a23 += wzst*st;
+    a33 += wzzst*st;
+    b0 += (w*s)*ct;
+    b1 += (wz*s)*ct;
+    b2 += (w*s)*st;
+    b3 += (wz*s)*st;
+  }
+
+  // A = L D L^T
+  const Lane one = { 1., 1., 1., 1. };
+  const Lane d0  = a00;
+  const Lane e0  = one/d0;
+  const Lane l10 = a01*e0;
+  const Lane l20 = a02*e0;
+  const Lane l30 = a03*e0;
+  const Lane d1  = a11 - l10*a01;
+  const Lane e1  = one/d1;
+  const Lane u21 = a03 - l20*a01;
+  const Lane u31 = a13 - l30*a01;
+  const Lane l21 = u21*e1;
+  const Lane l31 = u31*e1;
+  const Lane d2  = a22 - l20*a02 - l21*u21;
+  const Lane e2  = one/d2;
+  const Lane u32 = a23 - l30*a02 - l31*u21;
+  const Lane l32 = u32*e2;
+  const Lane d3  = a33 - l30*a03 - l31*u31 - l32*u32;
+  const Lane e3  = one/d3;
+
+  const Lane y0 = b0;
+  const Lane y1 = b1 - l10*y0;
+  const Lane y2 = b2 - l20*y0 - l21*y1;
+  const Lane y3 = b3 - l30*y0 - l31*y1 - l32*y2;
+  const Lane p3 = y3*e3;
+  const Lane p2 = y2*e2 - l32*p3;
+  const Lane p1 = y1*e1 - l21*p2 - l31*p3;
+  const Lane p0 = y0*e0 - l10*p1 - l20*p2 - l30*p3;
+
+  // the padding hits have w = c = 0
+  Lane chi = {};
+  for(Int_t i=0; i<n_hit; ++i){
+    const Double_t* h = lane + i*kNInput*NLane;
+    Lane z0, w, ct, st, r, c;
+    Load(z0, h + kZ0*NLane);
+    Load(w,  h + kW*NLane);
+    Load(ct, h + kCt*NLane);
+    Load(st, h + kSt*NLane);
+    Load(r,  h + kR*NLane);
+    Load(c,  h + kC*NLane);
+    const Lane scal = (p0+p1*z0)*ct+(p2+p3*z0)*st;
+    const Lane res  = (r-scal)*c;
+    chi += w*res*res;
+  }
+
+  // a singular (or not positive) system fails as in GaussJordan()
+  const Lane zero = {};
+  const auto good = (d0>zero) & (d1>zero) & (d2>zero) & (d3>zero);
+
+  std::memcpy(param + 0*NLane, &p0, sizeof(p0));
+  std::memcpy(param + 1*NLane, &p1, sizeof(p1));
+  std::memcpy(param + 2*NLane, &p2, sizeof(p2));
+  std::memcpy(param + 3*NLane, &p3, sizeof(p3));
+  std::memcpy(chisqr, &chi, sizeof(chi));
+  std::memcpy(ok, &good, sizeof(good));
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+//_____________________________________________________________________________
+__attribute__((target("avx2"))) void
+FitLaneAvx2(const Double_t* lane, Int_t n_hit,
+            Double_t* param, Double_t* chisqr, Long64_t* ok)
+{
+  FitLaneImpl(lane, n_hit, param, chisqr, ok);
+}
+#endif
+
+//_____________________________________________________________________________
+Bool_t
+HasAvx2()
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+  static const Bool_t has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+#else
+  return false;
+#endif
+}
+
+Bool_t use_avx2 = HasAvx2();
+
+//_____________________________________________________________________________
+void
+FitLane(const Double_t* lane, Int_t n_hit,
+        Double_t* param, Double_t* chisqr, Long64_t* ok)
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+  if(use_avx2){
+    FitLaneAvx2(lane, n_hit, param, chisqr, ok);
+    return;
+  }
+#endif
+  FitLaneImpl(lane, n_hit, param, chisqr, ok);
+}
+}
+
+//_____________________________________________________________________________
+Bool_t
+DCLocalTrackFitter::SetUseAvx2(Bool_t flag)
+{
+  use_avx2 = flag && HasAvx2();
+  return use_avx2 == flag;
+}
+
+//_____________________________________________________________________________
+Bool_t
+DCLocalTrackFitter::UseAvx2()
+{
+  return use_avx2;
+}
+
+//_____________________________________________________________________________
+DCLocalTrackFitter::DCLocalTrackFitter(Int_t block_size)
+  : m_block_size(block_size),
+    m_track(),
+    m_status(),
+    m_input(),
+    m_n_itr(),
+    m_prev_chisqr(),
+    m_active(),
+    m_next(),
+    m_lane()
+{
+  m_track.reserve(m_block_size);
+}
+
+//_____________________________________________________________________________
+DCLocalTrackFitter::~DCLocalTrackFitter()
+{
+}
+
+//_____________________________________________________________________________
+void
+DCLocalTrackFitter::Clear()
+{
+  m_track.clear();
+  m_status.clear();
+}
+
+//_____________________________________________________________________________
+Int_t
+DCLocalTrackFitter::Fit()
+{
+  const Int_t n = m_track.size();
+  m_status.assign(n, false);
+  if(m_input.size() < n)
+    m_input.resize(n);
+  m_n_itr.resize(n);
+  m_prev_chisqr.resize(n);
+
+  m_active.clear();
+  for(Int_t i=0; i<n; ++i){
+    DCLocalTrack* track = m_track[i];
+    m_n_itr[i] = track->BeginFit(FUNC_NAME);
+    if(m_n_itr[i] <= 0)
+      continue;
+    m_prev_chisqr[i] = track->m_chisqr;
+    m_active.push_back(i);
+  }
+
+  Int_t n_fitted = 0;
+  for(Int_t iItr=0; !m_active.empty(); ++iItr){
+    for(const auto& i: m_active)
+      m_track[i]->SetFitInput(iItr, m_input[i]);
+
+    m_next.clear();
+    for(Int_t j=0, n_active=m_active.size(); j<n_active; j+=NLane){
+      const Int_t n_lane = std::min(NLane, n_active-j);
+      const Int_t n_hit  = FillLane(&m_active[j], n_lane);
+      Double_t param[4*NLane];
+      Double_t chisqr[NLane];
+      Long64_t ok[NLane];
+      FitLane(m_lane.data(), n_hit, param, chisqr, ok);
+
+      for(Int_t l=0; l<n_lane; ++l){
+        const Int_t i = m_active[j+l];
+        DCLocalTrack* track = m_track[i];
+        if(!ok[l]){
+          hddaq::cerr << FUNC_NAME << " Fitting failed" << std::endl;
+          continue;
+        }
+        if(track->EndIteration(iItr, param[0*NLane+l], param[1*NLane+l],
+                               param[2*NLane+l], param[3*NLane+l],
+                               chisqr[l]/track->GetNDF(), m_prev_chisqr[i])
+           || iItr+1 >= m_n_itr[i]){
+          track->m_is_fitted = true;
+          m_status[i] = true;
+          ++n_fitted;
+        }else{
+          m_next.push_back(i);
+        }
+      }
+    }
+    m_active.swap(m_next);
+  }
+
+  return n_fitted;
+}
+
+//_____________________________________________________________________________
+// copies the inputs of n candidates to the lanes, returns the number of hits
+Int_t
+DCLocalTrackFitter::FillLane(const Int_t* index, Int_t n)
+{
+  Int_t n_hit = 0;
+  for(Int_t l=0; l<n; ++l)
+    n_hit = std::max(n_hit, Int_t(m_input[index[l]].z.size()));
+
+  m_lane.assign(n_hit*kNInput*NLane, 0.);
+  for(Int_t l=0; l<n; ++l){
+    const DCLocalTrack::FitInput& in = m_input[index[l]];
+    for(Int_t i=0, nh=in.z.size(); i<nh; ++i){
+      Double_t* h = &m_lane[i*kNInput*NLane + l];
+      h[kZ0*NLane] = in.z0[i];
+      h[kZ*NLane]  = in.z[i];
+      h[kW*NLane]  = in.w[i];
+      h[kS*NLane]  = in.s[i];
+      h[kCt*NLane] = in.ct[i];
+      h[kSt*NLane] = in.st[i];
+      h[kR*NLane]  = in.r[i];
+      h[kC*NLane]  = in.c[i];
+    }
+  }
+  return n_hit;
+}
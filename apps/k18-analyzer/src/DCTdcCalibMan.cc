@@ -21,6 +21,17 @@ MakeKey(Int_t plane_id, Double_t wire_id)
 {
   return (plane_id<<10) | Int_t(wire_id);
 }
+
+inline Bool_t
+DecodeKey(Int_t key, Int_t& plane_id, Int_t (&wire_id)[1])
+{
+  // keys out of the table (negative or plane > 1023) stay in the map
+  if(key < 0 || key >= (1 << 20))
+    return false;
+  wire_id[0] = key & 0x3ff;
+  plane_id   = key >> 10;
+  return true;
+}
 }
 
 //_____________________________________________________________________________
@@ -35,8 +46,10 @@ struct DCTdcCalMap
 //_____________________________________________________________________________
 DCTdcCalibMan::DCTdcCalibMan()
   : m_is_ready(false),
+    m_is_frozen(false),
     m_file_name(),
-    m_container()
+    m_container(),
+    m_table()
 {
 }
 
@@ -50,6 +63,7 @@ DCTdcCalibMan::~DCTdcCalibMan()
 void
 DCTdcCalibMan::ClearElements()
 {
+  m_table.Clear();
   del::ClearMap(m_container);
 }
 
@@ -88,6 +102,7 @@ DCTdcCalibMan::Initialize()
     }
   }
 
+  Freeze();
   m_is_ready = true;
   return m_is_ready;
 }
@@ -100,11 +115,25 @@ DCTdcCalibMan::Initialize(const TString& file_name)
   return Initialize();
 }
 
+//_____________________________________________________________________________
+void
+DCTdcCalibMan::Freeze(Bool_t flag)
+{
+  if(flag)
+    m_table.Build(m_container, DecodeKey);
+  else
+    m_table.Clear();
+  m_is_frozen = flag;
+}
+
 //_____________________________________________________________________________
 DCTdcCalMap*
 DCTdcCalibMan::GetMap(Int_t plane_id, Double_t wire_id) const
 {
   Int_t key = MakeKey(plane_id, wire_id);
+  Int_t id, index[1];
+  if(m_is_frozen && DecodeKey(key, id, index))
+    return m_table.Get(id, index);
   DCTdcIterator itr = m_container.find(key);
   if(itr != m_container.end())
     return itr->second;
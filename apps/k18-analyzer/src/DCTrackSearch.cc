@@ -11,8 +11,10 @@
 #include <TH2D.h>
 #include <TH3D.h>
 
+#include "DCCombinationSearch.hh"
 #include "DCGeomMan.hh"
 #include "DCLocalTrack.hh"
+#include "DCLocalTrackFitter.hh"
 #include "DCLTrackHit.hh"
 #include "DCPairHitCluster.hh"
 #include "DCParameters.hh"
@@ -386,6 +388,34 @@ FinalizeTrack(const TString& arg,
   del::ClearContainerAll(candCont);
 }
 
+//_____________________________________________________________________________
+// fits the candidates of the fitter in a batch, the fitted tracks passing
+// accept(track) go to trackCont in the order of submission
+template <class Functor>
+inline void
+FitCandidates(DCLocalTrackFitter& fitter,
+              DCLocalTC& trackCont,
+              Functor accept)
+{
+  fitter.Fit();
+  for(Int_t i=0, n=fitter.GetNTrack(); i<n; ++i){
+    DCLocalTrack* track = fitter.GetTrack(i);
+    if(fitter.GetStatus(i) && accept(track))
+      trackCont.push_back(track);
+    else
+      delete track;
+  }
+  fitter.Clear();
+}
+
+//_____________________________________________________________________________
+struct ChisqrCut
+{
+  Double_t m_max;
+  Bool_t operator()(const DCLocalTrack* track) const
+  { return track->GetChiSquare()<m_max; }
+};
+
 //_____________________________________________________________________________
 // MakeCluster _________________________________________________________________
 
@@ -740,14 +770,11 @@ MakeTrack(const std::vector<ClusterList>& CandCont,
 }
 
 //_____________________________________________________________________________
-Int_t /* Local Track Search without BH2Filter */
-LocalTrackSearch(const std::vector<DCHC>& HC,
-                 const DCPairPlaneInfo * PpInfo,
-                 Int_t npp, DCLocalTC& TrackCont,
-                 Int_t MinNumOfHits, Int_t T0Seg)
+void
+MakeCandidates(const std::vector<DCHC>& HC,
+               const DCPairPlaneInfo *PpInfo,
+               Int_t npp, std::vector<ClusterList>& CandCont)
 {
-  std::vector<ClusterList> CandCont(npp);
-
   for(Int_t i=0; i<npp; ++i){
     Bool_t ppFlag    = PpInfo[i].pair;
     Bool_t honeycomb = PpInfo[i].honeycomb;
@@ -763,6 +790,17 @@ LocalTrackSearch(const std::vector<DCHC>& HC,
       MakeUnPairPlaneHitCluster(HC[layer1], CandCont[i], honeycomb);
     }
   }
+}
+
+//_____________________________________________________________________________
+Int_t /* Local Track Search without BH2Filter */
+LocalTrackSearch(const std::vector<DCHC>& HC,
+                 const DCPairPlaneInfo * PpInfo,
+                 Int_t npp, DCLocalTC& TrackCont,
+                 Int_t MinNumOfHits, Int_t T0Seg)
+{
+  std::vector<ClusterList> CandCont(npp);
+  MakeCandidates(HC, PpInfo, npp, CandCont);
 
   IndexList nCombi(npp);
   for(Int_t i=0; i<npp; ++i){
@@ -774,44 +812,46 @@ LocalTrackSearch(const std::vector<DCHC>& HC,
   DebugPrint(nCombi, CandCont, FUNC_NAME);
 #endif
 
-  Bool_t status = true;
-  std::vector<IndexList> CombiIndex = MakeIndex(npp, nCombi, status);
+  auto accept = [&](const DCLocalTrack* track){
+    if(track->GetChiSquare()<MaxChisquare
+       && T0Seg>=0 && T0Seg<NumOfSegBH2){
+      Double_t xbh2=track->GetX(zBH2), ybh2=track->GetY(zBH2);
+      Double_t difPosBh2 = localPosBh2X[T0Seg] - xbh2;
 
-  for(Int_t i=0, n=CombiIndex.size(); i<n; ++i){
-    DCLocalTrack *track = MakeTrack(CandCont, CombiIndex[i]);
-    if(!track) continue;
-    if(track->GetNHit()>=MinNumOfHits
-       && track->DoFit()
-       && track->GetChiSquare()<MaxChisquare){
-
-      if(T0Seg>=0 && T0Seg<NumOfSegBH2) {
-        Double_t xbh2=track->GetX(zBH2), ybh2=track->GetY(zBH2);
-        Double_t difPosBh2 = localPosBh2X[T0Seg] - xbh2;
-
-        //   Double_t xtgt=track->GetX(zTarget), ytgt=track->GetY(zTarget);
-        //   Double_t ytgt=track->GetY(zTarget);
-
-        if(true
-           && fabs(difPosBh2)<Bh2SegXAcc[T0Seg]
-           && (-10 < ybh2 && ybh2 < 40)
-           //       && fabs(ytgt)<21.
-          ){
-          TrackCont.push_back(track);
-        }else{
-          delete track;
-        }
+      //   Double_t xtgt=track->GetX(zTarget), ytgt=track->GetY(zTarget);
+      //   Double_t ytgt=track->GetY(zTarget);
 
-      }else{
-        TrackCont.push_back(track);
-      }
+      return (true
+              && fabs(difPosBh2)<Bh2SegXAcc[T0Seg]
+              && (-10 < ybh2 && ybh2 < 40)
+              //       && fabs(ytgt)<21.
+        );
     }
-    else{
+    return track->GetChiSquare()<MaxChisquare;
+  };
+
+  DCLocalTrackFitter fitter;
+  DCCombinationSearch search(CandCont, nCombi, MinNumOfHits,
+                             MaxChisquare, MaxCombi);
+  IndexList combination;
+  while(search.Next(combination)){
+    DCLocalTrack *track = MakeTrack(CandCont, combination);
+    if(!track) continue;
+    if(track->GetNHit()>=MinNumOfHits)
+      fitter.Add(track);
+    else
       delete track;
-    }
+    if(fitter.IsFull())
+      FitCandidates(fitter, TrackCont, accept);
   }
+  FitCandidates(fitter, TrackCont, accept);
+
+  // over MaxCombi, no track rather than those of a part of the search
+  if(!search.GetStatus())
+    del::ClearContainer(TrackCont);
 
   FinalizeTrack(FUNC_NAME, TrackCont, DCLTrackComp(), CandCont);
-  return status? TrackCont.size() : -1;
+  return search.GetStatus()? TrackCont.size() : -1;
 }
 
 //_____________________________________________________________________________
@@ -869,31 +909,38 @@ LocalTrackSearchSdcOut(const std::vector<DCHC>& SdcOutHC,
     nCombi[i] = n>MaxNumOfCluster ? 0 : n;
   }
 
-  Bool_t status = true;
-  std::vector<IndexList> CombiIndex = MakeIndex(npp, nCombi, status);
+  DCCombinationSearch search(CandCont, nCombi, MinNumOfHits,
+                             MaxChisquare, MaxCombi);
 
 #if 0
   DebugPrint(nCombi, CandCont, FUNC_NAME);
 #endif
 
-  for(Int_t i=0, n=CombiIndex.size(); i<n; ++i) {
-    DCLocalTrack *track = MakeTrack(CandCont, CombiIndex[i]);
+  const ChisqrCut accept = { MaxChisquare };
+  DCLocalTrackFitter fitter;
+  IndexList combination;
+  while(search.Next(combination)){
+    DCLocalTrack *track = MakeTrack(CandCont, combination);
     if(!track) continue;
     if(track->GetNHit()>=MinNumOfHits     &&
-       track->GetNHitY() >= 2             &&
-       track->DoFit()                     &&
-       track->GetChiSquare()<MaxChisquare)
+       track->GetNHitY() >= 2)
     {
-      TrackCont.push_back(track);
+      fitter.Add(track);
     }
     else
     {
       delete track;
     }
+    if(fitter.IsFull())
+      FitCandidates(fitter, TrackCont, accept);
   }
+  FitCandidates(fitter, TrackCont, accept);
+
+  if(!search.GetStatus())
+    del::ClearContainer(TrackCont);
 
   FinalizeTrack(FUNC_NAME, TrackCont, DCLTrackComp(), CandCont);
-  return status? TrackCont.size() : -1;
+  return search.GetStatus()? TrackCont.size() : -1;
 }
 
 //_____________________________________________________________________________
@@ -931,15 +978,18 @@ LocalTrackSearchSdcOut(const DCHC& TOFHC,
     nCombi[i] = n>MaxNumOfCluster ? 0 : n;
   }
 
-  Bool_t status = true;
-  std::vector<IndexList> CombiIndex = MakeIndex(npp, nCombi, status);
+  DCCombinationSearch search(CandCont, nCombi, MinNumOfHits+2,
+                             MaxChisquare, MaxCombi);
 
 #if 0
   DebugPrint(nCombi, CandCont, FUNC_NAME);
 #endif
 
-  for(Int_t i=0, n=CombiIndex.size(); i<n; ++i){
-    DCLocalTrack *track = MakeTrack(CandCont, CombiIndex[i]);
+  const ChisqrCut accept = { MaxChisquare };
+  DCLocalTrackFitter fitter;
+  IndexList combination;
+  while(search.Next(combination)){
+    DCLocalTrack *track = MakeTrack(CandCont, combination);
     if(!track) continue;
 
     static const Int_t IdTOF_UX = gGeom.GetDetectorId("TOF-UX");
@@ -968,20 +1018,24 @@ LocalTrackSearchSdcOut(const DCHC& TOFHC,
     if(TOFSegXYMatching &&
        //FBT&&
        track->GetNHit()>=MinNumOfHits+2   &&
-       track->GetNHitY() >= 2             &&
-       track->DoFit()                     &&
-       track->GetChiSquare()<MaxChisquare)
+       track->GetNHitY() >= 2)
     {
-      TrackCont.push_back(track);
+      fitter.Add(track);
     }
     else
     {
       delete track;
     }
+    if(fitter.IsFull())
+      FitCandidates(fitter, TrackCont, accept);
   }
+  FitCandidates(fitter, TrackCont, accept);
+
+  if(!search.GetStatus())
+    del::ClearContainer(TrackCont);
 
   FinalizeTrack(FUNC_NAME, TrackCont, DCLTrackComp(), CandCont);
-  return status? TrackCont.size() : -1;
+  return search.GetStatus()? TrackCont.size() : -1;
 }
 
 //_____________________________________________________________________________
@@ -1016,26 +1070,32 @@ LocalTrackSearchSdcInFiber(const std::vector<DCHC>& HC,
     nCombi[i] = n>MaxNumOfCluster ? 0 : n;
   }
 
-  Bool_t status = true;
-  std::vector<IndexList> CombiIndex = MakeIndex(npp, nCombi, status);
-
-  for(Int_t i=0, n=CombiIndex.size(); i<n; ++i){
-    DCLocalTrack *track = MakeTrack(CandCont, CombiIndex[i]);
+  DCCombinationSearch search(CandCont, nCombi, MinNumOfHits,
+                             MaxChisquare, MaxCombi);
+  const ChisqrCut accept = { MaxChisquare };
+  DCLocalTrackFitter fitter;
+  IndexList combination;
+  while(search.Next(combination)){
+    DCLocalTrack *track = MakeTrack(CandCont, combination);
     if(!track) continue;
     if(true
        && track->GetNHitSFT() > 1
        && track->GetNHit()>=MinNumOfHits
-       && track->DoFit()
-       && track->GetChiSquare()<MaxChisquare
       ){
-      TrackCont.push_back(track);
+      fitter.Add(track);
     }
     else
       delete track;
+    if(fitter.IsFull())
+      FitCandidates(fitter, TrackCont, accept);
   }
+  FitCandidates(fitter, TrackCont, accept);
+
+  if(!search.GetStatus())
+    del::ClearContainer(TrackCont);
 
   FinalizeTrack(FUNC_NAME, TrackCont, DCLTrackCompSdcInFiber(), CandCont);
-  return status? TrackCont.size() : -1;
+  return search.GetStatus()? TrackCont.size() : -1;
 }
 
 // BC3&4, SDC1 VUX Tracking ___________________________________________
@@ -1669,23 +1729,17 @@ LocalTrackSearchBcOutSdcIn(const std::vector<DCHC>& BcHC,
   DebugPrint(nCombi, CandCont, FUNC_NAME);
 #endif
 
-  Bool_t status = true;
-  std::vector<IndexList> CombiIndex = MakeIndex(npp, nCombi, status);
-  Int_t nnCombi = CombiIndex.size();
-
+  // DoFitBcSdc() shifts the SdcIn hits, only the number of hits is cut
+  DCCombinationSearch search(CandCont, nCombi, MinNumOfHits, 0., MaxCombi);
+  IndexList combination;
+  while(search.Next(combination)){
 #if 0
-  hddaq::cout << " ===> " << nnCombi << " combinations will be checked.."
-              << std::endl;
-  for(Int_t i=0; i<nnCombi; ++i){
     for(Int_t j=0;j<npp;j++) {
-      hddaq::cout << CombiIndex[i][j] << " ";
+      hddaq::cout << combination[j] << " ";
     }
     hddaq::cout << std::endl;
-  }
 #endif
-
-  for(Int_t i=0; i<nnCombi; ++i){
-    DCLocalTrack *track = MakeTrack(CandCont, CombiIndex[i]);
+    DCLocalTrack *track = MakeTrack(CandCont, combination);
     if(!track) continue;
     if(track->GetNHit()>=MinNumOfHits && track->DoFitBcSdc() &&
        track->GetChiSquare()<MaxChisquare)
@@ -1694,6 +1748,9 @@ LocalTrackSearchBcOutSdcIn(const std::vector<DCHC>& BcHC,
       delete track;
   }
 
+  if(!search.GetStatus())
+    del::ClearContainer(TrackCont);
+
   FinalizeTrack(FUNC_NAME, TrackCont, DCLTrackComp(), CandCont);
 
   return TrackCont.size();
@@ -1761,23 +1818,28 @@ LocalTrackSearchSdcInSdcOut(const std::vector<DCHC>& SdcInHC,
     nCombi[i] = n>MaxNumOfCluster ? 0 : n;
   }
 
-  Bool_t status = true;
-  std::vector<IndexList> CombiIndex = MakeIndex(npp, nCombi, status);
-  Int_t nnCombi = CombiIndex.size();
-
-  for(Int_t i=0; i<nnCombi; ++i){
-    DCLocalTrack *track = MakeTrack(CandCont, CombiIndex[i]);
+  DCCombinationSearch search(CandCont, nCombi, MinNumOfHits,
+                             MaxChisquare, MaxCombi);
+  const ChisqrCut accept = { MaxChisquare };
+  DCLocalTrackFitter fitter;
+  IndexList combination;
+  while(search.Next(combination)){
+    DCLocalTrack *track = MakeTrack(CandCont, combination);
     if(!track) continue;
-    if(track->GetNHit()>=MinNumOfHits &&
-       track->DoFit() &&
-       track->GetChiSquare()<MaxChisquare)
-      TrackCont.push_back(track);
+    if(track->GetNHit()>=MinNumOfHits)
+      fitter.Add(track);
     else
       delete track;
+    if(fitter.IsFull())
+      FitCandidates(fitter, TrackCont, accept);
   }
+  FitCandidates(fitter, TrackCont, accept);
+
+  if(!search.GetStatus())
+    del::ClearContainer(TrackCont);
 
   FinalizeTrack(FUNC_NAME, TrackCont, DCLTrackComp(), CandCont);
-  return status? TrackCont.size() : -1;
+  return search.GetStatus()? TrackCont.size() : -1;
 }
 
 //For MWPC
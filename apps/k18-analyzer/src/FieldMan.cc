@@ -18,6 +18,7 @@ const auto& valueNMR  = ConfMan::Get<Double_t>("FLDNMR");
 const auto& valueCalc = ConfMan::Get<Double_t>("FLDCALC");
 const auto& valueHSHall = ConfMan::Get<Double_t>("HSFLDHALL");
 const auto& valueHSCalc = ConfMan::Get<Double_t>("HSFLDCALC");
+const auto& useCentralDifference = ConfMan::Get<Bool_t>("FLDCDIFF");
 }
 
 namespace
@@ -29,7 +30,8 @@ const Double_t Delta = 0.1;
 FieldMan::FieldMan()
   : m_is_ready(false),
     m_s2s_map(nullptr),
-    m_shs_map(nullptr)
+    m_shs_map(nullptr),
+    m_central_difference(false)
 {
 }
 
@@ -52,6 +54,9 @@ FieldMan::Initialize()
   if(m_s2s_map)
     delete m_s2s_map;
 
+  if(useCentralDifference)
+    m_central_difference = true;
+
   if(!m_file_name_s2s.IsNull()){
     m_s2s_map = new S2sFieldMap(m_file_name_s2s, valueNMR, valueCalc);
     if(!m_s2s_map->Initialize())
@@ -112,13 +117,73 @@ FieldMan::GetField(const TVector3& position) const
   }
 
 #if 1
+  field += GetElementField(position);
+#endif
+
+  return field;
+}
+
+//_____________________________________________________________________________
+TVector3
+FieldMan::GetField(const TVector3& position,
+                   TVector3& dBdX, TVector3& dBdY, TVector3* dBdZ) const
+{
+  if(m_central_difference){
+    dBdX = GetdBdX(position);
+    dBdY = GetdBdY(position);
+    if(dBdZ)
+      *dBdZ = GetdBdZ(position);
+    return GetField(position);
+  }
+
+  TVector3 field(0., 0., 0.);
+  dBdX.SetXYZ(0., 0., 0.);
+  dBdY.SetXYZ(0., 0., 0.);
+  if(dBdZ)
+    dBdZ->SetXYZ(0., 0., 0.);
+  if(m_s2s_map){
+    Double_t p[3], b_s2s[3], db_s2s[9];
+    p[0] = position.x()*0.1;
+    p[1] = position.y()*0.1;
+    p[2] = position.z()*0.1;
+    if(m_s2s_map->GetFieldValue(p, b_s2s, db_s2s)){
+      // the map gradient is per cm
+      field.SetXYZ(b_s2s[0], b_s2s[1], b_s2s[2]);
+      dBdX.SetXYZ(0.1*db_s2s[0], 0.1*db_s2s[1], 0.1*db_s2s[2]);
+      dBdY.SetXYZ(0.1*db_s2s[3], 0.1*db_s2s[4], 0.1*db_s2s[5]);
+      if(dBdZ)
+        dBdZ->SetXYZ(0.1*db_s2s[6], 0.1*db_s2s[7], 0.1*db_s2s[8]);
+    }
+  }
+
+  if(!m_element_list.empty()){
+    field += GetElementField(position);
+    const TVector3 dx(Delta, 0., 0.);
+    const TVector3 dy(0., Delta, 0.);
+    dBdX += 0.5/Delta*(GetElementField(position+dx) -
+                       GetElementField(position-dx));
+    dBdY += 0.5/Delta*(GetElementField(position+dy) -
+                       GetElementField(position-dy));
+    if(dBdZ){
+      const TVector3 dz(0., 0., Delta);
+      *dBdZ += 0.5/Delta*(GetElementField(position+dz) -
+                          GetElementField(position-dz));
+    }
+  }
+
+  return field;
+}
+
+//_____________________________________________________________________________
+TVector3
+FieldMan::GetElementField(const TVector3& position) const
+{
+  TVector3 field(0., 0., 0.);
   FEIterator itr, itr_end = m_element_list.end();
   for(itr=m_element_list.begin(); itr!=itr_end; ++itr){
     if((*itr)->ExistField(position))
       field += (*itr)->GetField(position);
   }
-#endif
-
   return field;
 }
 
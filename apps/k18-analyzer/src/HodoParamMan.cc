@@ -32,6 +32,7 @@ const auto qnan = TMath::QuietNaN();
 //_____________________________________________________________________________
 HodoParamMan::HodoParamMan()
   : m_is_ready(false),
+    m_is_frozen(false),
     m_file_name()
 {
 }
@@ -48,6 +49,7 @@ HodoParamMan::~HodoParamMan()
 void
 HodoParamMan::ClearAHCont()
 {
+  m_AHPTable.Clear();
   del::ClearMap(m_AHPContainer);
 }
 
@@ -55,6 +57,7 @@ HodoParamMan::ClearAHCont()
 void
 HodoParamMan::ClearALCont()
 {
+  m_ALPTable.Clear();
   del::ClearMap(m_ALPContainer);
 }
 
@@ -62,6 +65,7 @@ HodoParamMan::ClearALCont()
 void
 HodoParamMan::ClearTCont()
 {
+  m_TPTable.Clear();
   del::ClearMap(m_TPContainer);
 }
 
@@ -75,6 +79,17 @@ KEY(Int_t cid, Int_t pl, Int_t seg, Int_t ud)
           ((ud&UdMask)   << UdShift  ));
 }
 
+//_____________________________________________________________________________
+inline Bool_t
+DecodeKey(Int_t key, Int_t& cid, Int_t (&index)[3])
+{
+  cid      = (key >> CidShift ) & CidMask;
+  index[0] = (key >> PlidShift) & PlidMask;
+  index[1] = (key >> SegShift ) & SegMask;
+  index[2] = (key >> UdShift  ) & UdMask;
+  return true;
+}
+
 //_____________________________________________________________________________
 Bool_t
 HodoParamMan::Initialize()
@@ -162,6 +177,7 @@ HodoParamMan::Initialize()
     } /* if(input_line >>) */
   } /* while(std::getline) */
 
+  Freeze();
   m_is_ready = true;
   return true;
 }
@@ -174,6 +190,22 @@ HodoParamMan::Initialize(const TString& file_name)
   return Initialize();
 }
 
+//_____________________________________________________________________________
+void
+HodoParamMan::Freeze(Bool_t flag)
+{
+  if(flag){
+    m_TPTable.Build(m_TPContainer, DecodeKey);
+    m_AHPTable.Build(m_AHPContainer, DecodeKey);
+    m_ALPTable.Build(m_ALPContainer, DecodeKey);
+  }else{
+    m_TPTable.Clear();
+    m_AHPTable.Clear();
+    m_ALPTable.Clear();
+  }
+  m_is_frozen = flag;
+}
+
 //_____________________________________________________________________________
 Bool_t
 HodoParamMan::GetTime(Int_t cid, Int_t plid, Int_t seg,
@@ -285,6 +317,8 @@ HodoParamMan::GetGain(Int_t cid, Int_t plid, Int_t seg, Int_t ud) const
 HodoTParam*
 HodoParamMan::GetTmap(Int_t cid, Int_t plid, Int_t seg, Int_t ud) const
 {
+  if(m_is_frozen)
+    return m_TPTable.Get(cid&CidMask, { plid&PlidMask, seg&SegMask, ud&UdMask });
   Int_t key = KEY(cid, plid, seg, ud);
   TIterator itr = m_TPContainer.find(key);
   if(itr != m_TPContainer.end())
@@ -297,6 +331,8 @@ HodoParamMan::GetTmap(Int_t cid, Int_t plid, Int_t seg, Int_t ud) const
 HodoAParam*
 HodoParamMan::GetAHmap(Int_t cid, Int_t plid, Int_t seg, Int_t ud) const
 {
+  if(m_is_frozen)
+    return m_AHPTable.Get(cid&CidMask, { plid&PlidMask, seg&SegMask, ud&UdMask });
   Int_t key = KEY(cid, plid, seg, ud);
   AIterator itr = m_AHPContainer.find(key);
   if(itr != m_AHPContainer.end())
@@ -309,6 +345,8 @@ HodoParamMan::GetAHmap(Int_t cid, Int_t plid, Int_t seg, Int_t ud) const
 HodoAParam*
 HodoParamMan::GetALmap(Int_t cid, Int_t plid, Int_t seg, Int_t ud) const
 {
+  if(m_is_frozen)
+    return m_ALPTable.Get(cid&CidMask, { plid&PlidMask, seg&SegMask, ud&UdMask });
   Int_t key = KEY(cid, plid, seg, ud);
   AIterator itr = m_ALPContainer.find(key);
   if(itr != m_ALPContainer.end())
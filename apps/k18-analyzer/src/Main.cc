@@ -19,6 +19,7 @@
 #include "DebugCounter.hh"
 #include "DebugTimer.hh"
 #include "DeleteUtility.hh"
+#include "ParallelDriver.hh"
 #include "UnpackerManager.hh"
 #include "VEvent.hh"
 
@@ -36,32 +37,13 @@ enum EArg
   kArgOutFile,
   kArgc
 };
-}
-
-TROOT theROOT("k18analyzer", "k18analyzer");
 
 //______________________________________________________________________________
-int
-main(int argc, char **argv)
+// sequential analysis, also run by each worker of the parallel mode
+Int_t
+Analyze(const TString& conf_file, const TString& in_file,
+        const TString& out_file, Bool_t is_worker=false)
 {
-  std::vector<TString> arg(argv, argv + argc);
-  const TString& process = arg[kArgProcess];
-  if(argc!=kArgc){
-    hddaq::cout << "#D Usage: " << gSystem->BaseName(process)
-  		<< " [analyzer config file]"
-  		<< " [data input stream]"
-  		<< " [output root file]"
-  		<< std::endl;
-    return EXIT_SUCCESS;
-  }
-
-  debug::Timer timer("[::main()] End of Analyzer");
-
-  const TString& conf_file = arg[kArgConfFile];
-  const TString& in_file   = arg[kArgInFile];
-  const TString& out_file  = arg[kArgOutFile];
-
-
   // TTree::SetMaxTreeSize(1000000000000LL);
   hddaq::cout << "[::main()] recreate root file : " << out_file << std::endl;
   new TFile(out_file, "recreate");
@@ -72,8 +54,20 @@ main(int argc, char **argv)
   if(!gConf.Initialize(conf_file) || !gConf.InitializeUnpacker())
     return EXIT_FAILURE;
 
+  if(is_worker){
+    // the dispatcher applies skip and max_loop to the whole stream
+    if(gUnpacker.get_skip() != 0 || gUnpacker.get_max_loop() > 0){
+      hddaq::cerr << "[::main()] skip/max_loop of the unpacker config are"
+                  << " ignored in the parallel mode, use --skip/--max-loop"
+                  << std::endl;
+    }
+    gUnpacker.set_parameter("skip", "0");
+    gUnpacker.set_parameter("max_loop", "-1");
+  }
+
   gUnpacker.set_istream(in_file.Data());
-  gUnpacker.enable_istream_bookmark();
+  if(!is_worker)
+    gUnpacker.enable_istream_bookmark();
   gUnpacker.initialize();
 
   CatchSignal::Set(SIGINT);
@@ -91,3 +85,67 @@ main(int argc, char **argv)
 
   return EXIT_SUCCESS;
 }
+}
+
+TROOT theROOT("k18analyzer", "k18analyzer");
+
+//______________________________________________________________________________
+int
+main(int argc, char **argv)
+{
+  std::vector<TString> arg(argv, argv + argc);
+  const TString& process = arg[kArgProcess];
+  if(argc<kArgc){
+    hddaq::cout << "#D Usage: " << gSystem->BaseName(process)
+  		<< " [analyzer config file]"
+  		<< " [data input stream]"
+  		<< " [output root file]"
+  		<< " (--jobs=N) (--ordered) (--skip=N) (--max-loop=N)"
+  		<< std::endl
+  		<< "   --jobs=N    analyze in N worker processes and merge the outputs"
+  		<< std::endl
+  		<< "   --ordered   keep the input event order in the merged trees"
+  		<< std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  debug::Timer timer("[::main()] End of Analyzer");
+
+  const TString& conf_file = arg[kArgConfFile];
+  const TString& in_file   = arg[kArgInFile];
+  const TString& out_file  = arg[kArgOutFile];
+
+  Int_t    n_job    = 1;
+  Bool_t   ordered  = false;
+  Long64_t skip     = 0;
+  Long64_t max_loop = -1;
+  for(Int_t i=kArgc; i<argc; ++i){
+    if(arg[i].BeginsWith("--jobs="))
+      n_job = TString(arg[i](7, arg[i].Length())).Atoi();
+    else if(arg[i] == "--ordered")
+      ordered = true;
+    else if(arg[i].BeginsWith("--skip="))
+      skip = TString(arg[i](7, arg[i].Length())).Atoll();
+    else if(arg[i].BeginsWith("--max-loop="))
+      max_loop = TString(arg[i](11, arg[i].Length())).Atoll();
+    else {
+      hddaq::cerr << "[::main()] unknown option : " << arg[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(n_job <= 1){
+    if(skip != 0 || max_loop > 0)
+      hddaq::cerr << "[::main()] --skip/--max-loop are for the parallel mode,"
+                  << " use the unpacker config" << std::endl;
+    return Analyze(conf_file, in_file, out_file);
+  }
+
+  ParallelDriver driver(in_file, out_file, n_job, ordered);
+  driver.SetSkip(skip);
+  driver.SetMaxLoop(max_loop);
+  return driver.Run([&conf_file](const TString& worker_in,
+                                 const TString& worker_out){
+                      return Analyze(conf_file, worker_in, worker_out, true);
+                    });
+}
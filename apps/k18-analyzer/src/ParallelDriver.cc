@@ -0,0 +1,421 @@
+// -*- C++ -*-
+
+#include "ParallelDriver.hh"
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <TFile.h>
+#include <TFileMerger.h>
+#include <TKey.h>
+#include <TSystem.h>
+#include <TTree.h>
+
+#include <DAQNode.hh>
+#include <IStream.hh>
+#include <std_ostream.hh>
+
+#include "CatchSignal.hh"
+#include "FuncName.hh"
+
+namespace
+{
+using hddaq::unpacker::DAQNode;
+const size_t HeaderBytes = DAQNode::k_header_size*sizeof(UInt_t);
+// large pipes let a worker run ahead of the dispatcher
+const Int_t  PipeSize    = 0x100000;
+}
+
+//_____________________________________________________________________________
+ParallelDriver::ParallelDriver(const TString& in_file, const TString& out_file,
+                               Int_t n_worker, Bool_t ordered)
+  : m_in_file(in_file),
+    m_out_file(out_file),
+    m_n_worker(n_worker),
+    m_ordered(ordered),
+    m_skip(0),
+    m_max_loop(-1),
+    m_pid(n_worker, -1),
+    m_fd(n_worker, -1),
+    m_n_event(n_worker, 0),
+    m_keep_worker_file(false)
+{
+}
+
+//_____________________________________________________________________________
+ParallelDriver::~ParallelDriver()
+{
+  for(Int_t i=0; i<m_n_worker; ++i)
+    CloseWorker(i);
+}
+
+//_____________________________________________________________________________
+TString
+ParallelDriver::WorkerFileName(Int_t i) const
+{
+  TString base = m_out_file;
+  if(base.EndsWith(".root"))
+    base.Resize(base.Length() - 5);
+  return Form("%s_w%03d.root", base.Data(), i);
+}
+
+//_____________________________________________________________________________
+TString
+ParallelDriver::WorkerLogName(Int_t i) const
+{
+  TString name = WorkerFileName(i);
+  name.Resize(name.Length() - 5);
+  return name + ".log";
+}
+
+//_____________________________________________________________________________
+void
+ParallelDriver::CloseWorker(Int_t i)
+{
+  if(m_fd[i] >= 0){
+    ::close(m_fd[i]);
+    m_fd[i] = -1;
+  }
+}
+
+//_____________________________________________________________________________
+Int_t
+ParallelDriver::Run(const Analysis& analysis)
+{
+  hddaq::cout << FUNC_NAME << " " << m_n_worker << " workers"
+              << (m_ordered ? ", event order preserved" : "") << std::endl;
+
+  // a dead worker must not kill the dispatcher
+  std::signal(SIGPIPE, SIG_IGN);
+
+  if(!Fork(analysis))
+    return EXIT_FAILURE;
+
+  CatchSignal::Set(SIGINT);
+  Bool_t status = Dispatch();
+  status = Wait() && status;
+  if(!status){
+    hddaq::cerr << FUNC_NAME << " worker files are kept for inspection"
+                << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return Merge() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ParallelDriver::Fork(const Analysis& analysis)
+{
+  std::vector<Int_t> rd(m_n_worker, -1);
+  for(Int_t i=0; i<m_n_worker; ++i){
+    Int_t p[2];
+    if(::pipe(p) < 0){
+      hddaq::cerr << FUNC_NAME << " pipe() failed : " << std::strerror(errno)
+                  << std::endl;
+      return false;
+    }
+#ifdef F_SETPIPE_SZ
+    ::fcntl(p[1], F_SETPIPE_SZ, PipeSize);
+#endif
+    rd[i]   = p[0];
+    m_fd[i] = p[1];
+  }
+
+  hddaq::cout.flush();
+  hddaq::cerr.flush();
+  std::cout.flush();
+  std::cerr.flush();
+
+  for(Int_t i=0; i<m_n_worker; ++i){
+    const pid_t pid = ::fork();
+    if(pid < 0){
+      hddaq::cerr << FUNC_NAME << " fork() failed : " << std::strerror(errno)
+                  << std::endl;
+      return false;
+    }
+
+    if(pid == 0){
+      // worker: only its own read end stays open, so that it sees the
+      // end of file when the dispatcher closes the pipe
+      for(Int_t j=0; j<m_n_worker; ++j){
+        if(m_fd[j] >= 0) ::close(m_fd[j]);
+        if(j != i && rd[j] >= 0) ::close(rd[j]);
+      }
+      ::dup2(rd[i], STDIN_FILENO);
+      ::close(rd[i]);
+
+      const Int_t log = ::open(WorkerLogName(i), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+      if(log >= 0){
+        ::dup2(log, STDOUT_FILENO);
+        ::dup2(log, STDERR_FILENO);
+        ::close(log);
+      }
+
+      std::exit(analysis("std::cin", WorkerFileName(i)));
+    }
+
+    m_pid[i] = pid;
+    ::close(rd[i]);
+    rd[i] = -1;
+    hddaq::cout << FUNC_NAME << " worker " << i << " pid " << pid
+                << " -> " << WorkerFileName(i) << std::endl;
+  }
+
+  return true;
+}
+
+//_____________________________________________________________________________
+Int_t
+ParallelDriver::SelectWorker(Long64_t event)
+{
+  if(m_ordered){
+    const Int_t i = event % m_n_worker;
+    return m_fd[i] >= 0 ? i : -1;
+  }
+
+  // the first worker with room in its pipe, starting after the last one
+  std::vector<pollfd> pfd;
+  std::vector<Int_t>  index;
+  for(Int_t k=0; k<m_n_worker; ++k){
+    const Int_t i = (event + k) % m_n_worker;
+    if(m_fd[i] < 0) continue;
+    pfd.push_back({ m_fd[i], POLLOUT, 0 });
+    index.push_back(i);
+  }
+  if(pfd.empty())
+    return -1;
+
+  while(::poll(&pfd[0], pfd.size(), -1) < 0){
+    if(errno != EINTR) return -1;
+  }
+  for(size_t k=0; k<pfd.size(); ++k){
+    if(pfd[k].revents) return index[k];
+  }
+  return index[0];
+}
+
+//_____________________________________________________________________________
+Bool_t
+ParallelDriver::WriteEvent(Int_t i, const char* buf, size_t n)
+{
+  while(n > 0){
+    const ssize_t ret = ::write(m_fd[i], buf, n);
+    if(ret < 0){
+      if(errno == EINTR) continue;
+      hddaq::cerr << FUNC_NAME << " worker " << i << " does not take data : "
+                  << std::strerror(errno) << ", see " << WorkerLogName(i)
+                  << std::endl;
+      CloseWorker(i);
+      return false;
+    }
+    buf += ret;
+    n   -= ret;
+  }
+  return true;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ParallelDriver::Dispatch()
+{
+  hddaq::unpacker::IStream stream(m_in_file.Data());
+  if(!stream.is_open() || stream.fail()){
+    hddaq::cerr << FUNC_NAME << " cannot open " << m_in_file << std::endl;
+    for(Int_t i=0; i<m_n_worker; ++i) CloseWorker(i);
+    return false;
+  }
+
+  Bool_t            status = true;
+  Long64_t          n_read = 0;
+  Long64_t          n_sent = 0;
+  std::vector<char> buf(HeaderBytes);
+  while(!CatchSignal::Stop()){
+    if(m_max_loop > 0 && n_sent >= m_max_loop)
+      break;
+
+    if(!stream.read(&buf[0], HeaderBytes)
+       || stream.gcount() != (std::streamsize)HeaderBytes)
+      break;
+    const size_t n_byte =
+      reinterpret_cast<const DAQNode::Header*>(&buf[0])->m_data_size*sizeof(UInt_t);
+    if(n_byte < HeaderBytes){
+      hddaq::cerr << FUNC_NAME << " broken event header after "
+                  << n_read << " events" << std::endl;
+      status = false;
+      break;
+    }
+
+    buf.resize(n_byte);
+    const std::streamsize n_body = n_byte - HeaderBytes;
+    if(n_body > 0 && (!stream.read(&buf[HeaderBytes], n_body)
+                      || stream.gcount() != n_body)){
+      hddaq::cerr << FUNC_NAME << " truncated event " << n_read
+                  << " at the end of the stream" << std::endl;
+      break;
+    }
+
+    if(n_read++ < m_skip)
+      continue;
+
+    // an event refused by a dead worker goes to the next one
+    Int_t i = -1;
+    do {
+      i = SelectWorker(n_sent);
+    } while(i >= 0 && !WriteEvent(i, &buf[0], n_byte) && !m_ordered);
+    if(i < 0 || m_fd[i] < 0){
+      hddaq::cerr << FUNC_NAME << " no worker to take event "
+                  << n_read - 1 << std::endl;
+      status = false;
+      break;
+    }
+
+    ++m_n_event[i];
+    ++n_sent;
+  }
+
+  for(Int_t i=0; i<m_n_worker; ++i)
+    CloseWorker(i);
+
+  hddaq::cout << FUNC_NAME << " " << n_sent << " events dispatched";
+  for(Int_t i=0; i<m_n_worker; ++i)
+    hddaq::cout << (i==0 ? " (" : ", ") << m_n_event[i];
+  hddaq::cout << ")" << std::endl;
+
+  return status;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ParallelDriver::Wait()
+{
+  Bool_t status = true;
+  for(Int_t i=0; i<m_n_worker; ++i){
+    if(m_pid[i] < 0) continue;
+    Int_t wstatus = 0;
+    while(::waitpid(m_pid[i], &wstatus, 0) < 0 && errno == EINTR);
+    m_pid[i] = -1;
+    if(!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != EXIT_SUCCESS){
+      hddaq::cerr << FUNC_NAME << " worker " << i << " failed, see "
+                  << WorkerLogName(i) << std::endl;
+      status = false;
+    }
+  }
+  return status;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ParallelDriver::Merge()
+{
+  hddaq::cout << FUNC_NAME << " merge into " << m_out_file << std::endl;
+
+  // trees rebuilt in the input order are left out of the ordinary merge
+  std::vector<TString> tree_name;
+  if(m_ordered){
+    std::unique_ptr<TFile> f(TFile::Open(WorkerFileName(0)));
+    if(!f || f->IsZombie()){
+      hddaq::cerr << FUNC_NAME << " cannot open " << WorkerFileName(0)
+                  << std::endl;
+      return false;
+    }
+    TIter next(f->GetListOfKeys());
+    while(auto key = dynamic_cast<TKey*>(next())){
+      if(TString(key->GetClassName()) == "TTree")
+        tree_name.push_back(key->GetName());
+    }
+  }
+
+  TFileMerger merger(kFALSE);
+  if(!merger.OutputFile(m_out_file, "RECREATE"))
+    return false;
+  for(Int_t i=0; i<m_n_worker; ++i){
+    if(!merger.AddFile(WorkerFileName(i)))
+      return false;
+  }
+  for(const auto& name : tree_name)
+    merger.AddObjectNames(name);
+
+  Int_t mode = TFileMerger::kAll | TFileMerger::kRegular;
+  if(m_ordered)
+    mode |= TFileMerger::kSkipListed;
+  if(!merger.PartialMerge(mode)){
+    hddaq::cerr << FUNC_NAME << " merge failed" << std::endl;
+    return false;
+  }
+
+  for(const auto& name : tree_name){
+    if(!MergeOrdered(name))
+      return false;
+  }
+
+  if(!m_keep_worker_file){
+    for(Int_t i=0; i<m_n_worker; ++i){
+      gSystem->Unlink(WorkerFileName(i));
+      gSystem->Unlink(WorkerLogName(i));
+    }
+  }
+
+  return true;
+}
+
+//_____________________________________________________________________________
+// Event n went to worker n % N, so reading the worker trees in turn gives
+// the input order back.
+Bool_t
+ParallelDriver::MergeOrdered(const TString& tree_name)
+{
+  TFile out(m_out_file, "UPDATE");
+  if(out.IsZombie())
+    return false;
+
+  std::vector<std::unique_ptr<TFile>> file;
+  std::vector<TTree*>                 tree;
+  Long64_t                            n_entry = 0;
+  Bool_t                              aligned = true;
+  for(Int_t i=0; i<m_n_worker; ++i){
+    file.emplace_back(TFile::Open(WorkerFileName(i)));
+    TTree* t = file.back() ? dynamic_cast<TTree*>(file.back()->Get(tree_name)) : nullptr;
+    if(!t){
+      hddaq::cerr << FUNC_NAME << " no " << tree_name << " in "
+                  << WorkerFileName(i) << std::endl;
+      return false;
+    }
+    tree.push_back(t);
+    n_entry += t->GetEntries();
+    aligned = aligned && (t->GetEntries() == m_n_event[i]);
+  }
+  if(!aligned){
+    hddaq::cerr << FUNC_NAME << " " << tree_name
+                << " is not filled once per event, entries are interleaved"
+                << " but the event order is not guaranteed" << std::endl;
+  }
+
+  out.cd();
+  TTree* merged = tree[0]->CloneTree(0);
+  std::vector<Long64_t> next(m_n_worker, 0);
+  for(Long64_t j=0; j<n_entry; ){
+    for(Int_t i=0; i<m_n_worker; ++i){
+      if(next[i] >= tree[i]->GetEntries()) continue;
+      tree[i]->CopyAddresses(merged);
+      tree[i]->GetEntry(next[i]++);
+      merged->Fill();
+      ++j;
+    }
+  }
+
+  out.cd();
+  merged->Write("", TObject::kOverwrite);
+  hddaq::cout << FUNC_NAME << " " << tree_name << " : " << n_entry
+              << " entries in input order" << std::endl;
+  return true;
+}
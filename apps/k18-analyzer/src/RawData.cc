@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include <TF1.h>
 
@@ -28,6 +30,148 @@ namespace
 using namespace hddaq::unpacker;
 const auto& gUnpacker     = GUnpacker::get_instance();
 const auto& gUser         = UserParamMan::GetInstance();
+
+// what a data type fills in the raw hit
+enum EDataAction
+{
+  kUnknown,
+  kIgnore,
+  kAdc,
+  kAdcHigh,
+  kAdcLow,
+  kTdcLeading,
+  kTdcTrailing,
+  kTdcOverflow
+};
+
+//_____________________________________________________________________________
+// Built once per device from the digit info: the action of each data id,
+// which replaces the get_data_id() string lookups of every hit, and the
+// slot of each (plane, seg), or (plane, wire) for DC, which replaces the
+// search of the hit in the container.
+struct DecodeTable
+{
+  Bool_t                   is_hodo;
+  Bool_t                   is_fiber;
+  Bool_t                   is_dc;
+  std::vector<Int_t>       hodo_action;  // [data id]
+  std::vector<Int_t>       fiber_action; // [data id]
+  std::vector<Int_t>       dc_action;    // [data id]
+  std::vector<Int_t>       hodo_base;    // [plane]
+  std::vector<Int_t>       dc_base;      // [plane]
+  std::vector<HodoRawHit*> hodo_slot;
+  std::vector<DCRawHit*>   dc_slot;
+  std::vector<Int_t>       used_slot;
+};
+
+//_____________________________________________________________________________
+std::vector<Int_t>
+MakeActionTable(const std::vector<std::string>& data_name,
+                const std::map<std::string, Int_t>& action)
+{
+  std::vector<Int_t> table(data_name.size(), kUnknown);
+  for(Int_t i=0, n=data_name.size(); i<n; ++i){
+    auto itr = action.find(data_name[i]);
+    if(itr != action.end())
+      table[i] = itr->second;
+  }
+  return table;
+}
+
+//_____________________________________________________________________________
+DecodeTable&
+GetDecodeTable(Int_t id, const TString& type)
+{
+  static std::map<Int_t, DecodeTable> s_table;
+  auto itr = s_table.find(id);
+  if(itr != s_table.end())
+    return itr->second;
+
+  static const auto& digit_info = GConfig::get_instance().get_digit_info();
+  DecodeTable& table = s_table[id];
+  table.is_hodo  = type.Contains("Hodo", TString::kIgnoreCase);
+  table.is_fiber = type.Contains("Fiber", TString::kIgnoreCase);
+  table.is_dc    = type.Contains("DC", TString::kIgnoreCase);
+
+  // data ids are given at (plane, seg, ch) = (0, 0, 0) as in get_data_id()
+  const auto& data_name = digit_info.get_name_list(id, 0, 0, 0);
+  table.hodo_action = MakeActionTable(data_name, {
+      { "adc",      kAdc         },
+      { "tdc",      kTdcLeading  },
+      { "trailing", kTdcTrailing },
+      { "overflow", kTdcOverflow } });
+  table.fiber_action = MakeActionTable(data_name, {
+      { "leading",  kTdcLeading  },
+      { "trailing", kTdcTrailing },
+      { "fadc",     kAdcHigh     },
+      { "overflow", kTdcOverflow },
+      { "highgain", kAdcHigh     },
+      { "lowgain",  kAdcLow      },
+      { "crs_cnt",  kIgnore      } });
+  table.dc_action = MakeActionTable(data_name, {
+      { "leading",  kTdcLeading  },
+      { "trailing", kTdcTrailing },
+      { "overflow", kTdcOverflow } });
+
+  Int_t n_hodo_slot = 0;
+  Int_t n_dc_slot   = 0;
+  for(Int_t plane=0, n_plane=gUnpacker.get_n_plane(id);
+      plane<n_plane; ++plane){
+    table.hodo_base.push_back(n_hodo_slot);
+    table.dc_base.push_back(n_dc_slot);
+    Int_t n_wire = 0;
+    for(Int_t seg=0, n_seg=gUnpacker.get_n_segment(id, plane);
+        seg<n_seg; ++seg){
+      n_wire = std::max<Int_t>(n_wire, gUnpacker.get_n_ch(id, plane, seg));
+      ++n_hodo_slot;
+    }
+    n_dc_slot += n_wire;
+  }
+  table.hodo_slot.assign(n_hodo_slot, nullptr);
+  table.dc_slot.assign(n_dc_slot, nullptr);
+  return table;
+}
+
+//_____________________________________________________________________________
+Bool_t
+SetHodoData(HodoRawHit* p, Int_t action, Int_t ch, Double_t val)
+{
+  switch(action){
+  case kAdc:         p->SetAdc(ch, val);         return true;
+  case kAdcHigh:     p->SetAdcHigh(ch, val);     return true;
+  case kAdcLow:      p->SetAdcLow(ch, val);      return true;
+  case kTdcLeading:  p->SetTdcLeading(ch, val);  return true;
+  case kTdcTrailing: p->SetTdcTrailing(ch, val); return true;
+  case kTdcOverflow: p->SetTdcOverflow(ch, val); return true;
+  case kIgnore:                                  return true;
+  default:                                       return false;
+  }
+}
+
+//_____________________________________________________________________________
+Bool_t
+SetDCData(DCRawHit* p, Int_t action, Double_t val)
+{
+  switch(action){
+  case kTdcLeading:  p->SetTdc(val);         return true;
+  case kTdcTrailing: p->SetTrailing(val);    return true;
+  case kTdcOverflow: p->SetTdcOverflow(val); return true;
+  default:                                   return false;
+  }
+}
+
+//_____________________________________________________________________________
+void
+PrintWrongDataType(const TString& func_name, const TString& name,
+                   Int_t plane, Int_t seg, Int_t ch, Int_t data)
+{
+  hddaq::cerr << func_name << " wrong data type " << std::endl
+              << " Detector   = " << name  << std::endl
+              << " Plane      = " << plane << std::endl
+              << " Segment    = " << seg   << std::endl
+              << " Channel    = " << ch    << std::endl
+              << " Data       = " << data  << std::endl;
+}
 }
 
 //_____________________________________________________________________________
@@ -97,179 +241,78 @@ RawData::DecodeHits(const TString& name)
 
   Clear(name);
 
-  Bool_t is_hodo  = type.Contains("Hodo", TString::kIgnoreCase);
-  Bool_t is_fiber = type.Contains("Fiber", TString::kIgnoreCase);
-  Bool_t is_dc    = type.Contains("DC", TString::kIgnoreCase);
-
-  if(!is_hodo && !is_fiber && !is_dc)
+  DecodeTable& table = GetDecodeTable(id, type);
+  if(!table.is_hodo && !table.is_fiber && !table.is_dc)
     return false;
 
-  for(Int_t plane=0, n_plane=gUnpacker.get_n_plane(id);
-      plane<n_plane; ++plane){
-    for(Int_t seg=0, n_seg=gUnpacker.get_n_segment(id, plane);
-        seg<n_seg; ++seg){
-      for(Int_t ch=0, n_ch=gUnpacker.get_n_ch(id, plane, seg);
-          ch<n_ch; ++ch){
-        for(Int_t data=0, n_data=gUnpacker.get_n_data(id, plane, seg, ch);
-            data<n_data; ++data){
-          for(Int_t i=0, n=gUnpacker.get_entries(id, plane, seg, ch, data);
-              i<n; ++i){
-            UInt_t val = gUnpacker.get(id, plane, seg, ch, data, i);
-            if(is_hodo)
-	      AddHodoRawHit(name, plane, seg, ch, data, val);
-	    if(is_fiber)
-	      AddFiberRawHit(name, plane, seg, ch, data, val);
-            if(is_dc)
-	      AddDCRawHit(name, plane, seg, ch, data, val);
-            // if(is_hodo){
-	    //   AddHodoRawHit(name, plane, seg, ch, data, val);
-	    //   std::cout << "is_hodo: " << n << std::endl;
-	    // }
-	    // if(is_fiber){
-	    //   AddFiberRawHit(name, plane, seg, ch, data, val);
-	    //   std::cout << "is_fiber: " << n << std::endl;
-	    // }
-            // if(is_dc){
-	    //   AddDCRawHit(name, plane, seg, ch, data, val);
-	    //   std::cout << "is_dc: " << n << std::endl;
-	    // }
-          }
-        }
+  auto& hodo_cont = m_hodo_raw_hit_collection[name];
+  auto& dc_cont   = m_dc_raw_hit_collection[name];
+
+  // the fired cells are sorted in the order of the digit info, so the
+  // hits are created in the same order as by a plane/seg/ch/data scan
+  const auto& digit_index = gUnpacker.get_digit_index();
+  UnpackerManager::cell_iterator itr, end;
+  gUnpacker.get_fired(id, itr, end);
+  for(; itr!=end; ++itr){
+    const auto& cell  = digit_index.get_coordinate(*itr);
+    const auto& data  = gUnpacker.get_cell_data(*itr);
+    const Int_t plane = cell.m_plane;
+    const Int_t seg   = cell.m_segment;
+    const Int_t ch    = cell.m_ch;
+    const Int_t dtype = cell.m_data_type;
+    if(data.empty())
+      continue;
+
+    if(table.is_hodo || table.is_fiber){
+      const Int_t slot = table.hodo_base[plane] + seg;
+      HodoRawHit*& p = table.hodo_slot[slot];
+      if(!p){
+        p = new HodoRawHit(name, plane, seg);
+        hodo_cont.push_back(p);
+        table.used_slot.push_back(slot);
+      }
+      for(const auto& d: data){
+        const UInt_t val = d;
+        if(table.is_hodo && !SetHodoData(p, table.hodo_action[dtype], ch, val))
+          PrintWrongDataType(FUNC_NAME, name, plane, seg, ch, dtype);
+        if(table.is_fiber && !SetHodoData(p, table.fiber_action[dtype], ch, val))
+          PrintWrongDataType(FUNC_NAME, name, plane, seg, ch, dtype);
       }
     }
-  }
-
-  m_is_decoded[name] = true;
-  return true;
-}
-
-//_____________________________________________________________________________
-Bool_t
-RawData::AddHodoRawHit(const TString& name, Int_t plane, Int_t seg,
-		       Int_t ch, Int_t data, Double_t val)
-{
-  auto& cont = m_hodo_raw_hit_collection[name];
-  HodoRawHit* p = nullptr;
-  for(Int_t i=0, n=cont.size(); i<n; ++i){
-    HodoRawHit* q = cont[i];
-    if(true
-       && q->DetectorName() == name
-       && q->PlaneId() == plane
-       && q->SegmentId() == seg){
-      p=q; break;
-    }
-  }
-  if(!p){
-    p = new HodoRawHit(name, plane, seg);
-    cont.push_back(p);
-  }
-
-  if(data == gUnpacker.get_data_id(name, "adc")){
-    p->SetAdc(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "tdc")){
-    p->SetTdcLeading(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "trailing")){
-    p->SetTdcTrailing(ch, val);
-  // }else if(data == gUnpacker.get_data_id(name, "cstop")){
-  //   ;
-  }else if(data == gUnpacker.get_data_id(name, "overflow")){
-    p->SetTdcOverflow(ch, val);
-  }
-  else{
-    hddaq::cerr << FUNC_NAME << " wrong data type " << std::endl
-                << " Detector   = " << name  << std::endl
-                << " Plane      = " << plane << std::endl
-                << " Segment    = " << seg   << std::endl
-                << " Channel    = " << ch    << std::endl
-                << " Data       = " << data  << std::endl;
-    return false;
-  }
-  return true;
-}
 
-//_____________________________________________________________________________
-Bool_t
-RawData::AddFiberRawHit(const TString& name, Int_t plane, Int_t seg,
-		       Int_t ch, Int_t data, Double_t val)
-{
-  auto& cont = m_hodo_raw_hit_collection[name];
-  HodoRawHit* p = nullptr;
-  for(Int_t i=0, n=cont.size(); i<n; ++i){
-    HodoRawHit* q = cont[i];
-    if(true
-       && q->DetectorName() == name
-       && q->PlaneId() == plane
-       && q->SegmentId() == seg){
-      p=q; break;
+    if(table.is_dc){
+      const Int_t wire = ch;
+      const Int_t slot = table.dc_base[plane] + wire;
+      DCRawHit*& p = table.dc_slot[slot];
+      if(!p){
+        p = new DCRawHit(name, plane, wire);
+        dc_cont.push_back(p);
+        table.used_slot.push_back(slot);
+      }
+      for(const auto& d: data){
+        const UInt_t val = d;
+        if(!SetDCData(p, table.dc_action[dtype], val)){
+          hddaq::cerr << FUNC_NAME << " unknown data type " << std::endl
+                      << " Detector = " << name  << std::endl
+                      << " PlaneId  = " << plane << std::endl
+                      << " WireId   = " << wire  << std::endl
+                      << " DataType = " << dtype << std::endl
+                      << " Value    = " << val   << std::endl;
+        }
+      }
     }
   }
-  if(!p){
-    p = new HodoRawHit(name, plane, seg);
-    cont.push_back(p);
-  }
 
-  if(data == gUnpacker.get_data_id(name, "leading")){
-    p->SetTdcLeading(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "trailing")){
-    p->SetTdcTrailing(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "fadc")){
-    p->SetAdcHigh(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "overflow")){
-    p->SetTdcOverflow(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "highgain")){
-    p->SetAdcHigh(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "lowgain")){
-    p->SetAdcLow(ch, val);
-  }else if(data == gUnpacker.get_data_id(name, "crs_cnt")){
-    return true;
-  }else{
-    hddaq::cerr << FUNC_NAME << " wrong data type " << std::endl
-                << " Detector   = " << name  << std::endl
-                << " Plane      = " << plane << std::endl
-                << " Segment    = " << seg   << std::endl
-                << " Channel    = " << ch    << std::endl
-                << " Data       = " << data  << std::endl;
-    return false;
+  // the slots are kept for the next event, only the used ones are reset
+  for(const auto& slot: table.used_slot){
+    if(table.is_hodo || table.is_fiber)
+      table.hodo_slot[slot] = nullptr;
+    if(table.is_dc)
+      table.dc_slot[slot] = nullptr;
   }
-  return true;
-}
+  table.used_slot.clear();
 
-//_____________________________________________________________________________
-Bool_t
-RawData::AddDCRawHit(const TString& name, Int_t plane, Int_t seg,
-                     Int_t ch, Int_t data, Double_t val)
-{
-  auto& cont = m_dc_raw_hit_collection[name];
-  Int_t wire = ch;
-  DCRawHit* p = nullptr;
-  for(Int_t i=0, n=cont.size(); i<n; ++i){
-    DCRawHit* q = cont[i];
-    if(true
-       && q->DetectorName() == name
-       && q->PlaneId() == plane
-       && q->WireId() == wire){
-      p=q; break;
-    }
-  }
-  if(!p){
-    p = new DCRawHit(name, plane, wire);
-    cont.push_back(p);
-  }
-
-  if(data == gUnpacker.get_data_id(name, "leading")){
-    p->SetTdc(val);
-  }else if(data == gUnpacker.get_data_id(name, "trailing")){
-    p->SetTrailing(val);
-  }else if(data == gUnpacker.get_data_id(name, "overflow")){
-    p->SetTdcOverflow(val);
-  }else{
-    hddaq::cerr << FUNC_NAME << " unknown data type " << std::endl
-                << " Detector = " << name  << std::endl
-		<< " PlaneId  = " << plane << std::endl
-		<< " WireId   = " << wire  << std::endl
-		<< " DataType = " << data  << std::endl
-		<< " Value    = " << val   << std::endl;
-  }
+  m_is_decoded[name] = true;
   return true;
 }
 
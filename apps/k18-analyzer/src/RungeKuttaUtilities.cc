@@ -273,14 +273,14 @@ RK::TraceOneStep(Double_t StepSize, const RKTrajectoryPoint &prevPoint)
   Double_t dr    = StepSize/std::sqrt(1.+pre_u*pre_u+pre_v*pre_v);
 
   ThreeVector Z1 = prevPoint.PositionInGlobal();
-  ThreeVector B1 = gField.GetField(Z1);
 #ifdef ExactFFTreat
-  ThreeVector dBdX1 = gField.GetdBdX(Z1);
-  ThreeVector dBdY1 = gField.GetdBdY(Z1);
+  ThreeVector dBdX1, dBdY1;
+  ThreeVector B1 = gField.GetField(Z1, dBdX1, dBdY1);
   RKFieldIntegral f1 =
     RK::CalcFieldIntegral(pre_u, pre_v, pre_q,
                           B1, dBdX1, dBdY1);
 #else
+  ThreeVector B1 = gField.GetField(Z1);
   RKFieldIntegral f1 =
     RK::CalcFieldIntegral(pre_u, pre_v, pre_q, B1);
 #endif
@@ -291,15 +291,15 @@ RK::TraceOneStep(Double_t StepSize, const RKTrajectoryPoint &prevPoint)
     ThreeVector(0.5*dr,
                 0.5*dr*pre_u + 0.125*dr*dr*f1.kx,
                 0.5*dr*pre_v + 0.125*dr*dr*f1.ky);
-  ThreeVector B2 = gField.GetField(Z2);
 #ifdef ExactFFTreat
-  ThreeVector dBdX2 = gField.GetdBdX(Z2);
-  ThreeVector dBdY2 = gField.GetdBdY(Z2);
+  ThreeVector dBdX2, dBdY2;
+  ThreeVector B2 = gField.GetField(Z2, dBdX2, dBdY2);
   RKFieldIntegral f2 =
     RK::CalcFieldIntegral(pre_u + 0.5*dr*f1.kx,
                           pre_v + 0.5*dr*f1.ky,
                           pre_q, B2, dBdX2, dBdY2);
 #else
+  ThreeVector B2 = gField.GetField(Z2);
   RKFieldIntegral f2 =
     RK::CalcFieldIntegral(pre_u + 0.5*dr*f1.kx,
                           pre_v + 0.5*dr*f1.ky,
@@ -326,15 +326,15 @@ RK::TraceOneStep(Double_t StepSize, const RKTrajectoryPoint &prevPoint)
     ThreeVector(dr,
                 dr*pre_u + 0.5*dr*dr*f3.kx,
                 dr*pre_v + 0.5*dr*dr*f3.ky);
-  ThreeVector B4 = gField.GetField(Z4);
 #ifdef ExactFFTreat
-  ThreeVector dBdX4 = gField.GetdBdX(Z4);
-  ThreeVector dBdY4 = gField.GetdBdY(Z4);
+  ThreeVector dBdX4, dBdY4;
+  ThreeVector B4 = gField.GetField(Z4, dBdX4, dBdY4);
   RKFieldIntegral f4 =
     RK::CalcFieldIntegral(pre_u + dr*f3.kx,
                           pre_v + dr*f3.ky,
                           pre_q, B4, dBdX4, dBdY4);
 #else
+  ThreeVector B4 = gField.GetField(Z4);
   RKFieldIntegral f4 =
     RK::CalcFieldIntegral(pre_u + dr*f3.kx,
                           pre_v + dr*f3.ky,
@@ -466,11 +466,9 @@ RK::PropagateOnce(Double_t StepSize, const RKTrajectoryPoint &prevPoint)
 
   ThreeVector Z1 = prevPoint.PositionInGlobal();
 
-  ThreeVector B1 = gField.GetField(Z1);
+  ThreeVector dBdX1, dBdY1;
+  ThreeVector B1 = gField.GetField(Z1, dBdX1, dBdY1);
   //  std::cout << B1.Y() << std::endl;
-
-  ThreeVector dBdX1 = gField.GetdBdX(Z1);
-  ThreeVector dBdY1 = gField.GetdBdY(Z1);
   RKFieldIntegral f1 =
     RK::CalcFieldIntegral(pre_u, pre_v, pre_q,
                           B1, dBdX1, dBdY1);
@@ -481,9 +479,8 @@ RK::PropagateOnce(Double_t StepSize, const RKTrajectoryPoint &prevPoint)
     ThreeVector(0.5*dr,
                 0.5*dr*pre_u + 0.125*dr*dr*f1.kx,
                 0.5*dr*pre_v + 0.125*dr*dr*f1.ky);
-  ThreeVector B2 = gField.GetField(Z2);
-  ThreeVector dBdX2 = gField.GetdBdX(Z2);
-  ThreeVector dBdY2 = gField.GetdBdY(Z2);
+  ThreeVector dBdX2, dBdY2;
+  ThreeVector B2 = gField.GetField(Z2, dBdX2, dBdY2);
   RKFieldIntegral f2 =
     RK::CalcFieldIntegral(pre_u + 0.5*dr*f1.kx,
                           pre_v + 0.5*dr*f1.ky,
@@ -502,10 +499,8 @@ RK::PropagateOnce(Double_t StepSize, const RKTrajectoryPoint &prevPoint)
     ThreeVector(dr,
                 dr*pre_u + 0.5*dr*dr*f3.kx,
                 dr*pre_v + 0.5*dr*dr*f3.ky);
-  ThreeVector B4 = gField.GetField(Z4);
-
-  ThreeVector dBdX4 = gField.GetdBdX(Z4);
-  ThreeVector dBdY4 = gField.GetdBdY(Z4);
+  ThreeVector dBdX4, dBdY4;
+  ThreeVector B4 = gField.GetField(Z4, dBdX4, dBdY4);
   RKFieldIntegral f4 =
     RK::CalcFieldIntegral(pre_u + dr*f3.kx,
                           pre_v + dr*f3.ky,
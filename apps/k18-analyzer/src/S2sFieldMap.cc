@@ -3,12 +3,19 @@
 #include "S2sFieldMap.hh"
 
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <std_ostream.hh>
 
 //#include "ConfMan.hh"
@@ -28,11 +35,48 @@
 //const auto& valueCalc = ConfMan::Get<Double_t>("FLDCALC");
 //}
 
+namespace
+{
+//_____________________________________________________________________________
+// header of the binary cache, followed by Bx, By, Bz at kCacheDataOffset
+struct CacheHeader
+{
+  char     magic[8];
+  Long64_t source_size;
+  Long64_t source_mtime;
+  Int_t    n[3];
+  Int_t    padding;
+  Double_t origin[3];
+  Double_t pitch[3];
+  Double_t factor;
+};
+const char   kCacheMagic[8]   = { 'S', '2', 'S', 'F', 'M', 'A', 'P', '1' };
+const size_t kCacheDataOffset = 128;
+static_assert(sizeof(CacheHeader) <= kCacheDataOffset,
+              "CacheHeader exceeds the data offset");
+
+//_____________________________________________________________________________
+// cell of t along one axis and weights of the two nodes,
+// dw is 0 outside of the map where the field is constant
+inline void
+Locate(Double_t t, Double_t t0, Double_t d, Int_t n,
+       Int_t& i1, Int_t& i2, Double_t& w1, Double_t& w2, Double_t& dw)
+{
+  i1 = Int_t((t-t0)/d);
+  if(i1<0) { i1=i2=0; w1=1.; w2=0.; dw=0.; }
+  else if(i1>=n-1) { i1=i2=n-1; w1=1.; w2=0.; dw=0.; }
+  else { i2=i1+1; w1=(t0+d*i2-t)/d; w2=1.-w1; dw=1.; }
+}
+}
+
 //_____________________________________________________________________________
 S2sFieldMap::S2sFieldMap(const TString& file_name)
   : m_is_ready(false),
     m_file_name(file_name),
+    m_field(),
     B(),
+    m_map_addr(nullptr),
+    m_map_size(0),
     Nx(0),
     Ny(0),
     Nz(0),
@@ -49,7 +93,10 @@ S2sFieldMap::S2sFieldMap(const TString& file_name)
 S2sFieldMap::S2sFieldMap(const TString& file_name, const Double_t measure, const Double_t calc)
   : m_is_ready(false),
     m_file_name(file_name),
+    m_field(),
     B(),
+    m_map_addr(nullptr),
+    m_map_size(0),
     Nx(0),
     Ny(0),
     Nz(0),
@@ -100,24 +147,29 @@ S2sFieldMap::Initialize()
     return false;
   }
 
-  B.resize(Nx);
-  for(Int_t ix=0; ix<Nx; ++ix){
-    B[ix].resize(Ny);
-    for(Int_t iy=0; iy<Ny; ++iy){
-      B[ix][iy].resize(Nz);
-    }
-  }
-
   if(valueCalc==0. || !std::isfinite(valueCalc) ||
      valueMeasure==0.  || !std::isfinite(valueMeasure) ){
     hddaq::cout << FUNC_NAME << " S2sField is zero : "
                 << " Calc = " << valueCalc
                 << " Measure = " << valueMeasure << std::endl
                 << " -> skip reading fieldmap" << std::endl;
+    m_field.assign(3*size_t(Nx)*Ny*Nz, 0.);
+    for(Int_t i=0; i<3; ++i)
+      B[i] = m_field.data() + i*size_t(Nx)*Ny*Nz;
     return true;
   }
   const Double_t factor = valueMeasure/valueCalc;
 
+  if(ReadCache(factor)){
+    m_is_ready = true;
+    return true;
+  }
+
+  const size_t n_node = size_t(Nx)*Ny*Nz;
+  m_field.assign(3*n_node, 0.);
+  Double_t* field[3];
+  for(Int_t i=0; i<3; ++i)
+    B[i] = field[i] = m_field.data() + i*n_node;
   Double_t x, y, z, bx, by, bz;
 
   hddaq::cout << " reading fieldmap " << std::flush;
@@ -138,9 +190,10 @@ S2sFieldMap::Initialize()
     Int_t iy = Int_t((y-Y0+0.1*dY)/dY);
     Int_t iz = Int_t((z-Z0+0.1*dZ)/dZ);
     if(ix>=0 && ix<Nx && iy>=0 && iy<Ny && iz>=0 && iz<Nz){
-      B[ix][iy][iz].x = bx*factor;
-      B[ix][iy][iz].y = by*factor;
-      B[ix][iy][iz].z = bz*factor;
+      const size_t i = (size_t(ix)*Ny + iy)*Nz + iz;
+      field[0][i] = bx*factor;
+      field[1][i] = by*factor;
+      field[2][i] = bz*factor;
 #if DebugDisp
       if(TMath::Abs(y) < 1.) h1->Fill(z, x, by);
 #endif
@@ -157,6 +210,7 @@ S2sFieldMap::Initialize()
 #endif
 
   hddaq::cout << " done" << std::endl;
+  WriteCache(factor);
   m_is_ready = true;
   return true;
 }
@@ -164,52 +218,49 @@ S2sFieldMap::Initialize()
 //_____________________________________________________________________________
 Bool_t
 S2sFieldMap::GetFieldValue(const Double_t pointCM[3],
-                              Double_t* BfieldTesla) const
+                           Double_t* BfieldTesla,
+                           Double_t* dBdxTeslaPerCM) const
 {
-  Double_t xt = pointCM[0];
-  Double_t yt = pointCM[1];
-  Double_t zt = pointCM[2];
-
   Int_t ix1, ix2, iy1, iy2, iz1, iz2;
-  ix1 = Int_t((xt-X0)/dX);
-  iy1 = Int_t((yt-Y0)/dY);
-  iz1 = Int_t((zt-Z0)/dZ);
-
-  Double_t wx1, wx2, wy1, wy2, wz1, wz2;
-  if(ix1<0) { ix1=ix2=0; wx1=1.; wx2=0.; }
-  else if(ix1>=Nx-1) { ix1=ix2=Nx-1; wx1=1.; wx2=0.; }
-  else { ix2=ix1+1; wx1=(X0+dX*ix2-xt)/dX; wx2=1.-wx1; }
-
-  if(iy1<0) { iy1=iy2=0; wy1=1.; wy2=0.; }
-  else if(iy1>=Ny-1) { iy1=iy2=Ny-1; wy1=1.; wy2=0.; }
-  else { iy2=iy1+1; wy1=(Y0+dY*iy2-yt)/dY; wy2=1.-wy1; }
-
-  if(iz1<0) { iz1=iz2=0; wz1=1.; wz2=0.; }
-  else if(iz1>=Nz-1) { iz1=iz2=Nz-1; wz1=1.; wz2=0.; }
-  else { iz2=iz1+1; wz1=(Z0+dZ*iz2-zt)/dZ; wz2=1.-wz1; }
-
-  Double_t bx1 = wx1*wy1*B[ix1][iy1][iz1].x + wx1*wy2*B[ix1][iy2][iz1].x
-    + wx2*wy1*B[ix2][iy1][iz1].x + wx2*wy2*B[ix2][iy2][iz1].x;
-  Double_t bx2 = wx1*wy1*B[ix1][iy1][iz2].x + wx1*wy2*B[ix1][iy2][iz2].x
-    + wx2*wy1*B[ix2][iy1][iz2].x + wx2*wy2*B[ix2][iy2][iz2].x;
-  Double_t bx  = wz1*bx1 + wz2*bx2;
-
-  Double_t by1 = wx1*wy1*B[ix1][iy1][iz1].y + wx1*wy2*B[ix1][iy2][iz1].y
-    + wx2*wy1*B[ix2][iy1][iz1].y + wx2*wy2*B[ix2][iy2][iz1].y;
-  Double_t by2 = wx1*wy1*B[ix1][iy1][iz2].y + wx1*wy2*B[ix1][iy2][iz2].y
-    + wx2*wy1*B[ix2][iy1][iz2].y + wx2*wy2*B[ix2][iy2][iz2].y;
-  Double_t by  = wz1*by1 + wz2*by2;
-
-  Double_t bz1 = wx1*wy1*B[ix1][iy1][iz1].z + wx1*wy2*B[ix1][iy2][iz1].z
-    + wx2*wy1*B[ix2][iy1][iz1].z + wx2*wy2*B[ix2][iy2][iz1].z;
-  Double_t bz2 = wx1*wy1*B[ix1][iy1][iz2].z + wx1*wy2*B[ix1][iy2][iz2].z
-    + wx2*wy1*B[ix2][iy1][iz2].z + wx2*wy2*B[ix2][iy2][iz2].z;
-  Double_t bz  = wz1*bz1 + wz2*bz2;
-
-  //Default
-  BfieldTesla[0] = bx;
-  BfieldTesla[1] = by;
-  BfieldTesla[2] = bz;
+  Double_t wx[2], wy[2], wz[2], dwx, dwy, dwz;
+  Locate(pointCM[0], X0, dX, Nx, ix1, ix2, wx[0], wx[1], dwx);
+  Locate(pointCM[1], Y0, dY, Ny, iy1, iy2, wy[0], wy[1], dwy);
+  Locate(pointCM[2], Z0, dZ, Nz, iz1, iz2, wz[0], wz[1], dwz);
+
+  // the 4 (x, y) columns of the cell, each holding the pair (iz1, iz2)
+  // next to each other; the derivatives reuse the interpolation along z
+  const size_t   nyz    = size_t(Ny)*Nz;
+  const size_t   col[4] = { ix1*nyz + iy1*Nz + iz1, ix1*nyz + iy2*Nz + iz1,
+                            ix2*nyz + iy1*Nz + iz1, ix2*nyz + iy2*Nz + iz1 };
+  const size_t   diz    = iz2 - iz1;
+  const Double_t wxy[4] = { wx[0]*wy[0], wx[0]*wy[1],
+                            wx[1]*wy[0], wx[1]*wy[1] };
+  Double_t fz[3][4];
+  for(Int_t i=0; i<3; ++i){
+    const Double_t* b = B[i];
+    for(Int_t q=0; q<4; ++q)
+      fz[i][q] = wz[0]*b[col[q]] + wz[1]*b[col[q]+diz];
+    BfieldTesla[i] = (wxy[0]*fz[i][0] + wxy[1]*fz[i][1] +
+                      wxy[2]*fz[i][2] + wxy[3]*fz[i][3]);
+  }
+
+  if(dBdxTeslaPerCM){
+    dwx /= dX;
+    dwy /= dY;
+    dwz /= dZ;
+    for(Int_t i=0; i<3; ++i){
+      const Double_t* b = B[i];
+      Double_t gz[4];
+      for(Int_t q=0; q<4; ++q)
+        gz[q] = b[col[q]+diz] - b[col[q]];
+      dBdxTeslaPerCM[i]   = dwx*(wy[0]*(fz[i][2] - fz[i][0]) +
+                                 wy[1]*(fz[i][3] - fz[i][1]));
+      dBdxTeslaPerCM[3+i] = dwy*(wx[0]*(fz[i][1] - fz[i][0]) +
+                                 wx[1]*(fz[i][3] - fz[i][2]));
+      dBdxTeslaPerCM[6+i] = dwz*(wxy[0]*gz[0] + wxy[1]*gz[1] +
+                                 wxy[2]*gz[2] + wxy[3]*gz[3]);
+    }
+  }
 
   return true;
 }
@@ -218,11 +269,102 @@ S2sFieldMap::GetFieldValue(const Double_t pointCM[3],
 void
 S2sFieldMap::ClearField()
 {
-  for(Int_t ix=0; ix<Nx; ++ix){
-    for(Int_t iy=0; iy<Ny; ++iy){
-      B[ix][iy].clear();
-    }
-    B[ix].clear();
+  m_field.clear();
+  m_field.shrink_to_fit();
+  for(Int_t i=0; i<3; ++i)
+    B[i] = nullptr;
+  if(m_map_addr){
+    ::munmap(m_map_addr, m_map_size);
+    m_map_addr = nullptr;
+    m_map_size = 0;
+  }
+}
+
+//_____________________________________________________________________________
+TString
+S2sFieldMap::CacheFileName() const
+{
+  return m_file_name + ".bin";
+}
+
+//_____________________________________________________________________________
+Bool_t
+S2sFieldMap::ReadCache(Double_t factor)
+{
+  struct stat source;
+  if(::stat(m_file_name, &source) != 0)
+    return false;
+
+  const TString cache_name = CacheFileName();
+  Int_t fd = ::open(cache_name, O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  const size_t n_node = size_t(Nx)*Ny*Nz;
+  const size_t size = kCacheDataOffset + 3*n_node*sizeof(Double_t);
+  struct stat cache;
+  CacheHeader header;
+  if(::fstat(fd, &cache) != 0 || size_t(cache.st_size) != size ||
+     ::pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+     std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+     header.source_size != source.st_size ||
+     header.source_mtime != source.st_mtime ||
+     header.n[0] != Nx || header.n[1] != Ny || header.n[2] != Nz ||
+     header.origin[0] != X0 || header.origin[1] != Y0 ||
+     header.origin[2] != Z0 || header.pitch[0] != dX ||
+     header.pitch[1] != dY || header.pitch[2] != dZ ||
+     header.factor != factor){
+    ::close(fd);
+    return false;
   }
-  B.clear();
+
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(addr == MAP_FAILED)
+    return false;
+
+  m_field.clear();
+  m_field.shrink_to_fit();
+  m_map_addr = addr;
+  m_map_size = size;
+  const Double_t* data = reinterpret_cast<const Double_t*>(
+    static_cast<const char*>(addr) + kCacheDataOffset);
+  for(Int_t i=0; i<3; ++i)
+    B[i] = data + i*n_node;
+  hddaq::cout << " mapped fieldmap cache " << cache_name << std::endl;
+  return true;
+}
+
+//_____________________________________________________________________________
+void
+S2sFieldMap::WriteCache(Double_t factor) const
+{
+  struct stat source;
+  if(::stat(m_file_name, &source) != 0)
+    return;
+
+  CacheHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+  header.source_size  = source.st_size;
+  header.source_mtime = source.st_mtime;
+  header.n[0] = Nx; header.n[1] = Ny; header.n[2] = Nz;
+  header.origin[0] = X0; header.origin[1] = Y0; header.origin[2] = Z0;
+  header.pitch[0] = dX; header.pitch[1] = dY; header.pitch[2] = dZ;
+  header.factor = factor;
+
+  // written aside and renamed, a concurrent job never maps a partial file
+  const TString cache_name = CacheFileName();
+  const TString tmp_name = cache_name + Form(".%d", ::getpid());
+  std::ofstream ofs(tmp_name, std::ios::binary);
+  if(!ofs.is_open())
+    return;
+  char block[kCacheDataOffset] = {};
+  std::memcpy(block, &header, sizeof(header));
+  ofs.write(block, sizeof(block));
+  ofs.write(reinterpret_cast<const char*>(m_field.data()),
+            m_field.size()*sizeof(Double_t));
+  ofs.close();
+  if(!ofs || std::rename(tmp_name, cache_name) != 0)
+    std::remove(tmp_name);
 }
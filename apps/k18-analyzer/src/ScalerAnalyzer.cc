@@ -94,12 +94,10 @@ ScalerAnalyzer::Decode()
   //////////////////// Trigger Flag
   std::bitset<NumOfSegTrig> trigger_flag;
   {
-    static const auto k_device = gUnpacker.get_device_id("TFlag");
-    static const auto k_tdc    = gUnpacker.get_data_id("TFlag", "tdc");
+    static const auto k_tdc = gUnpacker.get_handle("TFlag", 0, "tdc");
     for(Int_t seg=0; seg<NumOfSegTrig; ++seg){
-      for(Int_t i=0, n=gUnpacker.get_entries(k_device, 0, seg, 0, k_tdc);
-	   i<n; ++i){
-	auto tdc = gUnpacker.get(k_device, 0, seg, 0, k_tdc, i);
+      for(Int_t i=0, n=gUnpacker.get_entries(k_tdc, seg, 0); i<n; ++i){
+	auto tdc = gUnpacker.get(k_tdc, seg, 0, i);
 	if(tdc>0) trigger_flag.set(seg);
 	if(trigger_flag[seg]) break;
       }
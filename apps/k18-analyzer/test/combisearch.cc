@@ -0,0 +1,349 @@
+/*
+ *  combisearch: lazy against materialized cluster combinations
+ *
+ *  usage: combisearch DCGeomParam [nevent] [max_noise] [first_layer] [n_layer]
+ *         combisearch --recorded conf_file data_file [BcOut|SdcIn]
+ *
+ *  Runs the candidate loop of track::LocalTrackSearch() twice on the
+ *  clusters of each event:
+ *    materialized  track::MakeIndex(), MakeTrack(), DoFit() on every entry
+ *    lazy          DCCombinationSearch, MakeTrack(), DoFit()
+ *  An overflow gives no track, as in the callers. MakeIndex() gives up
+ *  when the product of (n_cluster+1) is above MaxCombi, DCCombinationSearch
+ *  only when more than MaxCombi combinations pass its cuts, so an event
+ *  can overflow on the materialized path alone ("recovered"). Otherwise
+ *  the accepted combinations (NHit, chisqr cuts) must be the same.
+ *  Prints the track yield and the CPU time per event of both.
+ *
+ *  The first form generates straight tracks through n_layer planes
+ *  (default the 10 SDC1/2 layers 1-10), one cluster per hit, with 0 to
+ *  max_noise noise hits per plane.
+ *  The second form reads a recorded run with the analyzer config
+ *  (DCGEO, DCDRFT, DCTDC, USER and the unpacker), decodes the BcOut or
+ *  SdcIn (default) chambers as the tracking users do and takes the
+ *  clusters and MinLayer of DCAnalyzer::TrackSearchBcOut()/SdcIn(); the
+ *  BH2 filter is not applied. max_loop of the unpacker config limits the
+ *  number of events.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <TMath.h>
+#include <TString.h>
+
+#include <UnpackerManager.hh>
+
+#include "ConfMan.hh"
+#include "DCAnalyzer.hh"
+#include "DCCombinationSearch.hh"
+#include "DCDriftParamMan.hh"
+#include "DCGeomMan.hh"
+#include "DCHit.hh"
+#include "DCLocalTrack.hh"
+#include "DCLTrackHit.hh"
+#include "DCPairHitCluster.hh"
+#include "DCParameters.hh"
+#include "DCTdcCalibMan.hh"
+#include "DCTrackSearch.hh"
+#include "DeleteUtility.hh"
+#include "DetectorID.hh"
+#include "RawData.hh"
+#include "UserParamMan.hh"
+
+namespace
+{
+  // the cuts of track::LocalTrackSearch()
+  const Int_t    MinNumOfHits    = 6;
+  const Double_t MaxChisquare    = 2000.;
+  const Double_t MaxCombi        = 1.0e6;
+  const Int_t    MaxNumOfCluster = 20;
+
+  struct Result
+  {
+    std::vector<IndexList> accepted;
+    Bool_t                 status;
+  };
+
+  // the candidate loop, on combinations from either source
+  template <typename Source>
+  void search(const std::vector<ClusterList>& cand, Source& source,
+              Int_t min_n_hit, Result& result)
+  {
+    IndexList combination;
+    while(source.Next(combination)){
+      DCLocalTrack* track = track::MakeTrack(cand, combination);
+      if(track->GetNHit()>=min_n_hit
+         && track->DoFit()
+         && track->GetChiSquare()<MaxChisquare)
+        result.accepted.push_back(combination);
+      delete track;
+    }
+    result.status = source.GetStatus();
+    if(!result.status)
+      result.accepted.clear();
+  }
+
+  // track::MakeIndex() behind the interface of DCCombinationSearch
+  class Materialized
+  {
+  public:
+    Materialized(const IndexList& n_combi)
+      : m_status(true), m_i(0)
+    {
+      m_index = track::MakeIndex(n_combi.size(), n_combi, m_status);
+    }
+    Bool_t Next(IndexList& combination)
+    {
+      if(m_i>=m_index.size())
+        return false;
+      combination = m_index[m_i++];
+      return true;
+    }
+    Bool_t GetStatus() const { return m_status; }
+  private:
+    std::vector<IndexList> m_index;
+    bool                   m_status;
+    std::size_t            m_i;
+  };
+
+  // both paths on the events, and their sums
+  struct Compare
+  {
+    Double_t t_mat = 0., t_lazy = 0.;
+    Long64_t n_track_mat = 0, n_track_lazy = 0;
+    Int_t    n_event = 0, n_event_mat = 0, n_event_lazy = 0;
+    Int_t    n_overflow_mat = 0, n_overflow_lazy = 0;
+    Int_t    n_recovered = 0, n_differ = 0;
+
+    void Run(const std::vector<ClusterList>& cand, const IndexList& n_combi,
+             Int_t min_n_hit, Int_t ev)
+    {
+      Result mat, lazy;
+      std::clock_t c0 = std::clock();
+      {
+        Materialized source(n_combi);
+        search(cand, source, min_n_hit, mat);
+      }
+      std::clock_t c1 = std::clock();
+      {
+        DCCombinationSearch source(cand, n_combi, min_n_hit,
+                                   MaxChisquare, MaxCombi);
+        search(cand, source, min_n_hit, lazy);
+      }
+      std::clock_t c2 = std::clock();
+      t_mat  += Double_t(c1-c0)/CLOCKS_PER_SEC;
+      t_lazy += Double_t(c2-c1)/CLOCKS_PER_SEC;
+
+      ++n_event;
+      if(!mat.status)  ++n_overflow_mat;
+      if(!lazy.status) ++n_overflow_lazy;
+      if(!mat.status && lazy.status){
+        ++n_recovered;
+      }else if(mat.status!=lazy.status || mat.accepted!=lazy.accepted){
+        std::cerr << "#E event " << ev << ": materialized "
+                  << mat.accepted.size() << (mat.status ? "" : " (overflow)")
+                  << ", lazy " << lazy.accepted.size()
+                  << (lazy.status ? "" : " (overflow)") << std::endl;
+        ++n_differ;
+      }
+      n_track_mat  += mat.accepted.size();
+      n_track_lazy += lazy.accepted.size();
+      if(!mat.accepted.empty())  ++n_event_mat;
+      if(!lazy.accepted.empty()) ++n_event_lazy;
+    }
+
+    int Print() const
+    {
+      const Int_t n = n_event>0 ? n_event : 1;
+      std::cout << std::fixed << std::setprecision(3)
+                << "events        " << n_event
+                << ", recovered " << n_recovered
+                << ", differ " << n_differ << "\n"
+                << "materialized  events with tracks " << n_event_mat
+                << ", tracks " << n_track_mat
+                << ", overflow " << n_overflow_mat << ", "
+                << 1.e3*t_mat/n << " ms/event\n"
+                << "lazy          events with tracks " << n_event_lazy
+                << ", tracks " << n_track_lazy
+                << ", overflow " << n_overflow_lazy << ", "
+                << 1.e3*t_lazy/n << " ms/event\n";
+      if(t_lazy>0.)
+        std::cout << "speedup       " << t_mat/t_lazy << "\n";
+      std::cout << std::flush;
+      return n_differ==0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  };
+
+  //___________________________________________________________________________
+  int
+  generated(int argc, char* argv[])
+  {
+    const Int_t n_event     = argc>2 ? std::atoi(argv[2]) : 1000;
+    const Int_t max_noise   = argc>3 ? std::atoi(argv[3]) : 2;
+    const Int_t first_layer = argc>4 ? std::atoi(argv[4]) : 1;
+    const Int_t n_layer     = argc>5 ? std::atoi(argv[5]) : 10;
+
+    DCGeomMan& geom = DCGeomMan::GetInstance();
+    if(!geom.Initialize(argv[1]))
+      return EXIT_FAILURE;
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<Double_t> flat(-1., 1.);
+    std::normal_distribution<Double_t>       gaus(0., 1.);
+    std::uniform_int_distribution<Int_t>     noise(0, max_noise);
+
+    Compare compare;
+    for(Int_t ev=0; ev<n_event; ++ev){
+      const Double_t x0 = 50.*flat(rng), u0 = 0.1*flat(rng);
+      const Double_t y0 = 50.*flat(rng), v0 = 0.1*flat(rng);
+
+      std::vector<DCHit*>      hits;
+      std::vector<ClusterList> cand(n_layer);
+      IndexList                n_combi(n_layer);
+      for(Int_t i=0; i<n_layer; ++i){
+        const Int_t    layer = first_layer + i;
+        const Double_t z     = geom.GetLocalZ(layer);
+        const Double_t aa    = geom.GetTiltAngle(layer)*TMath::DegToRad();
+        const Double_t s     = (x0+u0*z)*TMath::Cos(aa) + (y0+v0*z)*TMath::Sin(aa);
+        const Int_t    n_hit = 1 + noise(rng);
+        for(Int_t j=0; j<n_hit; ++j){
+          DCHit* hit = new DCHit(layer);
+          hit->SetTiltAngle(geom.GetTiltAngle(layer));
+          hit->SetZ(z);
+          hit->SetDCData();
+          hits.push_back(hit);
+          const Double_t pos = j==0 ? s + geom.GetResolution(layer)*gaus(rng)
+            : s + 100.*flat(rng);
+          cand[i].push_back(new DCPairHitCluster(new DCLTrackHit(hit, pos, 0)));
+        }
+        n_combi[i] = cand[i].size();
+      }
+
+      compare.Run(cand, n_combi, MinNumOfHits, ev);
+
+      for(auto& clusters : cand)
+        for(auto cluster : clusters)
+          delete cluster;
+      for(auto hit : hits)
+        delete hit; // and its DCLTrackHits
+    }
+    return compare.Print();
+  }
+
+  //___________________________________________________________________________
+  int
+  recorded(int argc, char* argv[])
+  {
+    using hddaq::unpacker::GUnpacker;
+    auto& gConf     = ConfMan::GetInstance();
+    auto& gUnpacker = GUnpacker::get_instance();
+    const auto& gUser = UserParamMan::GetInstance();
+
+    const TString chamber = argc>4 ? argv[4] : "SdcIn";
+    const Bool_t is_bcout = chamber=="BcOut";
+    if(!is_bcout && chamber!="SdcIn"){
+      std::cerr << "unknown chamber : " << chamber << std::endl;
+      return EXIT_FAILURE;
+    }
+    const DCPairPlaneInfo* pp  = is_bcout ? PPInfoBcOut : PPInfoSdcIn;
+    const Int_t            npp = is_bcout ? NPPInfoBcOut : NPPInfoSdcIn;
+    Int_t n_layer = 0;
+    for(Int_t i=0; i<npp; ++i)
+      n_layer = std::max(n_layer, std::max(pp[i].id1, pp[i].id2)+1);
+
+    if(!gConf.Initialize(argv[2]) || !gConf.InitializeUnpacker())
+      return EXIT_FAILURE;
+    const Int_t min_n_hit = gUser.GetParameter("MinLayer"+chamber);
+
+    gUnpacker.set_istream(argv[3]);
+    gUnpacker.initialize();
+
+    Compare compare;
+    for(Int_t ev=0; !gUnpacker.eof(); ++gUnpacker, ++ev){
+      RawData rawData;
+      for(const auto& name: DCNameList.at(chamber))
+        rawData.DecodeHits(name);
+      DCAnalyzer DCAna(rawData);
+      if(is_bcout)
+        DCAna.DecodeBcOutHits();
+      else
+        DCAna.DecodeSdcInHits();
+
+      std::vector<DCHC> hc(n_layer);
+      for(Int_t l=0; l<n_layer; ++l)
+        hc[l] = is_bcout ? DCAna.GetBcOutHC(l) : DCAna.GetSdcInHC(l);
+
+      std::vector<ClusterList> cand(npp);
+      track::MakeCandidates(hc, pp, npp, cand);
+      IndexList n_combi(npp);
+      for(Int_t i=0; i<npp; ++i){
+        Int_t n = cand[i].size();
+        n_combi[i] = n>MaxNumOfCluster ? 0 : n;
+      }
+
+      compare.Run(cand, n_combi, min_n_hit, ev);
+
+      del::ClearContainerAll(cand);
+    }
+    gConf.Finalize();
+    return compare.Print();
+  }
+}
+
+//_____________________________________________________________________________
+int
+main(int argc, char* argv[])
+{
+  if(argc>1 && TString(argv[1])=="--recorded"){
+    if(argc<4){
+      std::cerr << "usage: " << argv[0]
+                << " --recorded conf_file data_file [BcOut|SdcIn]"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    return recorded(argc, argv);
+  }
+  if(argc<2){
+    std::cerr << "usage: " << argv[0]
+              << " DCGeomParam [nevent] [max_noise] [first_layer] [n_layer]"
+              << std::endl
+              << "       " << argv[0]
+              << " --recorded conf_file data_file [BcOut|SdcIn]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  return generated(argc, argv);
+}
+
+//_____________________________________________________________________________
+// the parameters of the recorded mode, as in the tracking users
+Bool_t
+ConfMan::InitializeParameterFiles()
+{
+  return
+    (InitializeParameter<DCGeomMan>("DCGEO")        &&
+     InitializeParameter<DCDriftParamMan>("DCDRFT") &&
+     InitializeParameter<DCTdcCalibMan>("DCTDC")    &&
+     InitializeParameter<UserParamMan>("USER"));
+}
+
+//_____________________________________________________________________________
+Bool_t
+ConfMan::InitializeHistograms()
+{
+  return true;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ConfMan::FinalizeProcess()
+{
+  return true;
+}
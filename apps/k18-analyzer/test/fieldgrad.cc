@@ -0,0 +1,198 @@
+/*
+ *  fieldgrad: S2sTrack fits with the analytic and the old field gradient
+ *
+ *  usage: fieldgrad conf_file data_file [tolerance]
+ *
+ *  Reads a recorded run with the analyzer config (DCGEO, DCDRFT, DCTDC,
+ *  FLDMAP, USER and the unpacker), finds the SdcIn and SdcOut local
+ *  tracks as DCAnalyzer::TrackSearchS2s() and fits every pair of good
+ *  tracks twice from the same initial momentum (1.4 GeV/c):
+ *    analytic  FieldMan::GetField(position, dBdX, dBdY), the gradient of
+ *              the trilinear interpolation from one lookup of the map
+ *    central   SetCentralDifference(true), the +-0.1 mm differences of
+ *              GetdBdX()/GetdBdY() that RK used before
+ *  Compares the status, the fitted momentum, the chisqr and the number
+ *  of iterations of each pair of fits; a momentum or a chisqr that
+ *  differs by more than tolerance (relative, default 1e-4) is an error.
+ *  Prints the differences and the CPU time per fit of both gradients.
+ *  max_loop of the unpacker config limits the number of events.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <TString.h>
+
+#include <UnpackerManager.hh>
+
+#include "ConfMan.hh"
+#include "DCAnalyzer.hh"
+#include "DCDriftParamMan.hh"
+#include "DCGeomMan.hh"
+#include "DCLocalTrack.hh"
+#include "DCTdcCalibMan.hh"
+#include "DetectorID.hh"
+#include "FieldMan.hh"
+#include "RawData.hh"
+#include "S2sTrack.hh"
+#include "UserParamMan.hh"
+
+namespace
+{
+  // as in DCAnalyzer::TrackSearchS2s()
+  const Double_t InitialMomentum = 1.4;
+
+  int n_error = 0;
+
+  void check(bool ok, const std::string& what, Int_t ev)
+  {
+    if(!ok){
+      if(n_error<20)
+        std::cerr << "#E event " << ev << ": " << what << std::endl;
+      ++n_error;
+    }
+  }
+
+  Double_t relative(Double_t a, Double_t b)
+  {
+    return std::abs(a-b)/std::max(1.e-12, std::abs(b));
+  }
+
+  struct Fit
+  {
+    Bool_t   status;
+    Double_t p;
+    Double_t chisqr;
+    Int_t    n_iteration;
+  };
+
+  // one fit of a pair of local tracks, CPU seconds added to t
+  Fit fit(const DCLocalTrack* in, const DCLocalTrack* out,
+          Bool_t central, Double_t& t)
+  {
+    FieldMan::GetInstance().SetCentralDifference(central);
+    S2sTrack track(in, out);
+    track.SetInitialMomentum(InitialMomentum);
+    std::clock_t c0 = std::clock();
+    Fit result;
+    result.status      = track.DoFit();
+    t += Double_t(std::clock()-c0)/CLOCKS_PER_SEC;
+    result.p           = track.PrimaryMomMag();
+    result.chisqr      = track.GetChiSquare();
+    result.n_iteration = track.Niteration();
+    return result;
+  }
+}
+
+//_____________________________________________________________________________
+int
+main(int argc, char* argv[])
+{
+  if(argc<3){
+    std::cerr << "usage: " << argv[0] << " conf_file data_file [tolerance]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const Double_t tolerance = argc>3 ? std::atof(argv[3]) : 1.e-4;
+
+  using hddaq::unpacker::GUnpacker;
+  auto& gConf     = ConfMan::GetInstance();
+  auto& gUnpacker = GUnpacker::get_instance();
+
+  if(!gConf.Initialize(argv[1]) || !gConf.InitializeUnpacker())
+    return EXIT_FAILURE;
+  gUnpacker.set_istream(argv[2]);
+  gUnpacker.initialize();
+
+  Double_t t_analytic = 0., t_central = 0.;
+  Long64_t n_fit = 0, n_analytic = 0, n_central = 0, n_both = 0;
+  Long64_t n_iteration_differ = 0;
+  Double_t sum_dp = 0., max_dp = 0., max_dchisqr = 0.;
+  for(Int_t ev=0; !gUnpacker.eof(); ++gUnpacker, ++ev){
+    RawData rawData;
+    for(const auto& name: DCNameList.at("SdcIn"))  rawData.DecodeHits(name);
+    for(const auto& name: DCNameList.at("SdcOut")) rawData.DecodeHits(name);
+    DCAnalyzer DCAna(rawData);
+    DCAna.DecodeSdcInHits();
+    DCAna.DecodeSdcOutHits();
+    DCAna.TrackSearchSdcIn();
+    DCAna.TrackSearchSdcOut();
+
+    for(Int_t i=0, n_in=DCAna.GetNtracksSdcIn(); i<n_in; ++i){
+      const DCLocalTrack* in = DCAna.GetTrackSdcIn(i);
+      if(!in->GoodForTracking()) continue;
+      for(Int_t j=0, n_out=DCAna.GetNtracksSdcOut(); j<n_out; ++j){
+        const DCLocalTrack* out = DCAna.GetTrackSdcOut(j);
+        if(!out->GoodForTracking()) continue;
+        const Fit a = fit(in, out, false, t_analytic);
+        const Fit c = fit(in, out, true, t_central);
+        ++n_fit;
+        if(a.status) ++n_analytic;
+        if(c.status) ++n_central;
+        check(a.status==c.status, "status differs", ev);
+        if(!a.status || !c.status) continue;
+        ++n_both;
+        const Double_t dp      = relative(a.p, c.p);
+        const Double_t dchisqr = relative(a.chisqr, c.chisqr);
+        sum_dp += dp;
+        max_dp      = std::max(max_dp, dp);
+        max_dchisqr = std::max(max_dchisqr, dchisqr);
+        if(a.n_iteration!=c.n_iteration) ++n_iteration_differ;
+        check(dp<=tolerance, Form("momentum %g against %g GeV/c", a.p, c.p), ev);
+        check(dchisqr<=tolerance, Form("chisqr %g against %g", a.chisqr, c.chisqr),
+              ev);
+      }
+    }
+  }
+  gConf.Finalize();
+
+  const Long64_t n = n_fit>0 ? n_fit : 1;
+  std::cout << std::scientific << std::setprecision(2)
+            << "fits      " << n_fit << ", converged analytic " << n_analytic
+            << ", central " << n_central << "\n"
+            << "momentum  mean " << (n_both ? sum_dp/n_both : 0.)
+            << ", max " << max_dp << " (relative)\n"
+            << "chisqr    max " << max_dchisqr << " (relative)\n"
+            << "iteration differs in " << n_iteration_differ << " fits\n"
+            << std::fixed << std::setprecision(3)
+            << "analytic  " << 1.e3*t_analytic/n << " ms/fit\n"
+            << "central   " << 1.e3*t_central/n << " ms/fit\n";
+  if(t_analytic>0.)
+    std::cout << "speedup   " << t_central/t_analytic << "\n";
+  std::cout << (n_error ? "FAILED " : "OK ") << n_error << " error(s)"
+            << std::endl;
+  return n_error==0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//_____________________________________________________________________________
+// the parameters of a S-2S tracking user
+Bool_t
+ConfMan::InitializeParameterFiles()
+{
+  return
+    (InitializeParameter<DCGeomMan>("DCGEO")        &&
+     InitializeParameter<DCDriftParamMan>("DCDRFT") &&
+     InitializeParameter<DCTdcCalibMan>("DCTDC")    &&
+     InitializeParameter<FieldMan>("FLDMAP")        &&
+     InitializeParameter<UserParamMan>("USER"));
+}
+
+//_____________________________________________________________________________
+Bool_t
+ConfMan::InitializeHistograms()
+{
+  return true;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ConfMan::FinalizeProcess()
+{
+  return true;
+}
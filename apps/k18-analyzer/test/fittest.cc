@@ -0,0 +1,250 @@
+/*
+ *  fittest: DCLocalTrackFitter against DCLocalTrack::DoFit()
+ *
+ *  usage: fittest DCGeomParam [ncandidate] [first_layer] [n_layer]
+ *
+ *  Generates track candidates of 6 to n_layer hits on the layers
+ *  first_layer.. (default the 10 SDC1/2 layers 1-10), a third of them with
+ *  honeycomb hits, and fits each one with DoFit() and in batches of
+ *  1, 2, 3, 4, 5, 7, 63 and 64 candidates with DCLocalTrackFitter, so that
+ *  the last lane group of a batch is partly empty and the candidates of a
+ *  lane group have different numbers of hits.
+ *   - batch against DoFit(): same status and number of iterations,
+ *     parameters and chisqr within a relative 1e-7
+ *   - AVX2 against the scalar kernel (SetUseAvx2(false)): the same bits
+ *  Then prints the fit time per candidate of DoFit() and of both kernels.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TMath.h>
+
+#include "DCGeomMan.hh"
+#include "DCHit.hh"
+#include "DCLocalTrack.hh"
+#include "DCLocalTrackFitter.hh"
+#include "DCLTrackHit.hh"
+
+namespace
+{
+  const Double_t Tolerance = 1.0e-7;
+
+  int n_error = 0;
+
+  void check(bool ok, const std::string& what, Int_t i)
+  {
+    if(!ok){
+      if(n_error<20)
+        std::cerr << "#E candidate " << i << ": " << what << std::endl;
+      ++n_error;
+    }
+  }
+
+  bool close(Double_t a, Double_t b)
+  {
+    return std::abs(a-b) <= Tolerance*std::max(1., std::abs(a));
+  }
+
+  bool same(Double_t a, Double_t b)
+  {
+    return a==b || (std::isnan(a) && std::isnan(b));
+  }
+
+  struct Candidate
+  {
+    std::vector<DCLTrackHit*> hits;
+  };
+
+  DCLocalTrack* make_track(const Candidate& cand)
+  {
+    DCLocalTrack* track = new DCLocalTrack;
+    for(auto hit : cand.hits)
+      track->AddHit(hit);
+    return track;
+  }
+
+  // fits the candidates in batches of block_size, keeps the tracks
+  void fit_batch(const std::vector<Candidate>& cand, Int_t block_size,
+                 std::vector<DCLocalTrack*>& tracks,
+                 std::vector<Bool_t>& status)
+  {
+    DCLocalTrackFitter fitter(block_size);
+    for(std::size_t i=0; i<cand.size(); ++i){
+      fitter.Add(make_track(cand[i]));
+      if(fitter.IsFull() || i+1==cand.size()){
+        fitter.Fit();
+        for(Int_t j=0, n=fitter.GetNTrack(); j<n; ++j){
+          tracks.push_back(fitter.GetTrack(j));
+          status.push_back(fitter.GetStatus(j));
+        }
+        fitter.Clear();
+      }
+    }
+  }
+
+  void clear(std::vector<DCLocalTrack*>& tracks)
+  {
+    for(auto track : tracks)
+      delete track;
+    tracks.clear();
+  }
+
+  double now()
+  {
+    return Double_t(std::clock())/CLOCKS_PER_SEC;
+  }
+}
+
+//_____________________________________________________________________________
+int
+main(int argc, char* argv[])
+{
+  if(argc<2){
+    std::cerr << "usage: " << argv[0]
+              << " DCGeomParam [ncandidate] [first_layer] [n_layer]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const Int_t n_cand      = argc>2 ? std::atoi(argv[2]) : 10000;
+  const Int_t first_layer = argc>3 ? std::atoi(argv[3]) : 1;
+  const Int_t n_layer     = argc>4 ? std::atoi(argv[4]) : 10;
+
+  DCGeomMan& geom = DCGeomMan::GetInstance();
+  if(!geom.Initialize(argv[1]))
+    return EXIT_FAILURE;
+
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<Double_t> flat(-1., 1.);
+  std::normal_distribution<Double_t>       gaus(0., 1.);
+
+  std::vector<DCHit*>    hits;
+  std::vector<Candidate> cand(n_cand);
+  for(Int_t c=0; c<n_cand; ++c){
+    const Double_t x0 = 50.*flat(rng), u0 = 0.1*flat(rng);
+    const Double_t y0 = 50.*flat(rng), v0 = 0.1*flat(rng);
+    const Bool_t   honeycomb = c%3==0;
+    // 6 to n_layer hits, the missing planes chosen at random
+    const Int_t n_hit = 6 + c%(n_layer-5);
+    std::vector<Int_t> layers;
+    for(Int_t i=0; i<n_layer; ++i)
+      layers.push_back(first_layer + i);
+    std::shuffle(layers.begin(), layers.end(), rng);
+    layers.resize(n_hit);
+    std::sort(layers.begin(), layers.end());
+    for(auto layer : layers){
+      const Double_t z  = geom.GetLocalZ(layer);
+      const Double_t aa = geom.GetTiltAngle(layer)*TMath::DegToRad();
+      const Double_t s  = (x0+u0*z)*TMath::Cos(aa) + (y0+v0*z)*TMath::Sin(aa)
+        + geom.GetResolution(layer)*gaus(rng);
+      DCHit* hit = new DCHit(layer);
+      hit->SetTiltAngle(geom.GetTiltAngle(layer));
+      hit->SetZ(z);
+      // the wire next to the hit, 5 mm cells
+      const Double_t wpos = 5.*std::floor(s/5.) + 2.5;
+      hit->SetWirePosition(wpos);
+      hit->SetDCData(0., std::abs(s-wpos));
+      hits.push_back(hit);
+      DCLTrackHit* lhit = new DCLTrackHit(hit, s, 0);
+      if(honeycomb)
+        lhit->SetHoneycomb();
+      cand[c].hits.push_back(lhit);
+    }
+  }
+
+  // DoFit() one by one
+  std::vector<DCLocalTrack*> ref;
+  std::vector<Bool_t>        ref_status;
+  double t0 = now();
+  for(const auto& c : cand){
+    ref.push_back(make_track(c));
+    ref_status.push_back(ref.back()->DoFit());
+  }
+  const double t_dofit = now() - t0;
+
+  const bool has_avx2 = DCLocalTrackFitter::SetUseAvx2(true);
+  if(!has_avx2)
+    std::cout << "no AVX2 on this CPU, scalar kernel only" << std::endl;
+
+  const Int_t block_sizes[] = { 1, 2, 3, 4, 5, 7, 63, 64 };
+  for(auto block_size : block_sizes){
+    for(int k=0; k<2; ++k){
+      const bool avx2 = k==0;
+      if(avx2 && !has_avx2)
+        continue;
+      DCLocalTrackFitter::SetUseAvx2(avx2);
+      std::vector<DCLocalTrack*> batch;
+      std::vector<Bool_t>        status;
+      fit_batch(cand, block_size, batch, status);
+      for(Int_t i=0; i<n_cand; ++i){
+        const DCLocalTrack* a = ref[i];
+        const DCLocalTrack* b = batch[i];
+        check(status[i]==ref_status[i], "status", i);
+        if(!status[i] || !ref_status[i])
+          continue;
+        check(a->GetNIteration()==b->GetNIteration(), "iterations", i);
+        check(close(a->GetX0(), b->GetX0()) && close(a->GetU0(), b->GetU0())
+              && close(a->GetY0(), b->GetY0()) && close(a->GetV0(), b->GetV0()),
+              "parameters", i);
+        check(close(a->GetChiSquare(), b->GetChiSquare()), "chisqr", i);
+      }
+
+      // the scalar kernel gives the bits of the AVX2 one
+      if(!avx2 && has_avx2){
+        DCLocalTrackFitter::SetUseAvx2(true);
+        std::vector<DCLocalTrack*> batch_avx2;
+        std::vector<Bool_t>        status_avx2;
+        fit_batch(cand, block_size, batch_avx2, status_avx2);
+        for(Int_t i=0; i<n_cand; ++i){
+          const DCLocalTrack* a = batch_avx2[i];
+          const DCLocalTrack* b = batch[i];
+          check(status[i]==status_avx2[i]
+                && same(a->GetX0(), b->GetX0()) && same(a->GetU0(), b->GetU0())
+                && same(a->GetY0(), b->GetY0()) && same(a->GetV0(), b->GetV0())
+                && same(a->GetChiSquare(), b->GetChiSquare()),
+                "AVX2 and scalar bits", i);
+        }
+        clear(batch_avx2);
+      }
+      clear(batch);
+    }
+  }
+
+  // timing of full batches
+  double t_kernel[2] = { 0., 0. };
+  for(int k=0; k<2; ++k){
+    if(k==0 && !has_avx2)
+      continue;
+    DCLocalTrackFitter::SetUseAvx2(k==0);
+    std::vector<DCLocalTrack*> batch;
+    std::vector<Bool_t>        status;
+    t0 = now();
+    fit_batch(cand, 64, batch, status);
+    t_kernel[k] = now() - t0;
+    clear(batch);
+  }
+  DCLocalTrackFitter::SetUseAvx2(has_avx2);
+
+  clear(ref);
+  for(auto hit : hits)
+    delete hit; // and its DCLTrackHits
+
+  const double n = n_cand>0 ? n_cand : 1;
+  std::cout << std::fixed << std::setprecision(1)
+            << "candidates " << n_cand << "\n"
+            << "DoFit      " << 1.e9*t_dofit/n << " ns/candidate\n";
+  if(has_avx2)
+    std::cout << "AVX2       " << 1.e9*t_kernel[0]/n << " ns/candidate\n";
+  std::cout << "scalar     " << 1.e9*t_kernel[1]/n << " ns/candidate\n";
+  std::cout << (n_error ? "FAILED " : "OK ") << n_error << " error(s)"
+            << std::endl;
+  return n_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
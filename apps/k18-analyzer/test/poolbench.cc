@@ -0,0 +1,207 @@
+/*
+ *  poolbench: per-event objects with and without mem::ObjectPool
+ *
+ *  usage: poolbench conf_file data_file [BcOut|SdcIn|SdcOut|hodoscope]...
+ *
+ *  Reads a recorded run with the analyzer config (DCGEO, DCDRFT, DCTDC,
+ *  HDPRM, HDPHC, USER and the unpacker) and builds the objects of each
+ *  event twice with their real constructors and destructors, once with
+ *  the pools and once without (mem::UsePool(false), the global operator
+ *  new/delete), the first of the two alternating from event to event:
+ *    RawData::DecodeHits()      HodoRawHit, DCRawHit of every detector
+ *    BcOut, SdcIn, SdcOut       DCAnalyzer decode and local track search:
+ *                               DCHit, DCLTrackHit, DCLocalTrack
+ *    other names                HodoAnalyzer::DecodeHits(): HodoHit,
+ *                               HodoCluster
+ *  and deletes them at the end of the event, as the users do. Prints the
+ *  mean number of objects and the CPU time per event of both.
+ *
+ *  The ObjectCounter bookkeeping is compiled in the library with
+ *  "make debug=1" (-DMemoryLeak); build the library and this test both
+ *  ways to compare it as well.
+ */
+
+#include <cstdlib>
+#include <ctime>
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <TString.h>
+
+#include <UnpackerConfig.hh>
+#include <UnpackerManager.hh>
+#include <UnpackerXMLReadDigit.hh>
+
+#include "ConfMan.hh"
+#include "DCAnalyzer.hh"
+#include "DCDriftParamMan.hh"
+#include "DCGeomMan.hh"
+#include "DCHit.hh"
+#include "DCLocalTrack.hh"
+#include "DCRawHit.hh"
+#include "DCTdcCalibMan.hh"
+#include "HodoAnalyzer.hh"
+#include "HodoParamMan.hh"
+#include "HodoPHCMan.hh"
+#include "HodoRawHit.hh"
+#include "ObjectPool.hh"
+#include "RawData.hh"
+#include "UserParamMan.hh"
+
+namespace
+{
+  struct Count
+  {
+    Long64_t n_hodo_raw = 0, n_dc_raw = 0;
+    Long64_t n_hodo_hit = 0, n_hodo_cluster = 0, n_track = 0;
+  };
+
+  // the objects of one event, CPU seconds added to t
+  void event(const std::vector<TString>& dc, const std::vector<TString>& hodo,
+             Double_t& t, Count* count)
+  {
+    static const auto& digit_info =
+      hddaq::unpacker::GConfig::get_instance().get_digit_info();
+    std::clock_t c0 = std::clock();
+    {
+      RawData rawData;
+      rawData.DecodeHits();
+      DCAnalyzer DCAna(rawData);
+      for(const auto& name: dc){
+        if(name=="BcOut"){
+          DCAna.DecodeBcOutHits();
+          DCAna.TrackSearchBcOut();
+        }else if(name=="SdcIn"){
+          DCAna.DecodeSdcInHits();
+          DCAna.TrackSearchSdcIn();
+        }else{
+          DCAna.DecodeSdcOutHits();
+          DCAna.TrackSearchSdcOut();
+        }
+      }
+      HodoAnalyzer hodoAna(rawData);
+      for(const auto& name: hodo)
+        hodoAna.DecodeHits(name);
+
+      if(count){
+        for(const auto& n: digit_info.get_name_list()){
+          if(n.empty()) continue;
+          count->n_hodo_raw += rawData.GetHodoRawHitContainer(n).size();
+          count->n_dc_raw   += rawData.GetDCRawHitContainer(n).size();
+        }
+        for(const auto& name: dc){
+          count->n_track += name=="BcOut" ? DCAna.GetNtracksBcOut()
+            : name=="SdcIn" ? DCAna.GetNtracksSdcIn()
+            : DCAna.GetNtracksSdcOut();
+        }
+        for(const auto& name: hodo){
+          count->n_hodo_hit     += hodoAna.GetNHits(name);
+          count->n_hodo_cluster += hodoAna.GetNClusters(name);
+        }
+      }
+    }
+    t += Double_t(std::clock()-c0)/CLOCKS_PER_SEC;
+  }
+}
+
+//_____________________________________________________________________________
+int
+main(int argc, char* argv[])
+{
+  if(argc<3){
+    std::cerr << "usage: " << argv[0]
+              << " conf_file data_file [BcOut|SdcIn|SdcOut|hodoscope]..."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<TString> dc, hodo;
+  for(Int_t i=3; i<argc; ++i){
+    const TString name = argv[i];
+    if(name=="BcOut" || name=="SdcIn" || name=="SdcOut")
+      dc.push_back(name);
+    else
+      hodo.push_back(name);
+  }
+
+  using hddaq::unpacker::GUnpacker;
+  auto& gConf     = ConfMan::GetInstance();
+  auto& gUnpacker = GUnpacker::get_instance();
+
+  if(!gConf.Initialize(argv[1]) || !gConf.InitializeUnpacker())
+    return EXIT_FAILURE;
+  gUnpacker.set_istream(argv[2]);
+  gUnpacker.initialize();
+
+  Double_t t_global = 0., t_pool = 0.;
+  Count    count;
+  Long64_t n_event = 0;
+  for(; !gUnpacker.eof(); ++gUnpacker, ++n_event){
+    // no pooled object is alive between the two
+    const Bool_t pool_first = n_event%2==0;
+    mem::UsePool() = pool_first;
+    event(dc, hodo, pool_first ? t_pool : t_global, &count);
+    mem::UsePool() = !pool_first;
+    event(dc, hodo, pool_first ? t_global : t_pool, nullptr);
+  }
+  mem::UsePool() = true;
+  gConf.Finalize();
+
+  const Double_t n = n_event>0 ? n_event : 1;
+  std::cout << std::fixed << std::setprecision(1)
+            << "events   " << n_event
+#ifdef MemoryLeak
+            << ", ObjectCounter on (debug=1)"
+#else
+            << ", ObjectCounter off"
+#endif
+            << "\n"
+            << "objects  HodoRawHit " << count.n_hodo_raw/n
+            << ", DCRawHit " << count.n_dc_raw/n
+            << ", HodoHit " << count.n_hodo_hit/n
+            << ", HodoCluster " << count.n_hodo_cluster/n
+            << ", DCLocalTrack " << count.n_track/n << " per event\n"
+            << std::setprecision(3)
+            << "global   " << 1.e6*t_global/n << " us/event\n"
+            << "pool     " << 1.e6*t_pool/n << " us/event\n";
+  if(t_pool>0.)
+    std::cout << "speedup  " << t_global/t_pool << "\n";
+  std::cout << "chunks   HodoRawHit "
+            << mem::ObjectPool<HodoRawHit>::GetInstance().GetNChunk()
+            << ", DCRawHit "
+            << mem::ObjectPool<DCRawHit>::GetInstance().GetNChunk()
+            << ", DCHit " << mem::ObjectPool<DCHit>::GetInstance().GetNChunk()
+            << ", DCLocalTrack "
+            << mem::ObjectPool<DCLocalTrack>::GetInstance().GetNChunk()
+            << std::endl;
+  return EXIT_SUCCESS;
+}
+
+//_____________________________________________________________________________
+// the parameters of a tracking user
+Bool_t
+ConfMan::InitializeParameterFiles()
+{
+  return
+    (InitializeParameter<DCGeomMan>("DCGEO")        &&
+     InitializeParameter<DCDriftParamMan>("DCDRFT") &&
+     InitializeParameter<DCTdcCalibMan>("DCTDC")    &&
+     InitializeParameter<HodoParamMan>("HDPRM")     &&
+     InitializeParameter<HodoPHCMan>("HDPHC")       &&
+     InitializeParameter<UserParamMan>("USER"));
+}
+
+//_____________________________________________________________________________
+Bool_t
+ConfMan::InitializeHistograms()
+{
+  return true;
+}
+
+//_____________________________________________________________________________
+Bool_t
+ConfMan::FinalizeProcess()
+{
+  return true;
+}
@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 
+#include "DenseParamTable.hh"
+
 struct DCDriftParamRecord;
 
 //______________________________________________________________________________
@@ -39,15 +41,23 @@ private:
 private:
   typedef std::map<unsigned int, DCDriftParamRecord*> DCDriftContainer;
   typedef DCDriftContainer::const_iterator DCDriftIterator;
+  // [plane][wire] of the keys, built by Freeze()
+  typedef DenseParamTable<DCDriftParamRecord,1> DCDriftTable;
   bool             m_is_ready;
+  bool             m_is_frozen;
   std::string      m_file_name;
   DCDriftContainer m_container;
+  DCDriftTable     m_table; //!
 
 public:
   bool CalcDrift( int PlaneId, double WireId, double ctime, double & dt, double & dl ) const;
   bool Initialize( void );
   bool Initialize( const std::string& file_name );
   bool IsReady( void ) const { return m_is_ready; }
+  // the lookups use the table once frozen (end of Initialize()),
+  // Freeze( false ) puts them back on the map
+  void Freeze( bool flag=true );
+  bool IsFrozen( void ) const { return m_is_frozen; }
   void SetFileName( const std::string& file_name ) { m_file_name = file_name; }
 
 private:
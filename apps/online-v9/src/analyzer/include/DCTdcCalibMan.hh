@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 
+#include "DenseParamTable.hh"
+
 struct DCTdcCalMap;
 
 //______________________________________________________________________________
@@ -29,14 +31,22 @@ private:
 private:
   typedef std::map <unsigned int, DCTdcCalMap*> DCTdcContainer;
   typedef DCTdcContainer::const_iterator DCTdcIterator;
+  // [plane][wire] of the keys, built by Freeze()
+  typedef DenseParamTable<DCTdcCalMap,1> DCTdcTable;
   bool           m_is_ready;
+  bool           m_is_frozen;
   std::string    m_file_name;
   DCTdcContainer m_container;
+  DCTdcTable     m_table; //!
 
 public:
   bool Initialize( void );
   bool Initialize( const std::string& file_name );
   bool IsReady( void ) const { return m_is_ready; }
+  // the lookups use the table once frozen (end of Initialize()),
+  // Freeze( false ) puts them back on the map
+  void Freeze( bool flag=true );
+  bool IsFrozen( void ) const { return m_is_frozen; }
   bool GetTime( int plane_id, double wire_id, int tdc, double& time ) const;
   bool GetTdc( int plane_id, double wire_id, double time, int& tdc ) const;
   void SetFileName( const std::string& file_name ) { m_file_name = file_name; }
@@ -0,0 +1,112 @@
+/**
+ *  file: DenseParamTable.hh
+ *  date: 2026.10.17
+ *
+ */
+
+#ifndef DENSE_PARAM_TABLE_HH
+#define DENSE_PARAM_TABLE_HH
+
+#include <algorithm>
+#include <vector>
+
+//______________________________________________________________________________
+// Flat lookup table of the parameter records of a manager, built from its
+// std::map once the parameter file is loaded (Freeze() of the managers).
+//
+// A record is addressed by a detector (or plane) id and N indices inside
+// it. Each id has its own extent of the indices and an offset in a single
+// array of record pointers, nullptr is a missing entry. The records stay
+// owned by the map.
+template <typename T, int N>
+class DenseParamTable
+{
+public:
+  DenseParamTable( void ) : m_detector(), m_record() {}
+  ~DenseParamTable( void ) {}
+
+private:
+  struct Detector
+  {
+    int offset;
+    int size[N]; // 0 when the id has no record
+  };
+  std::vector<Detector> m_detector; // [id]
+  std::vector<T*>       m_record;
+
+public:
+  void Clear( void );
+  // decode( key, id, index ) gives the address of a key of the map,
+  // false if the key cannot be put in the table
+  template <typename Map, typename Decode>
+  void Build( const Map& cont, Decode decode );
+  T*   Get( int id, const int (&index)[N] ) const;
+};
+
+//______________________________________________________________________________
+template <typename T, int N>
+inline void
+DenseParamTable<T,N>::Clear( void )
+{
+  m_detector.clear();
+  m_record.clear();
+}
+
+//______________________________________________________________________________
+template <typename T, int N>
+template <typename Map, typename Decode>
+inline void
+DenseParamTable<T,N>::Build( const Map& cont, Decode decode )
+{
+  Clear();
+  int id;
+  int index[N];
+  for( const auto& p : cont ){
+    if( !p.second || !decode( p.first, id, index ) )
+      continue;
+    if( id >= (int)m_detector.size() )
+      m_detector.resize( id+1, Detector() );
+    Detector& d = m_detector[id];
+    for( int k=0; k<N; ++k )
+      d.size[k] = std::max( d.size[k], index[k]+1 );
+  }
+
+  int n_record = 0;
+  for( auto& d : m_detector ){
+    d.offset = n_record;
+    int size = 1;
+    for( int k=0; k<N; ++k )
+      size *= d.size[k];
+    n_record += size;
+  }
+
+  m_record.assign( n_record, nullptr );
+  for( const auto& p : cont ){
+    if( !p.second || !decode( p.first, id, index ) )
+      continue;
+    const Detector& d = m_detector[id];
+    int i = 0;
+    for( int k=0; k<N; ++k )
+      i = i*d.size[k] + index[k];
+    m_record[d.offset+i] = p.second;
+  }
+}
+
+//______________________________________________________________________________
+template <typename T, int N>
+inline T*
+DenseParamTable<T,N>::Get( int id, const int (&index)[N] ) const
+{
+  if( id < 0 || id >= (int)m_detector.size() )
+    return nullptr;
+  const Detector& d = m_detector[id];
+  int i = 0;
+  for( int k=0; k<N; ++k ){
+    if( index[k] < 0 || index[k] >= d.size[k] )
+      return nullptr;
+    i = i*d.size[k] + index[k];
+  }
+  return m_record[d.offset+i];
+}
+
+#endif
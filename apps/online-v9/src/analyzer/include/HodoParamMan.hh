@@ -10,6 +10,8 @@
 #include <string>
 #include <map>
 
+#include "DenseParamTable.hh"
+
 //______________________________________________________________________________
 //Hodo TDC to Time
 class HodoTParam
@@ -114,17 +116,28 @@ private:
   typedef TContainer::const_iterator TIterator;
   typedef AContainer::const_iterator AIterator;
   typedef FContainer::const_iterator FIterator;
+  // [cid][plid][seg][ud], built by Freeze()
+  typedef DenseParamTable<HodoTParam,3> TTable;
+  typedef DenseParamTable<HodoAParam,3> ATable;
   bool        m_is_ready;
+  bool        m_is_frozen;
   std::string m_file_name;
   TContainer  m_TPContainer;
   AContainer  m_AHPContainer;
   AContainer  m_ALPContainer;
   FContainer  m_FPContainer;
+  TTable      m_TPTable;  //!
+  ATable      m_AHPTable; //!
+  ATable      m_ALPTable; //!
 
 public:
   bool Initialize( void );
   bool Initialize( const std::string& file_name );
   bool IsReady( void ) const { return m_is_ready; }
+  // the lookups use the tables once frozen (end of Initialize()),
+  // Freeze( false ) puts them back on the maps
+  void Freeze( bool flag=true );
+  bool IsFrozen( void ) const { return m_is_frozen; }
   bool GetTime( int cid, int plid, int seg, int ud, int tdc, double &time ) const;
   bool GetDeHighGain( int cid, int plid, int seg, int ud, int adc, double &de ) const;
   bool GetDeLowGain( int cid, int plid, int seg, int ud, int adc, double &de ) const;
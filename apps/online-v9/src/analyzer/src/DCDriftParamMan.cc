@@ -29,7 +29,10 @@ namespace
 //______________________________________________________________________________
 DCDriftParamMan::DCDriftParamMan( void )
   : m_is_ready(false),
-    m_file_name("")
+    m_is_frozen(false),
+    m_file_name(""),
+    m_container(),
+    m_table()
 {
 }
 
@@ -43,6 +46,7 @@ DCDriftParamMan::~DCDriftParamMan( void )
 void
 DCDriftParamMan::ClearElements( void )
 {
+  m_table.Clear();
   del::ClearMap( m_container );
 }
 
@@ -54,11 +58,15 @@ MakeKey( int plane, double wire )
 }
 
 //______________________________________________________________________________
-inline void
-DecodeKey( unsigned int key, int& plane, int& wire )
+inline bool
+DecodeKey( unsigned int key, int& plane, int (&wire)[1] )
 {
-  wire  = key & 0x3ff;
-  plane = key >> 10;
+  // keys out of the table (plane > 1023 or negative) stay in the map
+  if( key >= (1u << 20) )
+    return false;
+  wire[0] = key & 0x3ff;
+  plane   = key >> 10;
+  return true;
 }
 
 //______________________________________________________________________________
@@ -109,6 +117,7 @@ DCDriftParamMan::Initialize( void )
     m_container[key] = record;
   }
 
+  Freeze();
   m_is_ready = true;
   return m_is_ready;
 }
@@ -121,12 +130,26 @@ DCDriftParamMan::Initialize( const std::string& file_name )
   return Initialize();
 }
 
+//______________________________________________________________________________
+void
+DCDriftParamMan::Freeze( bool flag )
+{
+  if( flag )
+    m_table.Build( m_container, DecodeKey );
+  else
+    m_table.Clear();
+  m_is_frozen = flag;
+}
+
 //______________________________________________________________________________
 DCDriftParamRecord*
 DCDriftParamMan::GetParameter( int PlaneId, double WireId ) const
 {
   WireId = 0;
   unsigned int key = MakeKey( PlaneId, WireId );
+  int id, index[1];
+  if( m_is_frozen && DecodeKey( key, id, index ) )
+    return m_table.Get( id, index );
   DCDriftParamRecord *record = 0;
   DCDriftIterator itr = m_container.find(key);
   if( itr!=m_container.end() ) record = itr->second;
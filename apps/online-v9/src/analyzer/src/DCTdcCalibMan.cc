@@ -34,7 +34,10 @@ struct DCTdcCalMap
 //______________________________________________________________________________
 DCTdcCalibMan::DCTdcCalibMan( void )
   : m_is_ready(false),
-    m_file_name("")
+    m_is_frozen(false),
+    m_file_name(""),
+    m_container(),
+    m_table()
 {
 }
 
@@ -48,6 +51,7 @@ DCTdcCalibMan::~DCTdcCalibMan( void )
 void
 DCTdcCalibMan::ClearElements( void )
 {
+  m_table.Clear();
   del::ClearMap( m_container );
 }
 
@@ -58,6 +62,18 @@ MakeKey( int plane_id, double wire_id )
   return (plane_id<<10) | int(wire_id);
 }
 
+//______________________________________________________________________________
+inline bool
+DecodeKey( unsigned int key, int& plane_id, int (&wire_id)[1] )
+{
+  // keys out of the table (plane > 1023 or negative) stay in the map
+  if( key >= (1u << 20) )
+    return false;
+  wire_id[0] = key & 0x3ff;
+  plane_id   = key >> 10;
+  return true;
+}
+
 //______________________________________________________________________________
 bool
 DCTdcCalibMan::Initialize( void )
@@ -97,6 +113,7 @@ DCTdcCalibMan::Initialize( void )
     }
   }
 
+  Freeze();
   m_is_ready = true;
   return m_is_ready;
 }
@@ -109,11 +126,25 @@ DCTdcCalibMan::Initialize( const std::string& file_name )
   return Initialize();
 }
 
+//______________________________________________________________________________
+void
+DCTdcCalibMan::Freeze( bool flag )
+{
+  if( flag )
+    m_table.Build( m_container, DecodeKey );
+  else
+    m_table.Clear();
+  m_is_frozen = flag;
+}
+
 //______________________________________________________________________________
 DCTdcCalMap*
 DCTdcCalibMan::GetMap( int plane_id, double wire_id ) const
 {
   unsigned int key = MakeKey( plane_id, wire_id );
+  int id, index[1];
+  if( m_is_frozen && DecodeKey( key, id, index ) )
+    return m_table.Get( id, index );
   DCTdcCalMap *map = 0;
   DCTdcIterator itr = m_container.find(key);
   if( itr!=m_container.end() ) map = itr->second;
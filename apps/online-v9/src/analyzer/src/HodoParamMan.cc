@@ -33,6 +33,7 @@ namespace
 //______________________________________________________________________________
 HodoParamMan::HodoParamMan( void )
   : m_is_ready(false),
+    m_is_frozen(false),
     m_file_name("")
 {}
 
@@ -46,6 +47,7 @@ HodoParamMan::~HodoParamMan( void )
 void
 HodoParamMan::ClearAHCont( void )
 {
+  m_AHPTable.Clear();
   del::ClearMap( m_AHPContainer );
 }
 
@@ -53,6 +55,7 @@ HodoParamMan::ClearAHCont( void )
 void
 HodoParamMan::ClearALCont( void )
 {
+  m_ALPTable.Clear();
   del::ClearMap( m_ALPContainer );
 }
 
@@ -60,6 +63,7 @@ HodoParamMan::ClearALCont( void )
 void
 HodoParamMan::ClearTCont( void )
 {
+  m_TPTable.Clear();
   del::ClearMap( m_TPContainer );
 }
 
@@ -73,6 +77,17 @@ KEY( int cid, int pl, int seg, int ud )
 	   ( (ud&UdMask)   << UdShift   ) );
 }
 
+//______________________________________________________________________________
+inline bool
+DecodeKey( int key, int& cid, int (&index)[3] )
+{
+  cid      = ( key >> CidShift  ) & CidMask;
+  index[0] = ( key >> PlidShift ) & PlidMask;
+  index[1] = ( key >> SegShift  ) & SegMask;
+  index[2] = ( key >> UdShift   ) & UdMask;
+  return true;
+}
+
 //______________________________________________________________________________
 bool
 HodoParamMan::Initialize( void )
@@ -160,6 +175,7 @@ HodoParamMan::Initialize( void )
     } /* if( input_line >> ) */
   } /* while( std::getline ) */
 
+  Freeze();
   m_is_ready = true;
   return true;
 }
@@ -172,6 +188,23 @@ HodoParamMan::Initialize( const std::string& file_name )
   return Initialize();
 }
 
+//______________________________________________________________________________
+void
+HodoParamMan::Freeze( bool flag )
+{
+  if( flag ){
+    m_TPTable.Build( m_TPContainer, DecodeKey );
+    m_AHPTable.Build( m_AHPContainer, DecodeKey );
+    m_ALPTable.Build( m_ALPContainer, DecodeKey );
+  }
+  else {
+    m_TPTable.Clear();
+    m_AHPTable.Clear();
+    m_ALPTable.Clear();
+  }
+  m_is_frozen = flag;
+}
+
 //______________________________________________________________________________
 bool
 HodoParamMan::GetTime( int cid, int plid, int seg,
@@ -300,6 +333,8 @@ HodoParamMan::GetGain(int cid, int plid, int seg, int ud) const
 HodoTParam*
 HodoParamMan::GetTmap( int cid, int plid, int seg, int ud ) const
 {
+  if( m_is_frozen )
+    return m_TPTable.Get( cid&CidMask, { plid&PlidMask, seg&SegMask, ud&UdMask } );
   int key = KEY(cid, plid, seg, ud);
   TIterator itr = m_TPContainer.find(key);
   if( itr != m_TPContainer.end())
@@ -312,6 +347,8 @@ HodoParamMan::GetTmap( int cid, int plid, int seg, int ud ) const
 HodoAParam*
 HodoParamMan::GetAHmap( int cid, int plid, int seg, int ud ) const
 {
+  if( m_is_frozen )
+    return m_AHPTable.Get( cid&CidMask, { plid&PlidMask, seg&SegMask, ud&UdMask } );
   int key = KEY(cid, plid, seg, ud);
   AIterator itr = m_AHPContainer.find(key);
   if( itr != m_AHPContainer.end())
@@ -324,6 +361,8 @@ HodoParamMan::GetAHmap( int cid, int plid, int seg, int ud ) const
 HodoAParam*
 HodoParamMan::GetALmap( int cid, int plid, int seg, int ud ) const
 {
+  if( m_is_frozen )
+    return m_ALPTable.Get( cid&CidMask, { plid&PlidMask, seg&SegMask, ud&UdMask } );
   int key = KEY(cid, plid, seg, ud);
   AIterator itr = m_ALPContainer.find(key);
   if( itr != m_ALPContainer.end())
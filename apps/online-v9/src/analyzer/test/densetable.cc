@@ -0,0 +1,389 @@
+/**
+ *  file: densetable.cc
+ *
+ *  densetable: dense parameter tables against the maps
+ *
+ *  usage: densetable HodoParam DCTdcCalib DCDriftParam [nloop]
+ *
+ *  Loads the parameter files with HodoParamMan, DCTdcCalibMan and
+ *  DCDriftParamMan, the DC ones from copies with two more planes (1100 and
+ *  -3) whose keys do not fit in the tables and stay in the maps. Asks every
+ *  key of the files, its neighbours (mostly missing keys) and keys beyond
+ *  the masks of HodoParamMan once through the tables, as after Initialize(),
+ *  and once through the maps, after Freeze( false ):
+ *    HodoParamMan     GetTime(), GetDeHighGain(), GetDeLowGain(), GetOffset()
+ *    DCTdcCalibMan    GetParameter(), GetTime()
+ *    DCDriftParamMan  CalcDrift()
+ *  The answers must be the same. Then prints the time per lookup of the
+ *  keys of the files in both modes, nloop times over (default 100).
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <std_ostream.hh>
+
+#include "DCDriftParamMan.hh"
+#include "DCTdcCalibMan.hh"
+#include "HodoParamMan.hh"
+
+namespace
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  int n_error = 0;
+
+  //______________________________________________________________________________
+  void
+  check( bool ok, const std::string& what, int i )
+  {
+    if( !ok ){
+      if( n_error<20 )
+	std::cerr << "#E " << what << " query " << i << std::endl;
+      ++n_error;
+    }
+  }
+
+  struct HodoKey
+  {
+    int cid, plid, seg, ud;
+  };
+
+  struct DCKey
+  {
+    int    plane;
+    double wire;
+  };
+
+  struct Answer
+  {
+    bool   ok;
+    double x, y;
+  };
+
+  //______________________________________________________________________________
+  bool
+  same( double a, double b )
+  {
+    return a==b || ( std::isnan(a) && std::isnan(b) );
+  }
+
+  //______________________________________________________________________________
+  bool
+  equal( const Answer& a, const Answer& b )
+  {
+    return a.ok==b.ok && same( a.x, b.x ) && same( a.y, b.y );
+  }
+
+  //______________________________________________________________________________
+  // the data lines of a parameter file
+  std::vector<std::string>
+  read_lines( const std::string& file_name )
+  {
+    std::vector<std::string> lines;
+    std::ifstream ifs( file_name.c_str() );
+    std::string line;
+    while( std::getline( ifs, line ) ){
+      if( line.empty() || line[0]=='#' ) continue;
+      lines.push_back( line );
+    }
+    return lines;
+  }
+
+  //______________________________________________________________________________
+  // a copy of a DC file with the first data line again on two planes out
+  // of the tables, as type 1 in a drift file (types 3 and 6 know the planes)
+  bool
+  copy_with_extra_planes( const std::string& from, const std::string& to,
+			  bool drift )
+  {
+    std::vector<std::string> lines = read_lines( from );
+    if( lines.empty() )
+      return false;
+    std::ofstream ofs( to.c_str(), std::ios::trunc );
+    for( std::size_t i=0; i<lines.size(); ++i )
+      ofs << lines[i] << "\n";
+    std::istringstream iss( lines.front() );
+    std::vector<std::string> column;
+    std::string word;
+    while( iss >> word )
+      column.push_back( word );
+    if( drift && column.size()>2 )
+      column[2] = "1";
+    const char* planes[] = { "1100", "-3" };
+    for( int p=0; p<2; ++p ){
+      ofs << planes[p];
+      for( std::size_t i=1; i<column.size(); ++i )
+	ofs << " " << column[i];
+      ofs << "\n";
+    }
+    return ofs.good();
+  }
+
+  //______________________________________________________________________________
+  std::vector<HodoKey>
+  hodo_keys( const std::string& file_name )
+  {
+    std::vector<HodoKey> keys;
+    std::vector<std::string> lines = read_lines( file_name );
+    for( std::size_t i=0; i<lines.size(); ++i ){
+      std::istringstream iss( lines[i] );
+      HodoKey k;
+      int at;
+      if( iss >> k.cid >> k.plid >> k.seg >> at >> k.ud )
+	keys.push_back( k );
+    }
+    return keys;
+  }
+
+  //______________________________________________________________________________
+  std::vector<DCKey>
+  dc_keys( const std::string& file_name )
+  {
+    std::vector<DCKey> keys;
+    std::vector<std::string> lines = read_lines( file_name );
+    for( std::size_t i=0; i<lines.size(); ++i ){
+      std::istringstream iss( lines[i] );
+      DCKey k;
+      int wire;
+      if( iss >> k.plane >> wire ){
+	k.wire = wire;
+	keys.push_back( k );
+      }
+    }
+    return keys;
+  }
+
+  //______________________________________________________________________________
+  // the keys, their neighbours and keys beyond the masks
+  std::vector<HodoKey>
+  hodo_queries( const std::vector<HodoKey>& keys )
+  {
+    std::vector<HodoKey> q;
+    for( std::size_t i=0; i<keys.size(); ++i ){
+      const HodoKey& k = keys[i];
+      q.push_back( k );
+      q.push_back( { k.cid,   k.plid,   k.seg-1, k.ud   } );
+      q.push_back( { k.cid,   k.plid,   k.seg+1, k.ud   } );
+      q.push_back( { k.cid,   k.plid,   k.seg,   1-k.ud } );
+      q.push_back( { k.cid,   k.plid+1, k.seg,   k.ud   } );
+      q.push_back( { k.cid+1, k.plid,   k.seg,   k.ud   } );
+    }
+    if( !keys.empty() ){
+      const HodoKey& k = keys.front();
+      q.push_back( { -1,    k.plid, k.seg, k.ud } );
+      q.push_back( { 300,   k.plid, k.seg, k.ud } );
+      q.push_back( { k.cid, -1,     k.seg, k.ud } );
+      q.push_back( { k.cid, 300,    k.seg, k.ud } );
+      q.push_back( { k.cid, k.plid, -1,    k.ud } );
+      q.push_back( { k.cid, k.plid, 2000,  k.ud } );
+      q.push_back( { k.cid, k.plid, k.seg, 5    } );
+    }
+    return q;
+  }
+
+  //______________________________________________________________________________
+  std::vector<DCKey>
+  dc_queries( const std::vector<DCKey>& keys )
+  {
+    std::vector<DCKey> q;
+    for( std::size_t i=0; i<keys.size(); ++i ){
+      const DCKey& k = keys[i];
+      q.push_back( k );
+      q.push_back( { k.plane,   k.wire-1 } );
+      q.push_back( { k.plane,   k.wire+1 } );
+      q.push_back( { k.plane+1, k.wire   } );
+    }
+    q.push_back( { 2000, 1. } );
+    q.push_back( { -5,   1. } );
+    q.push_back( { 1,    2000. } );
+    return q;
+  }
+
+  //______________________________________________________________________________
+  void
+  ask_hodo( const std::vector<HodoKey>& q, std::vector<Answer>& ans )
+  {
+    const HodoParamMan& man = HodoParamMan::GetInstance();
+    for( std::size_t i=0; i<q.size(); ++i ){
+      const HodoKey& k = q[i];
+      Answer a = { false, nan, nan };
+      a.ok = man.GetTime( k.cid, k.plid, k.seg, k.ud, 1000, a.x );
+      a.y  = man.GetOffset( k.cid, k.plid, k.seg, k.ud );
+      ans.push_back( a );
+      a = { false, nan, nan };
+      a.ok = man.GetDeHighGain( k.cid, k.plid, k.seg, k.ud, 500, a.x );
+      ans.push_back( a );
+      a = { false, nan, nan };
+      a.ok = man.GetDeLowGain( k.cid, k.plid, k.seg, k.ud, 500, a.x );
+      ans.push_back( a );
+    }
+  }
+
+  //______________________________________________________________________________
+  void
+  ask_tdc( const std::vector<DCKey>& q, std::vector<Answer>& ans )
+  {
+    const DCTdcCalibMan& man = DCTdcCalibMan::GetInstance();
+    for( std::size_t i=0; i<q.size(); ++i ){
+      Answer a = { false, nan, nan };
+      a.ok = man.GetParameter( q[i].plane, q[i].wire, a.x, a.y );
+      ans.push_back( a );
+      a = { false, nan, nan };
+      a.ok = man.GetTime( q[i].plane, q[i].wire, 1000, a.x );
+      ans.push_back( a );
+    }
+  }
+
+  //______________________________________________________________________________
+  void
+  ask_drift( const std::vector<DCKey>& q, std::vector<Answer>& ans )
+  {
+    const DCDriftParamMan& man = DCDriftParamMan::GetInstance();
+    for( std::size_t i=0; i<q.size(); ++i ){
+      Answer a = { false, nan, nan };
+      a.ok = man.CalcDrift( q[i].plane, q[i].wire, 20., a.x, a.y );
+      ans.push_back( a );
+    }
+  }
+
+  //______________________________________________________________________________
+  // the managers print every missing key
+  std::vector<Answer>
+  ask_all( const std::vector<HodoKey>& hodo, const std::vector<DCKey>& tdc,
+	   const std::vector<DCKey>& drift )
+  {
+    std::streambuf* buf = hddaq::cerr.rdbuf( 0 );
+    std::vector<Answer> ans;
+    ask_hodo( hodo, ans );
+    ask_tdc( tdc, ans );
+    ask_drift( drift, ans );
+    hddaq::cerr.rdbuf( buf );
+    return ans;
+  }
+
+  //______________________________________________________________________________
+  void
+  freeze( bool flag )
+  {
+    HodoParamMan::GetInstance().Freeze( flag );
+    DCTdcCalibMan::GetInstance().Freeze( flag );
+    DCDriftParamMan::GetInstance().Freeze( flag );
+  }
+
+  //______________________________________________________________________________
+  // ns per lookup of the keys of the files
+  void
+  time_lookup( const std::vector<HodoKey>& hodo, const std::vector<DCKey>& tdc,
+	       int n_loop, double& t_hodo, double& t_tdc, double& sum )
+  {
+    const HodoParamMan&  hodo_man = HodoParamMan::GetInstance();
+    const DCTdcCalibMan& tdc_man  = DCTdcCalibMan::GetInstance();
+    double time;
+    std::clock_t c0 = std::clock();
+    for( int l=0; l<n_loop; ++l )
+      for( std::size_t i=0; i<hodo.size(); ++i )
+	if( hodo_man.GetTime( hodo[i].cid, hodo[i].plid, hodo[i].seg,
+			      hodo[i].ud, 1000, time ) )
+	  sum += time;
+    std::clock_t c1 = std::clock();
+    for( int l=0; l<n_loop; ++l )
+      for( std::size_t i=0; i<tdc.size(); ++i )
+	if( tdc_man.GetTime( tdc[i].plane, tdc[i].wire, 1000, time ) )
+	  sum += time;
+    std::clock_t c2 = std::clock();
+    const double n_hodo = hodo.empty() ? 1. : double(n_loop)*hodo.size();
+    const double n_tdc  = tdc.empty()  ? 1. : double(n_loop)*tdc.size();
+    t_hodo = 1.e9*(c1-c0)/CLOCKS_PER_SEC/n_hodo;
+    t_tdc  = 1.e9*(c2-c1)/CLOCKS_PER_SEC/n_tdc;
+  }
+}
+
+//______________________________________________________________________________
+int
+main( int argc, char* argv[] )
+{
+  if( argc<4 ){
+    std::cerr << "usage: " << argv[0]
+	      << " HodoParam DCTdcCalib DCDriftParam [nloop]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const int n_loop = argc>4 ? std::atoi( argv[4] ) : 100;
+  const std::string tdc_file   = "densetable.tdc.tmp";
+  const std::string drift_file = "densetable.drift.tmp";
+  if( !copy_with_extra_planes( argv[2], tdc_file, false )
+      || !copy_with_extra_planes( argv[3], drift_file, true ) ){
+    std::cerr << "#E no data in " << argv[2] << " or " << argv[3]
+	      << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const bool ready = HodoParamMan::GetInstance().Initialize( argv[1] )
+    && DCTdcCalibMan::GetInstance().Initialize( tdc_file )
+    && DCDriftParamMan::GetInstance().Initialize( drift_file );
+  const std::vector<HodoKey> hodo  = hodo_keys( argv[1] );
+  const std::vector<DCKey>   tdc   = dc_keys( tdc_file );
+  const std::vector<DCKey>   drift = dc_keys( drift_file );
+  std::remove( tdc_file.c_str() );
+  std::remove( drift_file.c_str() );
+  if( !ready )
+    return EXIT_FAILURE;
+
+  const std::vector<HodoKey> hodo_q  = hodo_queries( hodo );
+  const std::vector<DCKey>   tdc_q   = dc_queries( tdc );
+  const std::vector<DCKey>   drift_q = dc_queries( drift );
+
+  check( HodoParamMan::GetInstance().IsFrozen()
+	 && DCTdcCalibMan::GetInstance().IsFrozen()
+	 && DCDriftParamMan::GetInstance().IsFrozen(),
+	 "frozen after Initialize()", -1 );
+  const std::vector<Answer> table = ask_all( hodo_q, tdc_q, drift_q );
+  freeze( false );
+  const std::vector<Answer> map   = ask_all( hodo_q, tdc_q, drift_q );
+  freeze( true );
+  const std::vector<Answer> again = ask_all( hodo_q, tdc_q, drift_q );
+
+  int n_found = 0;
+  check( table.size()==map.size() && table.size()==again.size(),
+	 "number of answers", -1 );
+  const std::size_t n_hodo = 3*hodo_q.size();
+  const std::size_t n_tdc  = 2*tdc_q.size();
+  for( std::size_t i=0; i<table.size() && i<map.size(); ++i ){
+    const char* what = i<n_hodo ? "HodoParamMan"
+      : i<n_hodo+n_tdc ? "DCTdcCalibMan" : "DCDriftParamMan";
+    check( equal( table[i], map[i] ), what, i );
+    if( i<again.size() )
+      check( equal( table[i], again[i] ), "frozen again", i );
+    if( table[i].ok ) ++n_found;
+  }
+  // the queries of the keys of the files find something
+  check( n_found>0, "no key found", -1 );
+
+  double sum = 0.;
+  double t_hodo[2], t_tdc[2];
+  time_lookup( hodo, tdc, n_loop, t_hodo[0], t_tdc[0], sum );
+  freeze( false );
+  time_lookup( hodo, tdc, n_loop, t_hodo[1], t_tdc[1], sum );
+  freeze( true );
+
+  std::cout << std::fixed << std::setprecision(1)
+	    << "keys          hodo " << hodo.size() << ", tdc " << tdc.size()
+	    << ", drift " << drift.size() << "\n"
+	    << "queries       " << table.size() << ", found " << n_found << "\n"
+	    << "HodoParamMan  table " << t_hodo[0] << " map " << t_hodo[1]
+	    << " ns/lookup\n"
+	    << "DCTdcCalibMan table " << t_tdc[0] << " map " << t_tdc[1]
+	    << " ns/lookup (" << sum << ")\n";
+  std::cout << ( n_error ? "FAILED " : "OK " ) << n_error << " error(s)"
+	    << std::endl;
+  return n_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -9,6 +9,8 @@
 #include <bits/char_traits.h>
 #include <string>
 #include <vector>
+#include <fcntl.h>
+#include <unistd.h>
 #include <zlib.h>
 
 #include <iostream>
@@ -65,6 +67,10 @@ namespace hddaq
     bool          is_open() const throw();
     filebuf_type* open(const char* s, 
 		       std::ios_base::openmode mode);
+    // reading only, file_offset must be the beginning of a gzip member
+    filebuf_type* open_at(const char* s,
+			  std::ios_base::openmode mode,
+			  off_type file_offset);
     void          set_compression(int level, 
 				  int strategy = Z_DEFAULT_STRATEGY);
     
@@ -283,6 +289,39 @@ basic_gz_filebuf<CharT, Traits>::open(const char* s,
   
 }
 
+//______________________________________________________________________________
+template <typename CharT, typename Traits>
+inline
+typename basic_gz_filebuf<CharT, Traits>::filebuf_type*
+basic_gz_filebuf<CharT, Traits>::open_at(const char* s,
+					 std::ios_base::openmode mode,
+					 off_type file_offset)
+{
+  filebuf_type* ret = 0;
+  if (this->is_open() || !(std::ios_base::in & mode))
+    return ret;
+
+  int fd = ::open(s, O_RDONLY);
+  if (fd < 0)
+    return ret;
+  // gzdopen() takes the current position of fd as the start of the file
+  if (::lseek(fd, file_offset, SEEK_SET) != file_offset
+      || 0 == (m_file = ::gzdopen(fd, "rb")))
+    {
+      ::close(fd);
+      return ret;
+    }
+
+  allocate_internal_buffer();
+  m_mode    = mode;
+  m_reading = false;
+  m_writing = false;
+  set_buffer(-1);
+
+  ret = this;
+  return ret;
+}
+
 //______________________________________________________________________________
 template <typename CharT, typename Traits> 
 inline
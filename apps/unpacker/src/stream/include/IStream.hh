@@ -5,6 +5,7 @@
 #ifndef HDDAQ__I_STREAM_H
 #define HDDAQ__I_STREAM_H
 
+#include <stdint.h>
 #include <bits/char_traits.h>
 #include <istream>
 #include <string>
@@ -79,6 +80,8 @@ namespace hddaq
 //     std::streamsize readsome(char_type* s, std::streamsize n);
 //     stream_type& seekg(pos_type pos);
 //     stream_type& seekg(off_type off, std::ios_base::seekdir way);
+    // absolute position in the file, the start of a gzip member for .gz
+    bool             seek(uint64_t file_offset);
     int              sync();
 //     stream_type& unget();
     pos_type         tellg();
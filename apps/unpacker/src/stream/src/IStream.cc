@@ -255,6 +255,41 @@ IStream::read(char_type* s,
 //   return *m_stream;
 }
 
+//______________________________________________________________________________
+bool
+IStream::seek(uint64_t file_offset)
+{
+  if (!m_stream)
+    return false;
+
+  if (m_stream_type == k_stream_type_dat_file)
+    {
+      m_stream->clear();
+      m_stream->seekg(file_offset, std::ios::beg);
+      return !m_stream->fail();
+    }
+  else if (m_stream_type == k_stream_type_gzip_file)
+    {
+      IGZFileStream* gz = dynamic_cast<IGZFileStream*>(m_stream);
+      if (!gz)
+	return false;
+      gz->rdbuf()->close();
+      if (!gz->rdbuf()->open_at(m_stream_name.c_str(),
+				std::ios_base::in | std::ios_base::binary,
+				file_offset))
+	{
+	  gz->setstate(std::ios_base::failbit);
+	  return false;
+	}
+      gz->clear();
+      return true;
+    }
+
+  std::cerr << "#E seek() is not supported in " << m_stream_type
+	    << " stream type" << std::endl;
+  return false;
+}
+
 //______________________________________________________________________________
 int
 IStream::sync()
@@ -0,0 +1,109 @@
+// -*- C++ -*-
+
+#ifndef HDDAQ__DIGIT_INDEX_H
+#define HDDAQ__DIGIT_INDEX_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "defines.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+  // Flat view of the DigitList.
+  //
+  // Every Data of the DigitList (device, plane, segment, ch, data type) is
+  // given a cell number. The cells are numbered in the nesting order of
+  // the DigitList, so that the cells of one device, plane, ... are
+  // contiguous. The ragged sizes read from the digit XML are turned once
+  // into base tables, and a cell number costs four lookups in small
+  // contiguous arrays instead of five deque accesses:
+  //
+  //   cell = ch_base[segment_base[plane_base[device_base[device]
+  //                                          + plane] + segment] + ch]
+  //          + data_type
+  //
+  // The index describes only the shape of the DigitList. The Data of one
+  // event buffer are reached through a DigitCells bound to it.
+  class DigitIndex
+  {
+
+  public:
+    typedef uint32_t cell_t;
+    static const cell_t k_null_cell = 0xffffffffU;
+
+    struct Cell
+    {
+      uint32_t m_device;
+      uint32_t m_plane;
+      uint32_t m_segment;
+      uint32_t m_ch;
+      uint32_t m_data_type;
+    };
+
+  private:
+    std::vector<uint32_t> m_device_base;
+    std::vector<uint32_t> m_plane_base;
+    std::vector<uint32_t> m_segment_base;
+    std::vector<uint32_t> m_ch_base;
+    std::vector<Cell>     m_cell;
+
+  public:
+     DigitIndex();
+    ~DigitIndex();
+
+    void        bind(DigitList& digit_list,
+		     std::vector<Data*>& data) const;
+    void        build(const DigitList& digit_list);
+    void        clear();
+    bool        empty() const;
+    // [first, last) cells of a device
+    cell_t      get_first_cell(uint32_t device) const;
+    cell_t      get_last_cell(uint32_t device) const;
+    cell_t      get_cell(uint32_t device,
+			 uint32_t plane,
+			 uint32_t segment,
+			 uint32_t ch,
+			 uint32_t data_type) const;
+    const Cell& get_coordinate(cell_t cell) const;
+    uint32_t    size() const;
+
+  };
+
+  // Data of one event buffer, cell by cell, and the cells which received
+  // at least one hit in the current event (sorted once the event is
+  // decoded).
+  struct DigitCells
+  {
+    std::vector<Data*>              m_data;
+    std::vector<DigitIndex::cell_t> m_fired;
+  };
+
+//______________________________________________________________________________
+inline
+DigitIndex::cell_t
+DigitIndex::get_cell(uint32_t device,
+		     uint32_t plane,
+		     uint32_t segment,
+		     uint32_t ch,
+		     uint32_t data_type) const
+{
+  return m_ch_base[m_segment_base[m_plane_base[m_device_base[device]
+					       + plane] + segment] + ch]
+    + data_type;
+}
+
+//______________________________________________________________________________
+inline
+const DigitIndex::Cell&
+DigitIndex::get_coordinate(cell_t cell) const
+{
+  return m_cell[cell];
+}
+
+  }
+}
+#endif
@@ -0,0 +1,71 @@
+// -*- C++ -*-
+
+#ifndef HDDAQ__EVENT_INDEX_H
+#define HDDAQ__EVENT_INDEX_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Uncopyable.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+  // Random access to the events of a run file, from the index written by
+  // the Recorder (EventIndexer) as bookmark/runNNNNN_index.dat:
+  //
+  //   uint64_t event_offset[n_event];   start of event i in the raw data
+  //   uint64_t restart[n_restart][2];   {raw offset, file offset} at which
+  //                                     a gzip member starts
+  //   Trailer
+  //
+  // A plain bookmark file (runNNNNN_bookmark.dat, n_event+1 cumulative
+  // offsets) is accepted as an index without restart points.
+  class EventIndex
+    : private Uncopyable<EventIndex>
+  {
+
+  public:
+    static const uint32_t k_magic   = 0x58494448; // "HDIX"
+    static const uint32_t k_version = 1;
+
+    struct Trailer
+    {
+      uint32_t m_magic;
+      uint32_t m_version;
+      uint64_t m_n_event;
+      uint64_t m_n_restart;
+      uint64_t m_data_size;
+    };
+
+  private:
+    std::string           m_index_name;
+    std::ifstream         m_file;
+    uint64_t              m_n_event;
+    std::vector<uint64_t> m_restart_raw;
+    std::vector<uint64_t> m_restart_file;
+
+  public:
+     EventIndex();
+    ~EventIndex();
+
+    void               close();
+    const std::string& get_index_name() const;
+    uint64_t           get_n_event() const;
+    bool               is_open() const;
+    // where to continue reading to get event n: open the data file at
+    // file_offset (a gzip member for compressed data), then skip skip_byte
+    bool               locate(uint64_t n, bool is_compressed,
+			      uint64_t& file_offset,
+			      uint64_t& skip_byte);
+    bool               open(const std::string& index_name);
+
+  };
+
+  }
+}
+#endif
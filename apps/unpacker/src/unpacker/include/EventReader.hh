@@ -18,6 +18,7 @@ namespace hddaq
   {
 
   class IStream;
+  class EventIndex;
 
   class EventReader
     : private Uncopyable<EventReader>
@@ -37,6 +38,7 @@ namespace hddaq
     IStream*                            m_stream;
     DAQNode::Header*                    m_header;
     IStream*                            m_bookmark;
+    EventIndex*                         m_index;
 
   public:
      EventReader();
@@ -55,10 +57,14 @@ namespace hddaq
     unsigned int       get_daq_root_run_number() const;
     unsigned int       get_root_id() const;
     const std::string& get_stream_type() const;
+    bool               has_index() const;
     bool               is_open() const;
     void               open(const std::string& stream_name);
+    bool               open_index(const std::string& index_name);
     bool               read(bool skip_flag=false);
     bool               read_multi_events(int n_events);
+    // the next read() gets event n of the file, needs open_index()
+    bool               seek_event(uint64_t n);
     void               set_bookmark(const std::string& bookmark_name);
     int                skip(int n_skip);
     uint64_t           tellg();
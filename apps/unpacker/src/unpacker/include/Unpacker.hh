@@ -21,6 +21,7 @@ namespace hddaq
   {
 
     class UnpackerImpl;
+    class DigitIndex;
 
   class Unpacker 
     : private Uncopyable<Unpacker>
@@ -111,6 +112,12 @@ namespace hddaq
     static void          set_check_mode(const check_mode_t& mode,
 					const std::string& char_true="",
 					const std::string& char_false="");
+    // keep_capacity: clear() keeps the storage of the data vectors,
+    // shrinking those above watermark entries (0: never)
+    static void          set_clear_mode(bool keep_capacity,
+					std::size_t watermark=0);
+    // cell numbers of the channel map, recorded in the fired list by fill()
+    void                 set_cell_map(const DigitIndex& index);
     void                 set_container();
     void                 set_container(FrontEndData& fe_data);
     void                 set_data(unsigned int data);
@@ -120,6 +127,7 @@ namespace hddaq
     void                 set_decode_mode(bool decode_mode);
     void                 set_dump_mode(unsigned int dump_mode);
     static void          set_esc(bool flag);
+    void                 set_fired_list(std::vector<uint32_t>* fired);
     void                 set_id(uint64_t id);
     void                 set_impl(Impl* impl);
     void                 set_name(const std::string& name="");
@@ -49,6 +49,7 @@ namespace hddaq
       int m_data_type;
     };
     typedef std::vector<std::vector<DigitId> > DigitIdList;
+    typedef std::vector<std::vector<uint32_t> > CellIdList;
 
   protected:
     unpacker_type  m_type;
@@ -63,6 +64,8 @@ namespace hddaq
     iterator_list  m_first_list;
     iterator_list  m_last_list;
     DigitIdList    m_digit_id_list;
+    CellIdList     m_cell_id_list;
+    std::vector<uint32_t>* m_fired;
     FrontEndData   m_fe_data;       
     FrontEndData*  m_back;
     NullChList     m_null_ch;
@@ -87,6 +90,8 @@ namespace hddaq
     static std::string  gm_true_bit;
     static std::string  gm_false_bit;
     static int          gm_null_device_id;
+    static bool         gm_keep_capacity;
+    static std::size_t  gm_clear_watermark;
 
   private:
     friend class Unpacker;
@@ -13,6 +13,7 @@
 #include "Singleton.hh"
 #include "Uncopyable.hh"
 #include "defines.hh"
+#include "DigitIndex.hh"
 
 #include "RingBuffer.hh"
 
@@ -37,14 +38,25 @@ public:
   typedef defines::check_mode_t           check_mode_t;
   typedef defines::dump_mode_t            dump_mode_t;
   typedef std::vector<uint32_t>::iterator iterator;
+  typedef std::vector<DigitIndex::cell_t>::const_iterator cell_iterator;
 
 
   struct EventBuffer
   {
     DigitList                 m_digit;
+    DigitCells                m_cells;
     std::vector<FrontEndData> m_fe;
   };
 
+  // device, plane and data type of the digit XML, resolved from their
+  // names once by get_handle(): get(handle, ...) does no string work
+  struct Handle
+  {
+    uint32_t m_device;
+    uint32_t m_plane;
+    uint32_t m_data_type;
+  };
+
   typedef RingBuffer<EventBuffer> fifo_t;
   typedef fifo_t::iterator        fifo_iterator;
   typedef fifo_t::const_iterator  const_fifo_iterator;
@@ -64,12 +76,18 @@ private:
   DigitList              m_digit_list;
   fifo_t                 m_fifo;
   DigitList*             m_front;
+  DigitIndex             m_digit_index;
+  DigitCells             m_cells;
+  DigitCells*            m_front_cells;
+  DigitCells*            m_back_cells;
   bool                   m_is_data_ready;
   int                    m_counter;
   bool                   m_decode_mode;
   dump_mode_t            m_dump_mode;
   int                    m_run_number;
   bool                   m_enable_istream_bookmark;
+  bool                   m_keep_capacity;
+  int                    m_clear_watermark;
 
 public:
   ~UnpackerManager();
@@ -131,6 +149,10 @@ public:
                          unsigned int ch,
                          unsigned int data_type=0,
                          unsigned int hit_id=0) const;
+  unsigned long long get(const Handle& handle,
+                         unsigned int segment_id,
+                         unsigned int ch,
+                         unsigned int hit_id=0) const;
 
 
   void            get_buffer(const std::vector<uint64_t>& fe_id,
@@ -138,6 +160,8 @@ public:
                              iterator& end) const;
   iterator        get_buffer_begin(const std::vector<uint64_t>& fe_id) const;
   iterator        get_buffer_end(const std::vector<uint64_t>& fe_id) const;
+  // Data of a cell of the DigitIndex
+  const Data&     get_cell_data(DigitIndex::cell_t cell) const;
   unsigned int    get_counter() const;
   unsigned int    get_daq_root_number() const;
   int             get_fe_id(const char* fe_name) const;
@@ -147,8 +171,16 @@ public:
                               int ma      = -1,
                               int data_type = 0
     ) const;
+  // cells which received hits in the current event, in ascending order
+  // (grouped by device, plane, segment, ch): analyzers can loop over the
+  // fired channels only instead of every get_n_*() / get_entries()
+  const std::vector<DigitIndex::cell_t>& get_fired() const;
+  void            get_fired(unsigned int device_id,
+                            cell_iterator& begin,
+                            cell_iterator& end) const;
   int             get_device_id(const char* device_name) const;
   int             get_device_id(const std::string& device_name) const;
+  const DigitIndex& get_digit_index() const;
   int             get_plane_id(const char* device_name,
                                const char* plane_name ) const;;
   int             get_plane_id(const std::string& device_name,
@@ -167,6 +199,17 @@ public:
                               unsigned int segment_id,
                               unsigned int ch,
                               unsigned int data_type=0) const;
+  unsigned int    get_entries(const Handle& handle,
+                              unsigned int segment_id,
+                              unsigned int ch) const;
+  // data_name "" is data type 0, the data types are looked up at
+  // (plane, segment, ch) = (0, 0, 0) as in get_data_id()
+  Handle          get_handle(const std::string& device_name,
+                             const std::string& plane_name,
+                             const std::string& data_name="") const;
+  Handle          get_handle(const std::string& device_name,
+                             unsigned int plane_id=0,
+                             const std::string& data_name="") const;
   unsigned int  get_n_device() const;
   unsigned int  get_n_plane(int device_id) const;
   unsigned int  get_n_segment(int device_id,
@@ -200,6 +243,9 @@ public:
   void            push_event();
   void            read();
   void            reset();
+  // jumps to event n (0 = first event of the file) through the event
+  // index in bookmark/ and unpacks it, as operator++() does
+  bool            seek_event(uint64_t n);
   void            set_config_file(const std::string& config_file,
                                   const std::string& digit_file="",
                                   const std::string& channel_map_file="");
@@ -214,6 +260,7 @@ public:
 
 private:
   UnpackerManager();
+  bool            open_index();
   void            search_device(Unpacker* u,
                                 std::vector<Unpacker*>& uvect,
                                 int device_id, int plane_id
@@ -0,0 +1,134 @@
+// -*- C++ -*-
+
+#include "DigitIndex.hh"
+
+#include "std_ostream.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+const DigitIndex::cell_t DigitIndex::k_null_cell;
+
+//______________________________________________________________________________
+DigitIndex::DigitIndex()
+  : m_device_base(),
+    m_plane_base(),
+    m_segment_base(),
+    m_ch_base(),
+    m_cell()
+{
+}
+
+//______________________________________________________________________________
+DigitIndex::~DigitIndex()
+{
+}
+
+//______________________________________________________________________________
+void
+DigitIndex::bind(DigitList& digit_list,
+		 std::vector<Data*>& data) const
+{
+  data.assign(m_cell.size(), 0);
+  const uint32_t n = m_cell.size();
+  for (uint32_t i=0; i<n; ++i)
+    {
+      const Cell& c = m_cell[i];
+      data[i] = &(digit_list
+		  [c.m_device]
+		  [c.m_plane]
+		  [c.m_segment]
+		  [c.m_ch]
+		  [c.m_data_type]);
+    }
+  return;
+}
+
+//______________________________________________________________________________
+void
+DigitIndex::build(const DigitList& digit_list)
+{
+  clear();
+
+  // each base table ends with a sentinel holding the total count of the
+  // next level, so that [base[i], base[i+1]) is always valid
+  Cell c;
+  const uint32_t n_device = digit_list.size();
+  for (c.m_device=0; c.m_device<n_device; ++c.m_device)
+    {
+      const Device& device = digit_list[c.m_device];
+      m_device_base.push_back(m_plane_base.size());
+      const uint32_t n_plane = device.size();
+      for (c.m_plane=0; c.m_plane<n_plane; ++c.m_plane)
+	{
+	  const Plane& plane = device[c.m_plane];
+	  m_plane_base.push_back(m_segment_base.size());
+	  const uint32_t n_segment = plane.size();
+	  for (c.m_segment=0; c.m_segment<n_segment; ++c.m_segment)
+	    {
+	      const Segment& segment = plane[c.m_segment];
+	      m_segment_base.push_back(m_ch_base.size());
+	      const uint32_t n_ch = segment.size();
+	      for (c.m_ch=0; c.m_ch<n_ch; ++c.m_ch)
+		{
+		  m_ch_base.push_back(m_cell.size());
+		  const uint32_t n_data = segment[c.m_ch].size();
+		  for (c.m_data_type=0; c.m_data_type<n_data; ++c.m_data_type)
+		    m_cell.push_back(c);
+		}
+	    }
+	}
+    }
+  m_device_base.push_back(m_plane_base.size());
+  m_plane_base.push_back(m_segment_base.size());
+  m_segment_base.push_back(m_ch_base.size());
+  m_ch_base.push_back(m_cell.size());
+
+  cout << "#D DigitIndex::build() " << m_cell.size() << " cells" << std::endl;
+  return;
+}
+
+//______________________________________________________________________________
+void
+DigitIndex::clear()
+{
+  m_device_base.clear();
+  m_plane_base.clear();
+  m_segment_base.clear();
+  m_ch_base.clear();
+  m_cell.clear();
+  return;
+}
+
+//______________________________________________________________________________
+bool
+DigitIndex::empty() const
+{
+  return m_cell.empty();
+}
+
+//______________________________________________________________________________
+DigitIndex::cell_t
+DigitIndex::get_first_cell(uint32_t device) const
+{
+  return m_ch_base[m_segment_base[m_plane_base[m_device_base[device]]]];
+}
+
+//______________________________________________________________________________
+DigitIndex::cell_t
+DigitIndex::get_last_cell(uint32_t device) const
+{
+  return get_first_cell(device+1);
+}
+
+//______________________________________________________________________________
+uint32_t
+DigitIndex::size() const
+{
+  return m_cell.size();
+}
+
+  }
+}
@@ -0,0 +1,185 @@
+// -*- C++ -*-
+
+#include "EventIndex.hh"
+
+#include <algorithm>
+
+#include "std_ostream.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+  namespace
+  {
+    const std::streamoff k_offset_size = sizeof(uint64_t);
+  }
+
+//______________________________________________________________________________
+EventIndex::EventIndex()
+  : m_index_name(),
+    m_file(),
+    m_n_event(0),
+    m_restart_raw(),
+    m_restart_file()
+{
+}
+
+//______________________________________________________________________________
+EventIndex::~EventIndex()
+{
+  close();
+}
+
+//______________________________________________________________________________
+void
+EventIndex::close()
+{
+  if (m_file.is_open())
+    m_file.close();
+  m_n_event = 0;
+  m_restart_raw.clear();
+  m_restart_file.clear();
+  return;
+}
+
+//______________________________________________________________________________
+const std::string&
+EventIndex::get_index_name() const
+{
+  return m_index_name;
+}
+
+//______________________________________________________________________________
+uint64_t
+EventIndex::get_n_event() const
+{
+  return m_n_event;
+}
+
+//______________________________________________________________________________
+bool
+EventIndex::is_open() const
+{
+  return m_file.is_open();
+}
+
+//______________________________________________________________________________
+bool
+EventIndex::locate(uint64_t n, bool is_compressed,
+		   uint64_t& file_offset,
+		   uint64_t& skip_byte)
+{
+  if (!is_open() || n >= m_n_event)
+    return false;
+
+  uint64_t raw_offset = 0;
+  m_file.clear();
+  m_file.seekg(n * k_offset_size, std::ios::beg);
+  if (!m_file.read(reinterpret_cast<char*>(&raw_offset), k_offset_size))
+    return false;
+
+  if (!is_compressed)
+    {
+      file_offset = raw_offset;
+      skip_byte   = 0;
+      return true;
+    }
+
+  // the last member starting at or before the event, the first member
+  // (0, 0) is not in the table
+  std::vector<uint64_t>::const_iterator itr
+    = std::upper_bound(m_restart_raw.begin(), m_restart_raw.end(),
+		       raw_offset);
+  if (itr == m_restart_raw.begin())
+    {
+      file_offset = 0;
+      skip_byte   = raw_offset;
+    }
+  else
+    {
+      const std::size_t i = (itr - m_restart_raw.begin()) - 1;
+      file_offset = m_restart_file[i];
+      skip_byte   = raw_offset - m_restart_raw[i];
+    }
+  return true;
+}
+
+//______________________________________________________________________________
+bool
+EventIndex::open(const std::string& index_name)
+{
+  close();
+  m_file.open(index_name.c_str(), std::ios::in | std::ios::binary);
+  if (!m_file.is_open())
+    return false;
+  m_index_name = index_name;
+
+  m_file.seekg(0, std::ios::end);
+  const std::streamoff file_size = m_file.tellg();
+
+  Trailer trailer;
+  trailer.m_magic = 0;
+  if (file_size >= static_cast<std::streamoff>(sizeof(trailer)))
+    {
+      m_file.seekg(file_size - sizeof(trailer), std::ios::beg);
+      m_file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+    }
+
+  if (trailer.m_magic != k_magic)
+    {
+      // bookmark file: 0, then the cumulative size after each event;
+      // an index the Recorder did not close reads the same way
+      if (file_size < k_offset_size || file_size % k_offset_size != 0)
+	{
+	  cerr << "#E EventIndex::open() broken index " << index_name
+	       << std::endl;
+	  close();
+	  return false;
+	}
+      m_n_event = file_size / k_offset_size - 1;
+    }
+  else if (trailer.m_version != k_version
+	   || static_cast<uint64_t>(file_size)
+	   != ((trailer.m_n_event + 2 * trailer.m_n_restart) * k_offset_size
+	       + sizeof(trailer)))
+    {
+      cerr << "#E EventIndex::open() unknown index format " << index_name
+	   << std::endl;
+      close();
+      return false;
+    }
+  else
+    {
+      m_n_event = trailer.m_n_event;
+      std::vector<uint64_t> restart(2 * trailer.m_n_restart);
+      m_file.seekg(m_n_event * k_offset_size, std::ios::beg);
+      if (!restart.empty())
+	m_file.read(reinterpret_cast<char*>(&restart[0]),
+		    restart.size() * k_offset_size);
+      m_restart_raw.reserve(trailer.m_n_restart);
+      m_restart_file.reserve(trailer.m_n_restart);
+      for (std::size_t i=0; i<restart.size(); i+=2)
+	{
+	  m_restart_raw.push_back(restart[i]);
+	  m_restart_file.push_back(restart[i+1]);
+	}
+    }
+
+  if (!m_file)
+    {
+      cerr << "#E EventIndex::open() failed to read " << index_name
+	   << std::endl;
+      close();
+      return false;
+    }
+
+  cout << "#D EventIndex::open() " << index_name
+       << " : " << m_n_event << " events, "
+       << m_restart_raw.size() << " restart points" << std::endl;
+  return true;
+}
+
+  }
+}
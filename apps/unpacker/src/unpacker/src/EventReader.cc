@@ -14,6 +14,7 @@
 #include "std_ostream.hh"
 #include "BitDump.hh"
 #include "HexDump.hh"
+#include "EventIndex.hh"
 #include "IStream.hh"
 #include "Unpacker.hh"
 #include "UnpackerManager.hh"
@@ -38,7 +39,8 @@ EventReader::EventReader()
     m_end(),
     m_stream(0),
     m_header(0),
-    m_bookmark(0)
+    m_bookmark(0),
+    m_index(0)
 {
   m_begin = m_buffer.end();
   m_end   = m_buffer.end();
@@ -49,6 +51,7 @@ EventReader::~EventReader()
 {
 //   cout << "#D EventReader:~EventReader()" << std::endl;
   clear();
+  delete m_index;
 //   cout << "#D EventReader:~EventReader()" << std::endl;
 }
 
@@ -200,6 +203,13 @@ EventReader::get_stream_type() const
   return ret;
 }
 
+//______________________________________________________________________________
+bool
+EventReader::has_index() const
+{
+  return (m_index && m_index->is_open());
+}
+
 //______________________________________________________________________________
 bool
 EventReader::is_open() const
@@ -246,6 +256,15 @@ EventReader::open(const std::string& stream_name)
   return;
 }
 
+//______________________________________________________________________________
+bool
+EventReader::open_index(const std::string& index_name)
+{
+  if (!m_index)
+    m_index = new EventIndex;
+  return m_index->open(index_name);
+}
+
 //______________________________________________________________________________
 bool
 EventReader::unpack()
@@ -417,6 +436,45 @@ EventReader::set_bookmark(const std::string& bookmark_name)
   return;
 }
 
+//______________________________________________________________________________
+bool
+EventReader::seek_event(uint64_t n)
+{
+  if (!is_open() || !has_index())
+    return false;
+
+  const bool is_compressed = (get_stream_type() == k_stream_type_gzip_file);
+  if (!is_compressed && get_stream_type() != k_stream_type_dat_file)
+    {
+      cerr << "\n#E EventReader::seek_event() not supported for "
+	   << get_stream_type() << std::endl;
+      return false;
+    }
+
+  uint64_t file_offset = 0;
+  uint64_t skip_byte   = 0;
+  if (!m_index->locate(n, is_compressed, file_offset, skip_byte))
+    {
+      cerr << "\n#E EventReader::seek_event() event " << n
+	   << " is not in the index (" << m_index->get_n_event()
+	   << " events)" << std::endl;
+      return false;
+    }
+
+  clear();
+  if (!m_stream->seek(file_offset))
+    {
+      cerr << "\n#E EventReader::seek_event() failed to seek to "
+	   << file_offset << std::endl;
+      close();
+      return false;
+    }
+  if (skip_byte > 0)
+    m_stream->ignore(skip_byte);
+
+  return m_stream->good();
+}
+
 //______________________________________________________________________________
 int
 EventReader::skip(int n_skip)
@@ -25,6 +25,7 @@
 #include "UnpackerConfig.hh"
 #include "std_pair_dump.hh"
 #include "Clear.hh"
+#include "DigitIndex.hh"
 
 
 namespace hddaq
@@ -251,6 +252,8 @@ Unpacker::clear()
   m_impl->m_nsec.clear();
   m_impl->clear();
 
+  const bool        keep_capacity = Impl::gm_keep_capacity;
+  const std::size_t watermark     = Impl::gm_clear_watermark;
   FrontEndData& fe_data = *(m_impl->m_back);
   const int n_ch = fe_data.size();
   for (int i=0; i<n_ch; ++i)
@@ -261,8 +264,13 @@ Unpacker::clear()
 // 	   << std::endl;
       for (int j=0; j<n_data; ++j)
 	if (ch[j])
-// 	  ch[j]->clear();
-	  hddaq::clear(*(ch[j]));
+	  {
+	    if (keep_capacity)
+	      hddaq::clear_retain(*(ch[j]), watermark);
+	    else
+// 	      ch[j]->clear();
+	      hddaq::clear(*(ch[j]));
+	  }
 // 	else
 // 	  {
 // 	    cerr << "\n#E Unpacker::clear()\n unpacker " << m_impl->m_type
@@ -848,6 +856,43 @@ Unpacker::set_check_mode(const check_mode_t& mode,
   return;
 }
 
+//______________________________________________________________________________
+void
+Unpacker::set_clear_mode(bool keep_capacity, std::size_t watermark)
+{
+  cout << "#D clear mode = " << (keep_capacity ? "keep" : "free");
+  if (keep_capacity && watermark > 0)
+    cout << ", watermark = " << watermark;
+  cout << std::endl;
+  Impl::gm_keep_capacity   = keep_capacity;
+  Impl::gm_clear_watermark = watermark;
+  return;
+}
+
+//______________________________________________________________________________
+void
+Unpacker::set_cell_map(const DigitIndex& index)
+{
+  const FrontEndData& fe = m_impl->m_fe_data;
+  const int n_ch = fe.size();
+  Impl::CellIdList& cell = m_impl->m_cell_id_list;
+  cell.resize(n_ch);
+  for (int ch=0; ch<n_ch; ++ch)
+    {
+      const int n_type = fe[ch].size();
+      cell[ch].assign(n_type, DigitIndex::k_null_cell);
+      for (int type=0; type<n_type; ++type)
+	{
+	  if (!fe[ch][type] || m_impl->m_null_ch[ch][type])
+	    continue;
+	  const Impl::DigitId& d = m_impl->m_digit_id_list[ch][type];
+	  cell[ch][type] = index.get_cell(d.m_device, d.m_plane, d.m_segment,
+					  d.m_ch, d.m_data_type);
+	}
+    }
+  return;
+}
+
 //______________________________________________________________________________
 void
 Unpacker::set_container()
@@ -916,6 +961,14 @@ Unpacker::set_esc(bool flag)
   return;
 }
 
+//______________________________________________________________________________
+void
+Unpacker::set_fired_list(std::vector<uint32_t>* fired)
+{
+  m_impl->m_fired = fired;
+  return;
+}
+
 //______________________________________________________________________________
 void
 Unpacker::set_id(uint64_t id)
@@ -24,6 +24,8 @@ namespace hddaq
 
     bool UnpackerImpl::gm_is_esc_on = false;
     UnpackerImpl::check_mode_t UnpackerImpl::gm_check_mode;
+    bool        UnpackerImpl::gm_keep_capacity   = false;
+    std::size_t UnpackerImpl::gm_clear_watermark = 0;
     std::string UnpackerImpl::gm_true_bit;
     std::string UnpackerImpl::gm_false_bit;
     int UnpackerImpl::gm_null_device_id = -1;
@@ -63,6 +65,8 @@ UnpackerImpl::UnpackerImpl(const unpacker_type& type)
     m_first_list(),
     m_last_list(),
     m_digit_id_list(),
+    m_cell_id_list(),
+    m_fired(0),
     m_fe_data(),
     m_back(0),
     m_null_ch(),
@@ -420,7 +424,10 @@ UnpackerImpl::fill(unsigned int ch,
   if (m_null_ch[ch][data_type])
     return;
 
-  fe_data[ch][data_type]->push_back(data);
+  Data* d = fe_data[ch][data_type];
+  if (m_fired && d->empty())
+    m_fired->push_back(m_cell_id_list[ch][data_type]);
+  d->push_back(data);
 
 #else
   try{
@@ -440,6 +447,8 @@ UnpackerImpl::fill(unsigned int ch,
 	     << std::dec << std::noshowbase
 	     << std::endl;
       }else{
+	if (m_fired && d->empty())
+	  m_fired->push_back(m_cell_id_list.at(ch).at(data_type));
 	d->push_back(data);
       }
     }catch (const std::out_of_range& e){
@@ -27,6 +27,7 @@
 #include "UnpackerXMLReadDigit.hh"
 #include "UnpackerXMLChannelMap.hh"
 #include "EventReader.hh"
+#include "IStream.hh"
 #include "filesystem_util.hh"
 #include "replace_string.hh"
 
@@ -51,12 +52,18 @@ UnpackerManager::UnpackerManager()
     m_digit_list(),
     m_fifo(),
     m_front(0),
+    m_digit_index(),
+    m_cells(),
+    m_front_cells(0),
+    m_back_cells(0),
     m_is_data_ready(false),
     m_counter(0),
     m_decode_mode(true),
     m_dump_mode(),
     m_run_number(-1),
-    m_enable_istream_bookmark(false)
+    m_enable_istream_bookmark(false),
+    m_keep_capacity(false),
+    m_clear_watermark(0)
 {
   UnpackerRegister unpacker_register;
   IStreamRegister  istream_register;
@@ -111,22 +118,27 @@ UnpackerManager::clear()
   if (m_fifo.size()>1)
     {
       EventBuffer& wpos = m_fifo.back();
+      m_back_cells = &wpos.m_cells;
 
       for (int i=0; i<n; ++i)
 	{
 	  Unpacker* u = m_unpacker[i];
 	  if (u) u->set_container(wpos.m_fe[i]);
+	  if (u) u->set_fired_list(&m_back_cells->m_fired);
 	}
     }
   else
     {
+      m_back_cells = &m_cells;
       for (int i=0; i<n; ++i)
 	{
 	  Unpacker* u = m_unpacker[i];
 	  if (u) u->set_container();
+	  if (u) u->set_fired_list(&m_back_cells->m_fired);
 	}
       m_is_data_ready = false;
     }
+  m_back_cells->m_fired.clear();
 
 #ifdef DEBUG_FIFO
   ++s_n_back;
@@ -162,6 +174,8 @@ void
 UnpackerManager::decode()
 {
   if (m_decode_mode) m_root->decode();
+  if (m_back_cells)
+    std::sort(m_back_cells->m_fired.begin(), m_back_cells->m_fired.end());
   push_event();
   return;
 }
@@ -401,8 +415,11 @@ UnpackerManager::get(unsigned int device_id,
 		     unsigned int data_type,
 		     unsigned int hit_id) const
 {
-  const DigitList& digit_list = *m_front;
-  return digit_list[device_id][plane_id][segment_id][ch][data_type][hit_id];
+  const Data& data
+    = *(m_front_cells->m_data[m_digit_index.get_cell(device_id, plane_id,
+						     segment_id, ch,
+						     data_type)]);
+  return data[hit_id];
 }
 
 //_____________________________________________________________________________
@@ -458,6 +475,21 @@ UnpackerManager::get(const std::string& device_name,
   return plane[segment_id][ch][data_type][hit_id];
 }
 
+//_____________________________________________________________________________
+unsigned long long
+UnpackerManager::get(const Handle& handle,
+		     unsigned int segment_id,
+		     unsigned int ch,
+		     unsigned int hit_id) const
+{
+  const Data& data
+    = *(m_front_cells->m_data[m_digit_index.get_cell(handle.m_device,
+						     handle.m_plane,
+						     segment_id, ch,
+						     handle.m_data_type)]);
+  return data[hit_id];
+}
+
 //_____________________________________________________________________________
 void
 UnpackerManager::get_buffer(const std::vector<uint64_t>& fe_id,
@@ -506,6 +538,13 @@ UnpackerManager::get_buffer_end(const std::vector<uint64_t>& fe_id) const
   return u->get_buffer_end();
 }
 
+//_____________________________________________________________________________
+const Data&
+UnpackerManager::get_cell_data(DigitIndex::cell_t cell) const
+{
+  return *(m_front_cells->m_data[cell]);
+}
+
 //_____________________________________________________________________________
 unsigned int
 UnpackerManager::get_counter() const
@@ -564,6 +603,27 @@ UnpackerManager::get_fe_info(int node_id, int address, int ma,
   return 0;
 }
 
+//_____________________________________________________________________________
+const std::vector<DigitIndex::cell_t>&
+UnpackerManager::get_fired() const
+{
+  return m_front_cells->m_fired;
+}
+
+//_____________________________________________________________________________
+void
+UnpackerManager::get_fired(unsigned int device_id,
+			   cell_iterator& begin,
+			   cell_iterator& end) const
+{
+  const std::vector<DigitIndex::cell_t>& fired = m_front_cells->m_fired;
+  begin = std::lower_bound(fired.begin(), fired.end(),
+			   m_digit_index.get_first_cell(device_id));
+  end   = std::lower_bound(begin, fired.end(),
+			   m_digit_index.get_last_cell(device_id));
+  return;
+}
+
 //_____________________________________________________________________________
 int
 UnpackerManager::get_fe_id(const std::string& name) const
@@ -586,6 +646,13 @@ UnpackerManager::get_device_id(const std::string& name) const
   return GConfig::get_instance().get_digit_info().get_device_id(name);
 }
 
+//_____________________________________________________________________________
+const DigitIndex&
+UnpackerManager::get_digit_index() const
+{
+  return m_digit_index;
+}
+
 //_____________________________________________________________________________
 int
 UnpackerManager::get_plane_id(const char* device_name,
@@ -601,8 +668,7 @@ int
 UnpackerManager::get_plane_id(const std::string& device_name,
 			      const std::string& plane_name ) const
 {
-  int device_id = get_device_id(device_name);
-  return GConfig::get_instance().get_digit_info().get_plane_id(device_id, plane_name);
+  return get_handle(device_name, plane_name).m_plane;
 }
 
 //_____________________________________________________________________________
@@ -620,8 +686,7 @@ int
 UnpackerManager::get_data_id(const std::string& device_name,
 			     const std::string& data_name ) const
 {
-  int device_id = get_device_id(device_name);
-  return GConfig::get_instance().get_digit_info().get_data_id(device_id, 0, 0, 0, data_name);
+  return get_handle(device_name, 0U, data_name).m_data_type;
 }
 
 //_____________________________________________________________________________
@@ -632,10 +697,12 @@ UnpackerManager::get_entries(unsigned int device_id,
 			     unsigned int ch,
 			     unsigned int data_type) const
 {
-  const DigitList& digit_list = *m_front;
 #ifndef RANGE_CHECK
-  return digit_list[device_id][plane_id][segment_id][ch][data_type].size();
+  return m_front_cells->m_data[m_digit_index.get_cell(device_id, plane_id,
+						      segment_id, ch,
+						      data_type)]->size();
 #else
+  const DigitList& digit_list = *m_front;
   try
     {
       return digit_list.at(device_id).at(plane_id).at(segment_id).at(ch).at(data_type).size();
@@ -687,6 +754,48 @@ UnpackerManager::get_entries(const std::string& name,
 
 }
 
+//_____________________________________________________________________________
+unsigned int
+UnpackerManager::get_entries(const Handle& handle,
+			     unsigned int segment_id,
+			     unsigned int ch) const
+{
+  return get_entries(handle.m_device, handle.m_plane, segment_id, ch,
+		     handle.m_data_type);
+}
+
+//_____________________________________________________________________________
+UnpackerManager::Handle
+UnpackerManager::get_handle(const std::string& device_name,
+			    const std::string& plane_name,
+			    const std::string& data_name) const
+{
+  const UnpackerConfig::DigitInfo& digit_info
+    = GConfig::get_instance().get_digit_info();
+  const int device_id = digit_info.get_device_id(device_name);
+  return get_handle(device_name,
+		    digit_info.get_plane_id(device_id, plane_name),
+		    data_name);
+}
+
+//_____________________________________________________________________________
+UnpackerManager::Handle
+UnpackerManager::get_handle(const std::string& device_name,
+			    unsigned int plane_id,
+			    const std::string& data_name) const
+{
+  const UnpackerConfig::DigitInfo& digit_info
+    = GConfig::get_instance().get_digit_info();
+  Handle handle;
+  handle.m_device    = digit_info.get_device_id(device_name);
+  handle.m_plane     = plane_id;
+  handle.m_data_type = 0;
+  if (!data_name.empty())
+    handle.m_data_type
+      = digit_info.get_data_id(handle.m_device, 0, 0, 0, data_name);
+  return handle;
+}
+
 //_____________________________________________________________________________
 unsigned int
 UnpackerManager::get_n_device() const
@@ -866,6 +975,13 @@ UnpackerManager::initialize()
 
   const int n_unpacker = m_unpacker.size();
 
+  m_digit_index.build(m_digit_list);
+  for (int i=0; i<n_unpacker; ++i)
+  {
+    Unpacker* u = m_unpacker[i];
+    if (u) u->set_cell_map(m_digit_index);
+  }
+
   if (m_fifo.size()>1)
   {
     cout << "#D UnpackerManager::initialize()\n"
@@ -873,6 +989,7 @@ UnpackerManager::initialize()
     for (fifo_t::iterator itr=m_fifo.begin(); itr!=m_fifo.end(); ++itr)
     {
       itr->m_digit = m_digit_list;
+      m_digit_index.bind(itr->m_digit, itr->m_cells.m_data);
       itr->m_fe.resize(n_unpacker);
       for (int i=0; i<n_unpacker; ++i)
       {
@@ -887,19 +1004,16 @@ UnpackerManager::initialize()
   else
   {
     m_front = &m_digit_list;
+    m_digit_index.bind(m_digit_list, m_cells.m_data);
+    m_front_cells = &m_cells;
   }
 
-  if (m_enable_istream_bookmark && m_reader->get_stream_type() == ".dat") {
-    std::string base = hddaq::basename(m_input_stream);
-    replace_all(base, ".dat", "_bookmark.dat");
-    // replace_all(base, ".gz", "");
-    std::ostringstream path_oss;
-    path_oss << hddaq::dirname(m_input_stream)
-             << "/bookmark/" << base;
-    m_reader->set_bookmark(path_oss.str());
-  }
-
-  int n_skipped = m_reader->skip(m_skip);
+  int n_skipped = 0;
+  if (m_enable_istream_bookmark && m_skip > 0
+      && open_index() && m_reader->seek_event(m_skip))
+    n_skipped = m_skip;
+  else
+    n_skipped = m_reader->skip(m_skip);
   cout << "#D GUnpacker skipped " << n_skipped << " events"
        << std::endl;
 
@@ -990,6 +1104,7 @@ UnpackerManager::is_data_ready()
 
   if (m_fifo.size()>1){
     m_front = &(m_fifo.front().m_digit);
+    m_front_cells = &(m_fifo.front().m_cells);
   }
 
 
@@ -1060,6 +1175,32 @@ UnpackerManager::operator++()
   return;
 }
 
+//_____________________________________________________________________________
+bool
+UnpackerManager::open_index()
+{
+  if (m_reader->has_index())
+    return true;
+
+  // run00123.dat(.gz) -> bookmark/run00123_index.dat, or the older
+  // bookmark/run00123_bookmark.dat which has no gzip restart points
+  std::string base = hddaq::basename(m_input_stream);
+  replace_all(base, k_stream_type_gzip_file, "");
+  std::string index_base    = base;
+  std::string bookmark_base = base;
+  replace_all(index_base, ".dat", "_index.dat");
+  replace_all(bookmark_base, ".dat", "_bookmark.dat");
+  const std::string dir = hddaq::dirname(m_input_stream) + "/bookmark/";
+
+  if (m_reader->open_index(dir + index_base)
+      || m_reader->open_index(dir + bookmark_base))
+    return true;
+
+  cerr << "#W UnpackerManager::open_index()\n"
+       << " no event index for " << m_input_stream << std::endl;
+  return false;
+}
+
 //_____________________________________________________________________________
 void
 UnpackerManager::pop_event()
@@ -1162,6 +1303,24 @@ UnpackerManager::reset()
   return;
 }
 
+//_____________________________________________________________________________
+bool
+UnpackerManager::seek_event(uint64_t n)
+{
+  if (is_online() || !m_reader->is_open())
+    {
+      cerr << "#E UnpackerManager::seek_event()\n"
+           << " no seekable input stream" << std::endl;
+      return false;
+    }
+  if (!open_index() || !m_reader->seek_event(n))
+    return false;
+
+  // the next event in the stream is n
+  operator++();
+  return (m_reader->is_open() && !eof());
+}
+
 //_____________________________________________________________________________
 void
 UnpackerManager::set_config_file(const std::string& config_file,
@@ -1188,8 +1347,12 @@ UnpackerManager::set_config_file(const std::string& config_file,
       set_parameter("esc",         g_config.get_control_param("esc"));
       set_parameter("print_cycle", g_config.get_control_param("print_cycle"));
       set_parameter("fifo_length", g_config.get_control_param("fifo_length"));
+      set_parameter("clear",       g_config.get_control_param("clear"));
+      set_parameter("clear_watermark",
+		    g_config.get_control_param("clear_watermark"));
 
       Unpacker::set_esc(m_is_esc_on);
+      Unpacker::set_clear_mode(m_keep_capacity, m_clear_watermark);
       Unpacker::set_check_mode(std::bitset<defines::k_n_check_mode>
 			       (g_config.get_control_param("error_check")),
 			       g_config.get_control_param("char_true"),
@@ -1293,6 +1456,13 @@ UnpackerManager::set_parameter(const std::string& name,
   }else if (name=="fifo_length"){
     m_fifo.resize(a2i(value));
     m_fifo.initialize();
+  }else if (name=="clear"){
+    // "keep": the data vectors keep their capacity from event to event
+    m_keep_capacity = (value.find("keep")!=std::string::npos);
+  }else if (name=="clear_watermark"){
+    m_clear_watermark = a2i(value);
+    if (m_clear_watermark < 0)
+      m_clear_watermark = 0;
   }
 
 
@@ -22,6 +22,24 @@ namespace hddaq
     };
 
 
+  // empties arg but keeps its storage for the next event; a vector which
+  // grew beyond watermark elements is cut back to it (0: never)
+  template <typename STLVector>
+  void
+  clear_retain(STLVector& arg,
+	       typename STLVector::size_type watermark = 0)
+  {
+    if (watermark > 0 && arg.capacity() > watermark)
+      {
+	STLVector tmp;
+	tmp.reserve(watermark);
+	tmp.swap(arg);
+      }
+    else
+      arg.clear();
+    return;
+  };
+
   template <typename STLContainer>
   void
   clear(typename STLContainer::iterator& arg)
@@ -61,6 +61,7 @@ namespace hddaq
       UnpackerConfig();
       void read_control(xml::DOMElement* control_root);
       void read_elec(const std::string& filename);
+      void set_ostream() const;
 
     };
 
@@ -0,0 +1,153 @@
+// -*- C++ -*-
+
+#ifndef HDDAQ__UNPACKER_CONFIG_CACHE_H
+#define HDDAQ__UNPACKER_CONFIG_CACHE_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Uncopyable.hh"
+#include "UnpackerXMLReadDigit.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+  // Compiled form of the unpacker XML configuration, so that
+  // UnpackerConfig::initialize() can skip the xerces DOM on later starts.
+  //
+  // It holds everything the XML readers resolve:
+  //   - the <control> parameters and run ranges of UnpackerConfig
+  //   - the name -> index maps of UnpackerXMLReadDigit (device, plane,
+  //     segment, ch, data) and the device types
+  //   - the <front_end> tree of UnpackerXMLChannelMap as a list of
+  //     operations (create a front-end with its resolved attributes,
+  //     map an fe channel to a digit, close the front-end), replayed in
+  //     the same order as the DOM walk
+  //
+  // The file is
+  //   Header
+  //   payload: the XML files read, then the sections above
+  // and is mapped read-only when loaded. The header carries a hash of
+  // the XML files (names and contents) and of the file arguments; the
+  // cache is used only when the hash matches the files on disk now.
+  class UnpackerConfigCache
+    : private Uncopyable<UnpackerConfigCache>
+  {
+
+  public:
+    static const uint32_t k_version = 1;
+
+    struct Header
+    {
+      char     m_magic[8];
+      uint32_t m_version;
+      uint32_t m_reserved;
+      uint64_t m_hash;          // of the XML inputs
+      uint64_t m_payload_size;
+      uint64_t m_checksum;      // of the payload
+    };
+
+    typedef std::vector<std::string> AttrList;
+
+    // one step of the <front_end> tree
+    struct FrontEndOp
+    {
+      enum e_op
+	{
+	  k_begin,   // tag, names, values
+	  k_end,
+	  k_channel  // index
+	};
+      enum e_index
+	{
+	  k_fe_ch,
+	  k_fe_data,
+	  k_device,
+	  k_plane,
+	  k_segment,
+	  k_ch,
+	  k_data,
+	  k_n_index
+	};
+      int         m_op;
+      std::string m_tag;
+      AttrList    m_names;
+      AttrList    m_values;
+      int         m_index[k_n_index];
+    };
+    typedef std::vector<FrontEndOp> FrontEndOpList;
+
+  private:
+    typedef UnpackerXMLReadDigit Digit;
+
+    std::vector<std::string>           m_input;
+    std::map<std::string, std::string> m_control;
+    std::vector<std::pair<int, int> >  m_run_range;
+    std::string                        m_digit_tag;
+    Digit::Ref                         m_device_ref;
+    Digit::PlaneRef                    m_plane_ref;
+    Digit::SegmentRef                  m_segment_ref;
+    Digit::ChRef                       m_ch_ref;
+    Digit::DataRef                     m_data_ref;
+    Digit::TypeList                    m_device_types;
+    int                                m_null_device_id;
+    std::string                        m_dump;
+    FrontEndOpList                     m_front_end;
+
+  public:
+     UnpackerConfigCache();
+    ~UnpackerConfigCache();
+
+    // "" when the cache is disabled (UNPACKER_CONFIG_CACHE=off)
+    static std::string get_cache_name(const std::string& config_file);
+
+    void add_input(const std::string& file_name);
+    bool load(const std::string& cache_name,
+	      const std::string& config_file,
+	      const std::string& digit_file,
+	      const std::string& channel_map_file);
+    bool save(const std::string& cache_name,
+	      const std::string& config_file,
+	      const std::string& digit_file,
+	      const std::string& channel_map_file) const;
+
+    // UnpackerConfig
+    const std::map<std::string, std::string>& get_control() const;
+    const std::vector<std::pair<int, int> >&  get_run_range() const;
+    void set_control(const std::map<std::string, std::string>& control,
+		     const std::vector<std::pair<int, int> >& run_range);
+
+    // UnpackerXMLReadDigit
+    void restore_digit(UnpackerXMLReadDigit& digit) const;
+    void store_digit(const UnpackerXMLReadDigit& digit);
+
+    // UnpackerXMLChannelMap
+    const std::string&    get_dump() const;
+    const FrontEndOpList& get_front_end() const;
+    void begin_front_end(const std::string& tag,
+			 const AttrList& names,
+			 const AttrList& values);
+    void end_front_end();
+    void add_channel(int fe_ch, int fe_data,
+		     int device_id, int plane_id, int segment_id,
+		     int ch_id, int data_id);
+    void set_dump(const std::string& dump);
+
+  private:
+    static bool make_hash(const std::vector<std::string>& input,
+			  const std::string& config_file,
+			  const std::string& digit_file,
+			  const std::string& channel_map_file,
+			  uint64_t& hash);
+    bool read_payload(const char* p, const char* end);
+    void write_payload(std::string& buf) const;
+
+  };
+
+  }
+}
+#endif
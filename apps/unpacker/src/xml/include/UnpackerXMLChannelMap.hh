@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 #include <list>
+#include <vector>
 
 #include "xml_helper.hh"
 
@@ -22,6 +23,7 @@ namespace hddaq
   {
     
     class Unpacker;
+    class UnpackerConfigCache;
 
     class UnpackerXMLChannelMap
       : public xml::XMLRead,
@@ -38,12 +40,17 @@ namespace hddaq
      private:
        std::list<Unpacker*>  m_unpacker_list;
        DigitList& m_digit_list;
+       UnpackerConfigCache* m_cache; // records the front-ends if not 0
 
        NameList  m_felist_id2name;
        IndexList m_felist_name2id;
 
      public:
        UnpackerXMLChannelMap(DOMElement* e,
+			     DigitList& digit_list,
+			     UnpackerConfigCache* cache=0);
+       // replays the front-ends recorded in the cache
+       UnpackerXMLChannelMap(const UnpackerConfigCache& cache,
 			     DigitList& digit_list);
        ~UnpackerXMLChannelMap();
        
@@ -55,6 +62,12 @@ namespace hddaq
        virtual void generate_content(DOMElement* e);
        virtual void read(DOMElement* e);
        virtual void read_front_end(DOMElement* e);
+
+     private:
+       void create_front_end(const std::string& tag,
+			     const std::vector<std::string>& names,
+			     const std::vector<std::string>& values);
+       void set_global_mode(const std::string& value);
       
     };
 
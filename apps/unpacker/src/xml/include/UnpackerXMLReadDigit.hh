@@ -22,6 +22,8 @@ namespace hddaq
 namespace unpacker
 {
 
+class UnpackerConfigCache;
+
 class UnpackerXMLReadDigit
   : public xml::XMLRead,
     private Uncopyable<UnpackerXMLReadDigit>
@@ -76,6 +78,8 @@ private:
 public:
   UnpackerXMLReadDigit(DOMElement* e,
                        DigitList& digit_list);
+  UnpackerXMLReadDigit(const UnpackerConfigCache& cache,
+                       DigitList& digit_list);
   virtual ~UnpackerXMLReadDigit();
 
   const std::string& get_device_type(int device_id) const;
@@ -129,6 +133,8 @@ protected:
   virtual void read(DOMElement* e);
 
 private:
+  friend class UnpackerConfigCache;
+  void build();
   void read_device_digit(DOMElement* e);
   void read_plane_digit(DOMElement* e);
   void read_segment_digit(DOMElement* e);
@@ -11,6 +11,7 @@
 #include <sstream>
 
 #include "std_ostream.hh"
+#include "UnpackerConfigCache.hh"
 #include "UnpackerXMLErrorHandler.hh"
 #include "UnpackerXMLReadDigit.hh"
 #include "UnpackerXMLChannelMap.hh"
@@ -105,6 +106,23 @@ UnpackerConfig::initialize(DigitList& digit_list,
 			   const std::string& digit_file,
 			   const std::string& channel_map_file)
 {
+  // the compiled XML of an earlier start, if the XML files are unchanged
+  const std::string cache_name
+    = UnpackerConfigCache::get_cache_name(config_file);
+  UnpackerConfigCache cache;
+  if (!cache_name.empty()
+      && cache.load(cache_name, config_file, digit_file, channel_map_file))
+    {
+      cout << "#D UnpackerConfig::initialize()\n"
+	   << " load " << cache_name << std::endl;
+      m_control   = cache.get_control();
+      m_run_range = cache.get_run_range();
+      set_ostream();
+      m_digit       = new DigitInfo(cache, digit_list);
+      m_channel_map = new ChannelMap(cache, digit_list);
+      return;
+    }
+
   m_parser = new xml::DOMParser;
   UnpackerXMLErrorHandler err_handler;
   const bool is_validation_required = true;
@@ -112,6 +130,7 @@ UnpackerConfig::initialize(DigitList& digit_list,
     =  xml::initialize_parser(*m_parser, err_handler, config_file,
 			      "UnpackerConfig::initialize("+config_file+")",
 			      is_validation_required);
+  cache.add_input(config_file);
 
   xml::DOMElementList children;
   xml::get_children(root, children);
@@ -150,7 +169,7 @@ UnpackerConfig::initialize(DigitList& digit_list,
 // 	       || (filename.find("channle_map")!=std::string::npos))
 	{
 	  if (filename.empty())
-	    m_channel_map = new ChannelMap(e, digit_list);
+	    m_channel_map = new ChannelMap(e, digit_list, &cache);
 	  else
 	    cfile = filename;
 	}
@@ -164,6 +183,7 @@ UnpackerConfig::initialize(DigitList& digit_list,
 	= xml::initialize_parser(parser, err_handler, dfile,
 				 "UnpackerConfig::initialize("+dfile+")",
 				 is_validation_required);
+      cache.add_input(dfile);
       //      cout << " init digit" << std::endl;
       if (!m_digit){
 	m_digit = new DigitInfo(e, digit_list);      
@@ -177,12 +197,25 @@ UnpackerConfig::initialize(DigitList& digit_list,
 	= xml::initialize_parser(parser, err_handler, cfile,
 				 "UnpackerConfig::initialize(" + cfile +")",
 				 is_validation_required);
+      cache.add_input(cfile);
 
       //      cout << " init frontend" << std::endl;
       if (!m_channel_map){
-	m_channel_map = new ChannelMap(e,  digit_list);
+	m_channel_map = new ChannelMap(e,  digit_list, &cache);
       }
     }
+
+  if (!cache_name.empty() && m_digit && m_channel_map)
+    {
+      cache.set_control(m_control, m_run_range);
+      cache.store_digit(*m_digit);
+      if (cache.save(cache_name, config_file, digit_file, channel_map_file))
+	cout << "#D UnpackerConfig::initialize()\n"
+	     << " write " << cache_name << std::endl;
+      else
+	cerr << "#W UnpackerConfig::initialize()\n"
+	     << " cannot write " << cache_name << std::endl;
+    }
   return;
 }
 
@@ -306,20 +339,17 @@ UnpackerConfig::read_control(xml::DOMElement* control_root)
     }
 
   const std::string& cout_name = m_control["cout"];
-  set_cout(cout_name);
-  cout << "   cout = " << cout_name << "\n";
   const std::string& cerr_name = m_control["cerr"];
-  cout << "   cerr = " << cerr_name << "\n";
-  set_cerr(cerr_name);
-
   std::string& tag_summary_name = m_control["tag_summary"];
   if (tag_summary_name.empty())
     tag_summary_name = m_control["tout"];
   if (tag_summary_name.empty())
     tag_summary_name = m_control["tag"];
 
+  set_ostream();
+  cout << "   cout = " << cout_name << "\n";
+  cout << "   cerr = " << cerr_name << "\n";
   cout << "   tag_summary = " << tag_summary_name << "\n";
-  set_tag_summary(tag_summary_name);
 
   cout << std::endl;
 
@@ -329,6 +359,21 @@ UnpackerConfig::read_control(xml::DOMElement* control_root)
   return;
 }
 
+//______________________________________________________________________________
+// redirects cout, cerr and tag_summary as given in <control>
+void
+UnpackerConfig::set_ostream() const
+{
+  std::map<std::string, std::string>::const_iterator i;
+  if ((i = m_control.find("cout"))!=m_control.end())
+    set_cout(i->second);
+  if ((i = m_control.find("cerr"))!=m_control.end())
+    set_cerr(i->second);
+  if ((i = m_control.find("tag_summary"))!=m_control.end())
+    set_tag_summary(i->second);
+  return;
+}
+
 }
 }
 
@@ -0,0 +1,589 @@
+// -*- C++ -*-
+
+#include "UnpackerConfigCache.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "std_ostream.hh"
+
+namespace hddaq
+{
+  namespace unpacker
+  {
+
+  namespace
+  {
+    const char     k_magic[8]   = { 'H', 'D', 'U', 'C', 'O', 'N', 'F', 0 };
+    const uint64_t k_fnv_offset = 14695981039346656037ULL;
+    const uint64_t k_fnv_prime  = 1099511628211ULL;
+
+    typedef UnpackerConfigCache::FrontEndOp FrontEndOp;
+
+    //__________________________________________________________________________
+    // FNV-1a
+    uint64_t
+    hash_bytes(const char* p, std::size_t n, uint64_t h)
+    {
+      for (std::size_t i=0; i<n; ++i)
+	{
+	  h ^= static_cast<unsigned char>(p[i]);
+	  h *= k_fnv_prime;
+	}
+      return h;
+    }
+
+    //__________________________________________________________________________
+    uint64_t
+    hash_string(const std::string& s, uint64_t h)
+    {
+      // the terminating null separates the fields
+      return hash_bytes(s.c_str(), s.size()+1, h);
+    }
+
+    //__________________________________________________________________________
+    // payload encoding: native 32-bit integers, strings and containers
+    // as their size followed by the elements
+    void
+    put(std::string& buf, uint32_t v)
+    {
+      buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    void
+    put(std::string& buf, int v)
+    {
+      put(buf, static_cast<uint32_t>(v));
+    }
+
+    void
+    put(std::string& buf, const std::string& s)
+    {
+      put(buf, static_cast<uint32_t>(s.size()));
+      buf.append(s);
+    }
+
+    void put(std::string& buf, const FrontEndOp& op);
+    template <typename A, typename B>
+    void put(std::string& buf, const std::pair<A, B>& p);
+    template <typename K, typename V>
+    void put(std::string& buf, const std::map<K, V>& m);
+    template <typename T>
+    void put(std::string& buf, const std::vector<T>& v);
+
+    template <typename A, typename B>
+    void
+    put(std::string& buf, const std::pair<A, B>& p)
+    {
+      put(buf, p.first);
+      put(buf, p.second);
+    }
+
+    template <typename K, typename V>
+    void
+    put(std::string& buf, const std::map<K, V>& m)
+    {
+      put(buf, static_cast<uint32_t>(m.size()));
+      for (typename std::map<K, V>::const_iterator i=m.begin();
+	   i!=m.end(); ++i)
+	put(buf, *i);
+    }
+
+    template <typename T>
+    void
+    put(std::string& buf, const std::vector<T>& v)
+    {
+      put(buf, static_cast<uint32_t>(v.size()));
+      for (typename std::vector<T>::const_iterator i=v.begin();
+	   i!=v.end(); ++i)
+	put(buf, *i);
+    }
+
+    void
+    put(std::string& buf, const FrontEndOp& op)
+    {
+      put(buf, op.m_op);
+      if (op.m_op==FrontEndOp::k_begin)
+	{
+	  put(buf, op.m_tag);
+	  put(buf, op.m_names);
+	  put(buf, op.m_values);
+	}
+      else if (op.m_op==FrontEndOp::k_channel)
+	{
+	  for (int i=0; i<FrontEndOp::k_n_index; ++i)
+	    put(buf, op.m_index[i]);
+	}
+      return;
+    }
+
+    //__________________________________________________________________________
+    // decoding of the mapped payload, every read is checked against the end
+    class Reader
+    {
+    private:
+      const char* m_p;
+      const char* m_end;
+
+    public:
+      Reader(const char* p, const char* end)
+	: m_p(p), m_end(end)
+      {}
+
+      bool at_end() const { return m_p==m_end; }
+
+      bool
+      get(uint32_t& v)
+      {
+	if (static_cast<std::size_t>(m_end-m_p)<sizeof(v))
+	  return false;
+	std::memcpy(&v, m_p, sizeof(v));
+	m_p += sizeof(v);
+	return true;
+      }
+
+      bool
+      get(int& v)
+      {
+	uint32_t u;
+	if (!get(u))
+	  return false;
+	v = static_cast<int>(u);
+	return true;
+      }
+
+      bool
+      get(std::string& s)
+      {
+	uint32_t n;
+	if (!get(n) || static_cast<std::size_t>(m_end-m_p)<n)
+	  return false;
+	s.assign(m_p, n);
+	m_p += n;
+	return true;
+      }
+
+      bool get(FrontEndOp& op);
+
+      template <typename A, typename B>
+      bool
+      get(std::pair<A, B>& p)
+      {
+	return get(p.first) && get(p.second);
+      }
+
+      template <typename K, typename V>
+      bool
+      get(std::map<K, V>& m)
+      {
+	uint32_t n;
+	if (!get_size(n))
+	  return false;
+	m.clear();
+	for (uint32_t i=0; i<n; ++i)
+	  {
+	    std::pair<K, V> p;
+	    if (!get(p))
+	      return false;
+	    m.insert(m.end(), p);
+	  }
+	return true;
+      }
+
+      template <typename T>
+      bool
+      get(std::vector<T>& v)
+      {
+	uint32_t n;
+	if (!get_size(n))
+	  return false;
+	v.resize(n);
+	for (uint32_t i=0; i<n; ++i)
+	  if (!get(v[i]))
+	    return false;
+	return true;
+      }
+
+    private:
+      // every element takes at least 4 bytes
+      bool
+      get_size(uint32_t& n)
+      {
+	return get(n) && n<=static_cast<std::size_t>(m_end-m_p)/sizeof(n);
+      }
+    };
+
+    bool
+    Reader::get(FrontEndOp& op)
+    {
+      if (!get(op.m_op))
+	return false;
+      if (op.m_op==FrontEndOp::k_begin)
+	return get(op.m_tag) && get(op.m_names) && get(op.m_values);
+      if (op.m_op==FrontEndOp::k_channel)
+	{
+	  for (int i=0; i<FrontEndOp::k_n_index; ++i)
+	    if (!get(op.m_index[i]))
+	      return false;
+	  return true;
+	}
+      return op.m_op==FrontEndOp::k_end;
+    }
+
+  }
+
+//______________________________________________________________________________
+UnpackerConfigCache::UnpackerConfigCache()
+  : m_input(),
+    m_control(),
+    m_run_range(),
+    m_digit_tag(),
+    m_device_ref(),
+    m_plane_ref(),
+    m_segment_ref(),
+    m_ch_ref(),
+    m_data_ref(),
+    m_device_types(),
+    m_null_device_id(-1),
+    m_dump(),
+    m_front_end()
+{
+}
+
+//______________________________________________________________________________
+UnpackerConfigCache::~UnpackerConfigCache()
+{
+}
+
+//______________________________________________________________________________
+std::string
+UnpackerConfigCache::get_cache_name(const std::string& config_file)
+{
+  const char* env = std::getenv("UNPACKER_CONFIG_CACHE");
+  const std::string dir = env ? env : "";
+  if (config_file.empty() || dir=="off" || dir=="0" || dir=="no")
+    return "";
+
+  // next to the config file by default
+  if (dir.empty())
+    return config_file + ".cache";
+
+  // a directory shared by several configs: file name + hash of the path
+  std::ostringstream name;
+  name << dir << "/"
+       << config_file.substr(config_file.rfind('/')+1) << "."
+       << std::hex << hash_string(config_file, k_fnv_offset)
+       << ".cache";
+  return name.str();
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::add_input(const std::string& file_name)
+{
+  m_input.push_back(file_name);
+  return;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::add_channel(int fe_ch, int fe_data,
+				 int device_id, int plane_id, int segment_id,
+				 int ch_id, int data_id)
+{
+  FrontEndOp op;
+  op.m_op = FrontEndOp::k_channel;
+  op.m_index[FrontEndOp::k_fe_ch]   = fe_ch;
+  op.m_index[FrontEndOp::k_fe_data] = fe_data;
+  op.m_index[FrontEndOp::k_device]  = device_id;
+  op.m_index[FrontEndOp::k_plane]   = plane_id;
+  op.m_index[FrontEndOp::k_segment] = segment_id;
+  op.m_index[FrontEndOp::k_ch]      = ch_id;
+  op.m_index[FrontEndOp::k_data]    = data_id;
+  m_front_end.push_back(op);
+  return;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::begin_front_end(const std::string& tag,
+				     const AttrList& names,
+				     const AttrList& values)
+{
+  m_front_end.push_back(FrontEndOp());
+  FrontEndOp& op = m_front_end.back();
+  op.m_op     = FrontEndOp::k_begin;
+  op.m_tag    = tag;
+  op.m_names  = names;
+  op.m_values = values;
+  return;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::end_front_end()
+{
+  FrontEndOp op;
+  op.m_op = FrontEndOp::k_end;
+  m_front_end.push_back(op);
+  return;
+}
+
+//______________________________________________________________________________
+const std::map<std::string, std::string>&
+UnpackerConfigCache::get_control() const
+{
+  return m_control;
+}
+
+//______________________________________________________________________________
+const std::string&
+UnpackerConfigCache::get_dump() const
+{
+  return m_dump;
+}
+
+//______________________________________________________________________________
+const UnpackerConfigCache::FrontEndOpList&
+UnpackerConfigCache::get_front_end() const
+{
+  return m_front_end;
+}
+
+//______________________________________________________________________________
+const std::vector<std::pair<int, int> >&
+UnpackerConfigCache::get_run_range() const
+{
+  return m_run_range;
+}
+
+//______________________________________________________________________________
+bool
+UnpackerConfigCache::load(const std::string& cache_name,
+			  const std::string& config_file,
+			  const std::string& digit_file,
+			  const std::string& channel_map_file)
+{
+  const int fd = ::open(cache_name.c_str(), O_RDONLY);
+  if (fd<0)
+    return false;
+
+  struct stat st;
+  if (::fstat(fd, &st)!=0
+      || static_cast<std::size_t>(st.st_size)<sizeof(Header))
+    {
+      ::close(fd);
+      return false;
+    }
+
+  const std::size_t size = st.st_size;
+  void* addr = ::mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr==MAP_FAILED)
+    return false;
+
+  const char* base = static_cast<const char*>(addr);
+  const char* payload = base + sizeof(Header);
+  Header header;
+  std::memcpy(&header, base, sizeof(header));
+
+  uint64_t hash = 0;
+  bool ok = (std::memcmp(header.m_magic, k_magic, sizeof(k_magic))==0
+	     && header.m_version==k_version
+	     && header.m_payload_size==size-sizeof(Header)
+	     && header.m_checksum
+	     ==hash_bytes(payload, header.m_payload_size, k_fnv_offset)
+	     && read_payload(payload, base+size)
+	     && make_hash(m_input, config_file, digit_file, channel_map_file,
+			  hash)
+	     && hash==header.m_hash);
+  ::munmap(addr, size);
+
+  if (!ok)
+    {
+      m_input.clear();
+      m_control.clear();
+      m_run_range.clear();
+      m_digit_tag.clear();
+      m_device_ref.clear();
+      m_plane_ref.clear();
+      m_segment_ref.clear();
+      m_ch_ref.clear();
+      m_data_ref.clear();
+      m_device_types.clear();
+      m_null_device_id = -1;
+      m_dump.clear();
+      m_front_end.clear();
+    }
+  return ok;
+}
+
+//______________________________________________________________________________
+bool
+UnpackerConfigCache::make_hash(const std::vector<std::string>& input,
+			       const std::string& config_file,
+			       const std::string& digit_file,
+			       const std::string& channel_map_file,
+			       uint64_t& hash)
+{
+  const uint32_t version = k_version;
+  uint64_t h = k_fnv_offset;
+  h = hash_bytes(reinterpret_cast<const char*>(&version), sizeof(version), h);
+  h = hash_string(config_file, h);
+  h = hash_string(digit_file, h);
+  h = hash_string(channel_map_file, h);
+  for (std::vector<std::string>::const_iterator i=input.begin();
+       i!=input.end(); ++i)
+    {
+      std::ifstream ifs(i->c_str(), std::ios::binary);
+      if (!ifs.is_open())
+	return false;
+      const std::string contents((std::istreambuf_iterator<char>(ifs)),
+				 std::istreambuf_iterator<char>());
+      h = hash_string(*i, h);
+      h = hash_string(contents, h);
+    }
+  hash = h;
+  return true;
+}
+
+//______________________________________________________________________________
+bool
+UnpackerConfigCache::read_payload(const char* p, const char* end)
+{
+  Reader r(p, end);
+  return (r.get(m_input)
+	  && r.get(m_control)
+	  && r.get(m_run_range)
+	  && r.get(m_digit_tag)
+	  && r.get(m_device_ref)
+	  && r.get(m_plane_ref)
+	  && r.get(m_segment_ref)
+	  && r.get(m_ch_ref)
+	  && r.get(m_data_ref)
+	  && r.get(m_device_types)
+	  && r.get(m_null_device_id)
+	  && r.get(m_dump)
+	  && r.get(m_front_end)
+	  && r.at_end());
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::restore_digit(UnpackerXMLReadDigit& digit) const
+{
+  digit.m_tag            = m_digit_tag;
+  digit.m_device_ref     = m_device_ref;
+  digit.m_plane_ref      = m_plane_ref;
+  digit.m_segment_ref    = m_segment_ref;
+  digit.m_ch_ref         = m_ch_ref;
+  digit.m_data_ref       = m_data_ref;
+  digit.m_device_types   = m_device_types;
+  digit.m_null_device_id = m_null_device_id;
+  return;
+}
+
+//______________________________________________________________________________
+bool
+UnpackerConfigCache::save(const std::string& cache_name,
+			  const std::string& config_file,
+			  const std::string& digit_file,
+			  const std::string& channel_map_file) const
+{
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  if (!make_hash(m_input, config_file, digit_file, channel_map_file,
+		 header.m_hash))
+    return false;
+
+  std::string payload;
+  write_payload(payload);
+  std::memcpy(header.m_magic, k_magic, sizeof(k_magic));
+  header.m_version      = k_version;
+  header.m_payload_size = payload.size();
+  header.m_checksum     = hash_bytes(payload.data(), payload.size(),
+				     k_fnv_offset);
+
+  // written aside and renamed, a reader never sees a partial file
+  std::ostringstream tmp_name;
+  tmp_name << cache_name << ".tmp." << ::getpid();
+  std::ofstream ofs(tmp_name.str().c_str(),
+		    std::ios::binary | std::ios::trunc);
+  ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  ofs.write(payload.data(), payload.size());
+  ofs.close();
+  if (!ofs
+      || std::rename(tmp_name.str().c_str(), cache_name.c_str())!=0)
+    {
+      std::remove(tmp_name.str().c_str());
+      return false;
+    }
+  return true;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::set_control(const std::map<std::string,
+				                 std::string>& control,
+				 const std::vector<std::pair<int, int> >&
+				 run_range)
+{
+  m_control   = control;
+  m_run_range = run_range;
+  return;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::set_dump(const std::string& dump)
+{
+  m_dump = dump;
+  return;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::store_digit(const UnpackerXMLReadDigit& digit)
+{
+  m_digit_tag      = digit.m_tag;
+  m_device_ref     = digit.m_device_ref;
+  m_plane_ref      = digit.m_plane_ref;
+  m_segment_ref    = digit.m_segment_ref;
+  m_ch_ref         = digit.m_ch_ref;
+  m_data_ref       = digit.m_data_ref;
+  m_device_types   = digit.m_device_types;
+  m_null_device_id = digit.m_null_device_id;
+  return;
+}
+
+//______________________________________________________________________________
+void
+UnpackerConfigCache::write_payload(std::string& buf) const
+{
+  put(buf, m_input);
+  put(buf, m_control);
+  put(buf, m_run_range);
+  put(buf, m_digit_tag);
+  put(buf, m_device_ref);
+  put(buf, m_plane_ref);
+  put(buf, m_segment_ref);
+  put(buf, m_ch_ref);
+  put(buf, m_data_ref);
+  put(buf, m_device_types);
+  put(buf, m_null_device_id);
+  put(buf, m_dump);
+  put(buf, m_front_end);
+  return;
+}
+
+  }
+}
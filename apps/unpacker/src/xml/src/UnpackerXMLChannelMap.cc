@@ -15,6 +15,7 @@
 #include "Evaluator.hh"
 #include "UnpackerManager.hh"
 #include "UnpackerConfig.hh"
+#include "UnpackerConfigCache.hh"
 #include "UnpackerXMLReadDigit.hh"
 #include "Unpacker.hh"
 #include "replace_string.hh"
@@ -70,34 +71,18 @@ print(int idevice,
     } // end of anonymous namespace
 //______________________________________________________________________________
 UnpackerXMLChannelMap::UnpackerXMLChannelMap(DOMElement* e,
-					     DigitList& digit_list)
+					     DigitList& digit_list,
+					     UnpackerConfigCache* cache)
   : XMLRead(e),
     m_unpacker_list(),
-    m_digit_list(digit_list)
+    m_digit_list(digit_list),
+    m_cache(cache)
 {
-  UnpackerConfig& g_config = GConfig::get_instance();
-  const UnpackerConfig::DigitInfo& digit_info = g_config.get_digit_info();
-  Unpacker::set_null_device_id(digit_info.get_null_device_id());
-
   const std::string& value    = xml::get_attribute(e, "dump");
-  UnpackerManager& g_unpacker = GUnpacker::get_instance();
   const std::string& tag = xml::get_tag_name(e);
-  if (false
-      || value.find("y")==0
-      || value.find("Y")==0
-      || value.find("h")==0
-      || value.find("H")==0
-      || value.find("x")!=std::string::npos
-      || value.find("X")!=std::string::npos)
-    g_unpacker.set_dump_mode(defines::k_hex);
-  else if (false
-	   || value.find("d")==0
-	   || value.find("D")==0)
-    g_unpacker.set_dump_mode(defines::k_dec);
-  else if (false
-	   || value.find("b")==0
-	   || value.find("B")==0)
-    g_unpacker.set_dump_mode(defines::k_binary);
+  set_global_mode(value);
+  if (m_cache)
+    m_cache->set_dump(value);
 
   cout << "#D UnpackerXMLChannelMap::UnpackerXMLChannelMap()" << std::endl;
   try
@@ -115,6 +100,51 @@ UnpackerXMLChannelMap::UnpackerXMLChannelMap(DOMElement* e,
   cout << "\n#D UnpackerXMLChannelMap constructor  finished" << std::endl;
 }
 
+//______________________________________________________________________________
+UnpackerXMLChannelMap::UnpackerXMLChannelMap(const UnpackerConfigCache& cache,
+					     DigitList& digit_list)
+  : XMLRead(0),
+    m_unpacker_list(),
+    m_digit_list(digit_list),
+    m_cache(0)
+{
+  typedef UnpackerConfigCache::FrontEndOp     FrontEndOp;
+  typedef UnpackerConfigCache::FrontEndOpList FrontEndOpList;
+
+  set_global_mode(cache.get_dump());
+  cout << "#D UnpackerXMLChannelMap::UnpackerXMLChannelMap()\n"
+       << " front-ends from the config cache" << std::endl;
+
+  const FrontEndOpList& ops = cache.get_front_end();
+  for (FrontEndOpList::const_iterator i=ops.begin(); i!=ops.end(); ++i)
+    {
+      if (i->m_op==FrontEndOp::k_begin)
+	{
+	  create_front_end(i->m_tag, i->m_names, i->m_values);
+	}
+      else if (i->m_op==FrontEndOp::k_end)
+	{
+	  m_unpacker_list.pop_back();
+	}
+      else
+	{
+	  // the same calls succeeded when the cache was written
+	  const int* index = i->m_index;
+	  m_unpacker_list.back()
+	    ->add_channel_map(index[FrontEndOp::k_fe_ch],
+			      index[FrontEndOp::k_fe_data],
+			      m_digit_list,
+			      index[FrontEndOp::k_device],
+			      index[FrontEndOp::k_plane],
+			      index[FrontEndOp::k_segment],
+			      index[FrontEndOp::k_ch],
+			      index[FrontEndOp::k_data]);
+	}
+    }
+
+  cout << "#D UnpackerXMLChannelMap constructor  finished" << std::endl;
+}
+
 //______________________________________________________________________________
 UnpackerXMLChannelMap::~UnpackerXMLChannelMap()
 {
@@ -408,6 +438,9 @@ for (int i=0; i<n_attr_fe; ++i)
 			 isegment,
 			 ich,
 			 idata);
+      if (m_cache)
+	m_cache->add_channel(fe_ch, fe_data,
+			     idevice, iplane, isegment, ich, idata);
     }
   catch (const std::out_of_range& e)
     {
@@ -483,12 +516,6 @@ void
 UnpackerXMLChannelMap::read_front_end(DOMElement* e)
 {
   const std::string& tag = xml::get_tag_name(e);
-  UnpackerManager& g_unpacker = GUnpacker::get_instance();
-  Unpacker* parent = 0;
-  if (!m_unpacker_list.empty()) parent = m_unpacker_list.back();
-//   if (parent){
-//     cout << "#D parant = " << parent->get_name() << std::endl;
-//}
 
   std::vector<std::string> names;
   std::vector<std::string> values;
@@ -497,14 +524,39 @@ UnpackerXMLChannelMap::read_front_end(DOMElement* e)
 
   //cout << "tag : " << tag << "\n";
 
-  Unpacker* u = g_unpacker.create(tag);
-
   if (0<m_loop_depth)
     {
       for (int i=0; i<n; ++i) replace_loop_variables(values[i]);
       for (int i=0; i<n; ++i) xml::evaluate_attribute(values[i]);
     }
 
+  create_front_end(tag, names, values);
+  if (m_cache)
+    m_cache->begin_front_end(tag, names, values);
+  read(e);
+  m_unpacker_list.pop_back();
+  if (m_cache)
+    m_cache->end_front_end();
+  return;
+}
+
+//______________________________________________________________________________
+// creates the unpacker of a front-end from its (resolved) attributes
+void
+UnpackerXMLChannelMap::create_front_end(const std::string& tag,
+					const std::vector<std::string>& names,
+					const std::vector<std::string>& values)
+{
+  UnpackerManager& g_unpacker = GUnpacker::get_instance();
+  Unpacker* parent = 0;
+  if (!m_unpacker_list.empty()) parent = m_unpacker_list.back();
+//   if (parent){
+//     cout << "#D parant = " << parent->get_name() << std::endl;
+//}
+
+  const int n = names.size();
+  Unpacker* u = g_unpacker.create(tag);
+
   for (int i=0; i<n; ++i)
     {
       const std::string& name  = names[i];
@@ -584,8 +636,35 @@ UnpackerXMLChannelMap::read_front_end(DOMElement* e)
   u->resize_fe_data();
   m_unpacker_list.push_back(u);
 //   std::cout << "#D create unpacker  " << u->get_name() << std::endl;
-  read(e);
-  m_unpacker_list.pop_back();
+  return;
+}
+
+//______________________________________________________________________________
+// null device and dump mode of the manager, <front_end dump="...">
+void
+UnpackerXMLChannelMap::set_global_mode(const std::string& value)
+{
+  UnpackerConfig& g_config = GConfig::get_instance();
+  const UnpackerConfig::DigitInfo& digit_info = g_config.get_digit_info();
+  Unpacker::set_null_device_id(digit_info.get_null_device_id());
+
+  UnpackerManager& g_unpacker = GUnpacker::get_instance();
+  if (false
+      || value.find("y")==0
+      || value.find("Y")==0
+      || value.find("h")==0
+      || value.find("H")==0
+      || value.find("x")!=std::string::npos
+      || value.find("X")!=std::string::npos)
+    g_unpacker.set_dump_mode(defines::k_hex);
+  else if (false
+	   || value.find("d")==0
+	   || value.find("D")==0)
+    g_unpacker.set_dump_mode(defines::k_dec);
+  else if (false
+	   || value.find("b")==0
+	   || value.find("B")==0)
+    g_unpacker.set_dump_mode(defines::k_binary);
   return;
 }
 
@@ -12,6 +12,7 @@
 #include "replace_string.hh"
 #include "lexical_cast.hh"
 #include "func_name.hh"
+#include "UnpackerConfigCache.hh"
 
 namespace hddaq
 {
@@ -68,7 +69,42 @@ UnpackerXMLReadDigit::UnpackerXMLReadDigit(DOMElement* e,
          << std::endl;
   }
 
+  build();
+}
 
+//_____________________________________________________________________________
+UnpackerXMLReadDigit::UnpackerXMLReadDigit(const UnpackerConfigCache& cache,
+					   DigitList& digit_list)
+  : xml::XMLRead(0),
+    m_tag(),
+    m_digit_list(digit_list),
+    m_device_ref(),
+    m_plane_ref(),
+    m_segment_ref(),
+    m_ch_ref(),
+    m_data_ref(),
+    m_device_names(),
+    m_plane_names(),
+    m_segment_names(),
+    m_ch_names(),
+    m_data_names(),
+    m_device_id(0),
+    m_plane_id(0),
+    m_segment_id(0),
+    m_ch_id(0),
+    m_null_device_id(-1)
+{
+  cache.restore_digit(*this);
+  cout << "#D " << ks_class_name << "::" << ks_class_name << "()\n   "
+       << " <" << m_tag << "> from the config cache" << std::endl;
+  build();
+}
+
+//_____________________________________________________________________________
+// index -> name maps and the DigitList, from the name -> index maps
+void
+UnpackerXMLReadDigit::build()
+{
   // add default container when plane, segment, ch, or data are omitted
   for (DataRef::iterator i = m_data_ref.begin(); i != m_data_ref.end(); ++i)
   {
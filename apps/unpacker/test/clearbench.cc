@@ -0,0 +1,129 @@
+/*
+ *  clearbench: per-event clear of the unpacker data vectors
+ *
+ *  usage: clearbench [nevent] [nch] [max_sample] [watermark]
+ *
+ *  Replays what Unpacker::clear() and UnpackerImpl::fill() do to the
+ *  FrontEndData of a RAYRAW-like module every event: nch channels, each
+ *  with a waveform of up to max_sample words and a few TDC hits, cleared
+ *  before the next event by
+ *    free  hddaq::clear()        (capacity released, the default)
+ *    keep  hddaq::clear_retain() (capacity kept, <clear> keep)
+ *    keep  with watermark        (<clear_watermark>)
+ */
+
+#include <cstdlib>
+#include <sys/time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "Clear.hh"
+#include "defines.hh"
+
+using namespace hddaq::unpacker;
+
+namespace
+{
+  enum e_data_type { k_adc, k_leading, k_trailing, k_n_data_type };
+
+  double now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+  }
+
+  struct Module
+  {
+    std::vector<Data> storage;
+    FrontEndData      fe;
+
+    explicit Module(int nch)
+      : storage(nch * k_n_data_type), fe(nch)
+    {
+      for (int ch=0; ch<nch; ++ch)
+	for (int t=0; t<k_n_data_type; ++t)
+	  fe[ch].push_back(&storage[ch * k_n_data_type + t]);
+    }
+  };
+
+  // mode 0: free, 1: keep
+  double run(int mode, int nevent, int nch, int max_sample,
+	     Data::size_type watermark, unsigned long long& checksum)
+  {
+    Module m(nch);
+    unsigned int seed = 12345;
+    double t0 = now();
+    for (int ev=0; ev<nevent; ++ev) {
+      // Unpacker::clear()
+      for (int ch=0; ch<nch; ++ch)
+	for (int t=0; t<k_n_data_type; ++t) {
+	  Data& d = *m.fe[ch][t];
+	  if (mode == 0)
+	    hddaq::clear(d);
+	  else
+	    hddaq::clear_retain(d, watermark);
+	}
+      // UnpackerImpl::fill()
+      seed = seed * 1103515245u + 12345u;
+      int nsample = max_sample / 2 + (seed >> 16) % (max_sample / 2 + 1);
+      for (int ch=0; ch<nch; ++ch) {
+	Data& adc = *m.fe[ch][k_adc];
+	for (int i=0; i<nsample; ++i)
+	  adc.push_back((ch << 12) + (i & 0xfff));
+	int nhit = (seed >> (ch & 15)) & 3;
+	for (int i=0; i<nhit; ++i) {
+	  m.fe[ch][k_leading]->push_back(100 * i + ch);
+	  m.fe[ch][k_trailing]->push_back(100 * i + ch + 30);
+	}
+      }
+      checksum += m.fe[nch-1][k_adc]->back();
+    }
+    return now() - t0;
+  }
+
+  void print(const char* name, int nevent, double elapse, int nch,
+	     int max_sample)
+  {
+    std::cout << std::setw(22) << std::left << name << std::right
+	      << std::fixed << std::setprecision(3)
+	      << std::setw(8) << elapse << " s  "
+	      << std::setprecision(0) << std::setw(9) << nevent / elapse
+	      << " events/s  "
+	      << std::setprecision(1) << std::setw(6)
+	      << (1e9 * elapse / nevent / (nch * (max_sample * 3 / 4)))
+	      << " ns/sample" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int nevent     = argc > 1 ? std::atoi(argv[1]) : 20000;
+  int nch        = argc > 2 ? std::atoi(argv[2]) : 32;
+  int max_sample = argc > 3 ? std::atoi(argv[3]) : 2048;
+  int watermark  = argc > 4 ? std::atoi(argv[4]) : max_sample;
+  if (nch < 1) nch = 1;
+  if (max_sample < 2) max_sample = 2;
+
+  std::cout << nevent << " events, " << nch << " ch, "
+	    << max_sample / 2 << "-" << max_sample << " samples/ch"
+	    << std::endl;
+
+  unsigned long long sum[3] = { 0, 0, 0 };
+  double t_free = run(0, nevent, nch, max_sample, 0, sum[0]);
+  double t_keep = run(1, nevent, nch, max_sample, 0, sum[1]);
+  double t_wm   = run(1, nevent, nch, max_sample, watermark, sum[2]);
+
+  print("free (hddaq::clear)", nevent, t_free, nch, max_sample);
+  print("keep", nevent, t_keep, nch, max_sample);
+  std::ostringstream name;
+  name << "keep, watermark " << watermark;
+  print(name.str().c_str(), nevent, t_wm, nch, max_sample);
+  std::cout << "speed-up keep/free " << std::setprecision(2)
+	    << t_free / t_keep << std::endl;
+
+  return (sum[0] == sum[1] && sum[1] == sum[2]) ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+/*
+ *  configcache: round trip of the unpacker XML config cache
+ *
+ *  usage: configcache digit.xml [cache_file]
+ *
+ *  Reads the digit XML with xerces as UnpackerConfig::initialize() does,
+ *  stores the result and a few front-end steps in an UnpackerConfigCache,
+ *  writes and maps back the cache file, and checks that the digit built
+ *  from the cache answers every name lookup and digit shape as the XML
+ *  one. Then checks that a changed input or a damaged file is rejected.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "UnpackerConfigCache.hh"
+#include "UnpackerXMLErrorHandler.hh"
+#include "UnpackerXMLReadDigit.hh"
+#include "xml_helper.hh"
+
+using namespace hddaq::unpacker;
+
+namespace
+{
+  typedef UnpackerXMLReadDigit       DigitInfo;
+  typedef DigitInfo::NameList        NameList;
+  typedef UnpackerConfigCache::FrontEndOp     FrontEndOp;
+  typedef UnpackerConfigCache::FrontEndOpList FrontEndOpList;
+
+  int n_error = 0;
+
+  void check(bool ok, const std::string& what)
+  {
+    if (!ok)
+      {
+	std::cerr << "#E " << what << std::endl;
+	++n_error;
+      }
+  }
+
+  // every name of the XML digit resolves to the same index in the cached one
+  void compare(const DigitInfo& a, const DigitInfo& b,
+	       const DigitList& la, const DigitList& lb)
+  {
+    check(a.get_n_device()==b.get_n_device(), "n_device");
+    check(a.get_null_device_id()==b.get_null_device_id(), "null device");
+    check(la.size()==lb.size(), "digit list size");
+
+    const NameList& devices = a.get_name_list();
+    for (std::size_t d=0; d<devices.size(); ++d)
+      {
+	const int di = a.get_device_id(devices[d]);
+	check(di==b.get_device_id(devices[d]), "device " + devices[d]);
+	check(a.get_device_type(di)==b.get_device_type(di),
+	      "type " + devices[d]);
+	check(a.get_n_plane(di)==b.get_n_plane(di), "n_plane " + devices[d]);
+	const NameList& planes = a.get_name_list(di);
+	for (std::size_t p=0; p<planes.size(); ++p)
+	  {
+	    const int pi = a.get_plane_id(di, planes[p]);
+	    check(pi==b.get_plane_id(di, planes[p]), "plane " + planes[p]);
+	    check(a.get_n_segment(di, pi)==b.get_n_segment(di, pi),
+		  "n_segment " + planes[p]);
+	    check(la[di][pi].size()==lb[di][pi].size(),
+		  "digit list " + planes[p]);
+	    const NameList& segments = a.get_name_list(di, pi);
+	    for (std::size_t s=0; s<segments.size(); ++s)
+	      {
+		const int si = a.get_segment_id(di, pi, segments[s]);
+		check(si==b.get_segment_id(di, pi, segments[s]),
+		      "segment " + segments[s]);
+		const NameList& chs = a.get_name_list(di, pi, si);
+		for (std::size_t c=0; c<chs.size(); ++c)
+		  {
+		    const int ci = a.get_ch_id(di, pi, si, chs[c]);
+		    check(ci==b.get_ch_id(di, pi, si, chs[c]), "ch " + chs[c]);
+		    check(a.get_n_data(di, pi, si, ci)
+			  ==b.get_n_data(di, pi, si, ci), "n_data " + chs[c]);
+		    const NameList& data = a.get_name_list(di, pi, si, ci);
+		    for (std::size_t k=0; k<data.size(); ++k)
+		      check(a.get_data_id(di, pi, si, ci, data[k])
+			    ==b.get_data_id(di, pi, si, ci, data[k]),
+			    "data " + data[k]);
+		  }
+	      }
+	  }
+      }
+  }
+
+  bool equal(const FrontEndOpList& a, const FrontEndOpList& b)
+  {
+    if (a.size()!=b.size())
+      return false;
+    for (std::size_t i=0; i<a.size(); ++i)
+      {
+	if (a[i].m_op!=b[i].m_op)
+	  return false;
+	if (a[i].m_op==FrontEndOp::k_begin
+	    && (a[i].m_tag!=b[i].m_tag
+		|| a[i].m_names!=b[i].m_names
+		|| a[i].m_values!=b[i].m_values))
+	  return false;
+	if (a[i].m_op==FrontEndOp::k_channel)
+	  for (int k=0; k<FrontEndOp::k_n_index; ++k)
+	    if (a[i].m_index[k]!=b[i].m_index[k])
+	      return false;
+      }
+    return true;
+  }
+
+  void copy_file(const std::string& from, const std::string& to)
+  {
+    std::ifstream ifs(from.c_str(), std::ios::binary);
+    std::ofstream ofs(to.c_str(), std::ios::binary | std::ios::trunc);
+    ofs << ifs.rdbuf();
+  }
+}
+
+//______________________________________________________________________________
+int
+main(int argc, char* argv[])
+{
+  if (argc<2)
+    {
+      std::cerr << "usage: " << argv[0] << " digit.xml [cache_file]"
+		<< std::endl;
+      return EXIT_FAILURE;
+    }
+  const std::string source = argv[1];
+  const std::string cache_name
+    = (argc>2) ? argv[2] : "configcache.test.cache";
+  // a copy, so that the input can be changed below
+  const std::string digit_file = cache_name + ".digit.xml";
+  copy_file(source, digit_file);
+
+  hddaq::xml::initialize_xml();
+  // the parser goes before xerces is terminated
+  {
+    hddaq::xml::DOMParser parser;
+    UnpackerXMLErrorHandler err_handler;
+    hddaq::xml::DOMElement* e
+      = hddaq::xml::initialize_parser(parser, err_handler, digit_file,
+				      "configcache");
+
+    DigitList list_xml;
+    DigitInfo digit_xml(e, list_xml);
+
+    UnpackerConfigCache out;
+    out.add_input(digit_file);
+    std::map<std::string, std::string> control;
+    control["cout"] = "";
+    control["tag_summary"] = "tag.txt";
+    std::vector<std::pair<int, int> > run_range(1, std::make_pair(1, 100));
+    out.set_control(control, run_range);
+    out.store_digit(digit_xml);
+    out.set_dump("hex");
+    UnpackerConfigCache::AttrList names(2), values(2);
+    names[0] = "name";  values[0] = "fe0";
+    names[1] = "id";    values[1] = "0x10";
+    out.begin_front_end("vme", names, values);
+    out.add_channel(0, 1, 0, 0, 0, 0, 0);
+    out.end_front_end();
+    check(out.save(cache_name, "config.xml", digit_file, ""), "save");
+
+    UnpackerConfigCache in;
+    check(in.load(cache_name, "config.xml", digit_file, ""), "load");
+    check(in.get_control()==control, "control");
+    check(in.get_run_range()==run_range, "run range");
+    check(in.get_dump()=="hex", "dump");
+    check(equal(in.get_front_end(), out.get_front_end()), "front end");
+
+    DigitList list_cache;
+    DigitInfo digit_cache(in, list_cache);
+    compare(digit_xml, digit_cache, list_xml, list_cache);
+
+    // the file arguments and the inputs are part of the key
+    UnpackerConfigCache other;
+    check(!other.load(cache_name, "other.xml", digit_file, ""),
+	  "load with another config file");
+    {
+      std::ofstream ofs(digit_file.c_str(), std::ios::app);
+      ofs << "\n";
+    }
+    check(!other.load(cache_name, "config.xml", digit_file, ""),
+	  "load after the digit file changed");
+    check(other.get_front_end().empty() && other.get_control().empty(),
+	  "cleared after a failed load");
+
+    // a damaged payload fails the checksum
+    copy_file(source, digit_file);
+    check(out.save(cache_name, "config.xml", digit_file, ""), "save again");
+    {
+      std::fstream fs(cache_name.c_str(),
+		      std::ios::in | std::ios::out | std::ios::binary);
+      fs.seekp(0, std::ios::end);
+      const std::streamoff size = fs.tellp();
+      fs.seekp(size-1);
+      fs.put('\x7f');
+    }
+    check(!other.load(cache_name, "config.xml", digit_file, ""),
+	  "load of a damaged file");
+  }
+  std::remove(cache_name.c_str());
+  std::remove(digit_file.c_str());
+  hddaq::xml::terminate_xml();
+
+  std::cout << (n_error ? "FAILED " : "OK ") << n_error << " error(s)"
+	    << std::endl;
+  return n_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
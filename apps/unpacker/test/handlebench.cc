@@ -0,0 +1,139 @@
+/*
+ *  handlebench: name lookups against handles when reading a recorded run
+ *
+ *  usage: handlebench config.xml input.dat [nevent]
+ *
+ *  Unpacks the run and reads every channel of every device of the digit
+ *  XML twice per event, as analysis code does:
+ *    name    get_entries()/get() with the device name and a data id from
+ *            get_data_id(device, data) at each channel
+ *    handle  get_entries()/get() with handles from get_handle(), resolved
+ *            before the event loop
+ *  The sums of the values read must agree. The unpacking itself is not
+ *  timed.
+ */
+
+#include <cstdlib>
+#include <sys/time.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "UnpackerConfig.hh"
+#include "UnpackerManager.hh"
+#include "UnpackerXMLReadDigit.hh"
+
+using namespace hddaq::unpacker;
+
+namespace
+{
+  typedef UnpackerManager::Handle Handle;
+
+  double now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+  }
+}
+
+//______________________________________________________________________________
+int
+main(int argc, char* argv[])
+{
+  if (argc<3)
+    {
+      std::cerr << "usage: " << argv[0]
+		<< " config.xml input.dat [nevent]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  const int max_event = (argc>3) ? std::atoi(argv[3]) : -1;
+
+  UnpackerManager& g_unpacker = GUnpacker::get_instance();
+  g_unpacker.set_config_file(argv[1]);
+  g_unpacker.set_istream(argv[2]);
+  g_unpacker.initialize();
+
+  const UnpackerConfig::DigitInfo& digit_info
+    = GConfig::get_instance().get_digit_info();
+  const std::vector<std::string>& devices = digit_info.get_name_list();
+  const int n_device = devices.size();
+
+  // data names of each device, and one handle per device, plane, data
+  std::vector<std::vector<std::string> > data_names(n_device);
+  std::vector<std::vector<std::vector<Handle> > > handles(n_device);
+  for (int d=0; d<n_device; ++d)
+    {
+      if (devices[d].empty() || g_unpacker.get_n_plane(d)==0)
+	continue;
+      data_names[d] = digit_info.get_name_list(d, 0, 0, 0);
+      const int n_plane = g_unpacker.get_n_plane(d);
+      handles[d].resize(n_plane);
+      for (int p=0; p<n_plane; ++p)
+	for (std::size_t k=0; k<data_names[d].size(); ++k)
+	  handles[d][p].push_back(g_unpacker.get_handle(devices[d], p,
+							data_names[d][k]));
+    }
+
+  double t_name   = 0.;
+  double t_handle = 0.;
+  unsigned long long sum_name   = 0;
+  unsigned long long sum_handle = 0;
+  unsigned long long n_read     = 0;
+  int n_event = 0;
+  for (; !g_unpacker.eof() && n_event!=max_event; ++g_unpacker, ++n_event)
+    {
+      double t0 = now();
+      for (int d=0; d<n_device; ++d)
+	{
+	  const std::string& name = devices[d];
+	  for (int p=0, n_plane=handles[d].size(); p<n_plane; ++p)
+	    for (int s=0, n_seg=g_unpacker.get_n_segment(d, p); s<n_seg; ++s)
+	      for (int c=0, n_ch=g_unpacker.get_n_ch(d, p, s); c<n_ch; ++c)
+		{
+		  const int n_data = g_unpacker.get_n_data(d, p, s, c);
+		  for (int k=0; k<n_data && k<(int)data_names[d].size(); ++k)
+		    {
+		      const int id = g_unpacker.get_data_id(name,
+							    data_names[d][k]);
+		      const unsigned int n
+			= g_unpacker.get_entries(name, p, s, c, id);
+		      for (unsigned int i=0; i<n; ++i)
+			sum_name += g_unpacker.get(name, p, s, c, id, i);
+		      n_read += n;
+		    }
+		}
+	}
+      double t1 = now();
+      for (int d=0; d<n_device; ++d)
+	for (int p=0, n_plane=handles[d].size(); p<n_plane; ++p)
+	  {
+	    const std::vector<Handle>& h = handles[d][p];
+	    for (int s=0, n_seg=g_unpacker.get_n_segment(d, p); s<n_seg; ++s)
+	      for (int c=0, n_ch=g_unpacker.get_n_ch(d, p, s); c<n_ch; ++c)
+		{
+		  const int n_data = g_unpacker.get_n_data(d, p, s, c);
+		  for (int k=0; k<n_data && k<(int)h.size(); ++k)
+		    {
+		      const unsigned int n = g_unpacker.get_entries(h[k], s, c);
+		      for (unsigned int i=0; i<n; ++i)
+			sum_handle += g_unpacker.get(h[k], s, c, i);
+		    }
+		}
+	  }
+      double t2 = now();
+      t_name   += t1 - t0;
+      t_handle += t2 - t1;
+    }
+
+  std::cout << std::fixed << std::setprecision(3)
+	    << "events  " << n_event << ", hits " << n_read << "\n"
+	    << "name    " << t_name   << " s, sum " << sum_name   << "\n"
+	    << "handle  " << t_handle << " s, sum " << sum_handle << "\n";
+  if (t_handle>0.)
+    std::cout << "speedup " << t_name/t_handle << "\n";
+  std::cout << std::flush;
+  return (sum_name==sum_handle) ? EXIT_SUCCESS : EXIT_FAILURE;
+}